@@ -166,7 +166,8 @@ void GY521_I2C1_Init(void);
 //     (6) задаёт TRISE
 //     (7) включает аппаратный ACK
 //     (8) включает I2C (CR1.PE)
-//     (9) выводит CR1 и CR2 через USART для диагностики
+//     (9) передаёт шину менеджеру: I2CBus_Init(I2CBus_HwOps())
+//    (10) выводит CR1 и CR2 через USART для диагностики
 //
 //   После выполнения:
 //     → интерфейс готов к работе,
@@ -2,7 +2,9 @@
 #define MPU6050_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "stm32f4xx.h"
+#include "i2c_bus.h"
 
 /******************************************************************************
  *                         МОДУЛЬ MPU6050 — ПОЛНАЯ ДОКУМЕНТАЦИЯ
@@ -10,8 +12,8 @@
  * Этот модуль реализует низкоуровневый драйвер для инерциального датчика
  * MPU6050 (акселерометр + гироскоп + температура).
  *
- * Драйвер рассчитан НА ПОЛНОСТЬЮ РУЧНОЕ УПРАВЛЕНИЕ I2C (регистры CR1/CR2/SR1/SR2).
- * Мы используем только однобайтовые операции чтения/записи.
+ * Обмен по I2C идёт через менеджер шины (i2c_bus.h): датчик — одно из
+ * устройств на I2C1, регистровые транзакции — в i2c_bus_hw.c.
  *
  * ----------------------------------------------------------------------------
  *                         ОБЩАЯ СХЕМА РАБОТЫ MPU6050
@@ -20,6 +22,9 @@
  * 1) Сначала вызываем GY521_I2C1_Init()  — инициализация физического интерфейса I2C.
  * 2) Затем вызываем MPU6050_Init()       — конфигурация датчика.
  * 3) Далее можно опрашивать данные:
+ *       - MPU6050_ReadSample()    — отсчёт ImuSample_t (сырые + время + номер).
+ *       - MPU6050_SubmitSample()  — то же через очередь шины, с дедлайном.
+ *       - MPU6050_ToPhys() / MPU6050_ToFixed() — пакетный перевод N отсчётов.
  *       - MPU6050_ReadRaw()       — получить СЫРЫЕ значения (16-бит).
  *       - MPU6050_AccelLSB_to_g() — перевод акселя в g.
  *       - MPU6050_GyroLSB_to_dps()— перевод гироскопа в °/с.
@@ -73,13 +78,20 @@
  *
  *  ● float MPU6050_AccelLSB_to_g(int16_t raw)
  *      - Конвертирует сырые данные акселерометра в единицы ускорения g.
- *      - Использует масштаб текущего диапазона (в данном драйвере: ±8g → 4096 LSB/g).
+ *      - Использует масштаб текущего диапазона (по умолчанию ±8g → 4096 LSB/g).
  *
  * ----------------------------------------------------------------------------
  *
  *  ● float MPU6050_GyroLSB_to_dps(int16_t raw)
  *      - Конвертирует сырые данные гироскопа в градусы/секунду.
- *      - Масштаб фиксирован на ±2000°/с → 16.4 LSB/dps.
+ *      - Использует масштаб текущего диапазона (по умолчанию ±2000°/с → 16.4 LSB/dps).
+ *
+ * ----------------------------------------------------------------------------
+ *
+ *  ● uint8_t MPU6050_Configure(const MPU6050_Config_t *cfg)
+ *      - Меняет на лету DLPF, частоту выдачи и диапазоны.
+ *      - Коэффициенты перевода обновляются согласованно с регистрами.
+ *      - Готовые пресеты: MPU6050_CONFIG_DEFAULT / _LOW_LATENCY / _CALIBRATION.
  *
  * ----------------------------------------------------------------------------
  *
@@ -101,14 +113,11 @@
  *                              ВАЖНЫЕ МОМЕНТЫ:
  * ----------------------------------------------------------------------------
  *
- *  ● Все функции основаны на СИНХРОННЫХ однобайтных операциях I2C.
- *      Это делает код стабильным, но не самым быстрым.
- *
- *  ● Драйвер НЕ использует DMA, FIFO или burst read.
+ *  ● Все функции основаны на СИНХРОННЫХ операциях I2C (без DMA и FIFO).
  *
- *  ● MPU6050_ReadRaw() читает 14 регистров ПО ОДНОМУ БАЙТУ.
- *      → Работает всегда, но медленно.
- *      Если позже тебе нужен burst read — я напишу.
+ *  ● Данные (MPU6050_ReadSample / ReadRaw) читаются ОДНИМ burst-чтением
+ *      14 байт: датчик фиксирует теневые регистры на старте чтения, так
+ *      что аксель, температура и гироскоп — из одного момента.
  *
  *  ● Драйвер предполагает:
  *        - AD0 = GND → адрес 0x68
@@ -152,12 +161,159 @@
 // Прерывание: Data Ready
 #define MPU6050_INT_DATA_RDY 0x01
 
+/* ========== Масштаб температуры (обратная величина — умножение вместо деления) ========== */
+#define MPU6050_C_PER_LSB_TEMP (1.0f / 340.0f) // 340 LSB/°C
+
+/******************************************************************************
+ *                    НАСТРАИВАЕМАЯ КОНФИГУРАЦИЯ ДАТЧИКА
+ *
+ * Частота выдачи (ODR) = F_int / (1 + smplrt_div),
+ *     F_int = 8 кГц при DLPF_260HZ (фильтр выключен), иначе 1 кГц.
+ *
+ * DLPF — цифровой ФНЧ: чем уже полоса, тем меньше шум и БОЛЬШЕ задержка
+ * (по даташиту: 260 Гц → ~0 мс, 44 Гц → ~4.9 мс, 5 Гц → ~19 мс).
+ *
+ * Диапазоны задают масштаб: коэффициенты перевода в g и °/с
+ * пересчитываются автоматически в MPU6050_Configure().
+ ******************************************************************************/
+
+typedef enum
+{
+    MPU6050_DLPF_260HZ = 0, // фильтр выключен, задержка ~0
+    MPU6050_DLPF_184HZ = 1,
+    MPU6050_DLPF_94HZ = 2,
+    MPU6050_DLPF_44HZ = 3,
+    MPU6050_DLPF_21HZ = 4,
+    MPU6050_DLPF_10HZ = 5,
+    MPU6050_DLPF_5HZ = 6 // максимальное сглаживание
+} MPU6050_Dlpf;
+
+typedef enum
+{
+    MPU6050_GYRO_FS_250 = 0,  // 131   LSB/(°/с)
+    MPU6050_GYRO_FS_500 = 1,  // 65.5  LSB/(°/с)
+    MPU6050_GYRO_FS_1000 = 2, // 32.8  LSB/(°/с)
+    MPU6050_GYRO_FS_2000 = 3  // 16.4  LSB/(°/с)
+} MPU6050_GyroFs;
+
+typedef enum
+{
+    MPU6050_ACCEL_FS_2G = 0, // 16384 LSB/g
+    MPU6050_ACCEL_FS_4G = 1, // 8192  LSB/g
+    MPU6050_ACCEL_FS_8G = 2, // 4096  LSB/g
+    MPU6050_ACCEL_FS_16G = 3 // 2048  LSB/g
+} MPU6050_AccelFs;
+
+typedef struct
+{
+    MPU6050_Dlpf dlpf;
+    uint8_t smplrt_div;
+    MPU6050_GyroFs gyro_fs;
+    MPU6050_AccelFs accel_fs;
+} MPU6050_Config_t;
+
+/* Конфигурация по умолчанию (как было зашито раньше):
+ * DLPF 44 Гц, 125 Гц, ±2000°/с, ±8g */
+#define MPU6050_CONFIG_DEFAULT \
+    {MPU6050_DLPF_44HZ, 7U, MPU6050_GYRO_FS_2000, MPU6050_ACCEL_FS_8G}
+
+/* Быстрые повороты: минимальная задержка, 1 кГц */
+#define MPU6050_CONFIG_LOW_LATENCY \
+    {MPU6050_DLPF_184HZ, 0U, MPU6050_GYRO_FS_2000, MPU6050_ACCEL_FS_8G}
+
+/* Калибровка на месте: сильный ФНЧ, 100 Гц, максимальная чувствительность */
+#define MPU6050_CONFIG_CALIBRATION \
+    {MPU6050_DLPF_5HZ, 9U, MPU6050_GYRO_FS_250, MPU6050_ACCEL_FS_2G}
+
+/******************************************************************************
+ *                         ОТСЧЁТ IMU (ImuSample_t)
+ *
+ * 14 байт регистров 0x3B..0x48 читаются одним burst-чтением ПРЯМО в raw[],
+ * затем байты каждого слова переставляются на месте (REV16: big endian
+ * датчика → little endian ядра). Промежуточных буферов нет.
+ *
+ * raw[] выровнен на 4 байта: пары (ax,ay), (az,T), (gx,gy) читаются одним
+ * словом и обрабатываются упакованными 16-битными инструкциями DSP.
+ *
+ * Порядок raw[] совпадает с SlogImu_t — отсчёт пишется в sensor_log как есть.
+ ******************************************************************************/
+
+typedef enum
+{
+    IMU_AX = 0,
+    IMU_AY,
+    IMU_AZ,
+    IMU_TEMP,
+    IMU_GX,
+    IMU_GY,
+    IMU_GZ,
+    IMU_RAW_COUNT
+} ImuRawIdx;
+
+typedef struct __attribute__((packed, aligned(4)))
+{
+    int16_t raw[IMU_RAW_COUNT]; // ACCEL_X/Y/Z, TEMP, GYRO_X/Y/Z
+    uint16_t seq;               // номер попытки чтения (дыра — ошибка I2C)
+    uint32_t t_us;              // Time_Us() в начале burst-чтения
+} ImuSample_t;
+
+/* Физические единицы (float) */
+typedef struct
+{
+    float accel_g[3];
+    float temp_c;
+    float gyro_dps[3];
+    uint32_t t_us;
+} ImuPhys_t;
+
+/* Фиксированная точка: mg, сотые °C, m°/с */
+typedef struct
+{
+    int32_t accel_mg[3];
+    int32_t temp_cdeg;
+    int32_t gyro_mdps[3];
+    uint32_t t_us;
+} ImuFixed_t;
+
 /******************************************************************************
  *                           ПРОТОТИПЫ ФУНКЦИЙ
  ******************************************************************************/
 
 void MPU6050_Init(void);
 
+/**
+ * @brief Применить конфигурацию (DLPF, делитель частоты, диапазоны).
+ *        Регистры пишутся по порядку до первой ошибки; GetConfig() и масштабы
+ *        перевода следуют за каждой удачной записью.
+ * @return 1 — успех, 0 — ошибка I2C (GetConfig() — то, что реально в датчике)
+ */
+uint8_t MPU6050_Configure(const MPU6050_Config_t *cfg);
+
+/**
+ * @brief Сменить только полосу DLPF, сохранив частоту выдачи.
+ *        Переход через DLPF_260HZ меняет F_int (1 ↔ 8 кГц) — SMPLRT_DIV
+ *        пересчитывается на ту же частоту: к 8 кГц точно (до 31.25 Гц —
+ *        предел делителя), к 1 кГц — ближайшая 1000 / n Гц.
+ * @return 1 — успех, 0 — ошибка I2C (GetConfig() — то, что реально в датчике)
+ */
+uint8_t MPU6050_SetDLPF(MPU6050_Dlpf dlpf);
+
+/**
+ * @brief Текущая конфигурация
+ */
+const MPU6050_Config_t *MPU6050_GetConfig(void);
+
+/**
+ * @brief Частота выдачи данных, Гц
+ */
+float MPU6050_GetOutputRateHz(void);
+
+/**
+ * @brief Текущие масштабы: g на LSB и °/с на LSB
+ */
+float MPU6050_GetAccelScale(void);
+float MPU6050_GetGyroScale(void);
+
 /**
  * @brief Чтение WHO_AM_I (должно вернуть 0x68)
  */
@@ -173,12 +329,42 @@ uint8_t MPU6050_ReadWhoAmI(void);
 void MPU6050_ReadRaw(int16_t accel[3], int16_t gyro[3], int16_t *temp);
 
 /**
- * @brief Перевод LSB в g (для диапазона ±8g)
+ * @brief Один отсчёт burst-чтением прямо в s->raw, с отметкой времени и номером
+ * @return 1 — успех; при ошибке I2C номер всё равно расходуется
+ */
+uint8_t MPU6050_ReadSample(ImuSample_t *s);
+
+/**
+ * @brief Отсчёт через очередь шины: I2C_PRIO_HIGH, дедлайн, отброс при опоздании
+ *
+ * x и s должны жить до завершения; готовность — x->status == I2C_XFER_DONE,
+ * t_us — начало транзакции на шине.
+ * @return 0 — очередь полна или x ещё занята (тогда x и её отсчёт не меняются)
+ */
+uint8_t MPU6050_SubmitSample(I2CXfer_t *x, ImuSample_t *s, uint32_t deadline_us);
+
+/**
+ * @brief Пакетный перевод n отсчётов в физические единицы (float)
+ *
+ * @param gyro_bias_lsb [3] — смещение гироскопа в LSB (вычитается с насыщением), или NULL
+ */
+void MPU6050_ToPhys(const ImuSample_t *in, ImuPhys_t *out, uint32_t n,
+                    const int16_t gyro_bias_lsb[3]);
+
+/**
+ * @brief Пакетный перевод n отсчётов в фиксированную точку (без FPU):
+ *        пара осей — одно слово, масштаб с округлением — SMLAD
+ */
+void MPU6050_ToFixed(const ImuSample_t *in, ImuFixed_t *out, uint32_t n,
+                     const int16_t gyro_bias_lsb[3]);
+
+/**
+ * @brief Перевод LSB в g (для текущего диапазона акселерометра)
  */
 float MPU6050_AccelLSB_to_g(int16_t raw);
 
 /**
- * @brief Перевод LSB гироскопа в °/с (для ±2000 dps)
+ * @brief Перевод LSB гироскопа в °/с (для текущего диапазона гироскопа)
  */
 float MPU6050_GyroLSB_to_dps(int16_t raw);
 
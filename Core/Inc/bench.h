@@ -0,0 +1,56 @@
+// bench.h
+//
+// Набор бенчмарков модулей управления на самой плате.
+//
+// Каждый случай гоняет функцию по заранее сгенерированным входам
+// (xorshift32 с фиксированным BENCH_SEED — прогоны повторяемы):
+//
+//   1. подготовка входов и состояния (setup);
+//   2. прогрев BENCH_WARMUP вызовов — кэш ART флеша и предсказатель;
+//   3. BENCH_REPEATS замеров по iters вызовов счётчиком DWT->CYCCNT,
+//      берётся минимум (прерывания только увеличивают время).
+//
+// Результат — одна строка JSON в USART3:
+//
+//   {"bench":"core","cpu_hz":168000000,"seed":...,"results":[
+//     {"name":"pid_update","cycles":<такты>,"ns":<нс>,"heap":<байт>}, ...]}
+//
+//   cycles / ns — на одну операцию, heap — прирост занятой кучи, байт
+//   (newlib mallinfo, на ПК — glibc mallinfo2; −1, если недоступно).
+//   Модули управления кучу не используют — любое ненулевое значение
+//   уже регрессия.
+//
+// Слияние IMU (imu_fusion) — цепочка main_gyro.c на один отсчёт:
+// MPU6050_ToPhys → GyroTC_Process → интегрирование курса. Отдельного
+// модуля фильтра в дереве нет, поэтому меряется сама цепочка.
+//
+// Сравнение с эталоном и порог регрессии — Tools/bench_compare.py.
+// Тот же набор собирается на ПК (Tests/: make bench): "bench":"host",
+// cpu_hz = 1 ГГц, то есть такт — наносекунда ПК. Его эталон —
+// Tests/bench_baseline.json, свой у каждой машины (не в git); ни с
+// платой, ни с другим ПК такие цифры не сравнимы.
+//
+// Включается BENCH_ENABLE = 1: main() гоняет набор до сценария движения.
+// Моторы при этом стоят: регулятор скорости работает с нулевой целью.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE 0
+#endif
+
+#define BENCH_SEED 0x2545F491UL
+#define BENCH_WARMUP 64U
+#ifndef BENCH_REPEATS
+#define BENCH_REPEATS 5U // на ПК больше (Tests/Makefile): шумит планировщик ОС
+#endif
+#define BENCH_ITERS 1000U
+#define BENCH_INPUTS 256U // размер таблиц входов (степень двойки)
+
+/* Прогнать все случаи и напечатать JSON */
+void Bench_RunAll(void);
+
+#endif // BENCH_H
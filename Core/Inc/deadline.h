@@ -0,0 +1,118 @@
+// deadline.h
+//
+// Монитор дедлайнов задач управления + IWDG + аварийное отключение моторов.
+//
+// Каждая задача (регулятор скорости, цикл движения, опрос IMU) отмечается
+// Deadline_CheckIn() каждый свой проход. SysTick (1 мс) вызывает
+// Deadline_Tick(), который для каждой включённой задачи проверяет время
+// с последней отметки:
+//
+//   gap > budget        → промах: Motor_EmergencyOff() (break TIM1 —
+//                         PWM гаснет сразу, в пределах периода PWM),
+//                         запись в самописец, IWDG больше не сбрасывается
+//                         → через DEADLINE_IWDG_MS контроллер перезагрузится;
+//   gap > budget · 3/4  → «почти промах» (near miss): только счётчик.
+//
+// IWDG сбрасывается в том же SysTick, и только если все задачи здоровы.
+// Пока не включена ни одна задача (инициализация, паузы, бесконечный
+// цикл после ошибки), нужна ещё и отметка основного контекста
+// Deadline_Alive() после прошлого сброса — иначе зависший main без задач
+// держался бы на одном SysTick. Отметку ставит Idle_SleepUntil (значит,
+// и Time_DelayMs), долгие циклы без сна отмечаются сами.
+// Если встанут сами прерывания (HardFault, __disable_irq навсегда) —
+// IWDG перезагрузит контроллер, сброс периферии выключит мосты.
+//
+// Счётчики (near miss, max gap) показывают, где мало запаса по времени,
+// раньше, чем это превратится в аварию: Deadline_Report().
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+
+/* Таймаут IWDG, мс (LSI 32 кГц / 32 → 1 мс на отсчёт, максимум 4095) */
+#define DEADLINE_IWDG_MS 250U
+
+/* Порог near miss: доля бюджета, % */
+#define DEADLINE_NEAR_PCT 75U
+
+typedef enum
+{
+    DL_TASK_CONTROL = 0, // SpeedControl_Update
+    DL_TASK_MOTION = 1,  // цикл DriveDistanceMM
+    DL_TASK_IMU = 2,     // опрос MPU6050
+    DL_TASK_COUNT
+} DeadlineTask;
+
+/* Причина аварии (Deadline_Failsafe) помимо промаха задачи */
+#define DL_REASON_IMU_ABSENT 0x80U
+
+typedef struct
+{
+    uint32_t budget_ms;
+    uint32_t checkins;
+    uint32_t max_gap_ms; // наибольший интервал между отметками
+    uint32_t near_miss;
+    uint32_t misses;
+} DeadlineStats_t;
+
+/**
+ * @brief Запустить IWDG и сбросить статистику. Все задачи выключены.
+ *        Вызывать после Motor_Init().
+ */
+void Deadline_Init(void);
+
+/**
+ * @brief Включить контроль задачи с бюджетом budget_ms (отсчёт — с этого момента)
+ */
+void Deadline_Enable(DeadlineTask task, uint32_t budget_ms);
+
+/**
+ * @brief Выключить контроль задачи (например, цикл движения завершён)
+ */
+void Deadline_Disable(DeadlineTask task);
+
+/**
+ * @brief Отметка «задача прошла цикл» (main или прерывание)
+ */
+void Deadline_CheckIn(DeadlineTask task);
+
+/**
+ * @brief Отметка «основной контекст жив» (только из main, не из прерываний).
+ *        Без включённых задач IWDG сбрасывается, только если она была
+ *        за последние DEADLINE_IWDG_MS
+ */
+void Deadline_Alive(void);
+
+/**
+ * @brief Проверка дедлайнов и сброс IWDG — из SysTick_Handler, раз в 1 мс
+ */
+void Deadline_Tick(void);
+
+/**
+ * @brief Принудительная авария: моторы выключаются, IWDG перестаёт
+ *        сбрасываться → перезагрузка через DEADLINE_IWDG_MS
+ */
+void Deadline_Failsafe(uint8_t reason);
+
+/**
+ * @brief 0 — всё в порядке, иначе причина (номер задачи + 1 или DL_REASON_*)
+ */
+uint8_t Deadline_Tripped(void);
+
+/**
+ * @brief 1 — прошлая перезагрузка была от IWDG
+ */
+uint8_t Deadline_WasWatchdogReset(void);
+
+/**
+ * @brief Статистика задачи
+ */
+const DeadlineStats_t *Deadline_GetStats(DeadlineTask task);
+
+/**
+ * @brief Печать статистики в USART3
+ */
+void Deadline_Report(void);
+
+#endif // DEADLINE_H
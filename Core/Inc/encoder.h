@@ -48,8 +48,9 @@
 #define WHEEL_DIAMETER_MM 65.0f
 #define WHEEL_CIRCUMFERENCE_MM (3.1415926f * WHEEL_DIAMETER_MM)
 
-// Калибровочный коэффициент 0.95 — поправка реальной механики
-#define ENC_MM_PER_TICK (WHEEL_CIRCUMFERENCE_MM / ENC_PULSES_PER_REV) * 0.95f
+// Номинальный путь на тик (по паспортному диаметру).
+// Реальный масштаб каждого колеса и колея — в калибровке одометрии (odometry.h)
+#define ENC_MM_PER_TICK (WHEEL_CIRCUMFERENCE_MM / ENC_PULSES_PER_REV)
 #define ENC_M_PER_TICK (ENC_MM_PER_TICK / 1000.0f)
 
 // Минимальный интервал между тиками (мс) — защита от дребезга
@@ -60,16 +61,32 @@ extern "C"
 {
 #endif
 
+    /* Курсор потребителя: точка отсчёта для неразрушающих приращений.
+     * Каждому потребителю (регулятор скорости, одометрия, ...) — свой.
+     */
+    typedef struct
+    {
+        uint32_t left;
+        uint32_t right;
+    } EncoderCursor_t;
+
     /* Инициализация модуля энкодеров */
     void Encoder_Init(void);
 
-    /* Получить тики за интервал dt (и обнулить) */
+    /* Получить тики за интервал dt (совместимость; только ОДИН потребитель) */
     void Encoder_GetAndResetTicks(uint32_t *leftTicks, uint32_t *rightTicks);
 
     /* Суммарные тики с момента включения */
     uint32_t Encoder_GetTotalLeft(void);
     uint32_t Encoder_GetTotalRight(void);
 
+    /* Согласованный снимок обоих суммарных счётчиков (seqlock) */
+    void Encoder_GetTotals(uint32_t *left, uint32_t *right);
+
+    /* Неразрушающие приращения тиков по курсору */
+    void Encoder_CursorInit(EncoderCursor_t *c);
+    void Encoder_GetDelta(EncoderCursor_t *c, uint32_t *dLeft, uint32_t *dRight);
+
     /* Конвертация тиков */
     float Encoder_TicksToMM(uint32_t ticks);
     float Encoder_TicksToMeters(uint32_t ticks);
@@ -116,67 +133,44 @@ extern "C"
  *         импульс игнорируется.
  *
  *    Когда импульс прошёл фильтрацию:
- *       s_leftTicks++;     // тики за «интервал»
- *       s_leftTotal++;     // общие тики за всё время
+ *       s_leftTotal++;     // общие тики за всё время (под seqlock)
  *
- *    Таким образом:
- *       - s_leftTicks и s_rightTicks растут постоянно между вызовами
- *         Encoder_GetAndResetTicks().
+ * 3) Как читать счётчики?
  *
- * 3) Что делает Encoder_GetAndResetTicks()?
+ *    Счётчики никогда не обнуляются. Прерывание увеличивает их внутри
+ *    SeqLock_WriteBegin()/WriteEnd() (см. seqlock.h), а читатели берут
+ *    согласованный снимок пары L/R без __disable_irq():
  *
- *    Эта функция вызывается пользователем ПЕРИОДИЧЕСКИ (например, каждые 10 мс).
- *
- *    Назначение:
- *       - забрать значение счётчиков «за интервал»
- *       - и обнулить их
- *
- *    Пример:
- *        (прошло 10 мс)
- *        левое колесо = 3 тика
- *        правое колесо = 2 тика
+ *       uint32_t L, R;
+ *       Encoder_GetTotals(&L, &R);
  *
- *        В этот момент программист вызывает:
+ *    Если во время чтения пришёл тик — снимок просто перечитывается.
+ *    Задержка прерываний для остальной системы не растёт.
  *
- *           uint32_t L, R;
- *           Encoder_GetAndResetTicks(&L, &R);
+ * 4) Приращения за интервал — курсоры
  *
- *        Результат:
- *           L = 3
- *           R = 2
- *        а внутренние буферы станут нулевыми:
- *           s_leftTicks = 0;
- *           s_rightTicks = 0;
+ *    Каждый потребитель держит свой EncoderCursor_t:
  *
- *    Почему функция отключает прерывания (__disable_irq())?
- *       Потому что в этот момент может произойти новое прерывание EXTI,
- *       которое увеличит счётчики. Чтобы не было гонки данных,
- *       обнуление и копирование происходит атомарно.
+ *       static EncoderCursor_t cur;
+ *       Encoder_CursorInit(&cur);
+ *       ...
+ *       uint32_t dL, dR;
+ *       Encoder_GetDelta(&cur, &dL, &dR);   // тики с прошлого вызова
  *
- * 4) Где использовать Encoder_GetAndResetTicks() ?
+ *    Это неразрушающая операция: регулятор скорости, одометрия и
+ *    телеметрия могут читать приращения независимо друг от друга.
  *
- *    Обычно — в основном цикле или внутри таймера, который вызывается
- *    раз в фиксированный промежуток времени, например:
- *
- *       раз в 10 мс → получить тики → рассчитать скорость колеса
+ *    Encoder_GetAndResetTicks() оставлена для совместимости и работает
+ *    поверх внутреннего курсора — её может использовать только ОДИН
+ *    потребитель.
  *
  *    Пример:
- *       float v_left = Encoder_TicksToMM(L) / dt_ms;
- *       float v_right = Encoder_TicksToMM(R) / dt_ms;
- *
- * 5) Какие данные остаются неизменными?
- *
- *    Общие тики:
- *       s_leftTotal и s_rightTotal
- *
- *    Они никогда НЕ обнуляются автоматически и используются чтобы:
- *       - определить пройденный путь
- *       - сбрасывать путь только вручную, если нужно
- *
+ *       float v_left = Encoder_TicksToMM(dL) / dt_ms;
+ *       float v_right = Encoder_TicksToMM(dR) / dt_ms;
  *
  * ИТОГ:
- *   - Прерывания фиксируют импульсы и увеличивают счётчики.
- *   - Encoder_GetAndResetTicks() безопасно забирает эти тики и обнуляет интервал.
- *   - Общие тики всегда растут и используются для логики расстояния.
+ *   - Прерывания фиксируют импульсы и увеличивают счётчики под seqlock.
+ *   - Читатели берут согласованные снимки без запрета прерываний.
+ *   - Приращения за интервал — через собственный курсор каждого потребителя.
  *
  ******************************************************************************/
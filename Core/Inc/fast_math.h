@@ -0,0 +1,119 @@
+// fast_math.h
+//
+// Быстрая математика для регуляторов, одометрии и фьюжна (float, FPv4-SP).
+//
+//   - нормализация углов без циклов while (один multiply + convert);
+//   - sin/cos/atan2 полиномами (минимакс, подобраны на [−π/2, π/2] и [0, 1]);
+//   - перевод единиц умножением на обратную величину вместо деления;
+//   - пакетный перевод массивов int16 → float.
+//
+// Погрешности (float против libm в double, сетка 10^6 точек,
+// замер — Tests/test_fast_math.c):
+//   FM_Sin / FM_Cos   : |ошибка| ≤ 7.2e-7 при |x| ≤ π/2, ≤ 1e-6 при |x| ≤ 2π,
+//                       ≤ 1e-5 при |x| ≤ 100 рад (растёт из-за приведения
+//                       аргумента во float — держите углы нормализованными)
+//   FM_Atan2          : |ошибка| ≤ 2e-6 рад (≈ 1.1e-4°)
+//   FM_WrapDeg180     : результат в [-180, 180], точен до ulp при |x| < 10^6
+//
+// Все функции — static inline: вызов в горячем цикле ничего не стоит.
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <stdint.h>
+
+#define FM_PI 3.14159265f
+#define FM_TWO_PI 6.28318531f
+#define FM_HALF_PI 1.57079633f
+#define FM_INV_TWO_PI 0.159154943f
+#define FM_DEG2RAD 0.0174532925f
+#define FM_RAD2DEG 57.2957795f
+
+/* Округление к ближайшему целому без ветвлений:
+ * copysignf — битовая операция, (int32_t) — VCVT с усечением.
+ */
+static inline float FM_RoundNearest(float x)
+{
+    return (float)(int32_t)(x + __builtin_copysignf(0.5f, x));
+}
+
+/* Угол в градусах → диапазон [-180, +180] */
+static inline float FM_WrapDeg180(float deg)
+{
+    return deg - 360.0f * FM_RoundNearest(deg * (1.0f / 360.0f));
+}
+
+/* Угол в радианах → диапазон [-π, +π] */
+static inline float FM_WrapRadPi(float rad)
+{
+    return rad - FM_TWO_PI * FM_RoundNearest(rad * FM_INV_TWO_PI);
+}
+
+/* sin(x), x — радианы, любой знак */
+static inline float FM_Sin(float x)
+{
+    x = FM_WrapRadPi(x);
+
+    // отражение в [-π/2, π/2]: sin(π − x) = sin(x)
+    float ax = __builtin_fabsf(x);
+    if (ax > FM_HALF_PI)
+        x = __builtin_copysignf(FM_PI, x) - x;
+
+    // минимакс-полином 7-й степени, |ошибка| ≤ 7.2e-7 на [-π/2, π/2]
+    // (максимум у ±π/2, вместе с округлением во float)
+    float x2 = x * x;
+    return x * (0.999996616f +
+                x2 * (-0.166648284f +
+                      x2 * (0.00830632523f +
+                            x2 * -0.000183636539f)));
+}
+
+/* cos(x) = sin(x + π/2) */
+static inline float FM_Cos(float x)
+{
+    return FM_Sin(x + FM_HALF_PI);
+}
+
+/* atan(z) для |z| ≤ 1, минимакс 11-й степени, |ошибка| ≤ 1.8e-6 */
+static inline float FM_AtanUnit(float z)
+{
+    float z2 = z * z;
+    return z * (0.999977219f +
+                z2 * (-0.332622826f +
+                      z2 * (0.193540364f +
+                            z2 * (-0.116426454f +
+                                  z2 * (0.0526473225f +
+                                        z2 * -0.011719125f)))));
+}
+
+/* atan2(y, x) → [-π, π]. atan2(0, 0) = 0. */
+static inline float FM_Atan2(float y, float x)
+{
+    float ax = __builtin_fabsf(x);
+    float ay = __builtin_fabsf(y);
+
+    float mx = (ax > ay) ? ax : ay;
+    float mn = (ax > ay) ? ay : ax;
+    if (mx == 0.0f)
+        return 0.0f;
+
+    float a = FM_AtanUnit(mn / mx); // октант [0, π/4]
+
+    if (ay > ax)
+        a = FM_HALF_PI - a;
+    if (x < 0.0f)
+        a = FM_PI - a;
+
+    return __builtin_copysignf(a, y);
+}
+
+/* Пакетный перевод: dst[i] = src[i] * scale (scale — обратная величина,
+ * например 1/16.4 для гироскопа). Развёрнут по 4 элемента.
+ */
+void FM_ScaleI16(const int16_t *src, float *dst, uint32_t n, float scale);
+
+/* То же с вычитанием смещения: dst[i] = src[i] * scale - offset */
+void FM_ScaleOffsetI16(const int16_t *src, float *dst, uint32_t n,
+                       float scale, float offset);
+
+#endif // FAST_MATH_H
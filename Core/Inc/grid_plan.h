@@ -0,0 +1,94 @@
+// grid_plan.h
+//
+// Карта площадки сеткой и поиск кратчайшего пути на плате.
+//
+// Карта — GRID_W × GRID_H клеток, занятость — битовое поле: строка
+// сетки — одно слово uint32_t (бит x), 128 байт на всю карту. Клетка
+// размером не меньше ширины робота с запасом: путь ведётся через центры
+// свободных клеток.
+//
+// Поиск (4-связность, шаг — 1):
+//
+//   GRID_ASTAR — A* с манхэттенской эвристикой. Открытый список — двоичная
+//       куча на GRID_OPEN_MAX элементов в статической памяти; при равном
+//       f первой берётся клетка с большим g (глубже к цели — меньше
+//       раскрытий). Переполнение кучи — переход на волну (счётчик
+//       overflows), результат остаётся кратчайшим;
+//   GRID_FLOOD — волна (BFS) от цели до старта, затем спуск по
+//       расстояниям; при выборе соседа предпочитается прежнее
+//       направление — среди кратчайших путей меньше поворотов.
+//
+// Пометки «уже видели / закрыта» — тоже битовые поля: подготовка к поиску —
+// обнуление 2 × GRID_H слов, а не всей таблицы расстояний.
+//
+// Grid_EmitPath переводит клетки в точки пути (path_follow.h) в мм
+// в системе одометрии: на прямых остаются только углы, а с smooth
+// соседние углы соединяются напрямую, если отрезок не задевает занятых
+// клеток (проверка всех клеток, которые пересекает отрезок) — путь
+// под произвольными углами для следования без остановок.
+
+#ifndef GRID_PLAN_H
+#define GRID_PLAN_H
+
+#include <stdint.h>
+
+#define GRID_W 32U // не больше 32: строка — одно слово
+#define GRID_H 32U
+#define GRID_CELLS (GRID_W * GRID_H)
+#define GRID_OPEN_MAX 256U // открытый список A*
+
+#define GRID_CELL_MM_DEFAULT 100.0f
+
+typedef struct
+{
+    uint8_t x;
+    uint8_t y;
+} GridCell_t;
+
+typedef enum
+{
+    GRID_ASTAR = 0,
+    GRID_FLOOD = 1
+} GridAlgo;
+
+typedef struct
+{
+    uint32_t expanded;  // раскрыто клеток (A*) / пройдено волной
+    uint32_t open_peak; // наибольший размер открытого списка
+    uint32_t overflows; // переполнения кучи → волна (за всё время)
+    uint32_t length;    // клеток в пути, 0 — пути нет
+} GridPlanStats_t;
+
+/* Размер клетки и положение угла клетки (0, 0) в системе одометрии, мм.
+ * Карта очищается.
+ */
+void Grid_Init(float cell_mm, float origin_x_mm, float origin_y_mm);
+
+void Grid_Clear(void);
+
+/* Прямоугольник клеток [x0..x1] × [y0..y1] включительно (обрезается по карте) */
+void Grid_SetRect(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, uint8_t blocked);
+
+void Grid_SetBlocked(uint32_t x, uint32_t y, uint8_t blocked);
+
+/* За пределами карты — занято */
+uint8_t Grid_IsBlocked(int32_t x, int32_t y);
+
+/* Клетка под точкой (мм). @return 0 — точка вне карты */
+uint8_t Grid_CellAt(float x_mm, float y_mm, GridCell_t *c);
+void Grid_CellCenter(GridCell_t c, float *x_mm, float *y_mm);
+
+/* Путь start → goal включительно в out[0..max-1].
+ * @return число клеток; 0 — пути нет, старт/цель заняты или не влезло в max
+ */
+uint32_t Grid_Plan(GridAlgo algo, GridCell_t start, GridCell_t goal,
+                   GridCell_t *out, uint32_t max);
+
+const GridPlanStats_t *Grid_LastStats(void);
+
+/* Клетки → точки пути (Path_Clear + Path_Add), smooth — срезать углы
+ * по прямой видимости. @return число точек; 0 — не влезло в PATH_MAX_POINTS
+ */
+uint32_t Grid_EmitPath(const GridCell_t *cells, uint32_t n, uint8_t smooth);
+
+#endif // GRID_PLAN_H
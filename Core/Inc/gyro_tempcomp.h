@@ -0,0 +1,95 @@
+// gyro_tempcomp.h
+//
+// Температурная компенсация смещения гироскопа.
+//
+// Смещение нуля MPU6050 заметно меняется с температурой кристалла
+// (порядка 0.01..0.05 °/с на °C), а калибровка при старте фиксирует его
+// только для одной температуры — за смену плата прогревается и yaw уплывает.
+//
+// Модель: кусочно-линейная таблица bias(T) по трём осям,
+// узлы через GTC_T_STEP_C от GTC_T_MIN_C.
+//
+// Обучение — на участках покоя (флаг still от вызывающего + отклонение
+// от текущей оценки меньше GTC_STILL_DPS по всем осям): каждые GTC_WINDOW
+// отсчётов среднее окна раскладывается в два соседних узла с весами
+// линейной интерполяции. Незаполненные узлы между заполненными
+// интерполируются, за краями — держится ближайший заполненный.
+//
+// Применение — GyroTC_Process() на каждый отсчёт: температура меняется
+// медленно, поэтому смещение пересчитывается только при изменении сырой
+// температуры на GTC_REFRESH_LSB (~0.1 °C), а в остальное время это
+// три вычитания и одно сравнение.
+//
+// Таблица сохраняется в backup SRAM (persist.h, слот PERSIST_SLOT_GYRO_TC).
+
+#ifndef GYRO_TEMPCOMP_H
+#define GYRO_TEMPCOMP_H
+
+#include <stdint.h>
+
+#define GTC_T_MIN_C 10.0f  // температура первого узла, °C
+#define GTC_T_STEP_C 4.0f  // шаг узлов, °C
+#define GTC_NODES 14U      // 10..62 °C
+
+#define GTC_WINDOW 250U       // отсчётов покоя на одну точку (2 с @ 125 Гц)
+#define GTC_STILL_DPS 2.0f    // порог «неподвижен» относительно текущего bias
+#define GTC_ALPHA_MIN 0.05f   // нижняя граница шага обучения (следим за старением)
+#define GTC_REFRESH_LSB 34    // пересчёт bias при ΔT ≥ 34 LSB ≈ 0.1 °C
+
+#define GTC_VERSION 1U
+
+/* Сохраняемая часть */
+typedef struct
+{
+    float bias[GTC_NODES][3]; // °/с
+    uint16_t count[GTC_NODES]; // сколько точек легло в узел (0 — пусто)
+} GyroTC_Table_t;
+
+typedef struct
+{
+    GyroTC_Table_t tab;
+
+    /* Кэш текущего смещения */
+    float cur_bias[3];
+    int16_t cache_temp_raw;
+    uint8_t cache_valid;
+
+    /* Окно обучения */
+    float win_sum[3];
+    int32_t win_temp_sum;
+    uint16_t win_n;
+
+    uint8_t dirty; // таблица изменилась после последнего сохранения
+} GyroTC_t;
+
+/**
+ * @brief Обнулить модель и подгрузить таблицу из backup SRAM
+ * @return 1 — таблица восстановлена, 0 — начинаем с пустой
+ */
+uint8_t GyroTC_Init(GyroTC_t *tc);
+
+/**
+ * @brief Добавить точку bias(T) (например, результат MPU6050_CalibrateGyro)
+ */
+void GyroTC_Learn(GyroTC_t *tc, float temp_c, const float bias_dps[3]);
+
+/**
+ * @brief Смещение по таблице для заданной температуры
+ */
+void GyroTC_GetBias(const GyroTC_t *tc, float temp_c, float bias_dps[3]);
+
+/**
+ * @brief Обработка отсчёта: обучение (если still) и вычитание bias на месте
+ * @param temp_raw сырое слово температуры из MPU6050_ReadRaw
+ * @param g        угловые скорости, °/с (на входе сырые, на выходе исправленные)
+ * @param still    1 — робот заведомо стоит (моторы выключены)
+ */
+void GyroTC_Process(GyroTC_t *tc, int16_t temp_raw, float g[3], uint8_t still);
+
+/**
+ * @brief Сохранить таблицу, если она менялась
+ * @return 1 — записано, 0 — нечего сохранять
+ */
+uint8_t GyroTC_Save(GyroTC_t *tc);
+
+#endif // GYRO_TEMPCOMP_H
@@ -10,7 +10,10 @@ void Heading_SetTarget(float yaw_deg);
 // Обновить управляющие воздействия: на выходе получаем желаемые rps для левого/правого колеса
 // yaw_deg    — текущий угол (из гироскопа)
 // base_rps   — "средняя" линейная скорость (об/сек)
-// *outL / R  — результат (об/сек) для левого/правого
+// *outL / R  — результат (об/сек) для левого/правого, СО ЗНАКОМ: при большой
+//              ошибке курса одно колесо уходит назад (разворот на месте).
+//              Передавать в SpeedControl_SetWheelRps — он принимает знак
+//              и урезает оба колеса одним множителем, не меняя кривизну.
 void Heading_Compute(float yaw_deg, float base_rps, float *outL, float *outR);
 
 #endif // HEADING_CONTROL_H
@@ -0,0 +1,149 @@
+// i2c_bus.h
+//
+// Менеджер шины I2C1: одна точка доступа для всех датчиков на шине
+// (MPU6050, в планах — дальномеры ToF и магнитометр).
+//
+// Устройство описывается I2CDev_t (имя, 7-битный адрес, статистика).
+// Драйвер обращается к шине двумя способами:
+//
+//   I2CBus_Read / I2CBus_Write — блокирующая транзакция «здесь и сейчас»
+//       (инициализация, редкие команды). Выполняется сразу, но тоже
+//       попадает в статистику устройства.
+//
+//   I2CBus_Submit — транзакция в очередь: приоритет, дедлайн (абсолютное
+//       время Time_Us) и обратный вызов по завершении. Очередь разбирает
+//       I2CBus_Poll() из главного цикла / задачи планировщика:
+//           сначала более высокий приоритет (меньшее число),
+//           при равном — более ранний дедлайн (EDF).
+//       Транзакции с I2C_XFER_DROP_LATE, не начатые до дедлайна,
+//       отбрасываются: устаревший отсчёт IMU хуже пропущенного.
+//
+// Шина половинчатая и блокирующая: одна транзакция за вызов Poll, вытеснения
+// нет. Поэтому дедлайн IMU держится, только если длинные чтения других
+// устройств разбиты на куски заметно короче периода IMU. На 100 кГц байт —
+// 9 тактов SCL ≈ 90 мкс: отсчёт IMU (14 байт + адреса) ≈ 1.6 мс, так что
+// реальный предел — около 250 Гц опроса при ~40 % занятости шины.
+//
+// Статистика на устройство: транзакции, байты, ошибки, опоздания,
+// отброшенные, время занятости шины, худшее ожидание в очереди.
+// I2CBus_Report() печатает долю занятости шины каждым устройством
+// (busy_us / окно) и пропускную способность в байт/с.
+//
+// Аппаратная часть вынесена в I2CBusOps_t: на целевой плате —
+// I2CBus_HwOps() (i2c_bus_hw.c, регистры I2C1), на хосте — симулятор
+// устройств. Ядро (i2c_bus.c) к регистрам не обращается.
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdint.h>
+
+#define I2C_BUS_MAX_DEVICES 6U
+#define I2C_BUS_QUEUE_LEN 8U
+
+/* Приоритеты: меньше — важнее */
+typedef enum
+{
+    I2C_PRIO_HIGH = 0, // IMU: период и дедлайн в пределах миллисекунд
+    I2C_PRIO_NORMAL = 1,
+    I2C_PRIO_LOW = 2 // конфигурация, калибровка, телеметрия
+} I2CPrio;
+
+/* Флаги транзакции */
+#define I2C_XFER_WRITE 0x01U     // запись; без флага — чтение
+#define I2C_XFER_DROP_LATE 0x02U // не выполнять, если дедлайн уже прошёл
+
+typedef enum
+{
+    I2C_XFER_IDLE = 0,
+    I2C_XFER_QUEUED,
+    I2C_XFER_DONE,
+    I2C_XFER_ERROR,
+    I2C_XFER_DROPPED
+} I2CXferStatus;
+
+/* ---------------- Аппаратный интерфейс ---------------- */
+
+typedef struct
+{
+    // addr — 7-битный адрес; n ≥ 1. Возврат 1 — успех, 0 — ошибка шины.
+    uint8_t (*read)(uint8_t addr, uint8_t reg, uint8_t *dst, uint32_t n);
+    uint8_t (*write)(uint8_t addr, uint8_t reg, const uint8_t *src, uint32_t n);
+    uint32_t (*now_us)(void);
+} I2CBusOps_t;
+
+/* ---------------- Устройство ---------------- */
+
+typedef struct
+{
+    uint32_t xfers;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t late;    // выполнены, но закончились после дедлайна
+    uint32_t dropped; // отброшены по I2C_XFER_DROP_LATE
+    uint32_t busy_us; // суммарное время на шине
+    uint32_t max_busy_us;
+    uint32_t max_wait_us; // от Submit до начала на шине
+} I2CDevStats_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t addr;       // 7 бит
+    uint8_t registered; // служебное: устройство уже в таблице шины
+    I2CDevStats_t st;
+} I2CDev_t;
+
+#define I2C_DEV_INIT(name, addr) {(name), (addr), 0U, {0}}
+
+/* ---------------- Транзакция в очереди ---------------- */
+
+typedef struct I2CXfer_s I2CXfer_t;
+typedef void (*I2CXferDone)(I2CXfer_t *x);
+
+// Память транзакции принадлежит вызывающему и должна жить до статуса
+// DONE / ERROR / DROPPED. Повторно отправлять можно только после этого.
+struct I2CXfer_s
+{
+    I2CDev_t *dev;
+    uint8_t *buf;
+    uint16_t len;
+    uint8_t reg;
+    uint8_t prio;  // I2CPrio
+    uint8_t flags; // I2C_XFER_*
+    volatile uint8_t status;
+
+    uint32_t deadline_us; // абсолютное время Time_Us()
+    uint32_t submit_us;
+    uint32_t start_us; // момент начала на шине
+    uint32_t end_us;
+
+    I2CXferDone done; // вызывается из I2CBus_Poll(); может быть NULL
+    void *ctx;
+};
+
+/* ---------------- API ---------------- */
+
+// ops: I2CBus_HwOps() на плате, симулятор на хосте. Сбрасывает очередь
+// и статистику. До вызова (или с NULL) все транзакции завершаются ошибкой.
+void I2CBus_Init(const I2CBusOps_t *ops);
+const I2CBusOps_t *I2CBus_HwOps(void);
+
+// Явная регистрация (для отчёта); Read/Write/Submit регистрируют сами.
+uint8_t I2CBus_AddDevice(I2CDev_t *dev);
+
+uint8_t I2CBus_Read(I2CDev_t *dev, uint8_t reg, uint8_t *dst, uint32_t n);
+uint8_t I2CBus_Write(I2CDev_t *dev, uint8_t reg, const uint8_t *src, uint32_t n);
+uint8_t I2CBus_WriteReg(I2CDev_t *dev, uint8_t reg, uint8_t val);
+
+// 0 — очередь полна или транзакция ещё не завершена
+uint8_t I2CBus_Submit(I2CXfer_t *x);
+
+// Выполнить одну транзакцию из очереди. Возврат 1 — что-то сделано.
+uint8_t I2CBus_Poll(void);
+uint32_t I2CBus_Pending(void);
+
+void I2CBus_ResetStats(void);
+void I2CBus_Report(void);
+
+#endif // I2C_BUS_H
@@ -0,0 +1,61 @@
+// idle.h
+//
+// Бестиковый (tickless) простой ядра.
+//
+// Обычный WFI будит ядро каждую миллисекунду прерыванием SysTick.
+// Idle_SleepUntil() на время сна:
+//
+//   1. останавливает SysTick (запомнив фазу текущей миллисекунды);
+//   2. ставит пробуждение на сравнение TIM2 CC1 = дедлайн (мкс);
+//   3. спит в WFI (режим Sleep: TIM1 PWM, TIM2, USART, EXTI работают —
+//      Stop не годится, он останавливает таймеры);
+//   4. после пробуждения по ЛЮБОМУ прерыванию досчитывает g_msTicks
+//      по TIM2 и перезапускает SysTick так, чтобы следующий тик пришёл
+//      ровно на границе миллисекунды — фаза не уплывает.
+//
+// Сон ограничен IDLE_MAX_US (меньше таймаута IWDG, deadline.h):
+// после пробуждения Deadline_Tick() сразу сбрасывает сторожевой таймер.
+//
+// Прерывания (EXTI энкодеров, USART) будят ядро как обычно — задержка
+// реакции на них не меняется, их обработчик запускается сразу после
+// пересчёта g_msTicks.
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+
+/* Короче этого — обычный WFI с SysTick: перенастройка дороже выигрыша */
+#define IDLE_TICKLESS_MIN_US 2000U
+
+/* Максимальная длительность одного сна (≤ DEADLINE_IWDG_MS / 2) */
+#define IDLE_MAX_US 100000U
+
+typedef struct
+{
+    uint32_t sleeps;   // всего засыпаний
+    uint32_t tickless; // из них без SysTick
+    uint64_t slept_us; // суммарное время сна без SysTick
+} IdleStats_t;
+
+/* Разрешить прерывание TIM2 в NVIC (вызывается из Time_Init) */
+void Idle_Init(void);
+
+/* Уснуть до дедлайна (мкс, шкала Time_Us) или до первого прерывания.
+ * Может вернуться раньше — вызывать в цикле (см. Idle_WaitUntil).
+ *
+ * wake — флаг «есть работа» (g_ptPending планировщика) или NULL.
+ * Он проверяется уже при запрещённых прерываниях, непосредственно
+ * перед WFI: флаг, поставленный прерыванием ПОСЛЕ проверки вызывающего,
+ * не проспит до дедлайна — либо виден здесь, либо его прерывание
+ * ожидает и будит WFI сразу.
+ */
+void Idle_SleepUntil(uint32_t deadline_us, volatile const uint8_t *wake);
+
+/* Спать до наступления дедлайна, обслуживая прерывания по пути */
+void Idle_WaitUntil(uint32_t deadline_us);
+
+/* Статистика сна */
+const IdleStats_t *Idle_GetStats(void);
+
+#endif // IDLE_H
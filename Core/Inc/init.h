@@ -2,7 +2,6 @@
 #define INIT_H
 
 #include <stdint.h>
-#include "../../CMSIS/Devices/STM32F4xx/Inc/STM32F429ZI/stm32f429xx.h"
 #include "stm32f4xx.h"
 
 // pb7
@@ -0,0 +1,117 @@
+// isr_latency.h
+//
+// Режим диагностики: задержка входа в прерывание относительно
+// аппаратного события, гистограммы и худшие случаи по каждому IRQ.
+//
+// Источники и опорное время события:
+//
+//   ISRLAT_SYSTICK — перезагрузка SysTick. Счётчик тактирован HCLK и
+//       считает вниз от LOAD, поэтому на входе в обработчик
+//           задержка = LOAD − VAL  (такты с момента перезагрузки).
+//       После бестикового сна (idle.h) первый период укорочен, но LOAD
+//       к перезагрузке уже снова обычный — формула остаётся верной.
+//
+//   ISRLAT_EXTI_ENC — фронт правого энкодера (PA6, EXTI6). Тот же вывод
+//       заводится на захват TIM3_CH1 (AF2, оба фронта, 84 МГц без
+//       делителя): таймер защёлкивает момент фронта, обработчик первым
+//       делом читает CNT, задержка = (CNT − CCR1) × 2 такта.
+//       TIM2 не подходит: его 1 МГц — это 168 тактов на отсчёт,
+//       а канал CC1 занят будильником сна.
+//
+// В обе величины входят несколько тактов от входа до чтения счётчика
+// и 2–3 такта синхронизации входа таймера — это постоянный сдвиг,
+// одинаковый для всех замеров; джиттер он не меняет.
+//
+// Гистограмма: 32 линейные корзины по 4 такта (0..127) и 8 двоичных
+// (128..255, 256..511, … ≥ 16384). IsrLat_Report() печатает
+// min/mean/max, σ, p50/p99, время худшего случая и приоритеты NVIC —
+// по этим данным и расставлять приоритеты.
+//
+// Включается ISR_LAT_ENABLE = 1; иначе макросы пустые и TIM3 не трогается.
+
+#ifndef ISR_LATENCY_H
+#define ISR_LATENCY_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "mem_sections.h"
+
+#ifndef ISR_LAT_ENABLE
+#define ISR_LAT_ENABLE 0
+#endif
+
+#define ISRLAT_CAPTURE_TIM TIM3
+#define ISRLAT_CYC_PER_TICK 2U // HCLK 168 МГц / TIM3 84 МГц
+
+#define ISRLAT_LIN_BINS 32U
+#define ISRLAT_LIN_WIDTH 4U // тактов на линейную корзину
+#define ISRLAT_LOG_BINS 8U
+#define ISRLAT_BINS (ISRLAT_LIN_BINS + ISRLAT_LOG_BINS)
+
+typedef enum
+{
+    ISRLAT_SYSTICK = 0,
+    ISRLAT_EXTI_ENC,
+    ISRLAT_SRC_COUNT
+} IsrLatSrc;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t max_ms;  // g_msTicks худшего случая
+    uint64_t sum;
+    uint64_t sum_sq;  // для σ (джиттер)
+    uint32_t missed;  // захват перезаписан до чтения (CC1OF)
+    uint32_t hist[ISRLAT_BINS];
+} IsrLatStats_t;
+
+/* Обнулить статистику; при ISR_LAT_ENABLE — включить захват TIM3_CH1 на PA6.
+ * Вызывать после Encoder_Init().
+ */
+void IsrLat_Init(void);
+
+/* Учесть один замер (такты) */
+RAMFUNC void IsrLat_Record(IsrLatSrc src, uint32_t cycles);
+
+/* Отметить пропущенный замер */
+void IsrLat_Missed(IsrLatSrc src);
+
+/* Статистика источника */
+const IsrLatStats_t *IsrLat_Get(IsrLatSrc src);
+
+/* Печать таблицы и гистограмм в USART3 */
+void IsrLat_Report(void);
+
+#if ISR_LAT_ENABLE
+
+/* Первой строкой SysTick_Handler */
+#define ISRLAT_SYSTICK_ENTRY() \
+    IsrLat_Record(ISRLAT_SYSTICK, SysTick->LOAD - SysTick->VAL)
+
+/* Первой строкой EXTI9_5_IRQHandler: замер, только если фронт был на PA6 */
+#define ISRLAT_EXTI_ENC_ENTRY()                                                          \
+    do                                                                                   \
+    {                                                                                    \
+        uint16_t isrlat_now = (uint16_t)ISRLAT_CAPTURE_TIM->CNT;                         \
+        uint32_t isrlat_sr = ISRLAT_CAPTURE_TIM->SR;                                     \
+        if (isrlat_sr & TIM_SR_CC1OF)                                                    \
+        {                                                                                \
+            ISRLAT_CAPTURE_TIM->SR = (uint32_t)~TIM_SR_CC1OF; /* rc_w0 */                  \
+            (void)ISRLAT_CAPTURE_TIM->CCR1;                                              \
+            IsrLat_Missed(ISRLAT_EXTI_ENC);                                              \
+        }                                                                                \
+        else if (isrlat_sr & TIM_SR_CC1IF)                                               \
+        {                                                                                \
+            uint16_t isrlat_dt = (uint16_t)(isrlat_now - (uint16_t)ISRLAT_CAPTURE_TIM->CCR1); \
+            IsrLat_Record(ISRLAT_EXTI_ENC, (uint32_t)isrlat_dt * ISRLAT_CYC_PER_TICK);   \
+        }                                                                                \
+    } while (0)
+
+#else
+#define ISRLAT_SYSTICK_ENTRY() ((void)0)
+#define ISRLAT_EXTI_ENC_ENTRY() ((void)0)
+#endif
+
+#endif // ISR_LATENCY_H
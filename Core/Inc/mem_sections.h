@@ -0,0 +1,67 @@
+// mem_sections.h
+//
+// Размещение «горячего» кода и данных в быстрой памяти (профиль
+// производительности, включается define ROBOT_PERF_PROFILE).
+//
+//   RAMFUNC — функция копируется в SRAM (секция .RamFunc) и исполняется
+//             оттуда без wait-state'ов flash. Подходит для ISR и цикла
+//             управления. CCM RAM для кода НЕ годится: она висит только
+//             на D-шине ядра, исполнять из неё нельзя.
+//
+//   CCMRAM  — переменная в CCM RAM (64 КБ, 0 wait-state, не конкурирует
+//             с DMA за шинную матрицу). Только для данных ядра: DMA в CCM
+//             не ходит.
+//
+// Без ROBOT_PERF_PROFILE макросы пустые — всё лежит как раньше.
+//
+// Требования к линкер-скрипту (стандартный скрипт STM32CubeIDE для F429
+// их уже содержит):
+//
+//   .data : { ... *(.RamFunc) *(.RamFunc*) ... } >RAM AT> FLASH
+//
+//   _siccmram = LOADADDR(.ccmram);
+//   .ccmram :
+//   {
+//     . = ALIGN(4);
+//     _sccmram = .;
+//     *(.ccmram)
+//     *(.ccmram*)
+//     . = ALIGN(4);
+//     _eccmram = .;
+//   } >CCMRAM AT> FLASH
+//
+//   /* верх CCM занят самописцем (trace.h): sizeof(TraceBuf_t) =
+//      TRACE_CAPACITY * sizeof(TraceRec_t) + 16 байт заголовка */
+//   ASSERT(_eccmram <= ORIGIN(CCMRAM) + LENGTH(CCMRAM) - (2048 * 12 + 16), "CCM overlaps trace")
+//
+// Линкер заголовков C не видит, поэтому числа в скрипте — копия;
+// trace.c проверяет ту же формулу при компиляции, и при смене
+// TRACE_CAPACITY или TraceRec_t сборка напомнит поправить ASSERT.
+//
+// .RamFunc копирует стартовый код вместе с .data; .ccmram стартовый код
+// не трогает — её заполняет MemSections_Init().
+//
+// Выигрыш профиля меряется только на плате (perf.h): PERF_ENABLE=1,
+// Perf_Report() на одном сценарии без ROBOT_PERF_PROFILE и с ним.
+// На ПК (Tests/) размещение по секциям ничего не меняет; замеров
+// с платы в репозитории пока нет.
+
+#ifndef MEM_SECTIONS_H
+#define MEM_SECTIONS_H
+
+#include <stdint.h>
+
+#ifdef ROBOT_PERF_PROFILE
+#define RAMFUNC __attribute__((section(".RamFunc"), noinline, long_call))
+#define CCMRAM __attribute__((section(".ccmram")))
+#else
+#define RAMFUNC
+#define CCMRAM
+#endif
+
+/* Скопировать начальные значения .ccmram из flash.
+ * Вызывать первой строкой main(), до любого обращения к CCMRAM-переменным.
+ */
+void MemSections_Init(void);
+
+#endif // MEM_SECTIONS_H
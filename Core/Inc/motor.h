@@ -3,21 +3,20 @@
 #define MOTOR_H
 
 #include <stdint.h>
-#include "../../CMSIS/Devices/STM32F4xx/Inc/STM32F429ZI/stm32f429xx.h"
 #include "stm32f4xx.h"
 
 /******************************************************************************
  *                              ОБЩЕЕ ОПИСАНИЕ
  *
- * Модуль motor.c обеспечивает управление двумя моторами постоянного тока
- * через H-мостовой драйвер. Каждый мотор имеет две линии направления (INx)
- * и одну линию PWM (формируется таймером TIM1).
+ * Модуль motor.c управляет N моторами постоянного тока через H-мостовые
+ * драйверы. Каждый мотор описывается строкой таблицы MotorDesc_t
+ * (motor.c, раздел «КОНФИГУРАЦИЯ»):
  *
- * Подключение:
+ *      IN1, IN2  — линии направления (любой порт/пин)
+ *      PWM       — канал CH1..CH4 любого таймера (TIM1/TIM8 — APB2,
+ *                  TIM3/TIM4 — APB1), пин и номер AF
  *
- *                  ┌───────────────────────────────┐
- *                  │             STM32F429ZI        │
- *                  └───────────────────────────────┘
+ * Подключение по умолчанию (2WD):
  *
  *   MOTOR_A:
  *       PWM  → TIM1_CH1 → PE9
@@ -29,45 +28,47 @@
  *       IN3  → PD12
  *       IN4  → PD13
  *
- * IN1/IN2 и IN3/IN4 формируют направление вращения:
+ * С MOTOR_4WD = 1 добавляются MOTOR_C (TIM1_CH3) и MOTOR_D (TIM1_CH4).
  *
- *        dir > 0:   IN1=0 IN2=1  (или аналогично для IN3/IN4)
+ * IN1/IN2 формируют направление вращения:
+ *
+ *        dir > 0:   IN1=0 IN2=1
  *        dir < 0:   IN1=1 IN2=0
- *        dir = 0:   IN1=0 IN2=0  → электротормоз
+ *        dir = 0:   IN1=0 IN2=0  → свободный выбег (coast)
+ *        brake:     IN1=1 IN2=1  → активный тормоз (short-brake), PWM=100%
  *
- * PWM регулирует мощность двигателя через TIM1.
+ * Motor_SetSpeeds() обновляет все моторы за один проход: линии INx
+ * собираются в одно слово BSRR на порт, CCR пишутся подряд. Записей BSRR
+ * столько, сколько портов: 2WD — 2 (GPIOE, GPIOD), 4WD — 3 (ещё GPIOG:
+ * IN7/IN8 мотора D на PG2/PG3). Благодаря preload новые скважности всех
+ * каналов одного таймера вступают в силу одновременно.
  *
  *****************************************************************************/
 
+/* Полный привод: +2 мотора на TIM1 CH3/CH4 */
+#ifndef MOTOR_4WD
+#define MOTOR_4WD 0
+#endif
+
 /******************************************************************************
- *                     НАСТРОЙКИ TIM1 ДЛЯ ГЕНЕРАЦИИ PWM
+ *                     НАСТРОЙКИ ТАЙМЕРОВ ДЛЯ ГЕНЕРАЦИИ PWM
  *
- * Таймер TIM1 работает от частоты APB2 * 2 = 168 МГц.
+ * Таймеры APB2 (TIM1, TIM8) тактируются 168 МГц, APB1 (TIM3, TIM4) — 84 МГц.
  * Мы хотим частоту PWM = 20 кГц (плавное управление + отсутствие писка).
  *
  * Формула:
  *      f_PWM = f_TIM / ((PSC + 1) * (ARR + 1))
  *
- * Подбираем параметры:
- *
- *      f_TIM = 168 МГц
- *      target f_PWM = 20 кГц
- *
- * Требуемое произведение:
- *
- *      (PSC + 1) * (ARR + 1) = 8400
+ * ARR = 99 у всех таймеров (одинаковая шкала скорости 0..99),
+ * PSC считается из частоты таймера:
  *
- * Выбрано:
- *
- *      PSC = 83  → (PSC+1)=84
- *      ARR = 99  → (ARR+1)=100
- *
- * Проверка:
- *      f_PWM = 168 000 000 / (84 * 100) = 20000 Гц = 20 кГц
+ *      TIM1: (PSC+1) = 168 МГц / (20 кГц · 100) = 84  → PSC = 83
+ *      TIM3: (PSC+1) =  84 МГц / (20 кГц · 100) = 42  → PSC = 41
  *
  *****************************************************************************/
 
-#define MOTOR_TIM1_PSC 83U /* Делитель: (PSC+1)=84 */
+#define MOTOR_PWM_FREQ_HZ 20000U
+#define MOTOR_TIM1_PSC 83U /* Делитель TIM1: (PSC+1)=84 */
 #define MOTOR_TIM1_ARR 99U /* Период: (ARR+1)=100 */
 
 /******************************************************************************
@@ -96,20 +97,60 @@
 typedef enum
 {
     MOTOR_A = 0, /* Левый мотор: PWM=PE9, IN1=PE2, IN2=PD11 */
-    MOTOR_B = 1  /* Правый мотор: PWM=PE11, IN3=PD12, IN4=PD13 */
+    MOTOR_B = 1, /* Правый мотор: PWM=PE11, IN3=PD12, IN4=PD13 */
+#if MOTOR_4WD
+    MOTOR_C = 2, /* Левый задний: PWM=PE13, IN5=PD14, IN6=PD15 */
+    MOTOR_D = 3, /* Правый задний: PWM=PE14, IN7=PG2, IN8=PG3 */
+#endif
+    MOTOR_COUNT
 } MotorId;
 
+/******************************************************************************
+ *                        ОПИСАНИЕ МОТОРА (строка таблицы)
+ *****************************************************************************/
+
+typedef struct
+{
+    GPIO_TypeDef *in1_port;
+    uint8_t in1_pin;
+    GPIO_TypeDef *in2_port;
+    uint8_t in2_pin;
+
+    GPIO_TypeDef *pwm_port;
+    uint8_t pwm_pin;
+    uint8_t pwm_af; /* AF1 — TIM1/2, AF2 — TIM3/4/5, AF3 — TIM8 */
+
+    TIM_TypeDef *tim;
+    uint8_t channel; /* 1..4 */
+} MotorDesc_t;
+
+/******************************************************************************
+ *                           РЕЖИМ ОСТАНОВКИ
+ *
+ *  MOTOR_STOP_COAST — INx=0, PWM=0: обмотка отключена, колесо катится
+ *                     по инерции. Путь выбега зависит от скорости.
+ *
+ *  MOTOR_STOP_BRAKE — INx=1, PWM=100%: H-мост замыкает обмотку накоротко,
+ *                     противо-ЭДС тормозит мотор. Останов короткий
+ *                     и предсказуемый.
+ *****************************************************************************/
+
+typedef enum
+{
+    MOTOR_STOP_COAST = 0,
+    MOTOR_STOP_BRAKE = 1
+} MotorStopMode;
+
 /******************************************************************************
  *                          Motor_Init()
  *
- * Делает полную аппаратную инициализацию:
+ * Делает полную аппаратную инициализацию по таблице моторов:
  *
- *   ✔ включает тактирование портов GPIOD, GPIOE и таймера TIM1
- *   ✔ IN1=PE2, IN2=PD11, IN3=PD12, IN4=PD13 → настраиваются как выходы
- *   ✔ PWM-выводы PE9/PE11 → Alternate Function AF1 (TIM1_CH1/CH2)
- *   ✔ TIM1 настраивается в PWM mode 1 на двух каналах
- *   ✔ частота PWM = 20 кГц
- *   ✔ ARPE, preload, MOE включены
+ *   ✔ включает тактирование всех задействованных портов и таймеров
+ *   ✔ IN1/IN2 каждого мотора → выходы push-pull
+ *   ✔ PWM-выводы → Alternate Function (AF из таблицы)
+ *   ✔ каждый таймер — PWM mode 1 на своих каналах, 20 кГц
+ *   ✔ ARPE, preload; у TIM1/TIM8 — OSSI и MOE
  *   ✔ моторы остановлены в конце
  *
  * Вызывать ОДИН раз в начале программы.
@@ -124,7 +165,7 @@ void Motor_Init(void);
  *
  *  Параметры:
  *
- *      id    — какой мотор (MOTOR_A или MOTOR_B)
+ *      id    — какой мотор (MOTOR_A, MOTOR_B, ...)
  *
  *      speed — диапазон:
  *
@@ -153,13 +194,25 @@ void Motor_Init(void);
 
 void Motor_SetSpeed(MotorId id, int16_t speed);
 
+/******************************************************************************
+ *                          Motor_SetSpeeds(speeds)
+ *
+ * Векторная версия: speeds[MOTOR_COUNT], по элементу на мотор.
+ * Линии направления всех моторов пишутся одним BSRR на порт.
+ *
+ *      int16_t s[MOTOR_COUNT] = {60, 60};
+ *      Motor_SetSpeeds(s);
+ *****************************************************************************/
+
+void Motor_SetSpeeds(const int16_t speeds[MOTOR_COUNT]);
+
 /******************************************************************************
  *                               Motor_Stop(id)
  *
  * Полностью останавливает мотор:
  *
  *    - PWM = 0
- *    - INx = 0 (электротормоз)
+ *    - INx = 0 (свободный выбег)
  *
  * Эквивалент:
  *      Motor_SetSpeed(id, 0)
@@ -167,4 +220,30 @@ void Motor_SetSpeed(MotorId id, int16_t speed);
 
 void Motor_Stop(MotorId id);
 
+/******************************************************************************
+ *                    Motor_Brake(id) / Motor_Coast(id)
+ *
+ * Motor_Brake — активный тормоз: IN1=IN2=1, PWM=100% (обмотка закорочена).
+ * Motor_Coast — свободный выбег: IN1=IN2=0, PWM=0 (то же, что Motor_Stop).
+ *
+ * Motor_StopWithMode(id, mode) — выбор одного из двух вариантов.
+ *
+ * Тормоз не стоит держать бесконечно: после остановки колеса лучше
+ * перевести мотор в выбег (Motor_Coast), чтобы снять нагрузку с моста.
+ *****************************************************************************/
+
+void Motor_Brake(MotorId id);
+void Motor_Coast(MotorId id);
+void Motor_StopWithMode(MotorId id, MotorStopMode mode);
+
+/******************************************************************************
+ *                          Motor_EmergencyOff()
+ *
+ * Аварийное отключение ВСЕХ моторов: break TIM1/TIM8 (MOE=0), CCR=0, INx=0.
+ * Выход PWM гаснет сразу, не дожидаясь конца периода. Безопасно вызывать
+ * из прерывания. Снова включить — только Motor_Init().
+ *****************************************************************************/
+
+void Motor_EmergencyOff(void);
+
 #endif /* MOTOR_H */
@@ -0,0 +1,92 @@
+// odom_calib.h
+//
+// Автоматическая калибровка одометрии по гироскопу:
+// масштаб каждого колеса и эффективная колея.
+//
+// Модель ошибок (как в UMBmark): колёса отличаются от среднего на ±e,
+//     sL = s·(1 − e),  sR = s·(1 + e),   b — колея.
+//
+// Для любого заезда с тиками nL, nR (со знаком) и поворотом Δθ по гироскопу
+//     b·Δθ = sR·nR − sL·nL
+// делим на s и обозначаем β = b / s (колея в тиках):
+//     (nL + nR)·e − Δθ·β = nL − nR
+// — одно линейное уравнение на (e, β), средний масштаб s не нужен.
+//
+//   - развороты на месте (nL ≈ −nR) определяют β;
+//   - прямые заезды (nL ≈ nR) — асимметрию e: неравные колёса дают
+//     поворот, который видит гироскоп.
+//
+// Заезды копятся в нормальных уравнениях МНК (2×2), решение — в OdomCal_Solve.
+// Абсолютный масштаб s гироскопом не измерить: он либо остаётся прежним,
+// либо задаётся эталонным прямым заездом известной длины (OdomCal_SetReference).
+//
+// OdomCal_RunGyro() — вся процедура на роботе: развороты в обе стороны
+// и прямые вперёд/назад, по желанию эталонный прямой заезд (длину
+// оператор меряет рулеткой и вводит в USART3), решение, применение и
+// сохранение в backup SRAM. Запускается из main() при ODOM_CAL_ENABLE = 1
+// вместо сценария движения.
+
+#ifndef ODOM_CALIB_H
+#define ODOM_CALIB_H
+
+#include <stdint.h>
+#include "odometry.h"
+
+#ifndef ODOM_CAL_ENABLE
+#define ODOM_CAL_ENABLE 0
+#endif
+
+/* Эталонный заезд в процедуре (0 — без него, масштаб остаётся прежним) */
+#ifndef ODOM_CAL_REFERENCE
+#define ODOM_CAL_REFERENCE 1
+#endif
+
+/* Параметры процедуры */
+#define ODOM_CAL_SPIN_TURNS 2.0f     // оборотов на разворот
+#define ODOM_CAL_SPIN_PWM 70         // PWM разворота
+#define ODOM_CAL_STRAIGHT_MM 1000.0f // длина прямого заезда (по номиналу)
+#define ODOM_CAL_STRAIGHT_PWM 70     // PWM прямого заезда
+#define ODOM_CAL_SETTLE_MS 500U      // досчёт тиков и угла после остановки
+#define ODOM_CAL_GYRO_SIGN (+1)      // −1, если ось Z гироскопа смотрит вниз
+#define ODOM_CAL_REF_WAIT_MS 120000U // ожидание длины эталона от оператора
+
+/* Допустимые результаты */
+#define ODOM_CAL_MAX_ASYM 0.10f // |e| ≤ 10%
+
+typedef struct
+{
+    /* Нормальные уравнения: A = Σ r·rᵀ, y = Σ r·c, r = [nL+nR, −Δθ], c = nL−nR */
+    float a00, a01, a11;
+    float y0, y1;
+    uint16_t runs;
+
+    /* Эталонный заезд для абсолютного масштаба (ref_mm = 0 — нет) */
+    int32_t ref_nL, ref_nR;
+    float ref_mm;
+} OdomCal_t;
+
+/* Начать накопление */
+void OdomCal_Begin(OdomCal_t *c);
+
+/* Добавить заезд: тики со знаком и поворот по гироскопу (рад, + против часовой) */
+void OdomCal_AddRun(OdomCal_t *c, int32_t nL, int32_t nR, float dtheta_rad);
+
+/* Эталонный прямой заезд: тики и измеренная рулеткой длина, мм */
+void OdomCal_SetReference(OdomCal_t *c, int32_t nL, int32_t nR, float distance_mm);
+
+/* Решить. mean_mm_per_tick — средний масштаб, если эталона нет.
+ * @return 1 — решение в допустимых пределах, записано в out
+ */
+uint8_t OdomCal_Solve(const OdomCal_t *c, float mean_mm_per_tick, OdomCalib_t *out);
+
+/* Полная процедура на роботе (моторы, энкодеры, MPU6050 должны быть
+ * инициализированы, робот — на ровном полу с запасом места ~1.2 м).
+ * with_reference — после основных заездов ещё один прямой на
+ * ODOM_CAL_STRAIGHT_MM по номиналу; робот останавливается и ждёт строку
+ * с пройденной длиной в мм (рулеткой по пятну контакта). Пустая строка
+ * или ODOM_CAL_REF_WAIT_MS без ввода — эталон пропускается.
+ * @return 1 — калибровка применена и сохранена
+ */
+uint8_t OdomCal_RunGyro(uint8_t with_reference);
+
+#endif // ODOM_CALIB_H
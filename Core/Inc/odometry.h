@@ -0,0 +1,70 @@
+// odometry.h
+//
+// Одометрия дифференциального привода: поза (x, y, θ) по тикам энкодеров.
+//
+// Калибровка (OdomCalib_t) — свой масштаб мм/тик для каждого колеса
+// и эффективная колея. Хранится в backup SRAM (persist.h,
+// PERSIST_SLOT_ODOM); без сохранённой калибровки берутся номинальные
+// значения с прежней поправкой 0.95. Получается процедурой odom_calib.h.
+//
+// Энкодеры одноканальные — знак тиков задаёт вызывающий по команде
+// мотору (dirL / dirR), как и в регуляторе скорости.
+//
+// Шаг интегрирования (середина дуги):
+//     dL = sL·nL,  dR = sR·nR
+//     ds = (dL + dR) / 2,   dθ = (dR − dL) / b
+//     x += ds·cos(θ + dθ/2),  y += ds·sin(θ + dθ/2),  θ += dθ
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include <stdint.h>
+
+/* Номинальные значения до калибровки */
+#define ODOM_SCALE_DEFAULT 0.95f    // прежняя ручная поправка ENC_MM_PER_TICK
+#define ODOM_TRACK_MM_DEFAULT 150.0f // расстояние между пятнами контакта колёс
+
+#define ODOM_CALIB_VERSION 1U
+
+typedef struct
+{
+    float x_mm;
+    float y_mm;
+    float theta_rad; // −π..π, 0 — вдоль оси X, против часовой — положительно
+} Pose_t;
+
+typedef struct
+{
+    float mm_per_tick_left;
+    float mm_per_tick_right;
+    float track_mm;
+} OdomCalib_t;
+
+/* Загрузить калибровку (или умолчания), обнулить позу, взять курсор энкодеров.
+ * Вызывать после Encoder_Init() и Persist_Init().
+ * @return 1 — калибровка восстановлена из backup SRAM
+ */
+uint8_t Odom_Init(void);
+
+/* Поставить позу (например, после навигации по известной точке) */
+void Odom_SetPose(const Pose_t *p);
+
+/* Текущая поза */
+void Odom_GetPose(Pose_t *p);
+
+/* Забрать новые тики энкодеров; dirL/dirR — знак команды колёсам (+1/−1) */
+void Odom_Update(int8_t dirL, int8_t dirR);
+
+/* Шаг по уже знаковым тикам (для внешних источников и моделирования) */
+void Odom_Integrate(int32_t nL, int32_t nR);
+
+/* Пересчёт тиков в мм по калибровке колеса */
+float Odom_LeftMM(int32_t ticks);
+float Odom_RightMM(int32_t ticks);
+
+/* Калибровка: чтение / применение / сохранение в backup SRAM */
+const OdomCalib_t *Odom_GetCalib(void);
+void Odom_SetCalib(const OdomCalib_t *c);
+uint8_t Odom_SaveCalib(void);
+
+#endif // ODOMETRY_H
@@ -0,0 +1,127 @@
+// path_follow.h
+//
+// Следование по пути из точек: вместо «стоп — поворот — прямой отрезок»
+// робот едет по ломаной или сплайну непрерывно, с поворотом на ходу.
+//
+// Путь — до PATH_MAX_POINTS точек в фиксированном буфере, мм:
+//   Path_Add        — точка ломаной;
+//   Path_AddSpline  — контрольные точки Catmull-Rom, в буфер ложатся
+//                     отсчёты кривой (steps на участок).
+// Координаты пути — в системе робота на момент PathFollow_Start
+// (x — вперёд, y — влево), если не задан другой origin.
+//
+// Регулятор (шаг с периодом регулятора скорости, поза от одометрии):
+//
+//   проекция   — ближайшая точка пути ищется только вперёд от текущего
+//                участка, в окне PATH_SEARCH_SEGS: O(1) на шаг, путь
+//                с самопересечением не «перескакивает»;
+//   pure pursuit — цель на пути на дуге L = L0 + k·v впереди проекции,
+//                в системе робота (xl, yl): κ = 2·yl / (xl² + yl²), ω = v·κ;
+//   Stanley    — δ = (ψ_пути(s + k·v) − θ) + atan2(−k_e·e, v + v_soft),
+//                ω = k_h·δ; e — боковое отклонение (+ влево от пути).
+//
+// Скорость вдоль пути: профиль строится при старте — предел по боковому
+// ускорению на изломах (v ≤ √(a_lat/κ)) и обратный проход с торможением
+// к концу пути; разгон ограничен accel. Выход — (v, ω) для
+// SpeedControl_SetTwist (насыщение колёс сохраняет кривизну).
+//
+// Загрузка с хоста — кадры телеуправления $P / $F (teleop.h).
+
+#ifndef PATH_FOLLOW_H
+#define PATH_FOLLOW_H
+
+#include <stdint.h>
+#include "odometry.h"
+
+#define PATH_MAX_POINTS 64U
+#define PATH_SEARCH_SEGS 8U    // окно поиска проекции, участков вперёд
+#define PATH_MIN_SEG_MM 1.0f   // более короткие участки склеиваются
+
+typedef struct
+{
+    float x_mm;
+    float y_mm;
+} PathPoint_t;
+
+typedef enum
+{
+    PATH_PURE_PURSUIT = 0,
+    PATH_STANLEY = 1
+} PathMode;
+
+typedef enum
+{
+    PATH_IDLE = 0,
+    PATH_RUNNING,
+    PATH_DONE
+} PathStatus;
+
+typedef struct
+{
+    uint8_t mode; // PathMode
+
+    float v_max_mm_s;
+    float v_min_mm_s;     // ползком у конца, пока не в goal_tol
+    float accel_mm_s2;    // разгон и торможение по профилю
+    float a_lat_mm_s2;    // предел бокового ускорения v²·κ
+    float goal_tol_mm;
+
+    // упреждение: L = look_min + look_gain·v, не больше look_max
+    float look_min_mm;
+    float look_gain_s;
+    float look_max_mm;
+
+    // Stanley
+    float stanley_k;      // 1/с: atan(k·e / v)
+    float stanley_kh;     // 1/с: ω = kh·δ
+    float stanley_v_soft; // мм/с: не даёт atan разгоняться на малой скорости
+} PathFollowCfg_t;
+
+typedef struct
+{
+    uint32_t steps;
+    float time_s;
+    float length_mm;   // длина пути
+    float max_err_mm;  // наибольшее |e|
+    float rms_err_mm;
+    float end_err_mm;  // расстояние до последней точки на финише
+} PathFollowStats_t;
+
+/* Значения по умолчанию (pure pursuit, 300 мм/с) */
+void PathFollow_DefaultCfg(PathFollowCfg_t *cfg);
+
+/* ---------------- Путь ---------------- */
+
+void Path_Clear(void);
+
+/* @return 0 — буфер полон */
+uint8_t Path_Add(float x_mm, float y_mm);
+
+/* Catmull-Rom через ctrl[0..n-1], steps отсчётов на участок (≥ 1).
+ * Кривая проходит через все контрольные точки.
+ * @return 0 — не влезло (добавлено сколько поместилось)
+ */
+uint8_t Path_AddSpline(const PathPoint_t *ctrl, uint32_t n, uint32_t steps);
+
+uint32_t Path_Count(void);
+
+/* ---------------- Следование ---------------- */
+
+/* Начать с начала пути. origin — поза, в системе которой заданы точки
+ * (обычно текущая); NULL — точки в системе одометрии.
+ * @return 0 — меньше двух точек
+ */
+uint8_t PathFollow_Start(const PathFollowCfg_t *cfg, const Pose_t *origin);
+
+/* Шаг регулятора: поза одометрии → скорость корпуса (мм/с, рад/с).
+ * На PATH_DONE / PATH_IDLE выход нулевой.
+ */
+PathStatus PathFollow_Step(const Pose_t *pose, float dt, float *v_mm_s, float *w_rad_s);
+
+void PathFollow_Stop(void);
+PathStatus PathFollow_Status(void);
+
+void PathFollow_GetStats(PathFollowStats_t *out);
+void PathFollow_Report(void);
+
+#endif // PATH_FOLLOW_H
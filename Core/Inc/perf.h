@@ -0,0 +1,62 @@
+// perf.h
+//
+// Замер «горячих» участков кода счётчиком тактов DWT->CYCCNT.
+//
+// Использование:
+//     PERF_BEGIN(PERF_SPEED_UPDATE);
+//     ... код ...
+//     PERF_END(PERF_SPEED_UPDATE);
+//
+//     Perf_Report();   // таблица min/avg/max в тактах и нс в USART3
+//
+// Сравнение «до/после»: собрать прошивку с PERF_ENABLE=1 без
+// ROBOT_PERF_PROFILE и с ним, снять Perf_Report() на одном сценарии.
+//
+// При PERF_ENABLE = 0 макросы пустые и ничего не стоят.
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#ifndef PERF_ENABLE
+#define PERF_ENABLE 0
+#endif
+
+typedef enum
+{
+    PERF_EXTI_ENC = 0,  // EXTI9_5_IRQHandler (энкодеры)
+    PERF_SPEED_UPDATE,  // SpeedControl_Update целиком
+    PERF_PID_UPDATE,    // ПИД обоих колёс за один SpeedControl_Update
+    PERF_IMU_READ,      // MPU6050_ReadRaw
+    PERF_SLOT_COUNT
+} PerfSlot;
+
+typedef struct
+{
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    uint32_t count;
+    uint64_t sum;
+} PerfStat_t;
+
+/* Включить DWT->CYCCNT и обнулить статистику */
+void Perf_Init(void);
+
+/* Учесть один замер (такты) */
+void Perf_Add(PerfSlot slot, uint32_t cycles);
+
+/* Печать таблицы в USART3 */
+void Perf_Report(void);
+
+#if PERF_ENABLE
+#define PERF_BEGIN(slot) uint32_t perf_t0_##slot = DWT->CYCCNT
+#define PERF_END(slot) Perf_Add((slot), DWT->CYCCNT - perf_t0_##slot)
+#else
+#define PERF_BEGIN(slot) ((void)0)
+#define PERF_END(slot) ((void)0)
+#endif
+
+#endif // PERF_H
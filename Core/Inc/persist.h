@@ -0,0 +1,67 @@
+// persist.h
+//
+// Энергонезависимые параметры в backup SRAM (BKPSRAM, 4 КБ @ 0x40024000).
+//
+// Backup SRAM сохраняет содержимое при любом сбросе (NVIC_SystemReset, IWDG,
+// кнопка RESET), а при наличии батарейки на VBAT — и при выключении питания.
+// Без VBAT данные теряются при снятии питания: Persist_Load() вернёт 0 и
+// модуль-владелец должен начать с умолчаний.
+//
+// Память поделена на фиксированные слоты (PersistSlot). Каждый слот:
+//   PersistHdr_t { magic, version, len, crc } + данные (до PERSIST_SLOT_DATA байт)
+//   crc — CRC-32 (аппаратный блок CRC, полином 0x04C11DB7) по данным.
+//
+// Запись не атомарна: если питание пропадёт посреди Persist_Save(),
+// CRC не сойдётся и слот будет считаться пустым.
+
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#define PERSIST_MAGIC 0x50525331UL // "PRS1"
+
+#define PERSIST_SLOT_SIZE 512U
+#define PERSIST_SLOT_DATA (PERSIST_SLOT_SIZE - sizeof(PersistHdr_t))
+
+typedef enum
+{
+    PERSIST_SLOT_GYRO_TC = 0, // таблица смещения гироскопа от температуры
+    PERSIST_SLOT_ODOM = 1,    // калибровка одометрии
+    PERSIST_SLOT_COUNT = 8    // 8 × 512 = 4 КБ
+} PersistSlot;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version; // версия формата данных владельца слота
+    uint16_t len;     // длина данных в байтах
+    uint32_t crc;
+} PersistHdr_t;
+
+/**
+ * @brief Включить тактирование backup SRAM, доступ на запись и
+ *        backup-регулятор (чтобы содержимое держалось от VBAT)
+ */
+void Persist_Init(void);
+
+/**
+ * @brief Прочитать слот
+ * @param version ожидаемая версия формата (другая версия → слот пустой)
+ * @return 1 — данные скопированы в dst, 0 — слот пуст/повреждён
+ */
+uint8_t Persist_Load(PersistSlot slot, uint16_t version, void *dst, uint16_t len);
+
+/**
+ * @brief Записать слот (заголовок пишется последним)
+ * @return 1 — успех, 0 — неверный слот или длина
+ */
+uint8_t Persist_Save(PersistSlot slot, uint16_t version, const void *src, uint16_t len);
+
+/**
+ * @brief Пометить слот пустым
+ */
+void Persist_Erase(PersistSlot slot);
+
+#endif // PERSIST_H
@@ -16,6 +16,9 @@ typedef struct
 } PID_t;
 
 void PID_Init(PID_t *pid, float kp, float ki, float kd, float outMin, float outMax);
+
+// Сброс внутреннего состояния (интегратор, прошлая ошибка) без смены коэффициентов
+void PID_Reset(PID_t *pid);
 float PID_Update(PID_t *pid, float setpoint, float measurement, float dt);
 
 #endif // PID_H
@@ -0,0 +1,245 @@
+// pt.h
+//
+// Протопотоки (protothreads) — бесстековые кооперативные задачи на макросах.
+//
+// Вся логика сейчас линейная и блокирующая: MoveForwardMM() крутится
+// в цикле, пока не доедет. Протопоток — это обычная функция, которая
+// при ожидании ВОЗВРАЩАЕТСЯ, запомнив строку (Pt_t.lc), а при следующем
+// вызове прыгает туда через switch. Стек не нужен, памяти — 12 байт
+// на задачу, ничего не выделяется. Переключение — возврат из функции
+// плюс вызов и прыжок по таблице switch: десятки тактов.
+//
+//     static PT_THREAD(blink(Pt_t *pt, void *arg))
+//     {
+//         PT_BEGIN(pt);
+//         while (1)
+//         {
+//             LED_Toggle();
+//             PT_SLEEP_MS(pt, 500);
+//         }
+//         PT_END(pt);
+//     }
+//
+//     static PT_THREAD(report(Pt_t *pt, void *arg))
+//     {
+//         PT_BEGIN(pt);
+//         while (1)
+//         {
+//             PT_AWAIT_EVENT(pt, &g_dataReady);   // PtEvent_Signal() в другой задаче
+//             USART_Println("data");
+//         }
+//         PT_END(pt);
+//     }
+//
+//     static PtTask_t tasks[] = {
+//         PT_TASK(blink, NULL, "blink"),
+//         PT_TASK(report, NULL, "report"),
+//     };
+//     PtSched_Run(tasks, 2);   // pt_sched: круговой опрос + бестиковый сон
+//
+// ОГРАНИЧЕНИЯ (цена отсутствия стека):
+//   - локальные переменные НЕ сохраняются между ожиданиями — состояние
+//     держать в static или в структуре, переданной через arg;
+//   - внутри протопотока нельзя писать свой switch, охватывающий
+//     ожидание (макросы сами стоят в switch по lc);
+//   - не больше одного ожидания на строку исходника (метка — __LINE__);
+//   - ждать можно только на верхнем уровне функции; вложенную логику
+//     оформлять дочерним протопотоком (PT_SPAWN);
+//   - блокирующие вызовы (DriveDistanceMM, Time_DelayMs) останавливают
+//     всех — внутри задач использовать PT_SLEEP_* и PT_WAIT_UNTIL.
+
+#ifndef PT_H
+#define PT_H
+
+#include <stdint.h>
+#include "timebase.h"
+
+typedef struct
+{
+    uint16_t lc;      // строка продолжения (0 — с начала)
+    uint8_t timed;    // ждёт времени: wake_us действителен
+    uint8_t reserved;
+    uint32_t wake_us; // дедлайн ожидания по времени (шкала Time_Us)
+    uint32_t mark;    // снимок счётчика события
+} Pt_t;
+
+typedef enum
+{
+    PT_WAITING = 0, // ждёт условия
+    PT_YIELDED = 1, // уступил, готов работать дальше
+    PT_EXITED = 2,  // PT_EXIT
+    PT_ENDED = 3    // дошёл до PT_END
+} PtStatus;
+
+/* Что-то изменилось (событие, флаг) — планировщику не спать.
+ * Ставится PtEvent_Signal() и PT_KICK() из прерываний.
+ */
+extern volatile uint8_t g_ptPending;
+
+#define PT_KICK() (g_ptPending = 1U)
+
+/* --------------------------------------------------------------------------
+ * Базовые макросы
+ * -------------------------------------------------------------------------- */
+
+/* Проход в метку продолжения — намеренный (-Wimplicit-fallthrough) */
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define PT_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define PT_FALLTHROUGH ((void)0)
+#endif
+
+#define PT_THREAD(name_args) PtStatus name_args
+
+#define PT_INIT(pt)        \
+    do                     \
+    {                      \
+        (pt)->lc = 0U;     \
+        (pt)->timed = 0U;  \
+    } while (0)
+
+#define PT_BEGIN(pt)        \
+    switch ((pt)->lc)       \
+    {                       \
+    case 0:
+
+#define PT_END(pt)          \
+    }                       \
+    PT_INIT(pt);            \
+    return PT_ENDED
+
+/* Ждать, пока cond не станет истинным (проверяется при каждом вызове) */
+#define PT_WAIT_UNTIL(pt, cond)         \
+    do                                  \
+    {                                   \
+        (pt)->lc = (uint16_t)__LINE__;  \
+        PT_FALLTHROUGH;                 \
+    case __LINE__:                      \
+        if (!(cond))                    \
+            return PT_WAITING;          \
+    } while (0)
+
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL(pt, !(cond))
+
+/* Уступить другим задачам один раз */
+#define PT_YIELD(pt)                    \
+    do                                  \
+    {                                   \
+        (pt)->lc = (uint16_t)__LINE__;  \
+        return PT_YIELDED;              \
+    case __LINE__:;                     \
+    } while (0)
+
+/* Завершить задачу / начать её заново */
+#define PT_EXIT(pt)      \
+    do                   \
+    {                    \
+        PT_INIT(pt);     \
+        return PT_EXITED; \
+    } while (0)
+
+#define PT_RESTART(pt)    \
+    do                    \
+    {                     \
+        PT_INIT(pt);      \
+        return PT_YIELDED; \
+    } while (0)
+
+/* Запустить дочерний протопоток и ждать его завершения:
+ *     PT_SPAWN(pt, &child, calibrate(&child, arg));
+ * Дедлайн сна дочернего поднимается в родителя — планировщик его видит.
+ */
+static inline uint8_t Pt_ChildDone(Pt_t *pt, const Pt_t *child, PtStatus r)
+{
+    pt->timed = child->timed;
+    pt->wake_us = child->wake_us;
+    return (r >= PT_EXITED) ? 1U : 0U;
+}
+
+#define PT_SPAWN(pt, child, thread)                                \
+    do                                                             \
+    {                                                              \
+        PT_INIT(child);                                            \
+        PT_WAIT_UNTIL(pt, Pt_ChildDone((pt), (child), (thread)));  \
+        (pt)->timed = 0U;                                          \
+    } while (0)
+
+/* --------------------------------------------------------------------------
+ * Ожидание времени
+ * -------------------------------------------------------------------------- */
+
+/* До абсолютного дедлайна (мкс, шкала Time_Us) — для ровного периода:
+ *     s->next += 20000; PT_SLEEP_UNTIL(pt, s->next);
+ */
+#define PT_SLEEP_UNTIL(pt, deadline_us)                      \
+    do                                                       \
+    {                                                        \
+        (pt)->wake_us = (deadline_us);                       \
+        (pt)->timed = 1U;                                    \
+        PT_WAIT_UNTIL(pt, Time_Reached((pt)->wake_us));      \
+        (pt)->timed = 0U;                                    \
+    } while (0)
+
+#define PT_SLEEP_US(pt, us) PT_SLEEP_UNTIL(pt, Time_DeadlineUs(us))
+#define PT_SLEEP_MS(pt, ms) PT_SLEEP_US(pt, (uint32_t)(ms) * 1000U)
+
+/* Ждать cond, но не дольше timeout_us. После выхода проверить cond:
+ *     PT_WAIT_UNTIL_TIMEOUT(pt, s->ready, 5000);
+ *     if (!s->ready) ...   // таймаут
+ */
+#define PT_WAIT_UNTIL_TIMEOUT(pt, cond, timeout_us)                      \
+    do                                                                   \
+    {                                                                    \
+        (pt)->wake_us = Time_DeadlineUs(timeout_us);                     \
+        (pt)->timed = 1U;                                                \
+        PT_WAIT_UNTIL(pt, (cond) || Time_Reached((pt)->wake_us));        \
+        (pt)->timed = 0U;                                                \
+    } while (0)
+
+/* --------------------------------------------------------------------------
+ * События
+ *
+ * Событие — счётчик сигналов. Ожидание запоминает счётчик и ждёт, пока
+ * он изменится: сигналы ДО начала ожидания не считаются, несколько
+ * сигналов за время ожидания сливаются в один.
+ *
+ * Сигналить из одного контекста (одна задача ИЛИ одно прерывание):
+ * seq++ не атомарен относительно второго писателя.
+ * -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    volatile uint32_t seq;
+} PtEvent_t;
+
+#define PT_EVENT_INIT {0U}
+
+static inline void PtEvent_Signal(PtEvent_t *e)
+{
+    e->seq++;
+    PT_KICK();
+}
+
+#define PT_AWAIT_EVENT(pt, ev)                         \
+    do                                                 \
+    {                                                  \
+        (pt)->mark = (ev)->seq;                        \
+        PT_WAIT_UNTIL(pt, (ev)->seq != (pt)->mark);    \
+    } while (0)
+
+/* --------------------------------------------------------------------------
+ * Флаг из прерывания
+ *
+ * volatile uint8_t, который ISR ставит в 1 (и зовёт PT_KICK()), а задача
+ * после пробуждения сбрасывает. Повторная установка до сброса сливается
+ * с первой — для счёта событий брать PtEvent_t.
+ * -------------------------------------------------------------------------- */
+
+#define PT_AWAIT_FLAG(pt, flag)          \
+    do                                   \
+    {                                    \
+        PT_WAIT_UNTIL(pt, (flag) != 0U); \
+        (flag) = 0U;                     \
+    } while (0)
+
+#endif // PT_H
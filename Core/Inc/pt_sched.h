@@ -0,0 +1,52 @@
+// pt_sched.h
+//
+// Круговой планировщик протопотоков (pt.h) без выделения памяти:
+// задачи — статический массив PtTask_t.
+//
+// Проход: каждая живая задача вызывается по разу. Если за проход никто
+// не продвинулся (все вернули PT_WAITING на той же строке) и не было
+// PT_KICK(), ядро спит через Idle_SleepUntil() до ближайшего дедлайна
+// PT_SLEEP_* — любое прерывание будит раньше и проход повторяется.
+//
+// Поэтому условия PT_WAIT_UNTIL должны меняться либо в прерываниях,
+// либо в других задачах; опрос «медленной» периферии без прерывания
+// оформлять через PT_SLEEP_* с периодом.
+
+#ifndef PT_SCHED_H
+#define PT_SCHED_H
+
+#include <stdint.h>
+#include "pt.h"
+
+typedef PtStatus (*PtFunc)(Pt_t *pt, void *arg);
+
+typedef struct
+{
+    Pt_t pt;
+    PtFunc fn;
+    void *arg;
+    const char *name;
+    uint8_t done;
+} PtTask_t;
+
+#define PT_TASK(fn, arg, name) {{0U, 0U, 0U, 0U, 0U}, (fn), (arg), (name), 0U}
+
+typedef struct
+{
+    uint32_t passes;   // проходов по списку
+    uint32_t switches; // вызовов задач
+    uint32_t sleeps;   // засыпаний без работы
+} PtSchedStats_t;
+
+/* Один проход по задачам без сна.
+ * @return число ещё живых задач
+ */
+uint32_t PtSched_Step(PtTask_t *tasks, uint32_t n);
+
+/* Крутить, пока все задачи не завершатся (в прошивке — обычно вечно) */
+void PtSched_Run(PtTask_t *tasks, uint32_t n);
+
+/* Статистика планировщика */
+const PtSchedStats_t *PtSched_GetStats(void);
+
+#endif // PT_SCHED_H
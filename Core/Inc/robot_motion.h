@@ -2,14 +2,53 @@
 #define ROBOT_MOTION_H
 
 #include "stm32f4xx.h"
+#include "motor.h"
+
+/* Какой знак ШИМа означает "ФИЗИЧЕСКИ вперёд".
+ * Если сейчас MoveForwardMM едет назад — просто поменяй +1 на -1.
+ */
+#ifndef MOTOR_FORWARD_SIGN
+#define MOTOR_FORWARD_SIGN (+1) // при необходимости поменяешь на (-1)
+#endif
+
+/* Опрашивать акселерометр в цикле DriveDistanceMM для детектора удара.
+ * Нужен инициализированный MPU6050 на I2C1 — его поднимает main.c и
+ * сообщает результат через Motion_SetImu(); не ответил — опроса нет,
+ * остаётся детектор заклинивания по энкодерам.
+ */
+#ifndef MOTION_USE_IMU
+#define MOTION_USE_IMU 1
+#endif
+
+/* Результат поездки */
+typedef enum
+{
+    MOTION_OK = 0,           // доехали, штатная остановка
+    MOTION_ABORT_STALL = 1,  // колесо заклинило (stall_detect.h)
+    MOTION_ABORT_IMPACT = 2  // удар по акселерометру
+} MotionResult;
 
 /* Едем distance_mm мм с заданным PWM (по модулю),
  * знак направления будет задаваться через MoveForward/MoveBackward.
+ * При заклинивании или ударе моторы отключаются детектором сразу,
+ * поездка прерывается с соответствующим MotionResult.
+ */
+MotionResult DriveDistanceMM(float distance_mm, int16_t speed);
+
+/* Режим остановки в конце DriveDistanceMM:
+ *   MOTOR_STOP_BRAKE (по умолчанию) — планировщик по скорости энкодеров
+ *                                     включает активный тормоз заранее;
+ *   MOTOR_STOP_COAST                — выбег (старое поведение).
+ */
+void Motion_SetStopMode(MotorStopMode mode);
+
+/* Есть ли MPU6050 для детектора удара (по умолчанию нет; без
+ * MOTION_USE_IMU ни на что не влияет)
  */
-void DriveDistanceMM(float distance_mm, int16_t speed);
+void Motion_SetImu(uint8_t present);
 
 /* Удобные обёртки */
-void MoveForwardMM(float distance_mm, int16_t pwm);
-void MoveBackwardMM(float distance_mm, int16_t pwm);
+MotionResult MoveForwardMM(float distance_mm, int16_t pwm);
+MotionResult MoveBackwardMM(float distance_mm, int16_t pwm);
 
 #endif // ROBOT_MOTION_H
@@ -0,0 +1,126 @@
+// sensor_log.h
+//
+// Запись «сырых» входов регуляторов для детерминированного воспроизведения.
+//
+// Логируются ровно те значения, которые видят модули управления на своей
+// границе — чтобы при прогоне через тот же код на ПК результат совпал бит
+// в бит:
+//   - SLOG_CTRL   : dt (float как есть) + приращения тиков L/R, которые
+//                   получил SpeedControl_Update
+//   - SLOG_PWM    : что регулятор отдал на моторы (для сверки)
+//   - SLOG_CMD    : SpeedControl_SetTarget (цели и направления)
+//   - SLOG_IMU    : 7 сырых слов MPU6050_ReadRaw (accel, temp, gyro)
+//
+// Формат потока (little endian), запись = кадр:
+//
+//   0xA5 0x5A | SensorLogHdr_t (8 байт) | payload (len байт) | sum8
+//
+//   sum8 — сумма всех байт заголовка и payload по модулю 256.
+//   Синхрослово позволяет декодеру подхватить поток с любого места.
+//
+// Кадры копятся в кольце SRAM и уходят по своему каналу — USART6 TX
+// (PC6, SLOG_BAUD) через DMA2 Stream6: USART3 остаётся текстовой отладке
+// и телеуправлению, текст и бинарные кадры не перемешиваются.
+// SensorLog_Flush() из основного цикла запускает DMA на непрерывный кусок
+// кольца, дальше цепочку продолжает прерывание завершения DMA. При
+// переполнении кольца новые кадры отбрасываются и считаются
+// в SensorLog_Dropped() — seq в заголовке покажет дыру.
+//
+// SpeedControl_Stop пишет SLOG_CMD с dirL = dirR = 0 (цели ноль, сброс
+// ПИД) — воспроизведение повторяет и его. Лог воспроизводится от
+// состояния SpeedControl_Init; срабатывание детектора заклинивания
+// (кадр SLOG_CTRL без SLOG_PWM) не воспроизводится — состояние
+// детектора не пишется.
+//
+// Декодер: Tools/slog_decode.py (потоковый, mmap — логи любой длины).
+// Воспроизведение на ПК: Tests/slog_replay.c (make -C Tests).
+// Бит в бит — при одинаковой арифметике: прошивка и хостовая сборка
+// без слияния умножения со сложением (-ffp-contract=off).
+//
+// По умолчанию выключено (SENSOR_LOG_ENABLE = 0), USART6 не настраивается.
+
+#ifndef SENSOR_LOG_H
+#define SENSOR_LOG_H
+
+#include <stdint.h>
+
+#ifndef SENSOR_LOG_ENABLE
+#define SENSOR_LOG_ENABLE 0
+#endif
+
+/* Размер кольца (степень двойки) */
+#define SLOG_RING_SIZE 4096U
+
+/* Канал лога: USART6 (APB2, 84 МГц), только TX на PC6 (AF8) */
+#define SLOG_BAUD 921600U      // 84 МГц / 91 = 923 кбод, ошибка 0.2%
+#define SLOG_PCLK2_HZ 84000000UL
+#define SLOG_DMA_IRQ_PRIO 8U   // ниже приёма USART3 (7)
+
+#define SLOG_SYNC0 0xA5U
+#define SLOG_SYNC1 0x5AU
+
+typedef enum
+{
+    SLOG_CTRL = 1, // SlogCtrl_t
+    SLOG_PWM = 2,  // SlogPwm_t
+    SLOG_CMD = 3,  // SlogCmd_t
+    SLOG_IMU = 4   // SlogImu_t
+} SensorLogType;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t t_us; // Time_Us() в момент записи
+    uint8_t type;  // SensorLogType
+    uint8_t len;   // длина payload
+    uint16_t seq;  // номер кадра (по модулю 2^16)
+} SensorLogHdr_t;
+
+typedef struct __attribute__((packed))
+{
+    float dt_sec;
+    uint32_t ticksL;
+    uint32_t ticksR;
+} SlogCtrl_t;
+
+typedef struct __attribute__((packed))
+{
+    int16_t pwmL;
+    int16_t pwmR;
+} SlogPwm_t;
+
+typedef struct __attribute__((packed))
+{
+    float left_rps;
+    float right_rps;
+    int8_t dirL;
+    int8_t dirR;
+} SlogCmd_t;
+
+typedef struct __attribute__((packed))
+{
+    int16_t accel[3];
+    int16_t temp;
+    int16_t gyro[3];
+} SlogImu_t;
+
+/* Сброс кольца и счётчиков; при SENSOR_LOG_ENABLE — настройка USART6 и DMA
+ * (идущая передача останавливается)
+ */
+void SensorLog_Init(void);
+
+/* Добавить кадр. Вызывать из основного контекста (не из ISR). */
+void SensorLog_Write(uint8_t type, const void *payload, uint8_t len);
+
+/* Запустить передачу накопленного, если DMA простаивает. Не ждёт. */
+void SensorLog_Flush(void);
+
+/* Сколько кадров потеряно из-за переполнения кольца */
+uint32_t SensorLog_Dropped(void);
+
+#if SENSOR_LOG_ENABLE
+#define SLOG(type, ptr) SensorLog_Write((uint8_t)(type), (ptr), (uint8_t)sizeof(*(ptr)))
+#else
+#define SLOG(type, ptr) ((void)0)
+#endif
+
+#endif // SENSOR_LOG_H
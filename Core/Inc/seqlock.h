@@ -0,0 +1,99 @@
+// seqlock.h
+//
+// Seqlock — согласованный снимок данных, которые пишет прерывание,
+// без запрета прерываний у читателя.
+//
+// Писатель (ISR):
+//     SeqLock_WriteBegin(&lock);   // seq становится нечётным
+//     data.a++; data.b = x;
+//     SeqLock_WriteEnd(&lock);     // seq снова чётный
+//
+// Читатель (main или ISR ниже приоритетом, чем писатель):
+//     uint32_t s;
+//     do {
+//         s = SeqLock_ReadBegin(&lock);
+//         copy = data;
+//     } while (SeqLock_ReadRetry(&lock, s));
+//
+// Если во время копирования пришло прерывание-писатель, seq изменится
+// и читатель просто повторит копирование. Писатель никогда не ждёт.
+// Читателей может быть сколько угодно — они ничего не модифицируют.
+//
+// ОГРАНИЧЕНИЕ: читатель не должен вытеснять писателя (читать из ISR
+// с приоритетом ВЫШЕ, чем у пишущего ISR) — иначе он будет крутиться
+// на нечётном seq, пока писатель не сможет продолжить, т.е. вечно.
+//
+// Барьер — SEQLOCK_BARRIER(): на Cortex-M — __DMB() из CMSIS, на ПК —
+// полный барьер C11 (заголовок собирается без stm32f4xx.h; стресс-тест
+// с потоками — Tests/test_seqlock.c).
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__arm__)
+#include "stm32f4xx.h"
+#define SEQLOCK_BARRIER() __DMB()
+#else
+#define SEQLOCK_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+typedef struct
+{
+    volatile uint32_t seq;
+} SeqLock_t;
+
+#define SEQLOCK_INIT {0U}
+
+static inline void SeqLock_WriteBegin(SeqLock_t *l)
+{
+    l->seq++;
+    SEQLOCK_BARRIER();
+}
+
+static inline void SeqLock_WriteEnd(SeqLock_t *l)
+{
+    SEQLOCK_BARRIER();
+    l->seq++;
+}
+
+static inline uint32_t SeqLock_ReadBegin(const SeqLock_t *l)
+{
+    uint32_t s;
+
+    do
+    {
+        s = l->seq;
+    } while (s & 1U); // идёт запись
+
+    SEQLOCK_BARRIER();
+    return s;
+}
+
+static inline uint8_t SeqLock_ReadRetry(const SeqLock_t *l, uint32_t start)
+{
+    SEQLOCK_BARRIER();
+    return (l->seq != start) ? 1U : 0U;
+}
+
+/* Скопировать n байт защищённых данных src → dst согласованно */
+static inline void SeqLock_ReadCopy(const SeqLock_t *l, void *dst,
+                                    const volatile void *src, size_t n)
+{
+    uint32_t s;
+
+    do
+    {
+        s = SeqLock_ReadBegin(l);
+
+        const volatile uint8_t *ps = (const volatile uint8_t *)src;
+        uint8_t *pd = (uint8_t *)dst;
+        for (size_t i = 0; i < n; i++)
+            pd[i] = ps[i];
+
+    } while (SeqLock_ReadRetry(l, s));
+}
+
+#endif // SEQLOCK_H
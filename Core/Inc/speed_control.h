@@ -1,15 +1,47 @@
 #ifndef SPEED_CONTROL_H
 #define SPEED_CONTROL_H
 
-#include "stm32f4xx.h"
+#include <stdint.h>
+
+/* Модель мотора (калибровать на роботе), общая для оценщика скорости
+ * и детектора заклинивания:
+ *   K   — об/с на единицу PWM сверх мёртвой зоны,
+ *   U0  — мёртвая зона PWM (колесо не трогается),
+ *   TAU — постоянная времени разгона, с.
+ */
+#define WHEEL_MODEL_K 0.061f
+#define WHEEL_MODEL_U0 50.0f
+#define WHEEL_MODEL_TAU 0.08f
+
+/* Предел скорости колеса для уставок, об/с: ~0.9 · K · (PWM_MAX − U0),
+ * запас 10% — регулятору есть чем догонять под нагрузкой.
+ */
+#define SPEED_WHEEL_MAX_RPS 2.7f
 
 /* Инициализация ПИД-регуляторов скорости */
 void SpeedControl_Init(void);
 
 /*
- * Задание целевой скорости колёс:
- *  left_rps / right_rps — обороты в СЕКУНДУ (без знака, >= 0),
- *  dir_left / dir_right — направление (+1 вперёд, -1 назад).
+ * Скорость корпуса (twist): v — мм/с (+ вперёд), w — рад/с (+ против
+ * часовой). Кинематика дифференциального привода с калибровкой одометрии:
+ *
+ *     v_L = v − w·b/2,  v_R = v + w·b/2   (мм/с) → об/с по мм/оборот колеса
+ *
+ * Насыщение с сохранением кривизны: если хоть одно колесо выше
+ * SPEED_WHEEL_MAX_RPS, ОБА масштабируются одним множителем — отношение
+ * v_R/v_L (радиус дуги) не меняется, робот идёт той же траекторией
+ * с наибольшей доступной скоростью.
+ *
+ * @return применённый множитель: 1 — без насыщения, < 1 — урезано
+ */
+float SpeedControl_SetTwist(float v_mm_s, float w_rad_s);
+
+/* Цели колёс со знаком, об/с (+ вперёд), с тем же насыщением */
+float SpeedControl_SetWheelRps(float left_rps, float right_rps);
+
+/*
+ * Прежний интерфейс: модуль + направление (+1 вперёд, -1 назад).
+ * Эквивалент SpeedControl_SetWheelRps(left_rps · dir_left, right_rps · dir_right).
  */
 void SpeedControl_SetTarget(float left_rps, float right_rps,
                             int8_t dir_left, int8_t dir_right);
@@ -17,7 +49,18 @@ void SpeedControl_SetTarget(float left_rps, float right_rps,
 /* Остановка (обе цели = 0, моторы в ноль) */
 void SpeedControl_Stop(void);
 
-/* Обновление ПИД по скорости, вызывать с периодом dt_sec (например, каждые 10–20 мс) */
+/* Обновление ПИД по скорости, вызывать с периодом dt_sec (например, каждые 10–20 мс).
+ * Регуляторы знаковые: прямая связь по модели (U0 + |rps|/K) плюс ПИД,
+ * выход в [−PWM_MAX, +PWM_MAX] — колесо можно активно затормозить
+ * и провести через ноль обратным PWM.
+ * Обратная связь — оценка скорости фильтром Калмана (wheel_estimator.h),
+ * а не сырое «тики / dt».
+ * Если детектор заклинивания взведён (Stall_Arm) и сработал — моторы
+ * остаются выключенными, пока событие не сброшено.
+ */
 void SpeedControl_Update(float dt_sec);
 
+/* Оценённая скорость колёс, об/с со знаком (+ вперёд) */
+void SpeedControl_GetMeasured(float *left_rps, float *right_rps);
+
 #endif /* SPEED_CONTROL_H */
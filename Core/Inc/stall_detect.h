@@ -0,0 +1,72 @@
+// stall_detect.h
+//
+// Детектор заклинивания колеса и столкновения с немедленным отключением моторов.
+//
+// Два независимых признака:
+//
+//  1) Заклинивание (STALL_LEFT / STALL_RIGHT) — на частоте регулятора:
+//     по модели мотора (speed_control.h) из поданного PWM считается
+//     ожидаемая скорость, пропущенная через звено τ (чтобы разгон не давал
+//     ложных срабатываний). Если измеренная скорость вдоль команды меньше
+//     STALL_SPEED_RATIO от ожидаемой дольше STALL_CONFIRM_S — колесо стоит.
+//     Быстрее подтвердить нельзя: при 40 имп/об остановку энкодер «видит»
+//     только через несколько десятков миллисекунд.
+//
+//  2) Удар (STALL_IMPACT) — на частоте IMU: скачок горизонтального
+//     ускорения между соседними отсчётами |Δa_xy| > STALL_IMPACT_G.
+//     Проверка целочисленная (квадрат разности в LSB), срабатывает
+//     в том же вызове, в котором пришёл отсчёт, — задержка отключения
+//     равна периоду опроса IMU. Порог в LSB следует за текущим
+//     диапазоном акселерометра: при его смене пересчитывается в
+//     Stall_FeedAccel, прошлый отсчёт отбрасывается.
+//
+// При срабатывании моторы сразу переводятся в режим остановки
+// (по умолчанию выбег — снимает ток с моста), событие защёлкивается
+// до Stall_Clear(). Детектор работает только во «взведённом» состоянии
+// (Stall_Arm) — пока робот стоит, толчки рукой не учитываются.
+
+#ifndef STALL_DETECT_H
+#define STALL_DETECT_H
+
+#include <stdint.h>
+#include "motor.h"
+
+#define STALL_SPEED_RATIO 0.25f   // измерено < 25% ожидаемого
+#define STALL_MIN_EXPECT_RPS 1.0f // ниже этой ожидаемой скорости не судим
+#define STALL_CONFIRM_S 0.12f     // длительность подтверждения
+#define STALL_IMPACT_G 0.6f       // скачок горизонтального ускорения за отсчёт
+
+typedef enum
+{
+    STALL_NONE = 0,
+    STALL_LEFT = 1U << 0,
+    STALL_RIGHT = 1U << 1,
+    STALL_IMPACT = 1U << 2
+} StallEvent;
+
+/* Сброс состояния; порог удара считается из текущего диапазона акселерометра */
+void Stall_Init(void);
+
+/* Взвести (1) / снять (0) детектор. Взведение сбрасывает фильтры и событие. */
+void Stall_Arm(uint8_t on);
+
+/* Режим отключения моторов при срабатывании (по умолчанию выбег) */
+void Stall_SetCutMode(MotorStopMode mode);
+
+/* Проверка колёс — вызывать на частоте регулятора.
+ * pwmL/pwmR — PWM, действовавший на прошедшем интервале (со знаком),
+ * measL/measR — измеренная скорость, об/с со знаком.
+ * Возвращает защёлкнутые биты StallEvent.
+ */
+uint8_t Stall_UpdateWheels(int16_t pwmL, int16_t pwmR, float measL, float measR, float dt_sec);
+
+/* Проверка удара — вызывать на каждый отсчёт акселерометра (сырые LSB) */
+uint8_t Stall_FeedAccel(const int16_t accel[3]);
+
+/* Защёлкнутые события (0 — всё в порядке) */
+uint8_t Stall_Event(void);
+
+/* Сбросить событие (моторы остаются выключенными до новой команды) */
+void Stall_Clear(void);
+
+#endif // STALL_DETECT_H
@@ -0,0 +1,129 @@
+// teleop.h
+//
+// Режим телеуправления: поток уставок (v, ω) с хоста по USART3
+// (50–200 Гц) → SpeedControl_SetTwist, с контролируемой остановкой
+// при обрыве потока и учётом латентности.
+//
+// Кадр — строка ASCII, контрольная сумма XOR в стиле NMEA (байты между
+// '$' и '*', две hex-цифры):
+//
+//   $S,<seq>,<t_host_us>,<v_mm_s>,<w_mrad_s>*HH\n   уставка
+//   $R*52\n                                        отчёт Teleop_Report()
+//
+// Путь (path_follow.h) — точки в мм в системе робота на момент старта
+// (x вперёд, y влево), первая обычно 0,0:
+//
+//   $C*43\n                       очистить загруженные точки
+//   $P,<x_mm>,<y_mm>*HH\n         добавить точку (до TELEOP_PATH_MAX)
+//   $F,<mode>,<v_mm_s>,<steps>*HH\n ехать: mode 0 — pure pursuit, 1 — Stanley;
+//                                  steps > 1 — точки как контрольные
+//                                  Catmull-Rom, steps отсчётов на участок
+//
+// Карта (grid_plan.h): клетки GRID_CELL_MM_DEFAULT, робот после
+// Teleop_Init — в центре клетки (0, 0), курс вдоль +x:
+//
+//   $O,<x0>,<y0>,<x1>,<y1>,<b>*HH\n  прямоугольник клеток: b = 1 занят, 0 свободен
+//   $G,<gx>,<gy>,<mode>,<v_mm_s>*HH\n A* от клетки под роботом до (gx, gy),
+//                                    путь со срезанными углами — сразу в езду
+//
+// Ответы: $F,<точек пути>*HH (0 — путь не принят),
+// $G,<точек>,<клеток>,<раскрыто>,<план_us>*HH (0 точек — пути нет)
+// и по завершении $D,<max_e_mm>,<rms_e_mm>,<end_e_mm>,<t_ms>*HH.
+// Во время пути поток $S не нужен и обрыв не контролируется; любой кадр
+// $S прерывает путь.
+//
+// seq — возрастающий номер (uint32); кадр с seq не новее последнего
+// принятого отбрасывается (дубль или перестановка). t_host_us — время
+// отправки по часам хоста, мкс, по модулю 2^32.
+//
+// Ответ на каждый TELEOP_ACK_DIV-й кадр:
+//
+//   $A,<seq>,<t_host_us>,<dev_us>*HH\n
+//
+// dev_us — время в прошивке от прихода '\n' (отметка в прерывании USART)
+// до применения уставки. Хост по эху t_host_us считает полный круг (RTT),
+// вычитает dev_us и получает время в канале (Tools/teleop.py).
+//
+// Статистика на стороне робота часов хоста не требует:
+//   джиттер    — RFC 3550: D = (rx_i − rx_{i−1}) − (host_i − host_{i−1}),
+//                J += (|D| − J)/16, плюс максимум |D|;
+//   задержка   — d = rx − host включает неизвестный сдвиг часов, поэтому
+//                считается сверх минимума окна: d − min(d). Это очередь
+//                и буферизация (USB-UART, ОС хоста), а не постоянная часть
+//                пути; окно сбрасывает Teleop_Report(), так что дрейф
+//                кварцев не копится;
+//   прошивка   — rx → применение, мин/сред/макс;
+//   интервалы  — наибольший разрыв между кадрами.
+//
+// Обрыв потока: нет валидного кадра TELEOP_STALL_MS → v и ω плавно
+// сводятся к нулю одним множителем (кривизна сохраняется; быстрейшее колесо
+// тормозит с TELEOP_STOP_DECEL_MM_S2), затем SpeedControl_Stop().
+// Следующий валидный кадр снова разгоняет робота.
+//
+// Ответы шлёт блокирующий USART_Print: ~30 байт ≈ 2.6 мс на 115200.
+// На 200 Гц это половина периода — тогда ставить TELEOP_ACK_DIV 4..10.
+//
+// Включается TELEOP_ENABLE = 1 (main.c: вместо сценария MoveForwardMM).
+
+#ifndef TELEOP_H
+#define TELEOP_H
+
+#include <stdint.h>
+
+#ifndef TELEOP_ENABLE
+#define TELEOP_ENABLE 0
+#endif
+
+#define TELEOP_STALL_MS 200U           // ≥ нескольких периодов потока
+#define TELEOP_STOP_DECEL_MM_S2 1500.0f // мягче тормоза STOP_BRAKE_DECEL_MM_S2
+#define TELEOP_CTRL_PERIOD_US 10000U    // период SpeedControl_Update
+#define TELEOP_V_MAX_MM_S 600           // ограничение входных уставок
+#define TELEOP_W_MAX_MRAD_S 6000
+#define TELEOP_LINE_MAX 64U
+#define TELEOP_PATH_MAX 32U             // точек в одной загрузке $P
+
+#ifndef TELEOP_ACK_DIV
+#define TELEOP_ACK_DIV 1U // ответ на каждый N-й кадр; 0 — без ответов
+#endif
+
+typedef struct
+{
+    uint32_t frames;   // применённые уставки
+    uint32_t bad;      // ошибки формата / контрольной суммы
+    uint32_t stale;    // seq не новее последнего
+    uint32_t lost;     // пропуски в seq
+    uint32_t stalls;   // срабатывания таймаута потока
+    uint32_t rx_drops; // потери байтов в драйвере USART
+
+    uint32_t max_gap_us; // наибольший интервал между кадрами
+    float jitter_us;     // RFC 3550
+    uint32_t max_jitter_us;
+
+    uint32_t queue_mean_us; // задержка сверх минимума окна
+    uint32_t queue_max_us;
+
+    uint32_t fw_min_us; // rx → применение
+    uint32_t fw_mean_us;
+    uint32_t fw_max_us;
+} TeleopStats_t;
+
+/* SpeedControl_Init, обнуление статистики, робот стоит */
+void Teleop_Init(void);
+
+/* Один проход: разбор принятых строк, регулятор по таймеру, контроль обрыва.
+ * Не блокирует (кроме отправки ответов) — вызывать из главного цикла.
+ */
+void Teleop_Poll(void);
+
+/* Бесконечный цикл Teleop_Poll() с контролем дедлайна регулятора */
+void Teleop_Run(void);
+
+/* 1 — поток жив и робот управляется с хоста (или едет по пути) */
+uint8_t Teleop_IsActive(void);
+
+void Teleop_GetStats(TeleopStats_t *out);
+
+/* Печать статистики и сброс окна */
+void Teleop_Report(void);
+
+#endif // TELEOP_H
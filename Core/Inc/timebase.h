@@ -0,0 +1,87 @@
+// timebase.h
+//
+// Общая микросекундная шкала времени на TIM2 (32-битный таймер).
+//
+//   TIM2 тактируется от APB1 × 2 = 84 МГц, PSC = 83 → 1 МГц,
+//   ARR = 0xFFFFFFFF → счётчик переполняется раз в ~71.6 минуты.
+//
+// Все сравнения сделаны через беззнаковую разность (now - start),
+// поэтому переполнение счётчика ничего не ломает, пока интервалы
+// короче 2^31 мкс (~35 минут).
+//
+// Модуль заменяет копии Delay_ms() с активным ожиданием на g_msTicks:
+//   - Time_DelayMs() спит без SysTick до дедлайна (idle.h, будильник TIM2 CC1);
+//   - Time_DelayUs() для коротких пауз крутится на счётчике.
+//
+// g_msTicks (SysTick 1 мс) остаётся — на нём антидребезг энкодеров.
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#define TIMEBASE_TIM TIM2
+#define TIMEBASE_PSC 83U // 84 МГц / (83+1) = 1 МГц
+
+/* Запуск TIM2 как свободного счётчика микросекунд.
+ * Вызывать после Clock_Init().
+ */
+void Time_Init(void);
+
+/* Текущее время, мкс (с переполнением через 2^32) */
+static inline uint32_t Time_Us(void)
+{
+    return TIMEBASE_TIM->CNT;
+}
+
+/* Сколько мкс прошло с момента start */
+static inline uint32_t Time_ElapsedUs(uint32_t start)
+{
+    return Time_Us() - start;
+}
+
+/* Дедлайн через timeout_us от текущего момента */
+static inline uint32_t Time_DeadlineUs(uint32_t timeout_us)
+{
+    return Time_Us() + timeout_us;
+}
+
+/* Наступил ли дедлайн (корректно через переполнение) */
+static inline uint8_t Time_Reached(uint32_t deadline)
+{
+    return ((int32_t)(Time_Us() - deadline) >= 0) ? 1U : 0U;
+}
+
+/* Таймаут: старт + длительность.
+ *
+ *     Timeout_t to;
+ *     Timeout_Start(&to, 500);
+ *     while (!flag)
+ *         if (Timeout_Expired(&to))
+ *             return ERROR;
+ */
+typedef struct
+{
+    uint32_t start;
+    uint32_t duration;
+} Timeout_t;
+
+static inline void Timeout_Start(Timeout_t *t, uint32_t duration_us)
+{
+    t->start = Time_Us();
+    t->duration = duration_us;
+}
+
+static inline uint8_t Timeout_Expired(const Timeout_t *t)
+{
+    return (Time_ElapsedUs(t->start) >= t->duration) ? 1U : 0U;
+}
+
+/* Пауза в мкс (активное ожидание — для коротких интервалов) */
+void Time_DelayUs(uint32_t us);
+
+/* Пауза в мс: бестиковый сон (idle.h), прерывания обслуживаются как обычно */
+void Time_DelayMs(uint32_t ms);
+
+#endif // TIMEBASE_H
@@ -0,0 +1,117 @@
+// trace.h
+//
+// Бортовой самописец (flight recorder): кольцевой буфер событий в CCM RAM.
+//
+// Каждое событие — запись фиксированного размера (12 байт):
+//   ts — метка времени в тактах ядра (DWT->CYCCNT, 168 МГц)
+//   id — тип события (TraceEvent)
+//   a  — короткий аргумент (номер мотора, линия, регистр...)
+//   b  — длинный аргумент (PWM, тики, упакованные сэмплы...)
+//
+// Свойства:
+//   - без блокировок: индекс записи занимается через LDREX/STREX,
+//     поэтому Trace_Record() можно вызывать и из прерываний, и из main;
+//   - стоимость записи — десяток тактов (inline, без ветвлений по типу);
+//   - буфер лежит по фиксированному адресу в конце CCM RAM и не трогается
+//     стартовым кодом → переживает программный сброс (NVIC_SystemReset,
+//     IWDG), после сброса его можно выгрузить Trace_Dump();
+//   - Tools/trace2json.py превращает выгрузку в Chrome trace / Perfetto JSON.
+//
+// Выключается целиком через TRACE_ENABLE = 0 (макросы TRACE() пустые).
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+/* Ёмкость кольца (степень двойки): 2048 × 12 байт = 24 КБ CCM */
+#define TRACE_CAPACITY 2048U
+
+#define TRACE_MAGIC 0x54524331UL // "TRC1"
+
+typedef enum
+{
+    TRACE_EV_BOOT = 1,      // a = 0,            b = RCC->CSR (флаги сброса)
+    TRACE_EV_CTRL_TICK = 2, // a = 0,            b = dt (мкс)
+    TRACE_EV_PWM = 3,       // a = MotorId,      b = speed (int16, со знаком)
+    TRACE_EV_BRAKE = 4,     // a = MotorId,      b = 0
+    TRACE_EV_ENC = 5,       // a = 0 L / 1 R,    b = суммарные тики
+    TRACE_EV_IMU_GYRO = 6,  // a = gz (raw),     b = gx << 16 | gy (raw)
+    TRACE_EV_IMU_ACC = 7,   // a = az (raw),     b = ax << 16 | ay (raw)
+    TRACE_EV_I2C_ERR = 8,   // a = регистр,      b = SR1 << 16 | SR2
+    TRACE_EV_MARK = 9,      // a, b — произвольная пользовательская метка
+    TRACE_EV_STALL = 10,    // a = StallEvent,   b = Δa² (LSB²) для удара / 0
+    TRACE_EV_DEADLINE = 11, // a = задача/причина, b = gap (мс) / 0xFFFFFFFF — авария
+    TRACE_EV_TELEOP = 12    // a = 0 обрыв / 1 возобновление, b = последний seq
+} TraceEvent;
+
+typedef struct
+{
+    uint32_t ts;
+    uint16_t id;
+    uint16_t a;
+    uint32_t b;
+} TraceRec_t;
+
+typedef struct
+{
+    uint32_t magic;
+    volatile uint32_t head; // монотонный счётчик записей (индекс = head % CAPACITY)
+    uint32_t boots;         // сколько сбросов пережил буфер
+    uint32_t cpu_hz;        // частота счётчика меток времени
+    TraceRec_t rec[TRACE_CAPACITY];
+} TraceBuf_t;
+
+/* Буфер — в самом конце CCM RAM (0x10000000..0x1000FFFF) */
+#define TRACE_BUF ((TraceBuf_t *)(CCMDATARAM_END + 1UL - sizeof(TraceBuf_t)))
+
+/* Инициализация: включает CCM и DWT->CYCCNT.
+ * Если в CCM уже лежит валидный буфер (после сброса) — продолжает его
+ * и пишет событие TRACE_EV_BOOT, иначе начинает с нуля.
+ */
+void Trace_Init(void);
+
+/* Сбросить содержимое буфера */
+void Trace_Clear(void);
+
+/* Выгрузить весь буфер (от старых к новым) в USART3 текстом:
+ *   #TRACE v1 cpu_hz=... boots=... head=... cap=...
+ *   TTTTTTTT IIII AAAA BBBBBBBB
+ *   ...
+ *   #END
+ */
+void Trace_Dump(void);
+
+/* Запись события. Безопасна из любого контекста. */
+static inline void Trace_Record(uint16_t id, uint16_t a, uint32_t b)
+{
+    TraceBuf_t *tb = TRACE_BUF;
+    uint32_t idx;
+
+    do
+    {
+        idx = __LDREXW(&tb->head);
+    } while (__STREXW(idx + 1U, &tb->head));
+
+    TraceRec_t *r = &tb->rec[idx & (TRACE_CAPACITY - 1U)];
+    r->ts = DWT->CYCCNT;
+    r->id = id;
+    r->a = a;
+    r->b = b;
+}
+
+#if TRACE_ENABLE
+#define TRACE(id, a, b) Trace_Record((uint16_t)(id), (uint16_t)(a), (uint32_t)(b))
+#else
+#define TRACE(id, a, b) ((void)0)
+#endif
+
+/* Упаковка двух int16 в одно 32-битное поле b */
+#define TRACE_PACK16(hi, lo) (((uint32_t)(uint16_t)(hi) << 16) | (uint16_t)(lo))
+
+#endif // TRACE_H
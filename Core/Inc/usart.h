@@ -32,8 +32,20 @@ void USART_PrintlnHex(uint32_t value);
 void USART_PrintFloat(float value, uint8_t digits);
 void USART_PrintlnFloat(float value, uint8_t digits);
 
-/* Если захочешь читать из порта */
+/* Приём USART3: кольцо по прерыванию RXNE (включается в USART3_Init) */
+#define USART_RX_BUF_SIZE 256U  // степень двойки
+#define USART_RX_EOL_STAMPS 16U // отметок времени '\n' в очереди
+#define USART_RX_IRQ_PRIO 7U    // ниже энкодеров (5) и будильника сна (6)
+
 uint8_t USART_IsDataReceived(void);
-char USART_ReadChar(void);
+char USART_ReadChar(void); // блокирует, пока кольцо пусто
+
+/* Время Time_Us() прихода очередного '\n' (в порядке поступления строк).
+ * @return 0 — отметок нет (или потеряны при переполнении очереди)
+ */
+uint8_t USART_PopEolStamp(uint32_t *t_us);
+
+/* Потерянные байты: переполнение кольца + аппаратный overrun */
+uint32_t USART_RxDropped(void);
 
 #endif // USART_H
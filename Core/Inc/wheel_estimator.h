@@ -0,0 +1,78 @@
+// wheel_estimator.h
+//
+// Оценка скорости колеса фильтром Калмана по тикам энкодера и модели мотора.
+//
+// Проблема: при 40 имп/об и периоде 10 мс один тик = 2.5 об/с — скорость
+// «ticks / dt» сильно квантована и шумит, регулятор на ней дрожит.
+//
+// Модель (мотор первого порядка + неизвестная нагрузка):
+//
+//     dω/dt = (K · u_eff − ω) / τ + d
+//
+//     u_eff = sign(u) · max(|u| − u0, 0)   — PWM за вычетом мёртвой зоны
+//     d     — медленное возмущение (трение, уклон), оценивается фильтром
+//
+// Состояние x = [ω, d], измерение z = ticks / (PPR · dt) со знаком
+// команды (энкодер одноканальный, направления не видит). Исключение —
+// обратный PWM при заметной прогнозной скорости (активное торможение
+// знаковым регулятором): тогда знак тиков — по прогнозу ω.
+// Шум измерения считается из шага квантования: R = (1 / (PPR · dt))² / 12.
+//
+// Прогноз — точная дискретизация модели на шаге dt (вход и d постоянны
+// внутри шага): a = e^(−dt/τ), ω' = a·ω + (1 − a)·(K·u_eff + τ·d).
+// Эйлер (a = 1 − dt/τ) при dt > τ даёт a < 0 и раскачивает оценку,
+// а точная формула устойчива при любом dt (пропуск тактов, τ ≈ dt).
+//
+// На выходе каждый такт — гладкая скорость ω (об/с) и ускорение (об/с²).
+
+#ifndef WHEEL_ESTIMATOR_H
+#define WHEEL_ESTIMATOR_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    /* Модель мотора (калибруется: разгон на фиксированном PWM) */
+    float K;   // установившаяся скорость на единицу PWM, об/с
+    float u0;  // мёртвая зона PWM
+    float tau; // механическая постоянная времени, с
+    float ppr; // импульсов энкодера на оборот
+
+    /* Шум процесса (спектральная плотность) */
+    float q_omega;
+    float q_dist;
+
+    /* Состояние и ковариация */
+    float omega; // об/с, со знаком
+    float dist;  // об/с²
+    float P00, P01, P11;
+
+    float accel; // последняя оценка ускорения, об/с²
+
+    /* e^(−dt/τ) для последнего dt: период обычно постоянный, expf — редко */
+    float a_dt;
+    float a;
+} WheelEst_t;
+
+/* Инициализация с параметрами модели и нулевым состоянием */
+void WheelEst_Init(WheelEst_t *e, float K, float u0, float tau, float ppr);
+
+/* Сброс состояния (скорость 0, большая неопределённость) */
+void WheelEst_Reset(WheelEst_t *e);
+
+/* Один шаг: ticks — тики за dt (без знака), pwm — команда, действовавшая
+ * на этом интервале (со знаком).
+ */
+void WheelEst_Update(WheelEst_t *e, uint32_t ticks, int16_t pwm, float dt);
+
+static inline float WheelEst_Speed(const WheelEst_t *e)
+{
+    return e->omega;
+}
+
+static inline float WheelEst_Accel(const WheelEst_t *e)
+{
+    return e->accel;
+}
+
+#endif // WHEEL_ESTIMATOR_H
@@ -18,6 +18,7 @@
 
 #include "GU521_init.h"
 #include "usart.h"
+#include "i2c_bus.h"
 
 void GY521_I2C1_Init(void)
 {
@@ -122,7 +123,13 @@ void GY521_I2C1_Init(void)
     I2C1->CR1 |= I2C_CR1_PE;
 
     /**************************************************************************
-     * 7. Необязательный лог через USART → удобно при отладке
+     * 7. Шину получает менеджер (i2c_bus.h): дальше все драйверы ходят
+     *    на I2C1 только через него.
+     **************************************************************************/
+    I2CBus_Init(I2CBus_HwOps());
+
+    /**************************************************************************
+     * 8. Необязательный лог через USART → удобно при отладке
      **************************************************************************/
     USART_Print("I2C1 CR1 = 0x");
     USART_PrintHex(I2C1->CR1);
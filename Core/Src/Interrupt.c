@@ -1,5 +1,9 @@
 #include "Interrupt.h"
+#include "deadline.h"
+#include "isr_latency.h"
 void SysTick_Handler(void)
 {
+    ISRLAT_SYSTICK_ENTRY();
     g_msTicks++;
+    Deadline_Tick();
 }
\ No newline at end of file
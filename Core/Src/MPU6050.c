@@ -1,322 +1,269 @@
 #include "MPU6050.h"
 #include "usart.h"
-
-#define I2C_DEV I2C1
-#define I2C_TIMEOUT 100000UL
+#include "trace.h"
+#include "perf.h"
+#include "timebase.h"
+#include "sensor_log.h"
+#include "i2c_bus.h"
+#include "deadline.h"
+#include <string.h>
+
+/* Масштабы для каждого диапазона (обратные величины — умножение вместо деления) */
+static const float s_gyroScaleTable[4] = {
+    1.0f / 131.0f, // ±250°/с
+    1.0f / 65.5f,  // ±500°/с
+    1.0f / 32.8f,  // ±1000°/с
+    1.0f / 16.4f   // ±2000°/с
+};
+
+static const float s_accelScaleTable[4] = {
+    1.0f / 16384.0f, // ±2g
+    1.0f / 8192.0f,  // ±4g
+    1.0f / 4096.0f,  // ±8g
+    1.0f / 2048.0f   // ±16g
+};
+
+/* Те же масштабы в фиксированной точке для MPU6050_ToFixed():
+ *   гироскоп  — m°/с на LSB в Q8  (1000/16.4·256 = 15610)
+ *   аксель    — mg на LSB в Q16   (1000/2048·65536 = 32000)
+ * Все множители < 32768 — помещаются в знаковое полуслово для SMLAD.
+ */
+static const int16_t s_gyroQ8Table[4] = {1954, 3908, 7805, 15610};
+static const int16_t s_accelQ16Table[4] = {4000, 8000, 16000, 32000};
+
+/* Температура в сотых °C: 3653 + raw·100/340, множитель в Q16 */
+#define MPU6050_TEMP_CDEG_OFFSET 3653
+#define MPU6050_TEMP_CDEG_Q16 19275
+
+/* Текущая конфигурация и масштабы */
+static MPU6050_Config_t s_cfg = MPU6050_CONFIG_DEFAULT;
+static float s_gyroScale = 1.0f / 16.4f;
+static float s_accelScale = 1.0f / 4096.0f;
+static int16_t s_gyroQ8 = 15610;
+static int16_t s_accelQ16 = 16000;
+
+/* Датчик на общей шине I2C1 */
+static I2CDev_t s_dev = I2C_DEV_INIT("mpu6050", MPU6050_ADDR);
+
+/* Номер следующего отсчёта ImuSample_t */
+static uint16_t s_sampleSeq;
 
 /******************************************************************************
- * I2C_WaitSR1()
- *
- * Вспомогательная функция.
- * Ждёт установки указанного флага в регистре SR1.
+ * Упакованные 16-битные операции (DSP-расширение Cortex-M4)
  *
- * Используется там, где модуль I2C "обещает" выставить флаг,
- * например:
- *   - SB  (Start Bit установлен)
- *   - ADDR (адрес принят slave'ом)
- *   - TXE  (передающий буфер пуст)
- *   - RXNE (принят байт)
- *   - BTF  (завершён байт)
+ *   IMU_REV16(x)      — перестановка байтов в каждом полуслове
+ *   IMU_QSUB16(x, y)  — два вычитания с насыщением за одну инструкцию
+ *   IMU_SMLAD(x, y, a)— x.lo·y.lo + x.hi·y.hi + a: умножение на масштаб
+ *                       и округление одной инструкцией (второй множитель 0)
  *
- * Если флаг не установился за разумное время → возвращаем 0 (ошибка).
+ * На хосте (симуляция, проверка синтаксиса) — эквивалентный C.
  ******************************************************************************/
-static uint8_t I2C_WaitSR1(uint32_t flag)
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define IMU_REV16(x) __REV16(x)
+#define IMU_QSUB16(x, y) __QSUB16((x), (y))
+#define IMU_SMLAD(x, y, a) ((int32_t)__SMLAD((x), (y), (uint32_t)(a)))
+#else
+static inline uint32_t IMU_REV16(uint32_t x)
 {
-    uint32_t t = 0;
-    while (!(I2C_DEV->SR1 & flag))
-    {
-        if (t++ > I2C_TIMEOUT)
-            return 0; // произошёл таймаут — что-то зависло
-    }
-    return 1;
+    return ((x & 0x00FF00FFUL) << 8) | ((x >> 8) & 0x00FF00FFUL);
 }
 
-/******************************************************************************
- * I2C_WriteReg(reg, data)
- *
- * Записывает ОДИН байт в выбранный регистр MPU6050.
- *
- * Формат транзакции I2C:
- *
- *   START
- *   адрес + write
- *   байт_адреса_регистра
- *   байт_данных
- *   STOP
- *
- * Функция выполняет весь протокол:
- *   - генерирует START
- *   - ждёт флаг SB
- *   - отправляет адрес MPU6050 (0x68 << 1 | 0)
- *   - ждёт ADDR
- *   - записывает номер регистра
- *   - пишет данные
- *   - ждёт BTF (Byte Transfer Finished)
- *   - генерирует STOP
- *
- * При любой ошибке выводит SR1/SR2 для диагностики.
- ******************************************************************************/
-static uint8_t I2C_WriteReg(uint8_t reg, uint8_t data)
+static inline int32_t imu_sat16(int32_t v)
 {
-    uint32_t t;
+    return (v > 32767) ? 32767 : (v < -32768) ? -32768 : v;
+}
 
-    /* --- START condition --- */
-    I2C_DEV->CR1 |= I2C_CR1_START;
+static inline uint32_t IMU_QSUB16(uint32_t x, uint32_t y)
+{
+    int32_t lo = imu_sat16((int32_t)(int16_t)x - (int32_t)(int16_t)y);
+    int32_t hi = imu_sat16((int32_t)(int16_t)(x >> 16) - (int32_t)(int16_t)(y >> 16));
+    return ((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo;
+}
 
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_SB))
-    {
-        if (t++ > I2C_TIMEOUT)
-        {
-            USART_Println("I2C_WriteReg: timeout SB");
-            goto error;
-        }
-    }
+static inline int32_t IMU_SMLAD(uint32_t x, uint32_t y, int32_t a)
+{
+    return (int32_t)(int16_t)x * (int16_t)y +
+           (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16) + a;
+}
+#endif
 
-    /* --- Send address with Write bit --- */
-    I2C_DEV->DR = (MPU6050_ADDR << 1) | 0;
+/* Пара соседних полуслов одним словом (raw[] выровнен на 4) */
+static inline uint32_t imu_ld32(const int16_t *p)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
 
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_ADDR))
-    {
-        if (t++ > I2C_TIMEOUT)
-        {
-            USART_Println("I2C_WriteReg: timeout ADDR");
-            goto error;
-        }
-    }
+static inline void imu_st32(int16_t *p, uint32_t w)
+{
+    memcpy(p, &w, sizeof(w));
+}
 
-    // Сброс ADDR: обязательно читаем SR1/SR2
-    (void)I2C_DEV->SR1;
-    (void)I2C_DEV->SR2;
+/* Множитель только для младшего / старшего полуслова */
+#define IMU_K_LO(k) ((uint32_t)(uint16_t)(k))
+#define IMU_K_HI(k) ((uint32_t)(uint16_t)(k) << 16)
 
-    /* --- Send register address --- */
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_TXE))
-    {
-        if (t++ > I2C_TIMEOUT)
-        {
-            USART_Println("I2C_WriteReg: timeout TXE (reg)");
-            goto error;
-        }
-    }
-    I2C_DEV->DR = reg;
+/******************************************************************************
+ * MPU6050_Init()
+ *
+ * Полная инициализация датчика:
+ *   1) Сброс устройства (задержка после reset)
+ *   2) Выбор источника тактирования (PLL по X-gyro — рекомендуется даташитом)
+ *   3) DLPF, частота выборки и диапазоны — MPU6050_Configure()
+ *      с конфигурацией по умолчанию (MPU6050_CONFIG_DEFAULT)
+ *   4) Настройка прерывания Data Ready
+ ******************************************************************************/
+void MPU6050_Init(void)
+{
+    USART_Println("MPU6050_Init: start");
 
-    /* --- Send data byte --- */
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_TXE))
+    // 1) Reset device
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_PWR_MGMT_1, MPU6050_DEVICE_RESET))
     {
-        if (t++ > I2C_TIMEOUT)
-        {
-            USART_Println("I2C_WriteReg: timeout TXE (data)");
-            goto error;
-        }
+        USART_Println("MPU6050_Init: failed to write reset");
+        return;
     }
-    I2C_DEV->DR = data;
 
-    /* --- Wait for BTF (both bytes transmitted) --- */
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_BTF))
-    {
-        if (t++ > I2C_TIMEOUT)
-        {
-            USART_Println("I2C_WriteReg: timeout BTF");
-            goto error;
-        }
-    }
+    // Задержка после reset — датчик перезапускается (~100 мс по даташиту)
+    Time_DelayMs(100);
 
-    /* --- STOP --- */
-    I2C_DEV->CR1 |= I2C_CR1_STOP;
-    return 1;
+    // 2) Clock source = PLL (X-gyro)
+    I2CBus_WriteReg(&s_dev, MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_PLL_XGYRO);
 
-error:
-{
-    // Если ошибка — читаем SR1/SR2 для диагностики
-    uint32_t sr1 = I2C_DEV->SR1;
-    uint32_t sr2 = I2C_DEV->SR2;
+    // 3) DLPF 44 Гц, 125 Гц, ±2000 dps, ±8g
+    const MPU6050_Config_t def = MPU6050_CONFIG_DEFAULT;
+    if (!MPU6050_Configure(&def))
+        USART_Println("MPU6050_Init: failed to apply config");
 
-    // STOP обязателен, иначе шина зависнет
-    I2C_DEV->CR1 |= I2C_CR1_STOP;
+    // 4) Interrupt config
+    I2CBus_WriteReg(&s_dev, MPU6050_REG_INT_PIN_CFG, 0x00);
+    I2CBus_WriteReg(&s_dev, MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY);
 
-    USART_Print("I2C_WriteReg ERROR, SR1 = 0x");
-    USART_PrintHex(sr1);
-    USART_Print(" SR2 = 0x");
-    USART_PrintlnHex(sr2);
-}
-    return 0;
+    USART_Println("MPU6050_Init: done");
 }
 
 /******************************************************************************
- * I2C_Read1(reg, *val)
- *
- * Чтение одного байта из регистра MPU6050.
- * Формат чтения по I2C:
- *
- *   START
- *   адрес + write
- *   номер_регистра
- *   (BTF)
- *   RE-START
- *   адрес + read
- *   читем_1_байт (ACK=0)
- *   STOP
- *
- * Функция реализует классический протокол I2C Read из любого регистра.
- *
- * Почему ACK=0?
- *   При чтении последнего (или единственного) байта мастеру нельзя
- *   отправлять ACK — иначе slave будет думать, что мы хотим читать дальше.
+ * MPU6050_Configure()
+ *
+ * Записывает CONFIG, SMPLRT_DIV, GYRO_CONFIG, ACCEL_CONFIG по порядку
+ * и останавливается на первой неудачной записи. s_cfg и масштабы
+ * обновляются после КАЖДОЙ удачной записи своего регистра: при ошибке
+ * посередине они описывают то, что реально стоит в датчике (часть
+ * полей новая, остальные прежние), и сырые данные не разъезжаются
+ * с коэффициентами.
  ******************************************************************************/
-static uint8_t I2C_Read1(uint8_t reg, uint8_t *val)
+uint8_t MPU6050_Configure(const MPU6050_Config_t *cfg)
 {
-    uint32_t t;
-
-    if (!val)
+    if (!cfg || cfg->dlpf > MPU6050_DLPF_5HZ ||
+        cfg->gyro_fs > MPU6050_GYRO_FS_2000 ||
+        cfg->accel_fs > MPU6050_ACCEL_FS_16G)
         return 0;
 
-    /* --- Step 1: WRITE — send register address --- */
-
-    // START
-    I2C_DEV->CR1 |= I2C_CR1_START;
-
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_SB))
-    {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
-    }
-
-    // Send address + write
-    I2C_DEV->DR = (MPU6050_ADDR << 1) | 0;
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_CONFIG, (uint8_t)cfg->dlpf))
+        return 0;
+    s_cfg.dlpf = cfg->dlpf;
 
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_ADDR))
-    {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
-    }
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_SMPLRT_DIV, cfg->smplrt_div))
+        return 0;
+    s_cfg.smplrt_div = cfg->smplrt_div;
 
-    (void)I2C_DEV->SR1;
-    (void)I2C_DEV->SR2;
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_GYRO_CONFIG, (uint8_t)(cfg->gyro_fs << 3)))
+        return 0;
+    s_cfg.gyro_fs = cfg->gyro_fs;
+    s_gyroScale = s_gyroScaleTable[cfg->gyro_fs];
+    s_gyroQ8 = s_gyroQ8Table[cfg->gyro_fs];
 
-    // Send register number
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_TXE))
-    {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
-    }
-    I2C_DEV->DR = reg;
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_ACCEL_CONFIG, (uint8_t)(cfg->accel_fs << 3)))
+        return 0;
+    s_cfg.accel_fs = cfg->accel_fs;
+    s_accelScale = s_accelScaleTable[cfg->accel_fs];
+    s_accelQ16 = s_accelQ16Table[cfg->accel_fs];
 
-    // Wait for BTF
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_BTF))
-    {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
-    }
+    return 1;
+}
 
-    /* --- Step 2: RE-START and Read --- */
+/******************************************************************************
+ * MPU6050_SetDLPF()
+ *
+ * DLPF_260HZ переключает внутреннюю частоту F_int 1 кГц ↔ 8 кГц, и при
+ * том же SMPLRT_DIV частота выдачи молча менялась бы в 8 раз. Поэтому
+ * при переходе через 260 Гц делитель пересчитывается на ту же частоту
+ * (ближайшую возможную: 1 кГц / (1 + div) не всегда делится на 8,
+ * div ≤ 255) и пишется так, чтобы промежуточная частота не была выше
+ * итоговой: к 8 кГц — сначала SMPLRT_DIV, к 1 кГц — сначала CONFIG.
+ * Как и в Configure, s_cfg следует за каждой удачной записью; не
+ * записался CONFIG после нового делителя — делитель возвращается.
+ ******************************************************************************/
+static uint8_t f_int_khz(MPU6050_Dlpf dlpf)
+{
+    return (dlpf == MPU6050_DLPF_260HZ) ? 8U : 1U;
+}
 
-    I2C_DEV->CR1 |= I2C_CR1_START;
+uint8_t MPU6050_SetDLPF(MPU6050_Dlpf dlpf)
+{
+    if (dlpf > MPU6050_DLPF_5HZ)
+        return 0;
 
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_SB))
+    uint8_t from = f_int_khz(s_cfg.dlpf);
+    uint8_t to = f_int_khz(dlpf);
+
+    // период отсчёта в тактах F_int: та же частота в новых тактах
+    uint32_t period = (uint32_t)s_cfg.smplrt_div + 1U;
+    if (to > from)
+        period *= 8U;
+    else if (to < from)
+        period = (period + 4U) / 8U; // к ближайшему
+    if (period == 0U)
+        period = 1U;
+    if (period > 256U)
+        period = 256U;
+    uint8_t div = (uint8_t)(period - 1U);
+    uint8_t old_div = s_cfg.smplrt_div;
+
+    if (to > from)
     {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
+        if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_SMPLRT_DIV, div))
+            return 0;
+        s_cfg.smplrt_div = div;
     }
 
-    // Send address + read
-    I2C_DEV->DR = (MPU6050_ADDR << 1) | 1;
-
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_ADDR))
+    if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_CONFIG, (uint8_t)dlpf))
     {
-        if (t++ > I2C_TIMEOUT)
-            goto error;
+        // вернуть делитель, иначе повтор пересчитает уже пересчитанный
+        if (to > from && I2CBus_WriteReg(&s_dev, MPU6050_REG_SMPLRT_DIV, old_div))
+            s_cfg.smplrt_div = old_div;
+        return 0;
     }
+    s_cfg.dlpf = dlpf;
 
-    (void)I2C_DEV->SR1;
-    (void)I2C_DEV->SR2;
-
-    // For 1 byte read: ACK=0 + STOP immediately
-    I2C_DEV->CR1 &= ~I2C_CR1_ACK;
-    I2C_DEV->CR1 |= I2C_CR1_STOP;
-
-    // Wait for RXNE
-    t = 0;
-    while (!(I2C_DEV->SR1 & I2C_SR1_RXNE))
+    if (to < from)
     {
-        if (t++ > I2C_TIMEOUT)
-            goto error_after_stop;
+        if (!I2CBus_WriteReg(&s_dev, MPU6050_REG_SMPLRT_DIV, div))
+            return 0;
+        s_cfg.smplrt_div = div;
     }
-
-    *val = I2C_DEV->DR; // Read byte
-
-    // Restore ACK
-    I2C_DEV->CR1 |= I2C_CR1_ACK;
     return 1;
+}
 
-error_after_stop:
-    I2C_DEV->CR1 |= I2C_CR1_STOP;
-
-error:
+const MPU6050_Config_t *MPU6050_GetConfig(void)
 {
-    uint32_t sr1 = I2C_DEV->SR1;
-    uint32_t sr2 = I2C_DEV->SR2;
-    I2C_DEV->CR1 |= I2C_CR1_STOP;
-}
-    return 0;
+    return &s_cfg;
 }
 
-/******************************************************************************
- * MPU6050_Init()
- *
- * Полная инициализация датчика:
- *   1) Сброс устройства (задержка после reset)
- *   2) Выбор источника тактирования (PLL по X-gyro — рекомендуется даташитом)
- *   3) Установка DLPF (фильтр нижних частот)
- *   4) Настройка частоты выборки (SMPLRT_DIV)
- *   5) Настройка диапазона гироскопа
- *   6) Настройка диапазона акселерометра
- *   7) Настройка прерывания Data Ready
- ******************************************************************************/
-void MPU6050_Init(void)
+float MPU6050_GetOutputRateHz(void)
 {
-    USART_Println("MPU6050_Init: start");
-
-    // 1) Reset device
-    if (!I2C_WriteReg(MPU6050_REG_PWR_MGMT_1, MPU6050_DEVICE_RESET))
-    {
-        USART_Println("MPU6050_Init: failed to write reset");
-        return;
-    }
-
-    // Задержка после reset — датчик перезапускается
-    for (volatile uint32_t i = 0; i < 500000; i++)
-        __NOP();
-
-    // 2) Clock source = PLL (X-gyro)
-    I2C_WriteReg(MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_PLL_XGYRO);
-
-    // 3) DLPF — фильтр
-    I2C_WriteReg(MPU6050_REG_CONFIG, 0x03);
-
-    // 4) Sample rate divider: 1kHz / (7+1) = 125 Hz
-    I2C_WriteReg(MPU6050_REG_SMPLRT_DIV, MPU6050_SMPLRT_7DIV);
-
-    // 5) Gyro range: ±2000 dps
-    I2C_WriteReg(MPU6050_REG_GYRO_CONFIG, MPU6050_GYRO_CONFIG_2000);
-
-    // 6) Accel range: ±8g
-    I2C_WriteReg(MPU6050_REG_ACCEL_CONFIG, MPU6050_ACCEL_CONFIG_8G);
+    return 1000.0f * (float)f_int_khz(s_cfg.dlpf) / (1.0f + (float)s_cfg.smplrt_div);
+}
 
-    // 7) Interrupt config
-    I2C_WriteReg(MPU6050_REG_INT_PIN_CFG, 0x00);
-    I2C_WriteReg(MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY);
+float MPU6050_GetAccelScale(void)
+{
+    return s_accelScale;
+}
 
-    USART_Println("MPU6050_Init: done");
+float MPU6050_GetGyroScale(void)
+{
+    return s_gyroScale;
 }
 
 /******************************************************************************
@@ -331,7 +278,7 @@ uint8_t MPU6050_ReadWhoAmI(void)
 {
     uint8_t id = 0;
 
-    if (!I2C_Read1(MPU6050_REG_WHO_AM_I, &id))
+    if (!I2CBus_Read(&s_dev, MPU6050_REG_WHO_AM_I, &id, 1))
     {
         USART_Println("MPU6050_ReadWhoAmI: I2C_Read failed");
         return 0;
@@ -343,65 +290,198 @@ uint8_t MPU6050_ReadWhoAmI(void)
     return id;
 }
 
+/* Общий хвост чтения отсчёта: big endian → little endian на месте
+ * (пары (ax,ay) (az,T) (gx,gy), затем gz), трасса и лог.
+ */
+static void sample_finish(ImuSample_t *s)
+{
+    imu_st32(&s->raw[IMU_AX], IMU_REV16(imu_ld32(&s->raw[IMU_AX])));
+    imu_st32(&s->raw[IMU_AZ], IMU_REV16(imu_ld32(&s->raw[IMU_AZ])));
+    imu_st32(&s->raw[IMU_GX], IMU_REV16(imu_ld32(&s->raw[IMU_GX])));
+    s->raw[IMU_GZ] = (int16_t)IMU_REV16((uint16_t)s->raw[IMU_GZ]);
+
+    TRACE(TRACE_EV_IMU_ACC, s->raw[IMU_AZ], TRACE_PACK16(s->raw[IMU_AX], s->raw[IMU_AY]));
+    TRACE(TRACE_EV_IMU_GYRO, s->raw[IMU_GZ], TRACE_PACK16(s->raw[IMU_GX], s->raw[IMU_GY]));
+    SLOG(SLOG_IMU, (const SlogImu_t *)s->raw);
+}
+
 /******************************************************************************
- * MPU6050_ReadRaw()
+ * MPU6050_ReadSample()
  *
- * Читает 14 последовательных регистров:
+ * Читает 14 последовательных регистров ОДНИМ burst-чтением:
  *
  *   ACCEL_X/Y/Z (6 байтов)
  *   TEMP        (2 байта)
  *   GYRO_X/Y/Z  (6 байтов)
  *
- * ВНИМАНИЕ: данная реализация читает 14 байтов
- *           14 ОТДЕЛЬНЫМИ транзакциями I2C.
+ * Байты ложатся прямо в s->raw[], затем каждое слово разворачивается
+ * на месте REV16 (3 слова + последнее полуслово).
  *
- * Это медленно, но надёжно.
+ * Отметка времени — перед началом транзакции: датчик защёлкивает
+ * данные на старте burst-чтения.
+ ******************************************************************************/
+uint8_t MPU6050_ReadSample(ImuSample_t *s)
+{
+    PERF_BEGIN(PERF_IMU_READ);
+
+    s->seq = s_sampleSeq++;
+    s->t_us = Time_Us();
+
+    if (!I2CBus_Read(&s_dev, MPU6050_REG_ACCEL_XOUT_H, (uint8_t *)s->raw, sizeof(s->raw)))
+    {
+        USART_Println("MPU6050_ReadSample: I2C burst failed");
+        return 0;
+    }
+
+    sample_finish(s);
+
+    PERF_END(PERF_IMU_READ);
+    return 1;
+}
+
+/******************************************************************************
+ * MPU6050_SubmitSample(x, s, deadline_us)
+ *
+ * То же чтение, но через очередь менеджера шины: высокий приоритет,
+ * дедлайн и I2C_XFER_DROP_LATE — если шину не удалось получить вовремя,
+ * отсчёт отбрасывается (x->status = DROPPED), а не читается с опозданием.
  *
- * На выходе:
- *   accel[0..2] = акселерометр (сырые значения)
- *   gyro [0..2] = гироскоп     (сырые значения)
- *   temp        = температура   (сырой int16_t)
+ * Номер расходуется при постановке, поэтому отброшенный отсчёт виден
+ * потребителю как пропуск в seq. Отметка времени — фактическое начало
+ * транзакции на шине (x->start_us), а не момент постановки.
+ *
+ * Готовность — x->status == I2C_XFER_DONE после I2CBus_Poll(). Пока
+ * x в очереди (QUEUED), повторный вызов возвращает 0 и не меняет ни x,
+ * ни отсчёт, привязанный к ней.
+ ******************************************************************************/
+static void sample_done(I2CXfer_t *x)
+{
+    ImuSample_t *s = (ImuSample_t *)x->ctx;
+
+    if (x->status != I2C_XFER_DONE)
+        return;
+
+    s->t_us = x->start_us;
+    sample_finish(s);
+}
+
+uint8_t MPU6050_SubmitSample(I2CXfer_t *x, ImuSample_t *s, uint32_t deadline_us)
+{
+    // транзакция ещё в очереди: шина держит её buf/ctx — ничего не трогаем
+    if (x->status == I2C_XFER_QUEUED)
+        return 0;
+
+    x->dev = &s_dev;
+    x->buf = (uint8_t *)s->raw;
+    x->len = sizeof(s->raw);
+    x->reg = MPU6050_REG_ACCEL_XOUT_H;
+    x->prio = I2C_PRIO_HIGH;
+    x->flags = I2C_XFER_DROP_LATE;
+    x->deadline_us = deadline_us;
+    x->done = sample_done;
+    x->ctx = s;
+
+    if (!I2CBus_Submit(x))
+        return 0;
+
+    s->seq = s_sampleSeq++;
+    return 1;
+}
+
+/******************************************************************************
+ * MPU6050_ReadRaw()
+ *
+ * Прежний интерфейс поверх MPU6050_ReadSample(): раскладывает отсчёт
+ * по массивам вызывающего. При ошибке массивы не трогаются.
  ******************************************************************************/
 void MPU6050_ReadRaw(int16_t accel[3], int16_t gyro[3], int16_t *temp)
 {
-    uint8_t b;
-    uint8_t ok = 1;
-    uint8_t buf[14];
+    ImuSample_t s;
+
+    if (!MPU6050_ReadSample(&s))
+        return;
+
+    accel[0] = s.raw[IMU_AX];
+    accel[1] = s.raw[IMU_AY];
+    accel[2] = s.raw[IMU_AZ];
+
+    if (temp)
+        *temp = s.raw[IMU_TEMP];
 
-    uint8_t regs[14] = {
-        0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x40,
-        0x41, 0x42,
-        0x43, 0x44, 0x45, 0x46, 0x47, 0x48};
+    gyro[0] = s.raw[IMU_GX];
+    gyro[1] = s.raw[IMU_GY];
+    gyro[2] = s.raw[IMU_GZ];
+}
 
-    // Читаем 14 байтов по одному
-    for (int i = 0; i < 14; i++)
+/******************************************************************************
+ * Пакетный перевод отсчётов
+ *
+ * Смещение гироскопа вычитается в LSB до масштабирования: для пары
+ * (gx,gy) — одна QSUB16, для gz — вторая (с насыщением, как у датчика).
+ ******************************************************************************/
+void MPU6050_ToPhys(const ImuSample_t *in, ImuPhys_t *out, uint32_t n,
+                    const int16_t gyro_bias_lsb[3])
+{
+    uint32_t bxy = 0, bz = 0;
+    if (gyro_bias_lsb)
     {
-        if (!I2C_Read1(regs[i], &b))
-        {
-            ok = 0;
-            break;
-        }
-        buf[i] = b;
+        bxy = IMU_K_LO(gyro_bias_lsb[0]) | IMU_K_HI(gyro_bias_lsb[1]);
+        bz = IMU_K_LO(gyro_bias_lsb[2]);
     }
 
-    if (!ok)
+    const float ka = s_accelScale;
+    const float kg = s_gyroScale;
+
+    for (uint32_t i = 0; i < n; i++)
     {
-        USART_Println("MPU6050_ReadRaw: I2C_Read failed");
-        return;
+        const int16_t *r = in[i].raw;
+        uint32_t gxy = IMU_QSUB16(imu_ld32(&r[IMU_GX]), bxy);
+        uint32_t gz = IMU_QSUB16((uint16_t)r[IMU_GZ], bz);
+
+        out[i].accel_g[0] = (float)r[IMU_AX] * ka;
+        out[i].accel_g[1] = (float)r[IMU_AY] * ka;
+        out[i].accel_g[2] = (float)r[IMU_AZ] * ka;
+        out[i].temp_c = 36.53f + (float)r[IMU_TEMP] * MPU6050_C_PER_LSB_TEMP;
+        out[i].gyro_dps[0] = (float)(int16_t)gxy * kg;
+        out[i].gyro_dps[1] = (float)(int16_t)(gxy >> 16) * kg;
+        out[i].gyro_dps[2] = (float)(int16_t)gz * kg;
+        out[i].t_us = in[i].t_us;
     }
+}
 
-    // Склейка 16-битных значений (big endian → little endian)
-    accel[0] = (buf[0] << 8) | buf[1];
-    accel[1] = (buf[2] << 8) | buf[3];
-    accel[2] = (buf[4] << 8) | buf[5];
+void MPU6050_ToFixed(const ImuSample_t *in, ImuFixed_t *out, uint32_t n,
+                     const int16_t gyro_bias_lsb[3])
+{
+    uint32_t bxy = 0, bz = 0;
+    if (gyro_bias_lsb)
+    {
+        bxy = IMU_K_LO(gyro_bias_lsb[0]) | IMU_K_HI(gyro_bias_lsb[1]);
+        bz = IMU_K_LO(gyro_bias_lsb[2]);
+    }
 
-    int16_t t = (buf[6] << 8) | buf[7];
-    if (temp)
-        *temp = t;
+    // множители на младшее/старшее полуслово пары
+    const uint32_t ka_lo = IMU_K_LO(s_accelQ16), ka_hi = IMU_K_HI(s_accelQ16);
+    const uint32_t kt_hi = IMU_K_HI(MPU6050_TEMP_CDEG_Q16);
+    const uint32_t kg_lo = IMU_K_LO(s_gyroQ8), kg_hi = IMU_K_HI(s_gyroQ8);
+    const int32_t rnd16 = 1 << 15, rnd8 = 1 << 7;
 
-    gyro[0] = (buf[8] << 8) | buf[9];
-    gyro[1] = (buf[10] << 8) | buf[11];
-    gyro[2] = (buf[12] << 8) | buf[13];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        const int16_t *r = in[i].raw;
+        uint32_t axy = imu_ld32(&r[IMU_AX]);
+        uint32_t azt = imu_ld32(&r[IMU_AZ]);
+        uint32_t gxy = IMU_QSUB16(imu_ld32(&r[IMU_GX]), bxy);
+        uint32_t gz = IMU_QSUB16((uint16_t)r[IMU_GZ], bz);
+
+        out[i].accel_mg[0] = IMU_SMLAD(axy, ka_lo, rnd16) >> 16;
+        out[i].accel_mg[1] = IMU_SMLAD(axy, ka_hi, rnd16) >> 16;
+        out[i].accel_mg[2] = IMU_SMLAD(azt, ka_lo, rnd16) >> 16;
+        out[i].temp_cdeg = MPU6050_TEMP_CDEG_OFFSET + (IMU_SMLAD(azt, kt_hi, rnd16) >> 16);
+        out[i].gyro_mdps[0] = IMU_SMLAD(gxy, kg_lo, rnd8) >> 8;
+        out[i].gyro_mdps[1] = IMU_SMLAD(gxy, kg_hi, rnd8) >> 8;
+        out[i].gyro_mdps[2] = IMU_SMLAD(gz, kg_lo, rnd8) >> 8;
+        out[i].t_us = in[i].t_us;
+    }
 }
 
 /******************************************************************************
@@ -410,19 +490,19 @@ void MPU6050_ReadRaw(int16_t accel[3], int16_t gyro[3], int16_t *temp)
 
 float MPU6050_AccelLSB_to_g(int16_t raw)
 {
-    // Для диапазона ±8g масштаб ≈ 4096 LSB/g
-    return (float)raw / 4096.0f;
+    // Масштаб текущего диапазона (по умолчанию ±8g → 4096 LSB/g)
+    return (float)raw * s_accelScale;
 }
 
 float MPU6050_GyroLSB_to_dps(int16_t raw)
 {
-    // Для диапазона ±2000 dps → 16.4 LSB/dps
-    return (float)raw / 16.4f;
+    // Масштаб текущего диапазона (по умолчанию ±2000 dps → 16.4 LSB/dps)
+    return (float)raw * s_gyroScale;
 }
 
 float MPU6050_TempLSB_to_C(int16_t raw)
 {
-    return 36.53f + raw / 340.0f;
+    return 36.53f + (float)raw * MPU6050_C_PER_LSB_TEMP;
 }
 
 /******************************************************************************
@@ -439,20 +519,21 @@ float MPU6050_TempLSB_to_C(int16_t raw)
 void MPU6050_CalibrateGyro(float *bias_x, float *bias_y, float *bias_z)
 {
     int32_t sum_x = 0, sum_y = 0, sum_z = 0;
-    int16_t accel[3], gyro[3], temp;
+    // при ошибке I2C MPU6050_ReadRaw массивы не трогает — в сумму идут нули
+    int16_t accel[3] = {0}, gyro[3] = {0}, temp = 0;
 
     const int N = 5000;
 
     for (int i = 0; i < N; i++)
     {
+        Deadline_Alive(); // ~5000 чтений — дольше таймаута IWDG
         MPU6050_ReadRaw(accel, gyro, &temp);
 
         sum_x += gyro[0];
         sum_y += gyro[1];
         sum_z += gyro[2];
 
-        for (volatile uint32_t d = 0; d < 2000; d++)
-            __NOP(); // небольшая задержка
+        Time_DelayUs(50); // небольшая задержка
     }
 
     if (bias_x)
@@ -466,8 +547,9 @@ void MPU6050_CalibrateGyro(float *bias_x, float *bias_y, float *bias_z)
 /******************************************************************************
  *                           КАК РАБОТАЕТ I2C НА STM32
  *
- * Данный драйвер I2C реализован в полностью «ручном» (bare-metal) виде,
- * используя регистры I2C_CR1/CR2/SR1/SR2 и последовательные проверки флагов.
+ * Обмен с шиной — через менеджер i2c_bus.h; сама шина реализована
+ * в полностью «ручном» (bare-metal) виде в i2c_bus_hw.c, на регистрах
+ * I2C_CR1/CR2/SR1/SR2 и последовательных проверках флагов.
  *
  * Ниже описаны ключевые понятия: START, RESTART, STOP, ACK, SB, ADDR, BTF,
  * TXE, RXNE — и логика, по которой работает каждая функция чтения/записи.
@@ -621,17 +703,18 @@ void MPU6050_CalibrateGyro(float *bias_x, float *bias_y, float *bias_z)
  *  ✔ RESTART реализован корректно,
  *  ✔ ACK включается/выключается в нужные моменты,
  *  ✔ все ошибки логируются через USART,
- *  ✔ не используем длинные burst-последовательности (меньше точек сбоя),
+ *  ✔ отсчёт — одно burst-чтение 14 байтов (MPU6050_ReadSample): все оси
+ *    из одного момента, одна транзакция вместо отдельной на каждую ось,
  *  ✔ ручное управление даёт нам полный контроль над протоколом.
  *
  * ---------------------------------------------------------------------------
  * 11. Что можно улучшить (по желанию)
  * ---------------------------------------------------------------------------
  *
- *  • Burst-чтение 14 байтов за 1 транзакцию (ускорение ×10)
- *  • DMA-чтение
+ *  • DMA-чтение burst-а: ядро не ждёт ~1.6 мс на 100 кГц
  *  • Обработка ошибок SR1.AF (NACK) более детально
- *  • Стейт-машина для прозрачных ошибок
+ *  • Транзакции по прерываниям I2C вместо ожидания флагов (очередь
+ *    I2CBus_Submit уже есть, но каждая транзакция в Poll блокирующая)
  *
  * Но текущий драйвер *идеально подходит для надёжной первичной работы*.
  *
@@ -0,0 +1,416 @@
+// bench.c
+#include "bench.h"
+#include "perf.h"
+#include "usart.h"
+#include "pid.h"
+#include "speed_control.h"
+#include "heading_control.h"
+#include "wheel_estimator.h"
+#include "gyro_tempcomp.h"
+#include "MPU6050.h"
+#include "odometry.h"
+#include "sensor_log.h"
+#include "trace.h"
+#include "fast_math.h"
+#include "encoder.h"
+#include "grid_plan.h"
+#include "deadline.h"
+#include "stm32f4xx.h"
+#if defined(__NEWLIB__) || defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);       // может быть NULL
+    void (*run)(uint32_t n);   // n операций
+    uint32_t iters;            // операций на замер
+} BenchCase_t;
+
+/* Входы: общие таблицы, заполняются заново перед каждым случаем */
+static float s_inA[BENCH_INPUTS];
+static float s_inB[BENCH_INPUTS];
+static int16_t s_inI16[BENCH_INPUTS];
+static uint32_t s_rng;
+
+/* Результаты уходят сюда, чтобы компилятор не выкинул вычисления */
+static volatile float s_sink;
+
+#define BENCH_MASK (BENCH_INPUTS - 1U)
+
+/* Счётчик тактов. Хостовая сборка (Tests/bench_host) подставляет свой:
+ * на ПК DWT — просто структура в ОЗУ
+ */
+#ifndef BENCH_CYCLES
+#define BENCH_CYCLES() (DWT->CYCCNT)
+#endif
+
+#ifndef BENCH_TARGET
+#define BENCH_TARGET "core"
+#endif
+
+/* --------------------------------------------------------------------------
+ * Входные данные
+ * -------------------------------------------------------------------------- */
+
+static uint32_t bench_rand(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng = x;
+    return x;
+}
+
+/* Равномерно в [lo, hi) */
+static float bench_uniform(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(bench_rand() >> 8) * (1.0f / 16777216.0f);
+}
+
+static void bench_fill(float a_lo, float a_hi, float b_lo, float b_hi)
+{
+    for (uint32_t i = 0; i < BENCH_INPUTS; i++)
+    {
+        s_inA[i] = bench_uniform(a_lo, a_hi);
+        s_inB[i] = bench_uniform(b_lo, b_hi);
+        s_inI16[i] = (int16_t)bench_rand();
+    }
+}
+
+static int32_t bench_heap_used(void)
+{
+#if defined(__NEWLIB__)
+    return (int32_t)mallinfo().uordblks;
+#elif defined(__GLIBC__)
+    return (int32_t)mallinfo2().uordblks; // хостовая сборка (Tests/bench_host)
+#else
+    return -1;
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * Случаи
+ * -------------------------------------------------------------------------- */
+
+static PID_t s_pid;
+static WheelEst_t s_est;
+static GyroTC_t s_gtc;
+
+static void setup_pid(void)
+{
+    bench_fill(0.0f, 5.0f, 0.0f, 5.0f); // цель / измерение, об/с
+    PID_Init(&s_pid, 8.0f, 1.0f, 0.1f, 0.0f, 99.0f);
+}
+
+static void run_pid(uint32_t n)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < n; i++)
+        acc += PID_Update(&s_pid, s_inA[i & BENCH_MASK], s_inB[i & BENCH_MASK], 0.01f);
+    s_sink = acc;
+}
+
+static void setup_speed(void)
+{
+    SpeedControl_Init(); // цель 0 — PWM остаётся 0
+}
+
+static void run_speed(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        SpeedControl_Update(0.01f);
+}
+
+static void setup_heading(void)
+{
+    bench_fill(-180.0f, 180.0f, 0.5f, 3.0f);
+    Heading_SetTarget(0.0f);
+}
+
+static void run_heading(uint32_t n)
+{
+    float l, r, acc = 0.0f;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Heading_Compute(s_inA[i & BENCH_MASK], s_inB[i & BENCH_MASK], &l, &r);
+        acc += l - r;
+    }
+    s_sink = acc;
+}
+
+static void setup_wheel_est(void)
+{
+    bench_fill(0.0f, 6.0f, 0.0f, 99.0f);
+    WheelEst_Init(&s_est, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+}
+
+static void run_wheel_est(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        WheelEst_Update(&s_est, (uint32_t)s_inA[i & BENCH_MASK], (int16_t)s_inB[i & BENCH_MASK], 0.01f);
+    s_sink = WheelEst_Speed(&s_est);
+}
+
+static void setup_gyro_tc(void)
+{
+    bench_fill(-1.0f, 1.0f, -1.0f, 1.0f);
+    GyroTC_Init(&s_gtc);
+}
+
+static void run_gyro_tc(uint32_t n)
+{
+    float g[3];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g[0] = s_inA[i & BENCH_MASK];
+        g[1] = s_inB[i & BENCH_MASK];
+        g[2] = g[0] - g[1];
+        // температура медленно ползёт: раз в 64 отсчёта пересчёт смещения
+        GyroTC_Process(&s_gtc, (int16_t)(-2000 + (int16_t)((i >> 6) * 40U)), g, 1U);
+    }
+    s_sink = g[2];
+}
+
+/* Слияние IMU за один отсчёт — цепочка main_gyro.c: сырые слова →
+ * физические единицы → термокомпенсация смещения → интегрирование курса.
+ * Слова отсчёта берутся из s_inI16 со сдвигом, температура ползёт
+ * медленно, как в gyro_tc_process.
+ */
+static float s_yaw;
+
+static void setup_fusion(void)
+{
+    bench_fill(-1.0f, 1.0f, -1.0f, 1.0f);
+    GyroTC_Init(&s_gtc);
+    s_yaw = 0.0f;
+}
+
+static void run_fusion(uint32_t n)
+{
+    ImuSample_t imu = {0};
+    ImuPhys_t phys;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t k = 0; k < IMU_RAW_COUNT; k++)
+            imu.raw[k] = s_inI16[(i + k) & BENCH_MASK];
+        imu.raw[IMU_TEMP] = (int16_t)(-2000 + (int16_t)((i >> 6) * 40U));
+
+        MPU6050_ToPhys(&imu, &phys, 1U, NULL);
+        GyroTC_Process(&s_gtc, imu.raw[IMU_TEMP], phys.gyro_dps, 1U);
+        s_yaw = FM_WrapDeg180(s_yaw + phys.gyro_dps[2] * 0.005f);
+    }
+    s_sink = s_yaw;
+}
+
+static Pose_t s_savedPose;
+
+static void setup_odom(void)
+{
+    bench_fill(0.0f, 4.0f, 0.0f, 4.0f); // тики за шаг регулятора
+    Odom_GetPose(&s_savedPose);
+}
+
+static void run_odom(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        Odom_Integrate((int32_t)s_inA[i & BENCH_MASK], (int32_t)s_inB[i & BENCH_MASK]);
+    Odom_SetPose(&s_savedPose);
+}
+
+static void setup_slog(void)
+{
+    bench_fill(0.0f, 5.0f, 0.0f, 5.0f);
+    SensorLog_Init(); // пустое кольцо: меряем кодирование, а не отбрасывание
+}
+
+static void run_slog(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        SlogCmd_t c = {s_inA[i & BENCH_MASK], s_inB[i & BENCH_MASK], 1, 1};
+        SensorLog_Write(SLOG_CMD, &c, sizeof(c));
+    }
+}
+
+static void run_trace(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        Trace_Record(TRACE_EV_MARK, (uint16_t)i, (uint32_t)s_inI16[i & BENCH_MASK]);
+}
+
+static void setup_angles(void)
+{
+    bench_fill(-FM_TWO_PI, FM_TWO_PI, -1.0f, 1.0f);
+}
+
+static void run_sin(uint32_t n)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < n; i++)
+        acc += FM_Sin(s_inA[i & BENCH_MASK]);
+    s_sink = acc;
+}
+
+static void run_atan2(uint32_t n)
+{
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < n; i++)
+        acc += FM_Atan2(s_inB[i & BENCH_MASK], s_inA[i & BENCH_MASK]);
+    s_sink = acc;
+}
+
+static float s_scaled[BENCH_INPUTS];
+
+/* Одна операция — один отсчёт (пакетами по BENCH_INPUTS) */
+static void run_scale_i16(uint32_t n)
+{
+    for (uint32_t done = 0; done < n; done += BENCH_INPUTS)
+        FM_ScaleI16(s_inI16, s_scaled, BENCH_INPUTS, 0.061f);
+    s_sink = s_scaled[0];
+}
+
+/* Случайная карта: ~25% клеток занято, пары старт/цель — свободные клетки.
+ * Одна операция — одно планирование (пары по кругу, часть — без пути:
+ * тогда волна / A* обходят всю связную область).
+ */
+#define BENCH_GRID_PAIRS 16U
+#define BENCH_GRID_FILL_PCT 25U
+
+static GridCell_t s_gridPairs[2U * BENCH_GRID_PAIRS];
+static GridCell_t s_gridPath[GRID_CELLS];
+
+static GridCell_t bench_free_cell(void)
+{
+    GridCell_t c;
+    do
+    {
+        c.x = (uint8_t)(bench_rand() % GRID_W);
+        c.y = (uint8_t)(bench_rand() % GRID_H);
+    } while (Grid_IsBlocked(c.x, c.y));
+    return c;
+}
+
+static void setup_grid(void)
+{
+    Grid_Clear();
+    for (uint32_t y = 0; y < GRID_H; y++)
+        for (uint32_t x = 0; x < GRID_W; x++)
+            if (bench_rand() % 100U < BENCH_GRID_FILL_PCT)
+                Grid_SetBlocked(x, y, 1);
+
+    for (uint32_t i = 0; i < 2U * BENCH_GRID_PAIRS; i++)
+        s_gridPairs[i] = bench_free_cell();
+}
+
+static void run_grid(GridAlgo algo, uint32_t n)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        const GridCell_t *p = &s_gridPairs[2U * (i % BENCH_GRID_PAIRS)];
+        acc += Grid_Plan(algo, p[0], p[1], s_gridPath, GRID_CELLS);
+    }
+    s_sink = (float)acc;
+}
+
+static void run_grid_astar(uint32_t n)
+{
+    run_grid(GRID_ASTAR, n);
+}
+
+static void run_grid_flood(uint32_t n)
+{
+    run_grid(GRID_FLOOD, n);
+}
+
+/* Кольцо sensor_log — 4 КБ: 128 кадров по 20 байт помещаются целиком */
+static const BenchCase_t s_cases[] = {
+    {"pid_update", setup_pid, run_pid, BENCH_ITERS},
+    {"speed_update", setup_speed, run_speed, BENCH_ITERS},
+    {"heading_compute", setup_heading, run_heading, BENCH_ITERS},
+    {"wheel_est_update", setup_wheel_est, run_wheel_est, BENCH_ITERS},
+    {"gyro_tc_process", setup_gyro_tc, run_gyro_tc, BENCH_ITERS},
+    {"imu_fusion", setup_fusion, run_fusion, BENCH_ITERS},
+    {"odom_integrate", setup_odom, run_odom, BENCH_ITERS},
+    {"slog_write_cmd", setup_slog, run_slog, 128U},
+    {"trace_record", setup_angles, run_trace, BENCH_ITERS},
+    {"fm_sin", setup_angles, run_sin, BENCH_ITERS},
+    {"fm_atan2", setup_angles, run_atan2, BENCH_ITERS},
+    {"fm_scale_i16", setup_angles, run_scale_i16, 4U * BENCH_INPUTS},
+    {"grid_astar_32", setup_grid, run_grid_astar, BENCH_GRID_PAIRS},
+    {"grid_flood_32", setup_grid, run_grid_flood, BENCH_GRID_PAIRS},
+};
+
+#define BENCH_CASE_COUNT (sizeof(s_cases) / sizeof(s_cases[0]))
+
+/* --------------------------------------------------------------------------
+ * Прогон
+ * -------------------------------------------------------------------------- */
+
+void Bench_RunAll(void)
+{
+    // DWT уже включён Perf_Init(); повторное включение безвредно
+    SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk);
+    SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk);
+
+    USART_Print("{\"bench\":\"" BENCH_TARGET "\",\"cpu_hz\":");
+    USART_PrintInt((int32_t)SystemCoreClock);
+    USART_Print(",\"seed\":");
+    USART_PrintInt((int32_t)BENCH_SEED);
+    USART_Print(",\"results\":[");
+
+    for (uint32_t c = 0; c < BENCH_CASE_COUNT; c++)
+    {
+        const BenchCase_t *bc = &s_cases[c];
+        uint32_t best = 0xFFFFFFFFUL;
+
+        int32_t heap0 = bench_heap_used();
+
+        for (uint32_t r = 0; r < BENCH_REPEATS; r++)
+        {
+            Deadline_Alive();
+            // каждый замер — с одного и того же зерна, независимо от порядка
+            s_rng = BENCH_SEED;
+            if (bc->setup)
+                bc->setup();
+            bc->run(BENCH_WARMUP);
+
+            uint32_t t0 = BENCH_CYCLES();
+            bc->run(bc->iters);
+            uint32_t dt = BENCH_CYCLES() - t0;
+
+            if (dt < best)
+                best = dt;
+        }
+
+        int32_t heap1 = bench_heap_used();
+
+        float cyc = (float)best / (float)bc->iters;
+        float ns = cyc * 1e9f / (float)SystemCoreClock;
+
+        USART_Print(c ? ",{\"name\":\"" : "{\"name\":\"");
+        USART_Print(bc->name);
+        USART_Print("\",\"cycles\":");
+        USART_PrintFloat(cyc, 1);
+        USART_Print(",\"ns\":");
+        USART_PrintFloat(ns, 1);
+        USART_Print(",\"heap\":");
+        USART_PrintInt((heap0 < 0) ? -1 : heap1 - heap0);
+        USART_Print("}");
+    }
+
+    USART_Println("]}");
+
+    // состояние модулей после прогона — как после инициализации
+    // (trace_record затёр самописец метками — чистим его целиком,
+    // случаи grid_* оставили случайную карту)
+    SpeedControl_Init();
+    SensorLog_Init();
+    Trace_Clear();
+    Grid_Clear();
+}
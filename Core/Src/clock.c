@@ -17,8 +17,13 @@ void Clock_Init(void)
     MODIFY_REG(FLASH->ACR,
                FLASH_ACR_LATENCY,
                FLASH_ACR_LATENCY_5WS); // 5 wait states
-    /* Можно дополнительно включить prefetch / I-cache / D-cache (по желанию):
-       SET_BIT(FLASH->ACR, FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN); */
+    /* ART-акселератор: prefetch + I-cache + D-cache.
+       Без него каждая выборка из flash стоит 5 wait states.
+       Кэши сбрасываем только в выключенном состоянии (RM0090, 3.5.2). */
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+    SET_BIT(FLASH->ACR, FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+    CLEAR_BIT(FLASH->ACR, FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+    SET_BIT(FLASH->ACR, FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN);
     /* 4. Настраиваем делители шин: AHB, APB1, APB2
        - AHB (HCLK)  = SYSCLK / 1  = 168 МГц  (максимум)
        - APB1 (PCLK1)= HCLK  / 4   = 42  МГц  (максимум для APB1)
@@ -0,0 +1,198 @@
+// deadline.c
+#include "deadline.h"
+#include "motor.h"
+#include "init.h"
+#include "trace.h"
+#include "usart.h"
+#include "mem_sections.h"
+
+#define IWDG_KEY_RELOAD 0xAAAAU
+#define IWDG_KEY_ENABLE 0xCCCCU
+#define IWDG_KEY_ACCESS 0x5555U
+
+/* --------------------------------------------------------------------------
+ * Состояние
+ * -------------------------------------------------------------------------- */
+
+static DeadlineStats_t s_stats[DL_TASK_COUNT] CCMRAM;
+static volatile uint32_t s_last[DL_TASK_COUNT] CCMRAM;    // время последней отметки
+static volatile uint8_t s_enabled[DL_TASK_COUNT] CCMRAM;
+static volatile uint8_t s_nearFlag[DL_TASK_COUNT] CCMRAM; // near miss уже посчитан в этом интервале
+static volatile uint8_t s_tripped CCMRAM = 0;
+static volatile uint8_t s_alive CCMRAM = 0; // Deadline_Alive() после прошлого сброса IWDG
+static uint8_t s_wdgReset CCMRAM = 0;
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+static void Deadline_IWDG_Init(void)
+{
+    // При остановке ядра отладчиком IWDG тоже стоит
+    SET_BIT(DBGMCU->APB1FZ, DBGMCU_APB1_FZ_DBG_IWDG_STOP);
+
+    WRITE_REG(IWDG->KR, IWDG_KEY_ENABLE); // запуск (включает и LSI)
+    WRITE_REG(IWDG->KR, IWDG_KEY_ACCESS); // доступ к PR/RLR
+    WRITE_REG(IWDG->PR, IWDG_PR_PR_1);    // /32 → 1 кГц
+    WRITE_REG(IWDG->RLR, DEADLINE_IWDG_MS);
+
+    while (READ_BIT(IWDG->SR, IWDG_SR_PVU | IWDG_SR_RVU))
+    {
+    }
+
+    WRITE_REG(IWDG->KR, IWDG_KEY_RELOAD);
+}
+
+/* --------------------------------------------------------------------------
+ * Интерфейс
+ * -------------------------------------------------------------------------- */
+void Deadline_Init(void)
+{
+    // Причина прошлого сброса; флаги очищаем, чтобы следующий был виден
+    s_wdgReset = READ_BIT(RCC->CSR, RCC_CSR_IWDGRSTF) ? 1U : 0U;
+    SET_BIT(RCC->CSR, RCC_CSR_RMVF);
+
+    for (uint32_t i = 0; i < DL_TASK_COUNT; i++)
+    {
+        s_enabled[i] = 0;
+        s_nearFlag[i] = 0;
+        s_last[i] = g_msTicks;
+        s_stats[i] = (DeadlineStats_t){0, 0, 0, 0, 0};
+    }
+    s_tripped = 0;
+    s_alive = 1; // инициализация идёт в main — первый интервал засчитан
+
+    Deadline_IWDG_Init();
+}
+
+void Deadline_Enable(DeadlineTask task, uint32_t budget_ms)
+{
+    if (task >= DL_TASK_COUNT)
+        return;
+
+    s_stats[task].budget_ms = budget_ms;
+    s_last[task] = g_msTicks;
+    s_nearFlag[task] = 0;
+    s_enabled[task] = 1;
+}
+
+void Deadline_Disable(DeadlineTask task)
+{
+    if (task < DL_TASK_COUNT)
+        s_enabled[task] = 0;
+}
+
+RAMFUNC void Deadline_CheckIn(DeadlineTask task)
+{
+    if (task >= DL_TASK_COUNT)
+        return;
+
+    uint32_t now = g_msTicks;
+    uint32_t gap = now - s_last[task];
+    DeadlineStats_t *st = &s_stats[task];
+
+    if (s_enabled[task] && gap > st->max_gap_ms)
+        st->max_gap_ms = gap;
+
+    st->checkins++;
+    s_last[task] = now;
+    s_nearFlag[task] = 0;
+}
+
+void Deadline_Alive(void)
+{
+    s_alive = 1;
+}
+
+RAMFUNC void Deadline_Tick(void)
+{
+    if (s_tripped)
+        return; // IWDG не сбрасываем — ждём перезагрузки
+
+    uint32_t now = g_msTicks;
+    uint8_t watched = 0;
+
+    for (uint32_t i = 0; i < DL_TASK_COUNT; i++)
+    {
+        if (!s_enabled[i])
+            continue;
+        watched = 1;
+
+        DeadlineStats_t *st = &s_stats[i];
+        uint32_t gap = now - s_last[i];
+
+        if (gap > st->budget_ms)
+        {
+            st->misses++;
+            TRACE(TRACE_EV_DEADLINE, i, gap);
+            Deadline_Failsafe((uint8_t)(i + 1U));
+            return;
+        }
+
+        if (!s_nearFlag[i] && gap * 100U > st->budget_ms * DEADLINE_NEAR_PCT)
+        {
+            s_nearFlag[i] = 1;
+            st->near_miss++;
+        }
+    }
+
+    // без задач живость main подтверждает только его собственная отметка
+    if (!watched && !s_alive)
+        return;
+    s_alive = 0;
+
+    WRITE_REG(IWDG->KR, IWDG_KEY_RELOAD);
+}
+
+void Deadline_Failsafe(uint8_t reason)
+{
+    Motor_EmergencyOff();
+
+    if (!s_tripped)
+    {
+        s_tripped = reason ? reason : 0xFFU;
+        TRACE(TRACE_EV_DEADLINE, reason, 0xFFFFFFFFUL);
+    }
+}
+
+uint8_t Deadline_Tripped(void)
+{
+    return s_tripped;
+}
+
+uint8_t Deadline_WasWatchdogReset(void)
+{
+    return s_wdgReset;
+}
+
+const DeadlineStats_t *Deadline_GetStats(DeadlineTask task)
+{
+    return (task < DL_TASK_COUNT) ? &s_stats[task] : 0;
+}
+
+void Deadline_Report(void)
+{
+    static const char *const names[DL_TASK_COUNT] = {"control", "motion", "imu"};
+
+    USART_Print("#DEADLINE wdg_reset=");
+    USART_PrintInt(s_wdgReset);
+    USART_Print(" tripped=");
+    USART_PrintlnInt(s_tripped);
+
+    for (uint32_t i = 0; i < DL_TASK_COUNT; i++)
+    {
+        const DeadlineStats_t *st = &s_stats[i];
+
+        USART_Print(names[i]);
+        USART_Print(" budget_ms=");
+        USART_PrintInt((int32_t)st->budget_ms);
+        USART_Print(" checkins=");
+        USART_PrintInt((int32_t)st->checkins);
+        USART_Print(" max_gap_ms=");
+        USART_PrintInt((int32_t)st->max_gap_ms);
+        USART_Print(" near=");
+        USART_PrintInt((int32_t)st->near_miss);
+        USART_Print(" miss=");
+        USART_PrintlnInt((int32_t)st->misses);
+    }
+}
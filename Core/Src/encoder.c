@@ -6,9 +6,10 @@
 //  - Инициализацию GPIO (PA5, PA6) как входов с pull-up
 //  - Настройку EXTI5 и EXTI6 на оба фронта
 //  - Защиту от дребезга по времени
-//  - Подсчёт:
-//        * тиков за интервал (GetAndResetTicks)
-//        * суммарных тиков с момента старта
+//  - Подсчёт суммарных тиков с момента старта под seqlock:
+//        * согласованный снимок пары L/R без __disable_irq()
+//        * неразрушающие приращения через курсоры (любое число читателей)
+//        * GetAndResetTicks — совместимость, поверх внутреннего курсора
 //
 // Логика детекции:
 //   - EXTI вызывает IRQ на любом фронте.
@@ -18,6 +19,11 @@
 //
 
 #include "encoder.h"
+#include "trace.h"
+#include "mem_sections.h"
+#include "perf.h"
+#include "seqlock.h"
+#include "isr_latency.h"
 
 extern volatile uint32_t g_msTicks; // Глобальная миллисекундная метка SysTick
 
@@ -25,21 +31,23 @@ extern volatile uint32_t g_msTicks; // Глобальная миллисекун
  * Переменные модуля (статические)
  * -------------------------------------------------------------------------- */
 
-// Счётчики тиков за последний "интервал" (между вызовами GetAndResetTicks)
-static volatile uint32_t s_leftTicks = 0;
-static volatile uint32_t s_rightTicks = 0;
+// Общие суммарные тики с момента запуска системы (пишет только ISR)
+static volatile uint32_t s_leftTotal CCMRAM = 0;
+static volatile uint32_t s_rightTotal CCMRAM = 0;
 
-// Общие суммарные тики с момента запуска системы
-static volatile uint32_t s_leftTotal = 0;
-static volatile uint32_t s_rightTotal = 0;
+// Seqlock над парой s_leftTotal / s_rightTotal
+static SeqLock_t s_encLock CCMRAM = SEQLOCK_INIT;
+
+// Курсор для совместимого Encoder_GetAndResetTicks()
+static EncoderCursor_t s_legacyCursor CCMRAM;
 
 // Последнее состояние пинов (1/0) — используется для детекции перехода HIGH→LOW
-static volatile uint8_t s_leftLastState = 1;
-static volatile uint8_t s_rightLastState = 1;
+static volatile uint8_t s_leftLastState CCMRAM = 1;
+static volatile uint8_t s_rightLastState CCMRAM = 1;
 
 // Метка времени последнего принятого тика — антидребезг
-static volatile uint32_t s_leftLastMs = 0;
-static volatile uint32_t s_rightLastMs = 0;
+static volatile uint32_t s_leftLastMs CCMRAM = 0;
+static volatile uint32_t s_rightLastMs CCMRAM = 0;
 
 /* Локальные функции */
 static void Encoder_GPIO_Init(void);
@@ -62,8 +70,8 @@ void Encoder_Init(void)
     s_rightLastMs = g_msTicks;
 
     // Обнуляем счётчики
-    s_leftTicks = s_rightTicks = 0;
     s_leftTotal = s_rightTotal = 0;
+    Encoder_CursorInit(&s_legacyCursor);
 }
 
 /* --------------------------------------------------------------------------
@@ -126,9 +134,11 @@ static inline void Encoder_HandleEdge_Left(void)
         // Антидребезг по времени
         if ((now - s_leftLastMs) > ENC_MIN_TICK_INTERVAL_MS)
         {
-            s_leftTicks++; // tики за интервал
+            SeqLock_WriteBegin(&s_encLock);
             s_leftTotal++; // суммарные тики
+            SeqLock_WriteEnd(&s_encLock);
             s_leftLastMs = now;
+            TRACE(TRACE_EV_ENC, 0, s_leftTotal);
         }
     }
 
@@ -147,9 +157,11 @@ static inline void Encoder_HandleEdge_Right(void)
     {
         if ((now - s_rightLastMs) > ENC_MIN_TICK_INTERVAL_MS)
         {
-            s_rightTicks++;
+            SeqLock_WriteBegin(&s_encLock);
             s_rightTotal++;
+            SeqLock_WriteEnd(&s_encLock);
             s_rightLastMs = now;
+            TRACE(TRACE_EV_ENC, 1, s_rightTotal);
         }
     }
 
@@ -159,8 +171,11 @@ static inline void Encoder_HandleEdge_Right(void)
 /* --------------------------------------------------------------------------
  * Основной обработчик EXTI5..9
  * -------------------------------------------------------------------------- */
-void EXTI9_5_IRQHandler(void)
+RAMFUNC void EXTI9_5_IRQHandler(void)
 {
+    ISRLAT_EXTI_ENC_ENTRY(); // до всего остального — иначе мерили бы и себя
+    PERF_BEGIN(PERF_EXTI_ENC);
+
     // Проверяем: пришло ли прерывание с линии 5?
     if (READ_BIT(EXTI->PR, (1U << ENC_L_EXTI_LINE)))
     {
@@ -174,48 +189,75 @@ void EXTI9_5_IRQHandler(void)
         SET_BIT(EXTI->PR, (1U << ENC_R_EXTI_LINE));
         Encoder_HandleEdge_Right();
     }
+
+    PERF_END(PERF_EXTI_ENC);
 }
 
 /* --------------------------------------------------------------------------
  * Публичные функции
  * -------------------------------------------------------------------------- */
 
-/* Возвращает тики за интервал dt и обнуляет счётчики */
-void Encoder_GetAndResetTicks(uint32_t *leftTicks, uint32_t *rightTicks)
+/* Согласованный снимок суммарных тиков обоих колёс (без запрета IRQ) */
+void Encoder_GetTotals(uint32_t *left, uint32_t *right)
+{
+    uint32_t s, l, r;
+
+    do
+    {
+        s = SeqLock_ReadBegin(&s_encLock);
+        l = s_leftTotal;
+        r = s_rightTotal;
+    } while (SeqLock_ReadRetry(&s_encLock, s));
+
+    if (left)
+        *left = l;
+    if (right)
+        *right = r;
+}
+
+/* Курсор: запомнить текущие суммарные тики как точку отсчёта */
+void Encoder_CursorInit(EncoderCursor_t *c)
+{
+    Encoder_GetTotals(&c->left, &c->right);
+}
+
+/* Приращение тиков с прошлого вызова для ЭТОГО курсора.
+ * Счётчики не обнуляются — другие потребители их не теряют.
+ */
+void Encoder_GetDelta(EncoderCursor_t *c, uint32_t *dLeft, uint32_t *dRight)
 {
     uint32_t l, r;
+    Encoder_GetTotals(&l, &r);
+
+    // беззнаковая разность корректна и через переполнение
+    if (dLeft)
+        *dLeft = l - c->left;
+    if (dRight)
+        *dRight = r - c->right;
 
-    __disable_irq();
-    l = s_leftTicks;
-    r = s_rightTicks;
-    s_leftTicks = 0;
-    s_rightTicks = 0;
-    __enable_irq();
-
-    if (leftTicks)
-        *leftTicks = l;
-    if (rightTicks)
-        *rightTicks = r;
+    c->left = l;
+    c->right = r;
+}
+
+/* Возвращает тики за интервал dt (совместимость: внутренний курсор) */
+void Encoder_GetAndResetTicks(uint32_t *leftTicks, uint32_t *rightTicks)
+{
+    Encoder_GetDelta(&s_legacyCursor, leftTicks, rightTicks);
 }
 
-/* Возвращает суммарные тики левого колеса */
+/* Возвращает суммарные тики левого колеса.
+ * Чтение выровненного 32-битного слова на Cortex-M4 атомарно —
+ * ни блокировка, ни seqlock для одного значения не нужны.
+ */
 uint32_t Encoder_GetTotalLeft(void)
 {
-    uint32_t v;
-    __disable_irq();
-    v = s_leftTotal;
-    __enable_irq();
-    return v;
+    return s_leftTotal;
 }
 
 /* Возвращает суммарные тики правого колеса */
 uint32_t Encoder_GetTotalRight(void)
 {
-    uint32_t v;
-    __disable_irq();
-    v = s_rightTotal;
-    __enable_irq();
-    return v;
+    return s_rightTotal;
 }
 
 /* Перевод тиков в миллиметры */
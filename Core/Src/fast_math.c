@@ -0,0 +1,35 @@
+// fast_math.c
+#include "fast_math.h"
+
+void FM_ScaleI16(const int16_t *src, float *dst, uint32_t n, float scale)
+{
+    uint32_t i = 0;
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        dst[i + 0] = (float)src[i + 0] * scale;
+        dst[i + 1] = (float)src[i + 1] * scale;
+        dst[i + 2] = (float)src[i + 2] * scale;
+        dst[i + 3] = (float)src[i + 3] * scale;
+    }
+
+    for (; i < n; i++)
+        dst[i] = (float)src[i] * scale;
+}
+
+void FM_ScaleOffsetI16(const int16_t *src, float *dst, uint32_t n,
+                       float scale, float offset)
+{
+    uint32_t i = 0;
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        dst[i + 0] = (float)src[i + 0] * scale - offset;
+        dst[i + 1] = (float)src[i + 1] * scale - offset;
+        dst[i + 2] = (float)src[i + 2] * scale - offset;
+        dst[i + 3] = (float)src[i + 3] * scale - offset;
+    }
+
+    for (; i < n; i++)
+        dst[i] = (float)src[i] * scale - offset;
+}
@@ -0,0 +1,440 @@
+// grid_plan.c
+//
+// Карта-битовое поле, A* с ограниченной кучей и волна (BFS).
+// Вся память статическая; описание алгоритмов — в grid_plan.h.
+
+#include "grid_plan.h"
+#include "path_follow.h"
+
+/* --- Карта --- */
+static uint32_t s_blocked[GRID_H]; // бит x строки y — клетка занята
+static float s_cellMm = GRID_CELL_MM_DEFAULT;
+static float s_originX, s_originY;
+
+/* --- Рабочие данные поиска --- */
+static uint32_t s_seen[GRID_H];   // g / расстояние клетки действительно
+static uint32_t s_closed[GRID_H]; // A*: клетка раскрыта
+static uint16_t s_g[GRID_CELLS];
+static uint8_t s_from[GRID_CELLS]; // направление шага в клетку из родителя
+
+// куча A* и очередь волны не нужны одновременно
+static union
+{
+    struct
+    {
+        uint32_t key[GRID_OPEN_MAX]; // f << 16 | (0xFFFF − g)
+        uint16_t idx[GRID_OPEN_MAX];
+    } heap;
+    uint16_t queue[GRID_CELLS];
+} s_work;
+static uint32_t s_heapLen;
+
+static GridPlanStats_t s_st;
+
+/* Направления: +x, +y, −x, −y */
+static const int8_t k_dx[4] = {1, 0, -1, 0};
+static const int8_t k_dy[4] = {0, 1, 0, -1};
+
+// ---------------- Вспомогательное ----------------
+
+static inline uint32_t cell_idx(uint32_t x, uint32_t y)
+{
+    return y * GRID_W + x;
+}
+
+static inline uint8_t bit_get(const uint32_t *bs, uint32_t x, uint32_t y)
+{
+    return (uint8_t)((bs[y] >> x) & 1U);
+}
+
+static inline void bit_set(uint32_t *bs, uint32_t x, uint32_t y)
+{
+    bs[y] |= 1UL << x;
+}
+
+static void bits_clear(uint32_t *bs)
+{
+    for (uint32_t y = 0; y < GRID_H; y++)
+        bs[y] = 0;
+}
+
+static inline uint32_t iabs(int32_t v)
+{
+    return (uint32_t)((v < 0) ? -v : v);
+}
+
+// ---------------- Куча A* ----------------
+
+static uint8_t heap_push(uint32_t key, uint16_t idx)
+{
+    if (s_heapLen >= GRID_OPEN_MAX)
+        return 0;
+
+    uint32_t i = s_heapLen++;
+    while (i > 0U)
+    {
+        uint32_t parent = (i - 1U) >> 1;
+        if (s_work.heap.key[parent] <= key)
+            break;
+        s_work.heap.key[i] = s_work.heap.key[parent];
+        s_work.heap.idx[i] = s_work.heap.idx[parent];
+        i = parent;
+    }
+    s_work.heap.key[i] = key;
+    s_work.heap.idx[i] = idx;
+
+    if (s_heapLen > s_st.open_peak)
+        s_st.open_peak = s_heapLen;
+    return 1;
+}
+
+static uint16_t heap_pop(void)
+{
+    uint16_t top = s_work.heap.idx[0];
+    uint32_t key = s_work.heap.key[--s_heapLen];
+    uint16_t idx = s_work.heap.idx[s_heapLen];
+
+    uint32_t i = 0;
+    while (1)
+    {
+        uint32_t c = 2U * i + 1U;
+        if (c >= s_heapLen)
+            break;
+        if (c + 1U < s_heapLen && s_work.heap.key[c + 1U] < s_work.heap.key[c])
+            c++;
+        if (key <= s_work.heap.key[c])
+            break;
+        s_work.heap.key[i] = s_work.heap.key[c];
+        s_work.heap.idx[i] = s_work.heap.idx[c];
+        i = c;
+    }
+    s_work.heap.key[i] = key;
+    s_work.heap.idx[i] = idx;
+    return top;
+}
+
+// ---------------- Поиск ----------------
+
+static uint32_t plan_flood(GridCell_t start, GridCell_t goal, GridCell_t *out, uint32_t max)
+{
+    uint32_t head = 0, tail = 0;
+    uint32_t startIdx = cell_idx(start.x, start.y);
+
+    bits_clear(s_seen);
+    bit_set(s_seen, goal.x, goal.y);
+    s_g[cell_idx(goal.x, goal.y)] = 0;
+    s_work.queue[tail++] = (uint16_t)cell_idx(goal.x, goal.y);
+
+    // волна от цели: каждая клетка в очередь не больше раза
+    while (head < tail)
+    {
+        uint32_t idx = s_work.queue[head++];
+        s_st.expanded++;
+        if (idx == startIdx)
+            break;
+
+        uint32_t x = idx % GRID_W, y = idx / GRID_W;
+        for (uint32_t d = 0; d < 4U; d++)
+        {
+            int32_t nx = (int32_t)x + k_dx[d];
+            int32_t ny = (int32_t)y + k_dy[d];
+            if (Grid_IsBlocked(nx, ny) || bit_get(s_seen, (uint32_t)nx, (uint32_t)ny))
+                continue;
+
+            bit_set(s_seen, (uint32_t)nx, (uint32_t)ny);
+            s_g[cell_idx((uint32_t)nx, (uint32_t)ny)] = (uint16_t)(s_g[idx] + 1U);
+            s_work.queue[tail++] = (uint16_t)cell_idx((uint32_t)nx, (uint32_t)ny);
+        }
+    }
+
+    if (!bit_get(s_seen, start.x, start.y))
+        return 0;
+    uint32_t len = s_g[startIdx] + 1U;
+    if (len > max)
+        return 0;
+
+    // спуск от старта: расстояние на 1 меньше, прежнее направление — первым
+    uint32_t x = start.x, y = start.y;
+    uint32_t dir = 0;
+    out[0] = start;
+    for (uint32_t k = 1; k < len; k++)
+    {
+        uint32_t want = s_g[cell_idx(x, y)] - 1U;
+        for (uint32_t j = 0; j < 4U; j++)
+        {
+            uint32_t d = (dir + j) & 3U;
+            int32_t nx = (int32_t)x + k_dx[d];
+            int32_t ny = (int32_t)y + k_dy[d];
+            if (Grid_IsBlocked(nx, ny) || !bit_get(s_seen, (uint32_t)nx, (uint32_t)ny) ||
+                s_g[cell_idx((uint32_t)nx, (uint32_t)ny)] != want)
+                continue;
+
+            x = (uint32_t)nx;
+            y = (uint32_t)ny;
+            dir = d;
+            break;
+        }
+        out[k].x = (uint8_t)x;
+        out[k].y = (uint8_t)y;
+    }
+    return len;
+}
+
+static uint32_t plan_astar(GridCell_t start, GridCell_t goal, GridCell_t *out, uint32_t max)
+{
+    uint32_t goalIdx = cell_idx(goal.x, goal.y);
+
+    bits_clear(s_seen);
+    bits_clear(s_closed);
+    s_heapLen = 0;
+
+    bit_set(s_seen, start.x, start.y);
+    s_g[cell_idx(start.x, start.y)] = 0;
+    uint32_t h0 = iabs((int32_t)goal.x - start.x) + iabs((int32_t)goal.y - start.y);
+    (void)heap_push((h0 << 16) | 0xFFFFU, (uint16_t)cell_idx(start.x, start.y));
+
+    uint8_t found = 0;
+    while (s_heapLen)
+    {
+        uint32_t idx = heap_pop();
+        uint32_t x = idx % GRID_W, y = idx / GRID_W;
+
+        // устаревшая копия: клетку уже раскрыли с лучшим g
+        if (bit_get(s_closed, x, y))
+            continue;
+        bit_set(s_closed, x, y);
+        s_st.expanded++;
+
+        if (idx == goalIdx)
+        {
+            found = 1;
+            break;
+        }
+
+        uint32_t g = s_g[idx] + 1U;
+        for (uint32_t d = 0; d < 4U; d++)
+        {
+            int32_t nx = (int32_t)x + k_dx[d];
+            int32_t ny = (int32_t)y + k_dy[d];
+            if (Grid_IsBlocked(nx, ny) || bit_get(s_closed, (uint32_t)nx, (uint32_t)ny))
+                continue;
+
+            uint32_t n = cell_idx((uint32_t)nx, (uint32_t)ny);
+            if (bit_get(s_seen, (uint32_t)nx, (uint32_t)ny) && s_g[n] <= g)
+                continue;
+
+            bit_set(s_seen, (uint32_t)nx, (uint32_t)ny);
+            s_g[n] = (uint16_t)g;
+            s_from[n] = (uint8_t)d;
+
+            uint32_t f = g + iabs((int32_t)goal.x - nx) + iabs((int32_t)goal.y - ny);
+            if (!heap_push((f << 16) | (0xFFFFU - g), (uint16_t)n))
+            {
+                // куча мала для этой карты — волна памяти сверх очереди не просит
+                s_st.overflows++;
+                s_st.expanded = 0;
+                return plan_flood(start, goal, out, max);
+            }
+        }
+    }
+
+    if (!found)
+        return 0;
+
+    // эвристика согласованная, шаг единичный: g цели — длина кратчайшего пути
+    uint32_t len = s_g[goalIdx] + 1U;
+    if (len > max)
+        return 0;
+
+    uint32_t x = goal.x, y = goal.y;
+    for (uint32_t k = len; k-- > 0U;)
+    {
+        out[k].x = (uint8_t)x;
+        out[k].y = (uint8_t)y;
+        if (k)
+        {
+            uint8_t d = s_from[cell_idx(x, y)];
+            x = (uint32_t)((int32_t)x - k_dx[d]);
+            y = (uint32_t)((int32_t)y - k_dy[d]);
+        }
+    }
+    return len;
+}
+
+// Отрезок между центрами клеток не задевает занятых: обходятся все клетки,
+// которые он пересекает; проход точно через угол — обе соседние клетки
+static uint8_t line_free(GridCell_t a, GridCell_t b)
+{
+    int32_t x = a.x, y = a.y;
+    int32_t dx = (int32_t)iabs((int32_t)b.x - a.x);
+    int32_t dy = (int32_t)iabs((int32_t)b.y - a.y);
+    int32_t sx = (b.x > a.x) ? 1 : -1;
+    int32_t sy = (b.y > a.y) ? 1 : -1;
+    int32_t err = dx - dy;
+
+    for (int32_t n = 1 + dx + dy; n > 0; n--)
+    {
+        if (Grid_IsBlocked(x, y))
+            return 0;
+
+        if (err > 0)
+        {
+            x += sx;
+            err -= 2 * dy;
+        }
+        else if (err < 0)
+        {
+            y += sy;
+            err += 2 * dx;
+        }
+        else
+        {
+            if (Grid_IsBlocked(x + sx, y) || Grid_IsBlocked(x, y + sy))
+                return 0;
+            x += sx;
+            y += sy;
+            err += 2 * (dx - dy);
+            n--;
+        }
+    }
+    return 1;
+}
+
+static uint8_t emit_cell(GridCell_t c)
+{
+    float x, y;
+    Grid_CellCenter(c, &x, &y);
+    return Path_Add(x, y);
+}
+
+// ---------------- API ----------------
+
+void Grid_Init(float cell_mm, float origin_x_mm, float origin_y_mm)
+{
+    s_cellMm = cell_mm;
+    s_originX = origin_x_mm;
+    s_originY = origin_y_mm;
+    Grid_Clear();
+}
+
+void Grid_Clear(void)
+{
+    bits_clear(s_blocked);
+}
+
+void Grid_SetRect(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, uint8_t blocked)
+{
+    if (x0 >= GRID_W || y0 >= GRID_H || x1 < x0 || y1 < y0)
+        return;
+    if (x1 >= GRID_W)
+        x1 = GRID_W - 1U;
+    if (y1 >= GRID_H)
+        y1 = GRID_H - 1U;
+
+    // биты x0..x1 одной маской на строку
+    uint32_t width = x1 - x0 + 1U;
+    uint32_t mask = ((width >= 32U) ? 0xFFFFFFFFUL : ((1UL << width) - 1U)) << x0;
+
+    for (uint32_t y = y0; y <= y1; y++)
+    {
+        if (blocked)
+            s_blocked[y] |= mask;
+        else
+            s_blocked[y] &= ~mask;
+    }
+}
+
+void Grid_SetBlocked(uint32_t x, uint32_t y, uint8_t blocked)
+{
+    Grid_SetRect(x, y, x, y, blocked);
+}
+
+uint8_t Grid_IsBlocked(int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || x >= (int32_t)GRID_W || y >= (int32_t)GRID_H)
+        return 1;
+    return bit_get(s_blocked, (uint32_t)x, (uint32_t)y);
+}
+
+uint8_t Grid_CellAt(float x_mm, float y_mm, GridCell_t *c)
+{
+    float fx = (x_mm - s_originX) / s_cellMm;
+    float fy = (y_mm - s_originY) / s_cellMm;
+    if (fx < 0.0f || fy < 0.0f || fx >= (float)GRID_W || fy >= (float)GRID_H)
+        return 0;
+
+    c->x = (uint8_t)fx;
+    c->y = (uint8_t)fy;
+    return 1;
+}
+
+void Grid_CellCenter(GridCell_t c, float *x_mm, float *y_mm)
+{
+    *x_mm = s_originX + ((float)c.x + 0.5f) * s_cellMm;
+    *y_mm = s_originY + ((float)c.y + 0.5f) * s_cellMm;
+}
+
+uint32_t Grid_Plan(GridAlgo algo, GridCell_t start, GridCell_t goal,
+                   GridCell_t *out, uint32_t max)
+{
+    uint32_t overflows = s_st.overflows;
+    GridPlanStats_t zero = {0};
+    s_st = zero;
+    s_st.overflows = overflows;
+
+    if (!out || max == 0U || Grid_IsBlocked(start.x, start.y) || Grid_IsBlocked(goal.x, goal.y))
+        return 0;
+
+    uint32_t len = (algo == GRID_FLOOD) ? plan_flood(start, goal, out, max)
+                                        : plan_astar(start, goal, out, max);
+    s_st.length = len;
+    return len;
+}
+
+const GridPlanStats_t *Grid_LastStats(void)
+{
+    return &s_st;
+}
+
+uint32_t Grid_EmitPath(const GridCell_t *cells, uint32_t n, uint8_t smooth)
+{
+    Path_Clear();
+    if (!cells || n == 0U)
+        return 0;
+
+    uint8_t ok = emit_cell(cells[0]);
+
+    if (smooth)
+    {
+        // «натягивание нити»: держим отрезок от опорной клетки, пока он свободен
+        uint32_t anchor = 0;
+        for (uint32_t i = 2; i < n && ok; i++)
+        {
+            if (!line_free(cells[anchor], cells[i]))
+            {
+                ok = emit_cell(cells[i - 1U]);
+                anchor = i - 1U;
+            }
+        }
+    }
+    else
+    {
+        // только углы: направление шага меняется
+        for (uint32_t i = 1; i + 1U < n && ok; i++)
+        {
+            if (cells[i].x - cells[i - 1U].x != cells[i + 1U].x - cells[i].x ||
+                cells[i].y - cells[i - 1U].y != cells[i + 1U].y - cells[i].y)
+                ok = emit_cell(cells[i]);
+        }
+    }
+
+    if (ok && n > 1U)
+        ok = emit_cell(cells[n - 1U]);
+
+    if (!ok)
+    {
+        Path_Clear();
+        return 0;
+    }
+    return Path_Count();
+}
@@ -0,0 +1,201 @@
+// gyro_tempcomp.c
+#include "gyro_tempcomp.h"
+#include "MPU6050.h"
+#include "persist.h"
+#include "mem_sections.h"
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+static float gtc_absf(float x)
+{
+    return (x >= 0.0f) ? x : -x;
+}
+
+// Положение температуры в таблице: индекс левого узла и доля до правого
+static void gtc_locate(float temp_c, uint32_t *i0, float *frac)
+{
+    float x = (temp_c - GTC_T_MIN_C) * (1.0f / GTC_T_STEP_C);
+
+    if (x <= 0.0f)
+    {
+        *i0 = 0;
+        *frac = 0.0f;
+        return;
+    }
+    if (x >= (float)(GTC_NODES - 1U))
+    {
+        *i0 = GTC_NODES - 2U;
+        *frac = 1.0f;
+        return;
+    }
+
+    *i0 = (uint32_t)x;
+    *frac = x - (float)*i0;
+}
+
+// Учесть измерение в узле с весом w (0..1)
+static void gtc_update_node(GyroTC_Table_t *t, uint32_t k, float w, const float m[3])
+{
+    if (w <= 0.0f)
+        return;
+
+    if (t->count[k] == 0)
+    {
+        // Пустой узел — лучшей оценки, чем ближайшее измерение, нет
+        for (uint32_t a = 0; a < 3U; a++)
+            t->bias[k][a] = m[a];
+    }
+    else
+    {
+        float alpha = 1.0f / (float)(t->count[k] + 1U);
+        if (alpha < GTC_ALPHA_MIN)
+            alpha = GTC_ALPHA_MIN;
+        alpha *= w;
+
+        for (uint32_t a = 0; a < 3U; a++)
+            t->bias[k][a] += alpha * (m[a] - t->bias[k][a]);
+    }
+
+    if (w >= 0.25f && t->count[k] < 1000U)
+        t->count[k]++;
+}
+
+static void gtc_refresh(GyroTC_t *tc, int16_t temp_raw)
+{
+    GyroTC_GetBias(tc, MPU6050_TempLSB_to_C(temp_raw), tc->cur_bias);
+    tc->cache_temp_raw = temp_raw;
+    tc->cache_valid = 1;
+}
+
+/* --------------------------------------------------------------------------
+ * Интерфейс
+ * -------------------------------------------------------------------------- */
+uint8_t GyroTC_Init(GyroTC_t *tc)
+{
+    memset(tc, 0, sizeof(*tc));
+
+    if (Persist_Load(PERSIST_SLOT_GYRO_TC, GTC_VERSION, &tc->tab, sizeof(tc->tab)))
+        return 1;
+
+    memset(&tc->tab, 0, sizeof(tc->tab));
+    return 0;
+}
+
+void GyroTC_Learn(GyroTC_t *tc, float temp_c, const float bias_dps[3])
+{
+    uint32_t i0;
+    float f;
+    gtc_locate(temp_c, &i0, &f);
+
+    gtc_update_node(&tc->tab, i0, 1.0f - f, bias_dps);
+    gtc_update_node(&tc->tab, i0 + 1U, f, bias_dps);
+
+    tc->cache_valid = 0;
+    tc->dirty = 1;
+}
+
+void GyroTC_GetBias(const GyroTC_t *tc, float temp_c, float bias_dps[3])
+{
+    const GyroTC_Table_t *t = &tc->tab;
+    uint32_t i0;
+    float f;
+    gtc_locate(temp_c, &i0, &f);
+
+    // Ближайший заполненный узел слева (включая i0) и справа (от i0+1)
+    int32_t l = (int32_t)i0;
+    while (l >= 0 && t->count[l] == 0)
+        l--;
+
+    uint32_t r = i0 + 1U;
+    while (r < GTC_NODES && t->count[r] == 0)
+        r++;
+
+    if (l < 0 && r >= GTC_NODES)
+    {
+        // Таблица пустая
+        bias_dps[0] = bias_dps[1] = bias_dps[2] = 0.0f;
+        return;
+    }
+    if (l < 0)
+    {
+        memcpy(bias_dps, t->bias[r], sizeof(t->bias[r]));
+        return;
+    }
+    if (r >= GTC_NODES)
+    {
+        memcpy(bias_dps, t->bias[l], sizeof(t->bias[l]));
+        return;
+    }
+
+    // Интерполяция между заполненными узлами l и r
+    float x = (float)i0 + f;
+    float w = (x - (float)l) / (float)(r - (uint32_t)l);
+    if (w < 0.0f)
+        w = 0.0f;
+    else if (w > 1.0f)
+        w = 1.0f;
+
+    for (uint32_t a = 0; a < 3U; a++)
+        bias_dps[a] = t->bias[l][a] + w * (t->bias[r][a] - t->bias[l][a]);
+}
+
+RAMFUNC void GyroTC_Process(GyroTC_t *tc, int16_t temp_raw, float g[3], uint8_t still)
+{
+    int32_t dT = (int32_t)temp_raw - (int32_t)tc->cache_temp_raw;
+    if (!tc->cache_valid || dT >= GTC_REFRESH_LSB || dT <= -GTC_REFRESH_LSB)
+        gtc_refresh(tc, temp_raw);
+
+    /* --- Обучение на участках покоя --- */
+    if (still &&
+        gtc_absf(g[0] - tc->cur_bias[0]) < GTC_STILL_DPS &&
+        gtc_absf(g[1] - tc->cur_bias[1]) < GTC_STILL_DPS &&
+        gtc_absf(g[2] - tc->cur_bias[2]) < GTC_STILL_DPS)
+    {
+        tc->win_sum[0] += g[0];
+        tc->win_sum[1] += g[1];
+        tc->win_sum[2] += g[2];
+        tc->win_temp_sum += temp_raw;
+
+        if (++tc->win_n >= GTC_WINDOW)
+        {
+            float inv = 1.0f / (float)tc->win_n;
+            float mean[3] = {tc->win_sum[0] * inv, tc->win_sum[1] * inv, tc->win_sum[2] * inv};
+            int16_t t_mean = (int16_t)(tc->win_temp_sum / (int32_t)tc->win_n);
+
+            GyroTC_Learn(tc, MPU6050_TempLSB_to_C(t_mean), mean);
+            gtc_refresh(tc, temp_raw);
+            tc->win_n = 0;
+        }
+    }
+    else if (tc->win_n)
+    {
+        // Движение — окно начинается заново
+        tc->win_n = 0;
+    }
+
+    if (tc->win_n == 0)
+    {
+        tc->win_sum[0] = tc->win_sum[1] = tc->win_sum[2] = 0.0f;
+        tc->win_temp_sum = 0;
+    }
+
+    /* --- Компенсация --- */
+    g[0] -= tc->cur_bias[0];
+    g[1] -= tc->cur_bias[1];
+    g[2] -= tc->cur_bias[2];
+}
+
+uint8_t GyroTC_Save(GyroTC_t *tc)
+{
+    if (!tc->dirty)
+        return 0;
+
+    if (!Persist_Save(PERSIST_SLOT_GYRO_TC, GTC_VERSION, &tc->tab, sizeof(tc->tab)))
+        return 0;
+
+    tc->dirty = 0;
+    return 1;
+}
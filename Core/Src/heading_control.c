@@ -1,5 +1,6 @@
 // heading_control.c
 #include "heading_control.h"
+#include "fast_math.h"
 
 // Простой P-регулятор по углу
 static float target_yaw = 0.0f;
@@ -8,23 +9,14 @@ static const float Kp_yaw = 0.05f; // подбирать!
 // Удобная функция ошибки угла с учётом -180..+180
 static float angle_error(float target, float current)
 {
-    float e = target - current;
-    // Нормализуем в диапазон -180..+180
-    while (e > 180.0f)
-        e -= 360.0f;
-    while (e < -180.0f)
-        e += 360.0f;
-    return e;
+    // Нормализуем в диапазон -180..+180 (без циклов)
+    return FM_WrapDeg180(target - current);
 }
 
 void Heading_SetTarget(float yaw_deg)
 {
     // Нормализуем
-    while (yaw_deg > 180.0f)
-        yaw_deg -= 360.0f;
-    while (yaw_deg < -180.0f)
-        yaw_deg += 360.0f;
-    target_yaw = yaw_deg;
+    target_yaw = FM_WrapDeg180(yaw_deg);
 }
 
 void Heading_Compute(float yaw_deg, float base_rps, float *outL, float *outR)
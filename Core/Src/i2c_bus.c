@@ -0,0 +1,244 @@
+// i2c_bus.c
+//
+// Ядро менеджера шины I2C: таблица устройств, очередь транзакций
+// с приоритетами и дедлайнами, статистика. К регистрам не обращается —
+// всё железо за I2CBusOps_t (см. i2c_bus.h).
+//
+// Submit и Poll вызываются из основного контекста (главный цикл или
+// задачи протопотоков), не из прерываний: очередь без блокировок.
+
+#include "i2c_bus.h"
+#include "usart.h"
+#include <stddef.h>
+
+static const I2CBusOps_t *s_ops;
+
+static I2CDev_t *s_devs[I2C_BUS_MAX_DEVICES];
+static uint32_t s_devCount;
+
+static I2CXfer_t *s_queue[I2C_BUS_QUEUE_LEN];
+static uint32_t s_queueLen;
+
+static uint32_t s_statsStartUs;
+
+// ---------------- Вспомогательное ----------------
+
+static uint32_t bus_now(void)
+{
+    return (s_ops && s_ops->now_us) ? s_ops->now_us() : 0U;
+}
+
+// a раньше b с учётом переполнения 32-битного времени
+static inline uint8_t time_before(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) < 0) ? 1U : 0U;
+}
+
+// Одна транзакция на шине + учёт в статистике устройства
+static uint8_t bus_transfer(I2CDev_t *dev, uint8_t write, uint8_t reg,
+                            uint8_t *buf, uint32_t n,
+                            uint32_t *t_start, uint32_t *t_end)
+{
+    if (!s_ops || !dev || !buf || n == 0U)
+        return 0;
+
+    (void)I2CBus_AddDevice(dev);
+
+    uint32_t t0 = bus_now();
+    uint8_t ok = write ? s_ops->write(dev->addr, reg, buf, n)
+                       : s_ops->read(dev->addr, reg, buf, n);
+    uint32_t t1 = bus_now();
+    uint32_t busy = t1 - t0;
+
+    I2CDevStats_t *st = &dev->st;
+    st->xfers++;
+    st->busy_us += busy;
+    if (busy > st->max_busy_us)
+        st->max_busy_us = busy;
+    if (ok)
+        st->bytes += n;
+    else
+        st->errors++;
+
+    if (t_start)
+        *t_start = t0;
+    if (t_end)
+        *t_end = t1;
+    return ok;
+}
+
+// Индекс самой срочной транзакции: приоритет, затем ранний дедлайн
+static uint32_t queue_pick(void)
+{
+    uint32_t best = 0;
+
+    for (uint32_t i = 1; i < s_queueLen; i++)
+    {
+        const I2CXfer_t *a = s_queue[i];
+        const I2CXfer_t *b = s_queue[best];
+
+        if (a->prio < b->prio ||
+            (a->prio == b->prio && time_before(a->deadline_us, b->deadline_us)))
+            best = i;
+    }
+    return best;
+}
+
+// Удаление со сдвигом — сохраняет порядок поступления при равных ключах
+static void queue_remove(uint32_t idx)
+{
+    for (uint32_t i = idx + 1U; i < s_queueLen; i++)
+        s_queue[i - 1U] = s_queue[i];
+    s_queueLen--;
+}
+
+// ---------------- API ----------------
+
+void I2CBus_Init(const I2CBusOps_t *ops)
+{
+    s_ops = ops;
+    s_queueLen = 0;
+    I2CBus_ResetStats();
+}
+
+uint8_t I2CBus_AddDevice(I2CDev_t *dev)
+{
+    if (!dev)
+        return 0;
+    if (dev->registered)
+        return 1;
+    if (s_devCount >= I2C_BUS_MAX_DEVICES)
+        return 0;
+
+    s_devs[s_devCount++] = dev;
+    dev->registered = 1;
+    return 1;
+}
+
+uint8_t I2CBus_Read(I2CDev_t *dev, uint8_t reg, uint8_t *dst, uint32_t n)
+{
+    return bus_transfer(dev, 0, reg, dst, n, NULL, NULL);
+}
+
+uint8_t I2CBus_Write(I2CDev_t *dev, uint8_t reg, const uint8_t *src, uint32_t n)
+{
+    // буфер записи не меняется — снимаем const только ради общего пути
+    return bus_transfer(dev, 1, reg, (uint8_t *)(uintptr_t)src, n, NULL, NULL);
+}
+
+uint8_t I2CBus_WriteReg(I2CDev_t *dev, uint8_t reg, uint8_t val)
+{
+    return I2CBus_Write(dev, reg, &val, 1);
+}
+
+uint8_t I2CBus_Submit(I2CXfer_t *x)
+{
+    if (!x || !x->dev || !x->buf || x->len == 0U)
+        return 0;
+    if (x->status == I2C_XFER_QUEUED || s_queueLen >= I2C_BUS_QUEUE_LEN)
+        return 0;
+
+    (void)I2CBus_AddDevice(x->dev);
+
+    x->submit_us = bus_now();
+    x->status = I2C_XFER_QUEUED;
+    s_queue[s_queueLen++] = x;
+    return 1;
+}
+
+uint8_t I2CBus_Poll(void)
+{
+    if (s_queueLen == 0U)
+        return 0;
+
+    uint32_t idx = queue_pick();
+    I2CXfer_t *x = s_queue[idx];
+    queue_remove(idx);
+
+    I2CDevStats_t *st = &x->dev->st;
+    uint32_t now = bus_now();
+
+    if ((x->flags & I2C_XFER_DROP_LATE) && !time_before(now, x->deadline_us))
+    {
+        st->dropped++;
+        x->start_us = x->end_us = now;
+        x->status = I2C_XFER_DROPPED;
+    }
+    else
+    {
+        uint8_t ok = bus_transfer(x->dev, (x->flags & I2C_XFER_WRITE) ? 1U : 0U,
+                                  x->reg, x->buf, x->len, &x->start_us, &x->end_us);
+
+        uint32_t wait = x->start_us - x->submit_us;
+        if (wait > st->max_wait_us)
+            st->max_wait_us = wait;
+        if (time_before(x->deadline_us, x->end_us))
+            st->late++;
+
+        x->status = ok ? I2C_XFER_DONE : I2C_XFER_ERROR;
+    }
+
+    if (x->done)
+        x->done(x);
+    return 1;
+}
+
+uint32_t I2CBus_Pending(void)
+{
+    return s_queueLen;
+}
+
+void I2CBus_ResetStats(void)
+{
+    for (uint32_t i = 0; i < s_devCount; i++)
+    {
+        I2CDevStats_t zero = {0};
+        s_devs[i]->st = zero;
+    }
+    s_statsStartUs = bus_now();
+}
+
+// ---------------- Отчёт ----------------
+
+void I2CBus_Report(void)
+{
+    uint32_t window = bus_now() - s_statsStartUs;
+    float win_s = (float)window * 1e-6f;
+    uint32_t busy_total = 0;
+
+    USART_Print("--- I2C BUS (window ");
+    USART_PrintFloat(win_s, 2);
+    USART_Println(" s) ---");
+
+    for (uint32_t i = 0; i < s_devCount; i++)
+    {
+        const I2CDev_t *d = s_devs[i];
+        const I2CDevStats_t *st = &d->st;
+        busy_total += st->busy_us;
+
+        USART_Print(d->name);
+        USART_Print(" @0x");
+        USART_PrintHex(d->addr);
+        USART_Print(": util=");
+        USART_PrintFloat(window ? 100.0f * (float)st->busy_us / (float)window : 0.0f, 1);
+        USART_Print("% ");
+        USART_PrintFloat(win_s > 0.0f ? (float)st->bytes / win_s : 0.0f, 0);
+        USART_Print(" B/s  n=");
+        USART_PrintInt((int32_t)st->xfers);
+        USART_Print(" err=");
+        USART_PrintInt((int32_t)st->errors);
+        USART_Print(" late=");
+        USART_PrintInt((int32_t)st->late);
+        USART_Print(" drop=");
+        USART_PrintInt((int32_t)st->dropped);
+        USART_Print("  max busy/wait us=");
+        USART_PrintInt((int32_t)st->max_busy_us);
+        USART_Print("/");
+        USART_PrintlnInt((int32_t)st->max_wait_us);
+    }
+
+    USART_Print("bus total util=");
+    USART_PrintFloat(window ? 100.0f * (float)busy_total / (float)window : 0.0f, 1);
+    USART_Print("%  queued=");
+    USART_PrintlnInt((int32_t)s_queueLen);
+}
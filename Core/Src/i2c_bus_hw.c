@@ -0,0 +1,198 @@
+// i2c_bus_hw.c
+//
+// Аппаратная часть менеджера шины: транзакции master на регистрах I2C1
+// (опрос флагов SR1, без прерываний и DMA). Раньше жила в MPU6050.c
+// с зашитым адресом датчика — теперь адрес приходит параметром.
+//
+// Формат любой транзакции — «регистровый» доступ:
+//
+//   запись: START, адрес+W, reg, данные…, STOP
+//   чтение: START, адрес+W, reg, RE-START, адрес+R, данные…, STOP
+//
+// Окончание приёма по RM0090 зависит от длины:
+//   N = 1 — ACK=0 и STOP сразу после ADDR;
+//   N = 2 — POS=1, ACK=0 до сброса ADDR, по BTF — STOP и два чтения DR;
+//   N > 2 — когда осталось 3 байта: BTF, ACK=0, чтение N−2; снова BTF →
+//           STOP, чтение N−1 и N. Так NACK уходит ровно на последний байт.
+//
+// Любая ошибка — SR1/SR2 в трассу (TRACE_EV_I2C_ERR, a = reg), STOP,
+// ACK/POS в исходное. Подсчёт ошибок по устройствам — в i2c_bus.c.
+
+#include "i2c_bus.h"
+#include "stm32f4xx.h"
+#include "timebase.h"
+#include "trace.h"
+
+#define I2C_DEV I2C1
+#define I2C_TIMEOUT 100000UL
+
+/******************************************************************************
+ * I2C_WaitSR1()
+ *
+ * Ждёт установки флага SR1 (SB, ADDR, TXE, RXNE, BTF).
+ * Если флаг не установился за разумное время → 0 (ошибка).
+ ******************************************************************************/
+static uint8_t I2C_WaitSR1(uint32_t flag)
+{
+    uint32_t t = 0;
+    while (!(I2C_DEV->SR1 & flag))
+    {
+        if (t++ > I2C_TIMEOUT)
+            return 0; // произошёл таймаут — что-то зависло
+    }
+    return 1;
+}
+
+/* Сброс ADDR: обязательно читаем SR1, затем SR2 */
+static inline void I2C_ClearAddr(void)
+{
+    (void)I2C_DEV->SR1;
+    (void)I2C_DEV->SR2;
+}
+
+/* Ошибка: диагностика в трассу, STOP (иначе шина зависнет), ACK/POS назад */
+static uint8_t I2C_Fail(uint8_t reg)
+{
+    uint32_t sr1 = I2C_DEV->SR1;
+    uint32_t sr2 = I2C_DEV->SR2;
+
+    I2C_DEV->CR1 |= I2C_CR1_STOP;
+    I2C_DEV->CR1 &= ~I2C_CR1_POS;
+    I2C_DEV->CR1 |= I2C_CR1_ACK;
+
+    TRACE(TRACE_EV_I2C_ERR, reg, (sr1 << 16) | (sr2 & 0xFFFFU));
+    return 0;
+}
+
+/******************************************************************************
+ * I2C_Address(addr, reg)
+ *
+ * Общее начало записи и чтения: START, адрес+W, номер регистра.
+ * Возвращает 1, когда байт регистра ушёл в DR (TXE перед записью).
+ ******************************************************************************/
+static uint8_t I2C_Address(uint8_t addr, uint8_t reg)
+{
+    I2C_DEV->CR1 |= I2C_CR1_START;
+    if (!I2C_WaitSR1(I2C_SR1_SB))
+        return 0;
+
+    I2C_DEV->DR = (uint32_t)(addr << 1) | 0U;
+    if (!I2C_WaitSR1(I2C_SR1_ADDR))
+        return 0;
+    I2C_ClearAddr();
+
+    if (!I2C_WaitSR1(I2C_SR1_TXE))
+        return 0;
+    I2C_DEV->DR = reg;
+    return 1;
+}
+
+/******************************************************************************
+ * I2C_HwWrite(addr, reg, *src, n)
+ ******************************************************************************/
+static uint8_t I2C_HwWrite(uint8_t addr, uint8_t reg, const uint8_t *src, uint32_t n)
+{
+    if (!I2C_Address(addr, reg))
+        return I2C_Fail(reg);
+
+    while (n--)
+    {
+        if (!I2C_WaitSR1(I2C_SR1_TXE))
+            return I2C_Fail(reg);
+        I2C_DEV->DR = *src++;
+    }
+
+    // BTF — последний байт ушёл со сдвигового регистра
+    if (!I2C_WaitSR1(I2C_SR1_BTF))
+        return I2C_Fail(reg);
+
+    I2C_DEV->CR1 |= I2C_CR1_STOP;
+    return 1;
+}
+
+/******************************************************************************
+ * I2C_HwRead(addr, reg, *dst, n)
+ ******************************************************************************/
+static uint8_t I2C_HwRead(uint8_t addr, uint8_t reg, uint8_t *dst, uint32_t n)
+{
+    I2C_DEV->CR1 |= I2C_CR1_ACK;
+
+    /* --- Адрес регистра --- */
+    if (!I2C_Address(addr, reg) || !I2C_WaitSR1(I2C_SR1_BTF))
+        return I2C_Fail(reg);
+
+    /* --- RE-START и приём --- */
+    I2C_DEV->CR1 |= I2C_CR1_START;
+    if (!I2C_WaitSR1(I2C_SR1_SB))
+        return I2C_Fail(reg);
+
+    I2C_DEV->DR = (uint32_t)(addr << 1) | 1U;
+    if (!I2C_WaitSR1(I2C_SR1_ADDR))
+        return I2C_Fail(reg);
+
+    if (n == 1U)
+    {
+        I2C_DEV->CR1 &= ~I2C_CR1_ACK;
+        I2C_ClearAddr();
+        I2C_DEV->CR1 |= I2C_CR1_STOP;
+
+        if (!I2C_WaitSR1(I2C_SR1_RXNE))
+            return I2C_Fail(reg);
+        *dst = (uint8_t)I2C_DEV->DR;
+    }
+    else if (n == 2U)
+    {
+        // POS: NACK относится к следующему байту, а не к текущему
+        I2C_DEV->CR1 |= I2C_CR1_POS;
+        I2C_DEV->CR1 &= ~I2C_CR1_ACK;
+        I2C_ClearAddr();
+
+        if (!I2C_WaitSR1(I2C_SR1_BTF))
+            return I2C_Fail(reg);
+        I2C_DEV->CR1 |= I2C_CR1_STOP;
+        dst[0] = (uint8_t)I2C_DEV->DR;
+        dst[1] = (uint8_t)I2C_DEV->DR;
+        I2C_DEV->CR1 &= ~I2C_CR1_POS;
+    }
+    else
+    {
+        I2C_ClearAddr();
+
+        while (n > 3U)
+        {
+            if (!I2C_WaitSR1(I2C_SR1_RXNE))
+                return I2C_Fail(reg);
+            *dst++ = (uint8_t)I2C_DEV->DR;
+            n--;
+        }
+
+        // осталось 3 байта
+        if (!I2C_WaitSR1(I2C_SR1_BTF))
+            return I2C_Fail(reg);
+        I2C_DEV->CR1 &= ~I2C_CR1_ACK;
+        *dst++ = (uint8_t)I2C_DEV->DR;
+
+        if (!I2C_WaitSR1(I2C_SR1_BTF))
+            return I2C_Fail(reg);
+        I2C_DEV->CR1 |= I2C_CR1_STOP;
+        *dst++ = (uint8_t)I2C_DEV->DR;
+
+        if (!I2C_WaitSR1(I2C_SR1_RXNE))
+            return I2C_Fail(reg);
+        *dst = (uint8_t)I2C_DEV->DR;
+    }
+
+    I2C_DEV->CR1 |= I2C_CR1_ACK;
+    return 1;
+}
+
+static const I2CBusOps_t s_hwOps = {
+    .read = I2C_HwRead,
+    .write = I2C_HwWrite,
+    .now_us = Time_Us,
+};
+
+const I2CBusOps_t *I2CBus_HwOps(void)
+{
+    return &s_hwOps;
+}
@@ -0,0 +1,147 @@
+// idle.c
+#include "idle.h"
+#include <stddef.h>
+#include "timebase.h"
+#include "init.h"
+#include "deadline.h"
+
+/* Приоритет TIM2: ниже энкодеров, пробуждение не срочное */
+#define IDLE_TIM2_IRQ_PRIO 6U
+
+static IdleStats_t s_stats;
+
+static inline uint8_t wake_set(volatile const uint8_t *wake)
+{
+    return (wake != NULL && *wake != 0U) ? 1U : 0U;
+}
+
+void Idle_Init(void)
+{
+    // Sleep, не Deep Sleep: периферия должна работать
+    CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+    CLEAR_BIT(TIMEBASE_TIM->DIER, TIM_DIER_CC1IE);
+    CLEAR_BIT(TIMEBASE_TIM->SR, TIM_SR_CC1IF);
+
+    NVIC_SetPriority(TIM2_IRQn, IDLE_TIM2_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(TIM2_IRQn);
+    NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+void Idle_SleepUntil(uint32_t deadline_us, volatile const uint8_t *wake)
+{
+    // сон вызывается только из основного контекста — он жив
+    Deadline_Alive();
+
+    if (Time_Reached(deadline_us))
+        return;
+
+    uint32_t remain = deadline_us - Time_Us();
+    if (remain > IDLE_MAX_US)
+    {
+        remain = IDLE_MAX_US;
+        deadline_us = Time_Us() + IDLE_MAX_US;
+    }
+
+    s_stats.sleeps++;
+
+    /* --- Короткий сон: SysTick всё равно разбудит через ≤ 1 мс --- */
+    if (remain < IDLE_TICKLESS_MIN_US || !READ_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk))
+    {
+        if (remain > 1000U)
+        {
+            // флаг — под маской: прерывание после проверки будит WFI
+            uint32_t pm = __get_PRIMASK();
+            __disable_irq();
+            if (!wake_set(wake))
+            {
+                __DSB();
+                __WFI();
+            }
+            __set_PRIMASK(pm);
+        }
+        return;
+    }
+
+    /* --- Бестиковый сон --- */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Фаза текущей миллисекунды в тактах. Формула верна и для
+    // укороченного первого периода после прошлого сна: он кончается
+    // на той же границе миллисекунды.
+    uint32_t load = SysTick->LOAD;
+    CLEAR_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+    uint32_t phase = load - SysTick->VAL;
+
+    // Тик уже ждёт обработки — не спим, пусть SysTick_Handler отработает
+    if (READ_BIT(SCB->ICSR, SCB_ICSR_PENDSTSET_Msk))
+    {
+        SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    uint32_t cyc_per_us = (load + 1U) / 1000U;
+    uint32_t t0 = Time_Us();
+
+    // Пробуждение по сравнению TIM2
+    WRITE_REG(TIMEBASE_TIM->CCR1, deadline_us);
+    CLEAR_BIT(TIMEBASE_TIM->SR, TIM_SR_CC1IF);
+    SET_BIT(TIMEBASE_TIM->DIER, TIM_DIER_CC1IE);
+
+    // Дедлайн мог пройти, пока настраивали, или прерывание уже дало
+    // работу — тогда не спим
+    if (!Time_Reached(deadline_us) && !wake_set(wake))
+    {
+        __DSB();
+        __WFI(); // с PRIMASK=1 ядро просыпается, но обработчик ждёт
+    }
+
+    CLEAR_BIT(TIMEBASE_TIM->DIER, TIM_DIER_CC1IE);
+    CLEAR_BIT(TIMEBASE_TIM->SR, TIM_SR_CC1IF);
+    NVIC_ClearPendingIRQ(TIM2_IRQn);
+
+    /* --- Досчитываем пропущенные миллисекунды (в тактах — без накопления
+     *     ошибки округления от сна к сну) --- */
+    uint32_t slept = Time_Us() - t0;
+    uint32_t period = load + 1U;
+    uint32_t total = phase + slept * cyc_per_us;
+
+    g_msTicks += total / period;
+    uint32_t rem = total % period;
+
+    // Следующий тик — на границе миллисекунды: укороченный период,
+    // затем обычный LOAD (новый LOAD вступает в силу на перезагрузке).
+    // До границы совсем чуть-чуть — LOAD=0 выключил бы SysTick,
+    // поэтому этот тик засчитываем сразу, а ждём следующую границу.
+    uint32_t reload = period - rem;
+    if (reload < cyc_per_us)
+    {
+        g_msTicks++;
+        reload += period;
+    }
+    WRITE_REG(SysTick->LOAD, reload - 1U);
+    WRITE_REG(SysTick->VAL, 0U);
+    SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+    WRITE_REG(SysTick->LOAD, load);
+
+    s_stats.tickless++;
+    s_stats.slept_us += slept;
+
+    // IWDG и проверка дедлайнов с учётом проспанного времени
+    Deadline_Tick();
+
+    __set_PRIMASK(primask); // ожидающие прерывания обслуживаются здесь
+}
+
+void Idle_WaitUntil(uint32_t deadline_us)
+{
+    while (!Time_Reached(deadline_us))
+        Idle_SleepUntil(deadline_us, NULL);
+}
+
+const IdleStats_t *Idle_GetStats(void)
+{
+    return &s_stats;
+}
@@ -0,0 +1,196 @@
+// isr_latency.c
+#include "isr_latency.h"
+#include "usart.h"
+#include "encoder.h"
+#include <math.h>
+
+extern volatile uint32_t g_msTicks;
+
+static IsrLatStats_t s_lat[ISRLAT_SRC_COUNT];
+
+static const char *const s_latNames[ISRLAT_SRC_COUNT] = {
+    "SysTick",
+    "EXTI9_5 (enc R)",
+};
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+/* Номер корзины: линейно до 128 тактов, дальше — по степеням двойки */
+static inline uint32_t IsrLat_Bin(uint32_t cycles)
+{
+    if (cycles < ISRLAT_LIN_BINS * ISRLAT_LIN_WIDTH)
+        return cycles / ISRLAT_LIN_WIDTH;
+
+    // 128..255 → 0, 256..511 → 1, ...
+    uint32_t log = 31U - (uint32_t)__CLZ(cycles) - 7U;
+    if (log >= ISRLAT_LOG_BINS)
+        log = ISRLAT_LOG_BINS - 1U;
+    return ISRLAT_LIN_BINS + log;
+}
+
+/* Нижняя граница корзины, тактов */
+static uint32_t IsrLat_BinLow(uint32_t bin)
+{
+    if (bin < ISRLAT_LIN_BINS)
+        return bin * ISRLAT_LIN_WIDTH;
+    return 128UL << (bin - ISRLAT_LIN_BINS);
+}
+
+/* Верхняя граница корзины, где набирается доля pct замеров */
+static uint32_t IsrLat_Percentile(const IsrLatStats_t *s, uint32_t pct)
+{
+    uint64_t need = ((uint64_t)s->count * pct + 99U) / 100U;
+    uint64_t acc = 0;
+
+    for (uint32_t b = 0; b < ISRLAT_BINS; b++)
+    {
+        acc += s->hist[b];
+        if (acc >= need)
+            return (b + 1U < ISRLAT_BINS) ? IsrLat_BinLow(b + 1U) - 1U : s->max;
+    }
+    return s->max;
+}
+
+#if ISR_LAT_ENABLE
+static void IsrLat_CaptureInit(void)
+{
+    // PA6 → AF2 (TIM3_CH1); EXTI6 продолжает видеть вывод через IDR
+    SET_BIT(RCC->AHB1ENR, ENC_R_GPIO_CLK);
+    MODIFY_REG(ENC_R_GPIO->AFR[ENC_R_PIN >> 3],
+               0xFUL << ((ENC_R_PIN & 7U) * 4U),
+               2UL << ((ENC_R_PIN & 7U) * 4U));
+    MODIFY_REG(ENC_R_GPIO->MODER,
+               3UL << (ENC_R_PIN * 2U),
+               2UL << (ENC_R_PIN * 2U));
+
+    SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM3EN);
+    (void)READ_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM3EN);
+
+    TIM_TypeDef *t = ISRLAT_CAPTURE_TIM;
+    CLEAR_BIT(t->CR1, TIM_CR1_CEN);
+    WRITE_REG(t->PSC, 0U);      // 84 МГц — 2 такта ядра на отсчёт
+    WRITE_REG(t->ARR, 0xFFFFU); // свободный 16-битный счёт
+    t->EGR = TIM_EGR_UG;
+
+    // CC1 — вход TI1, без фильтра и делителя, оба фронта, без прерывания
+    MODIFY_REG(t->CCMR1, TIM_CCMR1_CC1S | TIM_CCMR1_IC1F | TIM_CCMR1_IC1PSC,
+               TIM_CCMR1_CC1S_0);
+    SET_BIT(t->CCER, TIM_CCER_CC1P | TIM_CCER_CC1NP | TIM_CCER_CC1E);
+    CLEAR_BIT(t->DIER, TIM_DIER_CC1IE);
+    t->SR = 0U;
+
+    SET_BIT(t->CR1, TIM_CR1_CEN);
+}
+#endif
+
+/* --------------------------------------------------------------------------
+ * Публичные функции
+ * -------------------------------------------------------------------------- */
+
+void IsrLat_Init(void)
+{
+    for (uint32_t i = 0; i < ISRLAT_SRC_COUNT; i++)
+    {
+        s_lat[i] = (IsrLatStats_t){0};
+        s_lat[i].min = 0xFFFFFFFFUL;
+    }
+
+#if ISR_LAT_ENABLE
+    IsrLat_CaptureInit();
+#endif
+}
+
+RAMFUNC void IsrLat_Record(IsrLatSrc src, uint32_t cycles)
+{
+    IsrLatStats_t *s = &s_lat[src];
+
+    s->count++;
+    s->sum += cycles;
+    s->sum_sq += (uint64_t)cycles * cycles;
+    if (cycles < s->min)
+        s->min = cycles;
+    if (cycles > s->max)
+    {
+        s->max = cycles;
+        s->max_ms = g_msTicks;
+    }
+    s->hist[IsrLat_Bin(cycles)]++;
+}
+
+void IsrLat_Missed(IsrLatSrc src)
+{
+    s_lat[src].missed++;
+}
+
+const IsrLatStats_t *IsrLat_Get(IsrLatSrc src)
+{
+    return &s_lat[src];
+}
+
+void IsrLat_Report(void)
+{
+    USART_Println("--- ISR LATENCY (cycles: min/mean/max, sigma, p50/p99) ---");
+
+    for (uint32_t i = 0; i < ISRLAT_SRC_COUNT; i++)
+    {
+        // снимок, чтобы прерывание не меняло цифры посреди печати
+        __disable_irq();
+        IsrLatStats_t s = s_lat[i];
+        __enable_irq();
+
+        if (s.count == 0)
+            continue;
+
+        float mean = (float)s.sum / (float)s.count;
+        float var = (float)s.sum_sq / (float)s.count - mean * mean;
+        float sigma = (var > 0.0f) ? sqrtf(var) : 0.0f;
+
+        USART_Print(s_latNames[i]);
+        USART_Print(": ");
+        USART_PrintInt((int32_t)s.min);
+        USART_Print("/");
+        USART_PrintFloat(mean, 1);
+        USART_Print("/");
+        USART_PrintInt((int32_t)s.max);
+        USART_Print("  sigma=");
+        USART_PrintFloat(sigma, 1);
+        USART_Print("  p50=");
+        USART_PrintInt((int32_t)IsrLat_Percentile(&s, 50U));
+        USART_Print(" p99=");
+        USART_PrintInt((int32_t)IsrLat_Percentile(&s, 99U));
+        USART_Print("  n=");
+        USART_PrintInt((int32_t)s.count);
+        USART_Print(" missed=");
+        USART_PrintInt((int32_t)s.missed);
+        USART_Print("  worst@");
+        USART_PrintInt((int32_t)s.max_ms);
+        USART_Println("ms");
+
+        // гистограмма: только непустые корзины, "нижняя_граница:число"
+        USART_Print("  hist");
+        for (uint32_t b = 0; b < ISRLAT_BINS; b++)
+        {
+            if (s.hist[b] == 0)
+                continue;
+            USART_Print(" ");
+            USART_PrintInt((int32_t)IsrLat_BinLow(b));
+            USART_Print(":");
+            USART_PrintInt((int32_t)s.hist[b]);
+        }
+        USART_Println("");
+    }
+
+    // текущие приоритеты — рядом с цифрами, по которым их выбирать
+    USART_Print("NVIC prio: SysTick=");
+    USART_PrintInt((int32_t)NVIC_GetPriority(SysTick_IRQn));
+    USART_Print(" EXTI9_5=");
+    USART_PrintInt((int32_t)NVIC_GetPriority(EXTI9_5_IRQn));
+    USART_Print(" TIM2=");
+    USART_PrintInt((int32_t)NVIC_GetPriority(TIM2_IRQn));
+    USART_Print(" USART3=");
+    USART_PrintInt((int32_t)NVIC_GetPriority(USART3_IRQn));
+    USART_Print(" I2C1_EV=");
+    USART_PrintlnInt((int32_t)NVIC_GetPriority(I2C1_EV_IRQn));
+}
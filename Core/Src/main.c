@@ -4,43 +4,119 @@
 #include "motor.h"
 #include "encoder.h"
 #include "robot_motion.h"
+#include "trace.h"
+#include "mem_sections.h"
+#include "perf.h"
+#include "timebase.h"
+#include "sensor_log.h"
+#include "persist.h"
+#include "stall_detect.h"
+#include "deadline.h"
+#include "odometry.h"
+#include "bench.h"
+#include "isr_latency.h"
+#include "teleop.h"
+#include "odom_calib.h"
+#include "GU521_init.h"
+#include "MPU6050.h"
 #include "stm32f4xx.h"
 
-extern volatile uint32_t g_msTicks;
-
-static void Delay_ms(uint32_t ms)
+#if MOTION_USE_IMU || ODOM_CAL_ENABLE
+/* I2C1 + MPU6050 (как в main_gyro.c). @return 1 — датчик ответил */
+static uint8_t imu_start(void)
 {
-    uint32_t start = g_msTicks;
-    while ((g_msTicks - start) < ms)
+    GY521_I2C1_Init();
+    Time_DelayMs(100); // модуль просыпается
+    MPU6050_Init();
+
+    if (MPU6050_ReadWhoAmI() != 0x68)
     {
+        USART_Println("ERROR: MPU6050 not responding!");
+        return 0;
     }
+    return 1;
 }
+#endif
 
 int main(void)
 {
+    MemSections_Init();
     Clock_Init();
     SysTick_Init_1ms();
+    Time_Init();
     USART3_Init(115200);
+    Trace_Init();
+    Perf_Init();
+    SensorLog_Init();
+    Persist_Init();
 
     USART_Println("=== SIMPLE DIST TEST (SIGN CALIB) ===");
 
     Motor_Init();
     Encoder_Init();
+    IsrLat_Init();
+    if (!Odom_Init())
+        USART_Println("Odometry: no calibration, nominal scale");
+#if MOTION_USE_IMU || ODOM_CAL_ENABLE
+    uint8_t imuOk = imu_start();
+#endif
+#if MOTION_USE_IMU
+    // детектор удара в DriveDistanceMM; без датчика — только заклинивание
+    Motion_SetImu(imuOk);
+#endif
+    Stall_Init();
+    Deadline_Init();
+
+    if (Deadline_WasWatchdogReset())
+        USART_Println("WARNING: previous reset by IWDG (see trace)");
 
     USART_Println("Init OK");
-    Delay_ms(1000);
+
+#if BENCH_ENABLE
+    // до сценария: моторы стоят, в USART3 — строка JSON для Tools/bench_compare.py
+    Bench_RunAll();
+#endif
+    Time_DelayMs(1000);
+
+#if ODOM_CAL_ENABLE
+    // вместо сценария — калибровка одометрии (odom_calib.h); результат
+    // в backup SRAM, следующие прошивки подхватят его в Odom_Init()
+    if (imuOk)
+        OdomCal_RunGyro(ODOM_CAL_REFERENCE);
+    while (1)
+    {
+        Deadline_Alive();
+        Time_DelayMs(1000);
+    }
+#endif
+
+#if TELEOP_ENABLE
+    // вместо сценария — уставки (v, ω) с хоста: Tools/teleop.py
+    Teleop_Init();
+    Teleop_Run();
+#endif
 
     // ПРОБА 1: Вперёд 30 см, PWM 50
-    MoveForwardMM(300.0f, 65);
-    Delay_ms(1000);
+    if (MoveForwardMM(300.0f, 65) != MOTION_OK)
+        USART_Println("Forward run aborted");
+    Time_DelayMs(1000);
 
     // ПРОБА 2: Назад 30 см, PWM 50
-    MoveBackwardMM(300.0f, 65);
+    if (MoveBackwardMM(300.0f, 65) != MOTION_OK)
+        USART_Println("Backward run aborted");
 
     USART_Println("=== SCRIPT DONE ===");
 
+    // Выгрузка самописца: сохранить лог и прогнать через Tools/trace2json.py
+    Trace_Dump();
+    Perf_Report();
+    Deadline_Report();
+#if ISR_LAT_ENABLE
+    IsrLat_Report();
+#endif
+
     while (1)
     {
-        Delay_ms(1000);
+        Time_DelayMs(1000);
     }
 }
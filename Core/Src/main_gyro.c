@@ -3,28 +3,31 @@
 #include "usart.h"
 #include "GU521_init.h"
 #include "MPU6050.h"
+#include "trace.h"
+#include "mem_sections.h"
+#include "timebase.h"
+#include "fast_math.h"
+#include "persist.h"
+#include "gyro_tempcomp.h"
+#include "deadline.h"
+#include "i2c_bus.h"
 #include "stm32f4xx.h"
 
-extern volatile uint32_t g_msTicks;
-
-static void Delay_ms(uint32_t ms)
-{
-    uint32_t start = g_msTicks;
-    while ((g_msTicks - start) < ms)
-    {
-    }
-}
-
 int maing(void)
 {
     /* 1. Тактирование ядра и шин */
+    MemSections_Init();
     Clock_Init();
 
-    /* 2. SysTick на 1 мс (g_msTicks) */
+    /* 2. SysTick на 1 мс (g_msTicks) + микросекундная шкала TIM2 */
     SysTick_Init_1ms();
+    Time_Init();
 
     /* 3. UART для отладочного вывода (USART3 на PD8/PD9) */
     USART3_Init(115200);
+    Trace_Init();
+    Persist_Init();
+    Deadline_Init();
     USART_Println("=== Simple MPU6050 test (I2C1 PB8/PB9) ===");
     USART_Println("=== Robot gyro test (yaw) ===");
 
@@ -33,7 +36,7 @@ int maing(void)
     USART_Println("I2C1 init done");
 
     /* Небольшая пауза, чтобы модуль проснулся */
-    Delay_ms(100);
+    Time_DelayMs(100);
 
     /* 5. Инициализация MPU6050 */
     MPU6050_Init();
@@ -47,9 +50,12 @@ int maing(void)
     if (id != 0x68)
     {
         USART_Println("ERROR: MPU6050 not responding!");
+
+        // авария: моторы выключены, IWDG перезагрузит контроллер (повторная попытка)
+        Deadline_Failsafe(DL_REASON_IMU_ABSENT);
         while (1)
         {
-            // висим, если датчик не отвечает
+            __WFI();
         }
     }
     USART_Println("MPU6050 OK!");
@@ -69,44 +75,75 @@ int maing(void)
 
     USART_Println("Calibration done.");
 
-    /* 7. Основной цикл: читаем аксель/гиро/температуру */
-
     int16_t accel[3];
     int16_t gyro[3];
     int16_t temp_raw;
+    ImuSample_t imu;
+    ImuPhys_t phys;
+
+    // --- Температурная модель смещения: стартовая калибровка — первая точка ---
+    static GyroTC_t gyro_tc;
+    if (GyroTC_Init(&gyro_tc))
+        USART_Println("Gyro temp table restored from backup SRAM");
+
+    MPU6050_ReadRaw(accel, gyro, &temp_raw);
+    const float boot_bias[3] = {gyro_bias_x, gyro_bias_y, gyro_bias_z};
+    GyroTC_Learn(&gyro_tc, MPU6050_TempLSB_to_C(temp_raw), boot_bias);
+
+    USART_Print("Temp [degC]: ");
+    USART_PrintlnFloat(MPU6050_TempLSB_to_C(temp_raw), 2);
+
+    /* 7. Основной цикл: читаем аксель/гиро/температуру */
 
     float yaw_deg = 0.0f;
-    uint32_t lastTicks = g_msTicks;
+    uint32_t lastUs = Time_Us();
+    Timeout_t saveTimer;
+    Timeout_Start(&saveTimer, 60000000UL); // сохраняем таблицу раз в минуту
+
+    // цикл ~50 Гц; бюджет с запасом на таймауты I2C и печать
+    Deadline_Enable(DL_TASK_IMU, 100U);
 
     while (1)
     {
 
-        uint32_t now = g_msTicks;
-        float dt = (now - lastTicks) / 1000.0f; // мс → сек
-        lastTicks = now;
+        Deadline_CheckIn(DL_TASK_IMU);
+
+        if (!MPU6050_ReadSample(&imu))
+        {
+            Time_DelayMs(20);
+            continue;
+        }
 
-        MPU6050_ReadRaw(accel, gyro, &temp_raw);
+        // dt — между отметками самих отсчётов (мкс → сек)
+        float dt = (imu.t_us - lastUs) * 1e-6f;
+        lastUs = imu.t_us;
 
-        // переводим сырые значения в dps
-        float gx = MPU6050_GyroLSB_to_dps(gyro[0]) - gyro_bias_x;
-        float gy = MPU6050_GyroLSB_to_dps(gyro[1]) - gyro_bias_y;
-        float gz = MPU6050_GyroLSB_to_dps(gyro[2]) - gyro_bias_z;
+        // переводим сырые значения в dps (пакетом) и вычитаем bias(T);
+        // моторы в этом тесте выключены — покой определяется по самому гироскопу
+        MPU6050_ToPhys(&imu, &phys, 1U, NULL);
+        GyroTC_Process(&gyro_tc, imu.raw[IMU_TEMP], phys.gyro_dps, 1);
+        float gz = phys.gyro_dps[2];
 
         // интеграция yaw по оси Z
         yaw_deg += gz * dt; // gz в °/с, dt в сек → градусы
 
         // нормализация угла (чтобы не разрастался до бесконечности)
-        if (yaw_deg > 180.0f)
-            yaw_deg -= 360.0f;
-        if (yaw_deg < -180.0f)
-            yaw_deg += 360.0f;
+        yaw_deg = FM_WrapDeg180(yaw_deg);
 
         // Можешь печатать вместе с A, G и T, но главное — yaw_deg:
         USART_Print("Yaw[deg]: ");
         USART_PrintFloat(yaw_deg, 2);
         USART_Print("\r\n");
 
-        Delay_ms(20); // ~50 Гц
+        if (Timeout_Expired(&saveTimer))
+        {
+            GyroTC_Save(&gyro_tc);
+            I2CBus_Report();
+            I2CBus_ResetStats();
+            Timeout_Start(&saveTimer, 60000000UL);
+        }
+
+        Time_DelayMs(20); // ~50 Гц
 
         // /* Читаем сырые данные */
         // MPU6050_ReadRaw(accel, gyro, &temp_raw);
@@ -145,6 +182,6 @@ int maing(void)
         // USART_Println("----------------");
 
         // /* Частота обновления ~10 Гц */
-        // Delay_ms(100);
+        // Time_DelayMs(100);
     }
 }
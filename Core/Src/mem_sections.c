@@ -0,0 +1,23 @@
+// mem_sections.c
+#include "mem_sections.h"
+#include "stm32f4xx.h"
+
+#ifdef ROBOT_PERF_PROFILE
+/* Символы из линкер-скрипта */
+extern uint32_t _siccmram;
+extern uint32_t _sccmram;
+extern uint32_t _eccmram;
+#endif
+
+void MemSections_Init(void)
+{
+    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_CCMDATARAMEN);
+
+#ifdef ROBOT_PERF_PROFILE
+    const uint32_t *src = &_siccmram;
+    uint32_t *dst = &_sccmram;
+
+    while (dst < &_eccmram)
+        *dst++ = *src++;
+#endif
+}
@@ -1,292 +1,272 @@
 #include "motor.h"
+#include "trace.h"
 
 /******************************************************************************
  *                           MOTOR DRIVER — motor.c
  *
- * Управляет двумя моторами постоянного тока через драйвер H-моста.
+ * Управляет N моторами постоянного тока через драйверы H-моста.
  *
  * Каждый мотор имеет:
  *   - ДВЕ линии направления (INx)
- *   - Один PWM-сигнал от TIM1 (канал 1 или 2)
+ *   - Один PWM-сигнал от канала таймера (CH1..CH4)
  *
- * Конструкция подключения (важно для понимания):
+ * Вся привязка к железу — в таблице s_motorTable ниже. Код драйвера
+ * не знает ни про конкретные пины, ни про количество моторов:
+ * добавить мотор = добавить строку в таблицу и значение в MotorId.
  *
- *   MOTOR_A (левый):
- *      IN1 = PE2
- *      IN2 = PD11
- *      PWM = TIM1_CH1 (PE9)
- *
- *   MOTOR_B (правый):
- *      IN3 = PD12
- *      IN4 = PD13
- *      PWM = TIM1_CH2 (PE11)
- *
- * PWM генерируется таймером TIM1 (частота 20 кГц).
  * Направление задаётся комбинациями INx:
  *
  *      Вперёд:   IN1=0, IN2=1
  *      Назад:    IN1=1, IN2=0
- *      Стоп:     IN1=0, IN2=0   (электротормоз)
+ *      Выбег:    IN1=0, IN2=0   (coast)
+ *      Тормоз:   IN1=1, IN2=1   (short-brake, PWM=100%)
  *
  *****************************************************************************/
 
-/* --- ЛОКАЛЬНЫЕ ПРОТОТИПЫ --- */
-static void Motor_ClockInit(void);
-static void Motor_GPIO_DirPins_Init(void);
-static void Motor_GPIO_PwmPins_Init(void);
-static void Motor_TIM1_Init(void);
+/******************************************************************************
+ *                              КОНФИГУРАЦИЯ
+ *
+ * Строка на мотор: IN1 (порт, пин), IN2 (порт, пин),
+ *                  PWM (порт, пин, AF), таймер, канал.
+ *
+ * Пины MOTOR_C/MOTOR_D — свободные на плате по умолчанию;
+ * проверить по схеме перед включением MOTOR_4WD.
+ *****************************************************************************/
 
-static void Motor_SetDir(MotorId id, int8_t dir);
+static const MotorDesc_t s_motorTable[MOTOR_COUNT] = {
+    /* MOTOR_A */ {GPIOE, 2, GPIOD, 11, GPIOE, 9, 1, TIM1, 1},
+    /* MOTOR_B */ {GPIOD, 12, GPIOD, 13, GPIOE, 11, 1, TIM1, 2},
+#if MOTOR_4WD
+    /* MOTOR_C */ {GPIOD, 14, GPIOD, 15, GPIOE, 13, 1, TIM1, 3},
+    /* MOTOR_D */ {GPIOG, 2, GPIOG, 3, GPIOE, 14, 1, TIM1, 4},
+#endif
+};
+
+/* Не больше портов INx / таймеров, чем моторов */
+#define MOTOR_MAX_PORTS (2U * MOTOR_COUNT)
+#define MOTOR_MAX_TIMS MOTOR_COUNT
+
+/* Внутренние коды направления (Motor_DirBits) */
+#define MOTOR_DIR_COAST 0
+#define MOTOR_DIR_FWD 1
+#define MOTOR_DIR_REV (-1)
+#define MOTOR_DIR_BRAKE 2
+
+/* CCR канала мотора: CCR1..CCR4 идут в TIM_TypeDef подряд */
+#define MOTOR_CCR(d) ((&(d)->tim->CCR1)[(d)->channel - 1U])
+
+/* --- Построенные в Motor_Init() списки портов и таймеров --- */
+static GPIO_TypeDef *s_ports[MOTOR_MAX_PORTS];
+static uint8_t s_portCount = 0;
+static uint8_t s_in1Port[MOTOR_COUNT]; // индекс порта IN1 в s_ports
+static uint8_t s_in2Port[MOTOR_COUNT]; // индекс порта IN2 в s_ports
+
+static TIM_TypeDef *s_tims[MOTOR_MAX_TIMS];
+static uint8_t s_timCount = 0;
+
+/* --- ЛОКАЛЬНЫЕ ПРОТОТИПЫ --- */
+static uint8_t Motor_PortIndex(GPIO_TypeDef *port);
+static void Motor_GpioClock(GPIO_TypeDef *port);
+static void Motor_GpioOutput(GPIO_TypeDef *port, uint8_t pin);
+static void Motor_GpioAf(GPIO_TypeDef *port, uint8_t pin, uint8_t af);
+static uint32_t Motor_TimClock(TIM_TypeDef *tim);
+static uint8_t Motor_TimIsAdvanced(TIM_TypeDef *tim);
+static void Motor_TimInit(TIM_TypeDef *tim);
+static void Motor_TimChannelInit(TIM_TypeDef *tim, uint8_t ch);
+
+static void Motor_DirBits(MotorId id, int8_t dir, uint32_t *bsrr);
+static void Motor_WriteDir(MotorId id, int8_t dir);
 static void Motor_SetPwm(MotorId id, uint16_t value);
 
 /******************************************************************************
- *                           Motor_ClockInit()
+ *                        Motor_PortIndex()
  *
- * Включает тактирование:
- *   - GPIO портов: D и E
- *   - таймера TIM1 (через APB2)
- *
- * Без включения тактирования любые попытки записи в регистры GPIO/TIM1
- * будут либо проигнорированы, либо вызовут ошибку.
+ * Индекс порта в s_ports; новый порт добавляется в список.
+ * Нужен для пакетной записи BSRR: одно слово на порт.
  *****************************************************************************/
-static void Motor_ClockInit(void)
+static uint8_t Motor_PortIndex(GPIO_TypeDef *port)
 {
-    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIODEN);
-    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOEEN);
+    for (uint8_t i = 0; i < s_portCount; i++)
+        if (s_ports[i] == port)
+            return i;
 
-    SET_BIT(RCC->APB2ENR, RCC_APB2ENR_TIM1EN);
+    s_ports[s_portCount] = port;
+    return s_portCount++;
 }
 
 /******************************************************************************
- *                  Motor_GPIO_DirPins_Init()
- *
- * Настраивает линии направления IN1–IN4 как цифровые выходы.
- *
- * Пины:
- *     IN1 = PE2
- *     IN2 = PD11
- *     IN3 = PD12
- *     IN4 = PD13
+ *                        Тактирование и режимы GPIO
  *
- * Все пины настраиваются как:
- *      MODE  = output (01)
- *      OTYPER = push-pull
- *      OSPEED = high speed (для лучшего отклика)
- *      PUPDR = no pull
- *
- * Затем выставляется начальное состояние всех INx = 0 (тормоз).
+ * Бит тактирования порта в RCC->AHB1ENR равен его номеру:
+ * GPIOA=0, GPIOB=1, ... (порты идут с шагом 0x400).
  *****************************************************************************/
-static void Motor_GPIO_DirPins_Init(void)
+static void Motor_GpioClock(GPIO_TypeDef *port)
 {
-    /* Тактирование портов */
-    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIODEN);
-    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOEEN);
-
-    /************** IN1 = PE2 **************/
-    MODIFY_REG(GPIOE->MODER, GPIO_MODER_MODER2_Msk,
-               (0x1UL << GPIO_MODER_MODER2_Pos)); // output mode
-
-    CLEAR_BIT(GPIOE->OTYPER, GPIO_OTYPER_OT_2); // push-pull
-
-    MODIFY_REG(GPIOE->OSPEEDR, GPIO_OSPEEDR_OSPEED2_Msk,
-               (0x3UL << GPIO_OSPEEDR_OSPEED2_Pos)); // high speed
-
-    MODIFY_REG(GPIOE->PUPDR, GPIO_PUPDR_PUPD2_Msk, 0U);
-
-    /************** IN2=PD11, IN3=PD12, IN4=PD13 **************/
-
-    MODIFY_REG(GPIOD->MODER,
-               GPIO_MODER_MODER11_Msk |
-                   GPIO_MODER_MODER12_Msk |
-                   GPIO_MODER_MODER13_Msk,
-               (0x1UL << GPIO_MODER_MODER11_Pos) |
-                   (0x1UL << GPIO_MODER_MODER12_Pos) |
-                   (0x1UL << GPIO_MODER_MODER13_Pos));
-
-    CLEAR_BIT(GPIOD->OTYPER,
-              GPIO_OTYPER_OT_11 |
-                  GPIO_OTYPER_OT_12 |
-                  GPIO_OTYPER_OT_13);
-
-    MODIFY_REG(GPIOD->OSPEEDR,
-               GPIO_OSPEEDR_OSPEED11_Msk |
-                   GPIO_OSPEEDR_OSPEED12_Msk |
-                   GPIO_OSPEEDR_OSPEED13_Msk,
-               (0x3UL << GPIO_OSPEEDR_OSPEED11_Pos) |
-                   (0x3UL << GPIO_OSPEEDR_OSPEED12_Pos) |
-                   (0x3UL << GPIO_OSPEEDR_OSPEED13_Pos));
-
-    MODIFY_REG(GPIOD->PUPDR,
-               GPIO_PUPDR_PUPD11_Msk |
-                   GPIO_PUPDR_PUPD12_Msk |
-                   GPIO_PUPDR_PUPD13_Msk,
-               0U);
-
-    /* Начальное состояние — стоп (все INx = 0) */
-    SET_BIT(GPIOE->BSRR, GPIO_BSRR_BR_2);
-    SET_BIT(GPIOD->BSRR,
-            GPIO_BSRR_BR_11 |
-                GPIO_BSRR_BR_12 |
-                GPIO_BSRR_BR_13);
+    uint32_t idx = (uint32_t)(((uintptr_t)port - (uintptr_t)GPIOA) >> 10);
+    SET_BIT(RCC->AHB1ENR, 1UL << idx);
+}
+
+static void Motor_GpioOutput(GPIO_TypeDef *port, uint8_t pin)
+{
+    Motor_GpioClock(port);
+
+    MODIFY_REG(port->MODER, 0x3UL << (2U * pin), 0x1UL << (2U * pin)); // output
+    CLEAR_BIT(port->OTYPER, 1UL << pin);                               // push-pull
+    MODIFY_REG(port->OSPEEDR, 0x3UL << (2U * pin), 0x3UL << (2U * pin)); // high speed
+    MODIFY_REG(port->PUPDR, 0x3UL << (2U * pin), 0U);                    // no pull
+
+    port->BSRR = 1UL << (pin + 16U); // начальное состояние — 0 (выбег)
+}
+
+static void Motor_GpioAf(GPIO_TypeDef *port, uint8_t pin, uint8_t af)
+{
+    Motor_GpioClock(port);
+
+    MODIFY_REG(port->MODER, 0x3UL << (2U * pin), 0x2UL << (2U * pin)); // AF
+    CLEAR_BIT(port->OTYPER, 1UL << pin);
+    MODIFY_REG(port->OSPEEDR, 0x3UL << (2U * pin), 0x3UL << (2U * pin));
+    MODIFY_REG(port->PUPDR, 0x3UL << (2U * pin), 0U);
+
+    MODIFY_REG(port->AFR[pin >> 3],
+               0xFUL << (4U * (pin & 7U)),
+               (uint32_t)af << (4U * (pin & 7U)));
 }
 
 /******************************************************************************
- *                    Motor_GPIO_PwmPins_Init()
+ *                           Motor_TimClock()
  *
- * Настройка PE9 (CH1) и PE11 (CH2) в режим PWM:
- *    - MODER = Alternate function (10b)
- *    - AF = AF1  (TIM1)
- *    - High speed
- *
- * TIM1 управляет этими двумя пинами в режиме PWM.
+ * Включает тактирование таймера и возвращает его входную частоту:
+ *   TIM1, TIM8 — APB2 × 2 = 168 МГц
+ *   TIM3, TIM4 — APB1 × 2 = 84 МГц
  *****************************************************************************/
-static void Motor_GPIO_PwmPins_Init(void)
+static uint32_t Motor_TimClock(TIM_TypeDef *tim)
+{
+    if (tim == TIM1)
+    {
+        SET_BIT(RCC->APB2ENR, RCC_APB2ENR_TIM1EN);
+        return 168000000UL;
+    }
+    if (tim == TIM8)
+    {
+        SET_BIT(RCC->APB2ENR, RCC_APB2ENR_TIM8EN);
+        return 168000000UL;
+    }
+    if (tim == TIM3)
+    {
+        SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM3EN);
+        return 84000000UL;
+    }
+    if (tim == TIM4)
+    {
+        SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM4EN);
+        return 84000000UL;
+    }
+    return 0;
+}
+
+static uint8_t Motor_TimIsAdvanced(TIM_TypeDef *tim)
 {
-    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOEEN);
-
-    MODIFY_REG(GPIOE->MODER,
-               GPIO_MODER_MODER9_Msk |
-                   GPIO_MODER_MODER11_Msk,
-               (0x2UL << GPIO_MODER_MODER9_Pos) |
-                   (0x2UL << GPIO_MODER_MODER11_Pos)); // AF
-
-    CLEAR_BIT(GPIOE->OTYPER, GPIO_OTYPER_OT_9 | GPIO_OTYPER_OT_11);
-
-    MODIFY_REG(GPIOE->OSPEEDR,
-               GPIO_OSPEEDR_OSPEED9_Msk |
-                   GPIO_OSPEEDR_OSPEED11_Msk,
-               (0x3UL << GPIO_OSPEEDR_OSPEED9_Pos) |
-                   (0x3UL << GPIO_OSPEEDR_OSPEED11_Pos)); // high
-
-    MODIFY_REG(GPIOE->PUPDR,
-               GPIO_PUPDR_PUPD9_Msk | GPIO_PUPDR_PUPD11_Msk,
-               0U);
-
-    MODIFY_REG(GPIOE->AFR[1],
-               GPIO_AFRH_AFSEL9_Msk |
-                   GPIO_AFRH_AFSEL11_Msk,
-               (0x1UL << GPIO_AFRH_AFSEL9_Pos) |
-                   (0x1UL << GPIO_AFRH_AFSEL11_Pos)); // AF1=TIM1
+    return (tim == TIM1 || tim == TIM8) ? 1U : 0U;
 }
 
 /******************************************************************************
- *                           Motor_TIM1_Init()
+ *                           Motor_TimInit()
  *
- * Полная настройка TIM1 на генерацию PWM 20 кГц на CH1 и CH2.
+ * Базовая настройка таймера на PWM 20 кГц:
+ *     PSC — из частоты таймера (TIM1: 83)
+ *     ARR = 99
+ *     ARPE = 1
  *
- * Параметры PWM:
- *     PSC = 83   (делит 168 МГц → 2 МГц)
- *     ARR = 99   (2 МГц / 100 → 20 кГц)
+ * У TIM1/TIM8 дополнительно:
+ *     - OSSI = 1, OISx = 0: при MOE = 0 выходы принудительно в 0,
+ *       а не «висят в воздухе» (важно для аварийного отключения)
+ *     - MOE = 1 (обязательно для продвинутых таймеров)
  *
- * Каналы настроены:
+ * Каналы настраиваются отдельно (Motor_TimChannelInit), таймер
+ * запускается после них.
+ *****************************************************************************/
+static void Motor_TimInit(TIM_TypeDef *tim)
+{
+    uint32_t clk = Motor_TimClock(tim);
+
+    CLEAR_BIT(tim->CR1, TIM_CR1_CEN); // стоп
+
+    WRITE_REG(tim->PSC, clk / (MOTOR_PWM_FREQ_HZ * (MOTOR_TIM1_ARR + 1U)) - 1U);
+    WRITE_REG(tim->ARR, MOTOR_TIM1_ARR);
+
+    SET_BIT(tim->CR1, TIM_CR1_ARPE);
+
+    if (Motor_TimIsAdvanced(tim))
+    {
+        SET_BIT(tim->BDTR, TIM_BDTR_OSSI);
+        SET_BIT(tim->BDTR, TIM_BDTR_MOE);
+    }
+}
+
+/******************************************************************************
+ *                        Motor_TimChannelInit()
+ *
+ * Канал ch (1..4):
+ *     - CCxS = 00 (выход)
  *     - PWM mode 1 (OCxM = 110)
  *     - Preload CCR включён (OCxPE = 1)
- *     - Выходы CH1/CH2 разрешены в CCER
- *     - MOE = 1 (обязательно для TIM1)
+ *     - выход разрешён в CCER (CCxE)
+ *
+ * CH1/CH2 живут в CCMR1, CH3/CH4 — в CCMR2, по 8 бит на канал.
  *****************************************************************************/
-static void Motor_TIM1_Init(void)
+static void Motor_TimChannelInit(TIM_TypeDef *tim, uint8_t ch)
 {
-    CLEAR_BIT(TIM1->CR1, TIM_CR1_CEN); // стоп
-
-    WRITE_REG(TIM1->PSC, MOTOR_TIM1_PSC);
-    WRITE_REG(TIM1->ARR, MOTOR_TIM1_ARR);
-
-    /*** Канал 1 (Motor A) ***/
-    MODIFY_REG(TIM1->CCMR1,
-               TIM_CCMR1_CC1S_Msk |
-                   TIM_CCMR1_OC1M_Msk |
-                   TIM_CCMR1_OC1PE_Msk,
-               (0x0 << TIM_CCMR1_CC1S_Pos) |
-                   (0x6 << TIM_CCMR1_OC1M_Pos) |
-                   TIM_CCMR1_OC1PE);
-
-    /*** Канал 2 (Motor B) ***/
-    MODIFY_REG(TIM1->CCMR1,
-               TIM_CCMR1_CC2S_Msk |
-                   TIM_CCMR1_OC2M_Msk |
-                   TIM_CCMR1_OC2PE_Msk,
-               (0x0 << TIM_CCMR1_CC2S_Pos) |
-                   (0x6 << TIM_CCMR1_OC2M_Pos) |
-                   TIM_CCMR1_OC2PE);
-
-    MODIFY_REG(TIM1->CCER,
-               TIM_CCER_CC1E_Msk |
-                   TIM_CCER_CC2E_Msk,
-               TIM_CCER_CC1E | TIM_CCER_CC2E);
-
-    WRITE_REG(TIM1->CCR1, 0);
-    WRITE_REG(TIM1->CCR2, 0);
-
-    SET_BIT(TIM1->CR1, TIM_CR1_ARPE);
-    SET_BIT(TIM1->BDTR, TIM_BDTR_MOE);
-    SET_BIT(TIM1->EGR, TIM_EGR_UG);
-    SET_BIT(TIM1->CR1, TIM_CR1_CEN);
+    volatile uint32_t *ccmr = (ch <= 2U) ? &tim->CCMR1 : &tim->CCMR2;
+    uint32_t sh = ((ch - 1U) & 1U) * 8U;
+
+    MODIFY_REG(*ccmr, 0xFFUL << sh, ((0x6UL << 4) | (1UL << 3)) << sh);
+    SET_BIT(tim->CCER, 1UL << (4U * (ch - 1U)));
+
+    (&tim->CCR1)[ch - 1U] = 0;
 }
 
 /******************************************************************************
- *                      Motor_SetDir() — направление
+ *                      Motor_DirBits() — направление
  *
- * Устанавливает логические уровни на INx в зависимости от dir:
+ * Добавляет в слова BSRR (по индексу порта) биты линий INx мотора:
  *
- *      dir > 0 → вперёд
- *      dir < 0 → назад
- *      dir = 0 → стоп (IN1=0, IN2=0)
- *
- * Реализация через GPIOx->BSRR:
- *   - BS_  → установить 1
- *   - BR_  → установить 0
+ *      MOTOR_DIR_FWD   → IN1=0, IN2=1
+ *      MOTOR_DIR_REV   → IN1=1, IN2=0
+ *      MOTOR_DIR_COAST → IN1=0, IN2=0
+ *      MOTOR_DIR_BRAKE → IN1=1, IN2=1
  *
+ * Младшие 16 бит BSRR — установить 1, старшие — сбросить в 0.
+ * Если IN1 и IN2 на одном порту, биты сливаются в одно слово.
  *****************************************************************************/
-static void Motor_SetDir(MotorId id, int8_t dir)
+static void Motor_DirBits(MotorId id, int8_t dir, uint32_t *bsrr)
 {
-    switch (id)
-    {
-    case MOTOR_A:
-        if (dir > 0) // вперёд
-        {
-            GPIOE->BSRR = GPIO_BSRR_BR_2;  // IN1 = 0
-            GPIOD->BSRR = GPIO_BSRR_BS_11; // IN2 = 1
-        }
-        else if (dir < 0) // назад
-        {
-            GPIOE->BSRR = GPIO_BSRR_BS_2;  // IN1 = 1
-            GPIOD->BSRR = GPIO_BSRR_BR_11; // IN2 = 0
-        }
-        else // стоп
-        {
-            GPIOE->BSRR = GPIO_BSRR_BR_2;
-            GPIOD->BSRR = GPIO_BSRR_BR_11;
-        }
-        break;
+    const MotorDesc_t *d = &s_motorTable[id];
+    uint32_t in1 = 1UL << d->in1_pin;
+    uint32_t in2 = 1UL << d->in2_pin;
 
-    case MOTOR_B:
-        if (dir > 0)
-        {
-            GPIOD->BSRR = GPIO_BSRR_BR_12;
-            GPIOD->BSRR = GPIO_BSRR_BS_13;
-        }
-        else if (dir < 0)
-        {
-            GPIOD->BSRR = GPIO_BSRR_BS_12;
-            GPIOD->BSRR = GPIO_BSRR_BR_13;
-        }
-        else
-        {
-            GPIOD->BSRR = GPIO_BSRR_BR_12 |
-                          GPIO_BSRR_BR_13;
-        }
-        break;
-    }
+    uint8_t in1Hi = (dir == MOTOR_DIR_REV || dir == MOTOR_DIR_BRAKE);
+    uint8_t in2Hi = (dir == MOTOR_DIR_FWD || dir == MOTOR_DIR_BRAKE);
+
+    bsrr[s_in1Port[id]] |= in1Hi ? in1 : (in1 << 16);
+    bsrr[s_in2Port[id]] |= in2Hi ? in2 : (in2 << 16);
+}
+
+/* Направление одного мотора: одна или две записи BSRR */
+static void Motor_WriteDir(MotorId id, int8_t dir)
+{
+    uint32_t bsrr[MOTOR_MAX_PORTS] = {0};
+
+    Motor_DirBits(id, dir, bsrr);
+
+    s_ports[s_in1Port[id]]->BSRR = bsrr[s_in1Port[id]];
+    if (s_in2Port[id] != s_in1Port[id])
+        s_ports[s_in2Port[id]]->BSRR = bsrr[s_in2Port[id]];
 }
 
 /******************************************************************************
  *                       Motor_SetPwm() — скважность PWM
  *
- * Записывает значение value в соответствующий регистр CCR:
- *
- *      MOTOR_A → CCR1
- *      MOTOR_B → CCR2
- *
+ * Записывает value в CCR канала мотора.
  * value обязан быть в пределах 0..MOTOR_PWM_MAX.
  *****************************************************************************/
 static void Motor_SetPwm(MotorId id, uint16_t value)
@@ -294,31 +274,58 @@ static void Motor_SetPwm(MotorId id, uint16_t value)
     if (value > MOTOR_PWM_MAX)
         value = MOTOR_PWM_MAX;
 
-    if (id == MOTOR_A)
-        WRITE_REG(TIM1->CCR1, value);
-    else
-        WRITE_REG(TIM1->CCR2, value);
+    MOTOR_CCR(&s_motorTable[id]) = value;
 }
 
 /******************************************************************************
  *                                 Motor_Init()
  *
- * Полная инициализация драйвера:
- *   1. Включить тактирование TIM1, GPIO
- *   2. Настроить IN1-In4 как выходы
- *   3. Настроить PWM-пины (PE9/PE11) под TIM1 AF1
- *   4. Настроить TIM1 под PWM 20 кГц
- *   5. Остановить оба мотора
+ * Полная инициализация драйвера по таблице:
+ *   1. IN1/IN2 всех моторов — выходы; списки портов для пакетной записи
+ *   2. PWM-пины — AF таймера
+ *   3. Каждый таймер — PWM 20 кГц, затем его каналы
+ *   4. UG + запуск таймеров
+ *   5. Остановить все моторы
  *****************************************************************************/
 void Motor_Init(void)
 {
-    Motor_ClockInit();
-    Motor_GPIO_DirPins_Init();
-    Motor_GPIO_PwmPins_Init();
-    Motor_TIM1_Init();
+    s_portCount = 0;
+    s_timCount = 0;
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++)
+    {
+        const MotorDesc_t *d = &s_motorTable[i];
+
+        Motor_GpioOutput(d->in1_port, d->in1_pin);
+        Motor_GpioOutput(d->in2_port, d->in2_pin);
+        s_in1Port[i] = Motor_PortIndex(d->in1_port);
+        s_in2Port[i] = Motor_PortIndex(d->in2_port);
+
+        Motor_GpioAf(d->pwm_port, d->pwm_pin, d->pwm_af);
+
+        // таймер настраиваем один раз, при первом его канале
+        uint8_t known = 0;
+        for (uint8_t t = 0; t < s_timCount; t++)
+            if (s_tims[t] == d->tim)
+                known = 1;
+
+        if (!known)
+        {
+            s_tims[s_timCount++] = d->tim;
+            Motor_TimInit(d->tim);
+        }
+
+        Motor_TimChannelInit(d->tim, d->channel);
+    }
+
+    for (uint8_t t = 0; t < s_timCount; t++)
+    {
+        SET_BIT(s_tims[t]->EGR, TIM_EGR_UG);
+        SET_BIT(s_tims[t]->CR1, TIM_CR1_CEN);
+    }
 
-    Motor_SetSpeed(MOTOR_A, 0);
-    Motor_SetSpeed(MOTOR_B, 0);
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++)
+        Motor_SetSpeed((MotorId)i, 0);
 }
 
 /******************************************************************************
@@ -335,32 +342,144 @@ void Motor_Init(void)
  *****************************************************************************/
 void Motor_SetSpeed(MotorId id, int16_t speed)
 {
-    if (id != MOTOR_A && id != MOTOR_B)
+    if (id >= MOTOR_COUNT)
         return;
 
+    TRACE(TRACE_EV_PWM, id, (int32_t)speed);
+
     if (speed == 0)
     {
         Motor_SetPwm(id, 0);
-        Motor_SetDir(id, 0);
+        Motor_WriteDir(id, MOTOR_DIR_COAST);
         return;
     }
 
-    int8_t dir = (speed > 0) ? +1 : -1;
+    int8_t dir = (speed > 0) ? MOTOR_DIR_FWD : MOTOR_DIR_REV;
     uint16_t mag = (speed > 0) ? speed : -speed;
 
     if (mag > MOTOR_PWM_MAX)
         mag = MOTOR_PWM_MAX;
 
-    Motor_SetDir(id, dir);
+    Motor_WriteDir(id, dir);
     Motor_SetPwm(id, mag);
 }
 
+/******************************************************************************
+ *                        Motor_SetSpeeds(speeds)
+ *
+ * Все моторы за один проход:
+ *   1. собрать биты INx в слова BSRR по портам
+ *   2. записать по одному BSRR на порт
+ *   3. записать CCR всех каналов
+ *
+ * Стоимость почти не зависит от числа моторов: записей BSRR столько,
+ * сколько разных портов, а не 2 × моторов (2WD — 2, 4WD — 3).
+ *****************************************************************************/
+void Motor_SetSpeeds(const int16_t speeds[MOTOR_COUNT])
+{
+    uint32_t bsrr[MOTOR_MAX_PORTS] = {0};
+    uint16_t mag[MOTOR_COUNT];
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++)
+    {
+        int16_t s = speeds[i];
+        TRACE(TRACE_EV_PWM, i, (int32_t)s);
+
+        int8_t dir = (s > 0) ? MOTOR_DIR_FWD : (s < 0) ? MOTOR_DIR_REV
+                                                       : MOTOR_DIR_COAST;
+        uint16_t m = (s >= 0) ? (uint16_t)s : (uint16_t)(-s);
+        mag[i] = (m > MOTOR_PWM_MAX) ? MOTOR_PWM_MAX : m;
+
+        Motor_DirBits((MotorId)i, dir, bsrr);
+    }
+
+    for (uint8_t p = 0; p < s_portCount; p++)
+        if (bsrr[p])
+            s_ports[p]->BSRR = bsrr[p];
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++)
+        MOTOR_CCR(&s_motorTable[i]) = mag[i];
+}
+
 /******************************************************************************
  *                             Motor_Stop()
  *
- * Полный стоп → PWM=0 + INx=0 + электротормоз.
+ * Полный стоп → PWM=0 + INx=0 (свободный выбег).
  *****************************************************************************/
 void Motor_Stop(MotorId id)
 {
     Motor_SetSpeed(id, 0);
 }
+
+/******************************************************************************
+ *                             Motor_Brake()
+ *
+ * Активный тормоз. Сначала гасим PWM, чтобы не получить сквозной ток
+ * при смене INx, затем IN1=IN2=1 и CCR = ARR+1 (100% скважность —
+ * в PWM mode 1 выход активен весь период, когда CCR > ARR).
+ *****************************************************************************/
+void Motor_Brake(MotorId id)
+{
+    if (id >= MOTOR_COUNT)
+        return;
+
+    TRACE(TRACE_EV_BRAKE, id, 0);
+
+    Motor_SetPwm(id, 0);
+    Motor_WriteDir(id, MOTOR_DIR_BRAKE);
+
+    MOTOR_CCR(&s_motorTable[id]) = MOTOR_TIM1_ARR + 1U;
+}
+
+/******************************************************************************
+ *                             Motor_Coast()
+ *
+ * Свободный выбег: PWM=0, INx=0.
+ *****************************************************************************/
+void Motor_Coast(MotorId id)
+{
+    Motor_SetSpeed(id, 0);
+}
+
+/******************************************************************************
+ *                          Motor_StopWithMode()
+ *****************************************************************************/
+void Motor_StopWithMode(MotorId id, MotorStopMode mode)
+{
+    if (mode == MOTOR_STOP_BRAKE)
+        Motor_Brake(id);
+    else
+        Motor_Coast(id);
+}
+
+/******************************************************************************
+ *                          Motor_EmergencyOff()
+ *
+ * Аварийное отключение всех мостов (можно вызывать из прерывания):
+ *
+ *   1. EGR.BG у TIM1/TIM8 — программное событие break: MOE сбрасывается
+ *      аппаратно сразу, без ожидания конца периода PWM; выходы уходят
+ *      в 0 (OSSI/OIS).
+ *   2. CCR = 0 у всех каналов — даже если MOE включат обратно,
+ *      скважность нулевая (у TIM3/TIM4 break нет — только это).
+ *   3. INx = 0 — выбег.
+ *
+ * AOE не включён, поэтому MOE сам не восстановится: моторы остаются
+ * выключенными до повторного Motor_Init() (или до сброса по IWDG).
+ * Работает и до Motor_Init() — берёт всё прямо из таблицы.
+ *****************************************************************************/
+void Motor_EmergencyOff(void)
+{
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++)
+    {
+        const MotorDesc_t *d = &s_motorTable[i];
+
+        if (Motor_TimIsAdvanced(d->tim))
+            WRITE_REG(d->tim->EGR, TIM_EGR_BG);
+
+        MOTOR_CCR(d) = 0;
+
+        d->in1_port->BSRR = 1UL << (d->in1_pin + 16U);
+        d->in2_port->BSRR = 1UL << (d->in2_pin + 16U);
+    }
+}
@@ -0,0 +1,286 @@
+// odom_calib.c
+#include "odom_calib.h"
+#include "motor.h"
+#include "encoder.h"
+#include "MPU6050.h"
+#include "robot_motion.h"
+#include "deadline.h"
+#include "timebase.h"
+#include "fast_math.h"
+#include "usart.h"
+
+/* Бюджет одного прохода цикла калибровки (чтение IMU + энкодеры) */
+#define ODOM_CAL_DEADLINE_MS 50U
+
+/* --------------------------------------------------------------------------
+ * Решатель
+ * -------------------------------------------------------------------------- */
+void OdomCal_Begin(OdomCal_t *c)
+{
+    *c = (OdomCal_t){0};
+}
+
+void OdomCal_AddRun(OdomCal_t *c, int32_t nL, int32_t nR, float dtheta_rad)
+{
+    float r0 = (float)(nL + nR);
+    float r1 = -dtheta_rad;
+    float rhs = (float)(nL - nR);
+
+    c->a00 += r0 * r0;
+    c->a01 += r0 * r1;
+    c->a11 += r1 * r1;
+    c->y0 += r0 * rhs;
+    c->y1 += r1 * rhs;
+    c->runs++;
+}
+
+void OdomCal_SetReference(OdomCal_t *c, int32_t nL, int32_t nR, float distance_mm)
+{
+    c->ref_nL = nL;
+    c->ref_nR = nR;
+    c->ref_mm = distance_mm;
+}
+
+uint8_t OdomCal_Solve(const OdomCal_t *c, float mean_mm_per_tick, OdomCalib_t *out)
+{
+    float det = c->a00 * c->a11 - c->a01 * c->a01;
+
+    // нужны и развороты, и прямые, иначе система вырождена
+    if (c->runs < 2U || det <= 1e-6f * c->a00 * c->a11)
+        return 0;
+
+    float e = (c->a11 * c->y0 - c->a01 * c->y1) / det;
+    float beta = (c->a00 * c->y1 - c->a01 * c->y0) / det;
+
+    if (e > ODOM_CAL_MAX_ASYM || e < -ODOM_CAL_MAX_ASYM || beta <= 0.0f)
+        return 0;
+
+    float s = mean_mm_per_tick;
+    if (c->ref_mm > 0.0f)
+    {
+        float eff = 0.5f * ((1.0f - e) * (float)c->ref_nL + (1.0f + e) * (float)c->ref_nR);
+        if (eff <= 0.0f)
+            return 0;
+        s = c->ref_mm / eff;
+    }
+
+    out->mm_per_tick_left = s * (1.0f - e);
+    out->mm_per_tick_right = s * (1.0f + e);
+    out->track_mm = beta * s;
+    return 1;
+}
+
+/* --------------------------------------------------------------------------
+ * Процедура на роботе
+ * -------------------------------------------------------------------------- */
+
+/* Один заезд: едем до поворота turn_rad (если > 0) или до dist_mm по
+ * номинальному масштабу, останавливаемся и ещё ODOM_CAL_SETTLE_MS
+ * досчитываем тики и угол (выбег тоже входит в уравнение).
+ */
+static void cal_segment(int16_t pwmL, int16_t pwmR, float turn_rad, float dist_mm,
+                        float bias_dps, int32_t *nL, int32_t *nR, float *dtheta)
+{
+    ImuSample_t imu;
+    ImuPhys_t phys;
+    EncoderCursor_t cur;
+    Encoder_CursorInit(&cur);
+
+    int32_t sumL = 0, sumR = 0;
+    float th = 0.0f;
+    uint8_t running = 1;
+    uint32_t stopUs = 0;
+    uint32_t lastUs = Time_Us();
+
+    Deadline_Enable(DL_TASK_MOTION, ODOM_CAL_DEADLINE_MS);
+    Motor_SetSpeed(MOTOR_A, pwmL);
+    Motor_SetSpeed(MOTOR_B, pwmR);
+
+    while (1)
+    {
+        Deadline_CheckIn(DL_TASK_MOTION);
+
+        // время — отметка самого отсчёта, а не момент после чтения по I2C
+        if (MPU6050_ReadSample(&imu))
+        {
+            MPU6050_ToPhys(&imu, &phys, 1U, NULL);
+            float dt = (float)(imu.t_us - lastUs) * 1e-6f;
+            lastUs = imu.t_us;
+
+            float gz = (phys.gyro_dps[2] - bias_dps) * (float)ODOM_CAL_GYRO_SIGN;
+            th += gz * FM_DEG2RAD * dt;
+        }
+        uint32_t now = Time_Us();
+
+        uint32_t dL, dR;
+        Encoder_GetDelta(&cur, &dL, &dR);
+        sumL += (pwmL >= 0) ? (int32_t)dL : -(int32_t)dL;
+        sumR += (pwmR >= 0) ? (int32_t)dR : -(int32_t)dR;
+
+        if (running)
+        {
+            float absTh = (th >= 0.0f) ? th : -th;
+            float nominal = 0.5f * (float)((sumL >= 0 ? sumL : -sumL) + (sumR >= 0 ? sumR : -sumR)) *
+                            ENC_MM_PER_TICK;
+
+            if ((turn_rad > 0.0f && absTh >= turn_rad) ||
+                (turn_rad <= 0.0f && nominal >= dist_mm))
+            {
+                Motor_Brake(MOTOR_A);
+                Motor_Brake(MOTOR_B);
+                running = 0;
+                stopUs = now;
+            }
+        }
+        else if ((now - stopUs) >= ODOM_CAL_SETTLE_MS * 1000U)
+        {
+            break;
+        }
+    }
+
+    Motor_Coast(MOTOR_A);
+    Motor_Coast(MOTOR_B);
+    Deadline_Disable(DL_TASK_MOTION);
+
+    *nL = sumL;
+    *nR = sumR;
+    *dtheta = th;
+}
+
+/* Длина эталона от оператора: строка с целым числом мм до CR/LF.
+ * @return мм; 0 — пустая строка, не число или не дождались
+ */
+static float cal_read_mm(uint32_t wait_ms)
+{
+    Timeout_t t;
+    uint32_t mm = 0, digits = 0;
+
+    Timeout_Start(&t, wait_ms * 1000U);
+    while (!Timeout_Expired(&t))
+    {
+        Deadline_Alive(); // задач нет — IWDG держит отметка main
+
+        if (!USART_IsDataReceived())
+        {
+            Time_DelayMs(10);
+            continue;
+        }
+
+        char ch = USART_ReadChar();
+        if (ch == '\r' || ch == '\n')
+        {
+            if (digits)
+                break;
+            continue; // хвост CRLF прошлой строки
+        }
+        if (ch < '0' || ch > '9' || digits >= 6U)
+            return 0.0f;
+        mm = mm * 10U + (uint32_t)(ch - '0');
+        digits++;
+    }
+    return (float)mm;
+}
+
+uint8_t OdomCal_RunGyro(uint8_t with_reference)
+{
+    OdomCal_t cal;
+    OdomCal_Begin(&cal);
+
+    USART_Println("ODOM CAL: gyro bias, keep still...");
+    float bx, by, bz;
+    MPU6050_CalibrateGyro(&bx, &by, &bz);
+
+    const float spin = ODOM_CAL_SPIN_TURNS * FM_TWO_PI;
+    const int16_t sp = ODOM_CAL_SPIN_PWM;
+    const int16_t st = ODOM_CAL_STRAIGHT_PWM * MOTOR_FORWARD_SIGN;
+
+    /* Развороты: против часовой (левое назад, правое вперёд) и по часовой,
+     * прямые: вперёд и назад — остаточный дрейф гироскопа взаимно гасится.
+     */
+    const struct
+    {
+        int16_t pwmL, pwmR;
+        float turn;
+    } plan[4] = {
+        {(int16_t)(-sp * MOTOR_FORWARD_SIGN), (int16_t)(sp * MOTOR_FORWARD_SIGN), spin},
+        {(int16_t)(sp * MOTOR_FORWARD_SIGN), (int16_t)(-sp * MOTOR_FORWARD_SIGN), spin},
+        {st, st, 0.0f},
+        {(int16_t)-st, (int16_t)-st, 0.0f},
+    };
+
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        int32_t nL, nR;
+        float dth;
+
+        // знак тиков — по физическому направлению колеса, а не по знаку PWM
+        cal_segment(plan[i].pwmL, plan[i].pwmR, plan[i].turn, ODOM_CAL_STRAIGHT_MM,
+                    bz, &nL, &nR, &dth);
+        nL *= MOTOR_FORWARD_SIGN;
+        nR *= MOTOR_FORWARD_SIGN;
+
+        OdomCal_AddRun(&cal, nL, nR, dth);
+
+        USART_Print("run ");
+        USART_PrintInt((int32_t)i);
+        USART_Print(": nL=");
+        USART_PrintInt(nL);
+        USART_Print(" nR=");
+        USART_PrintInt(nR);
+        USART_Print(" dth[deg]=");
+        USART_PrintlnFloat(dth * FM_RAD2DEG, 2);
+
+        Time_DelayMs(500);
+    }
+
+    /* Эталон: тот же прямой заезд, длину меряет оператор. Заезд
+     * входит и в систему уравнений — ещё одно наблюдение асимметрии.
+     */
+    if (with_reference)
+    {
+        int32_t nL, nR;
+        float dth;
+
+        USART_Println("ODOM CAL: reference run, mark the start point");
+        Time_DelayMs(2000);
+        cal_segment(st, st, 0.0f, ODOM_CAL_STRAIGHT_MM, bz, &nL, &nR, &dth);
+        nL *= MOTOR_FORWARD_SIGN;
+        nR *= MOTOR_FORWARD_SIGN;
+        OdomCal_AddRun(&cal, nL, nR, dth);
+
+        USART_Println("ODOM CAL: type travelled distance in mm + Enter (empty - skip)");
+        float mm = cal_read_mm(ODOM_CAL_REF_WAIT_MS);
+        if (mm > 0.0f)
+        {
+            OdomCal_SetReference(&cal, nL, nR, mm);
+            USART_Print("ref[mm]=");
+            USART_PrintlnFloat(mm, 0);
+        }
+        else
+        {
+            USART_Println("ODOM CAL: no reference, mean scale kept");
+        }
+    }
+
+    const OdomCalib_t *old = Odom_GetCalib();
+    float mean = 0.5f * (old->mm_per_tick_left + old->mm_per_tick_right);
+
+    OdomCalib_t res;
+    if (!OdomCal_Solve(&cal, mean, &res))
+    {
+        USART_Println("ODOM CAL: FAILED (check gyro sign / wheel wiring)");
+        return 0;
+    }
+
+    Odom_SetCalib(&res);
+    Odom_SaveCalib();
+    Odom_Init(); // поза с нуля, курсор энкодеров — с текущего момента
+
+    USART_Print("ODOM CAL: mm/tick L=");
+    USART_PrintFloat(res.mm_per_tick_left, 4);
+    USART_Print(" R=");
+    USART_PrintFloat(res.mm_per_tick_right, 4);
+    USART_Print(" track[mm]=");
+    USART_PrintlnFloat(res.track_mm, 1);
+    return 1;
+}
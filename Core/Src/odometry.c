@@ -0,0 +1,99 @@
+// odometry.c
+#include "odometry.h"
+#include "encoder.h"
+#include "persist.h"
+#include "fast_math.h"
+
+static OdomCalib_t s_cal;
+static Pose_t s_pose;
+static EncoderCursor_t s_cursor;
+
+static void Odom_DefaultCalib(OdomCalib_t *c)
+{
+    c->mm_per_tick_left = ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT;
+    c->mm_per_tick_right = ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT;
+    c->track_mm = ODOM_TRACK_MM_DEFAULT;
+}
+
+uint8_t Odom_Init(void)
+{
+    uint8_t restored = Persist_Load(PERSIST_SLOT_ODOM, ODOM_CALIB_VERSION, &s_cal, sizeof(s_cal));
+
+    // защита от мусора: масштаб в пределах ±30% от номинала, колея > 0
+    if (!restored ||
+        s_cal.mm_per_tick_left < 0.7f * ENC_MM_PER_TICK || s_cal.mm_per_tick_left > 1.3f * ENC_MM_PER_TICK ||
+        s_cal.mm_per_tick_right < 0.7f * ENC_MM_PER_TICK || s_cal.mm_per_tick_right > 1.3f * ENC_MM_PER_TICK ||
+        s_cal.track_mm <= 0.0f)
+    {
+        Odom_DefaultCalib(&s_cal);
+        restored = 0;
+    }
+
+    s_pose = (Pose_t){0.0f, 0.0f, 0.0f};
+    Encoder_CursorInit(&s_cursor);
+
+    return restored;
+}
+
+void Odom_SetPose(const Pose_t *p)
+{
+    s_pose = *p;
+    s_pose.theta_rad = FM_WrapRadPi(s_pose.theta_rad);
+}
+
+void Odom_GetPose(Pose_t *p)
+{
+    *p = s_pose;
+}
+
+void Odom_Update(int8_t dirL, int8_t dirR)
+{
+    uint32_t dL, dR;
+    Encoder_GetDelta(&s_cursor, &dL, &dR);
+
+    if (dL == 0 && dR == 0)
+        return;
+
+    int32_t nL = (dirL >= 0) ? (int32_t)dL : -(int32_t)dL;
+    int32_t nR = (dirR >= 0) ? (int32_t)dR : -(int32_t)dR;
+    Odom_Integrate(nL, nR);
+}
+
+void Odom_Integrate(int32_t nL, int32_t nR)
+{
+    float dL = (float)nL * s_cal.mm_per_tick_left;
+    float dR = (float)nR * s_cal.mm_per_tick_right;
+
+    float ds = 0.5f * (dL + dR);
+    float dth = (dR - dL) / s_cal.track_mm;
+    float mid = s_pose.theta_rad + 0.5f * dth;
+
+    s_pose.x_mm += ds * FM_Cos(mid);
+    s_pose.y_mm += ds * FM_Sin(mid);
+    s_pose.theta_rad = FM_WrapRadPi(s_pose.theta_rad + dth);
+}
+
+float Odom_LeftMM(int32_t ticks)
+{
+    return (float)ticks * s_cal.mm_per_tick_left;
+}
+
+float Odom_RightMM(int32_t ticks)
+{
+    return (float)ticks * s_cal.mm_per_tick_right;
+}
+
+const OdomCalib_t *Odom_GetCalib(void)
+{
+    return &s_cal;
+}
+
+void Odom_SetCalib(const OdomCalib_t *c)
+{
+    s_cal = *c;
+}
+
+uint8_t Odom_SaveCalib(void)
+{
+    return Persist_Save(PERSIST_SLOT_ODOM, ODOM_CALIB_VERSION, &s_cal, sizeof(s_cal));
+}
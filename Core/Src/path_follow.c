@@ -0,0 +1,388 @@
+// path_follow.c
+//
+// Следование по пути: pure pursuit / Stanley поверх одометрии.
+// Геометрия и настройки — в path_follow.h. Модуль «чистый»: поза на входе,
+// (v, ω) на выходе; моторы и регулятор скорости — у вызывающего.
+
+#include "path_follow.h"
+#include "fast_math.h"
+#include "usart.h"
+#include <math.h>
+#include <stddef.h>
+
+/* --- Путь --- */
+static PathPoint_t s_pts[PATH_MAX_POINTS];
+static float s_s[PATH_MAX_POINTS];    // длина дуги до точки, мм
+static float s_vprof[PATH_MAX_POINTS]; // профиль скорости в точке, мм/с
+static uint32_t s_n;
+
+/* --- Следование --- */
+static PathFollowCfg_t s_cfg;
+static PathStatus s_status;
+static uint32_t s_seg; // текущий участок s_pts[seg] → s_pts[seg + 1]
+static float s_v;      // скорость вдоль пути, мм/с
+
+// origin: поза, в системе которой заданы точки
+static float s_ox, s_oy, s_oth, s_oc, s_os;
+
+static PathFollowStats_t s_st;
+static float s_errSum2;
+
+// ---------------- Вспомогательное ----------------
+
+static inline float seg_len(uint32_t i)
+{
+    return s_s[i + 1U] - s_s[i];
+}
+
+static inline float seg_heading(uint32_t i)
+{
+    return FM_Atan2(s_pts[i + 1U].y_mm - s_pts[i].y_mm, s_pts[i + 1U].x_mm - s_pts[i].x_mm);
+}
+
+// Точка пути на длине дуги s (за концом — продолжение последнего участка)
+static void path_at(float s, float *x, float *y, float *heading)
+{
+    uint32_t j = s_seg;
+    while (j + 2U < s_n && s_s[j + 1U] < s)
+        j++;
+
+    float len = seg_len(j);
+    float t = (s - s_s[j]) / len;
+    if (t < 0.0f)
+        t = 0.0f;
+
+    const PathPoint_t *a = &s_pts[j];
+    const PathPoint_t *b = &s_pts[j + 1U];
+    *x = a->x_mm + (b->x_mm - a->x_mm) * t;
+    *y = a->y_mm + (b->y_mm - a->y_mm) * t;
+    if (heading)
+        *heading = seg_heading(j);
+}
+
+// Профиль скорости: предел на изломах по боковому ускорению,
+// затем обратный проход — успеть затормозить к следующей точке и к концу
+static void build_profile(void)
+{
+    // излом ломаной pure pursuit / Stanley срезают дугой длиной ~ упреждения
+    float round_mm = s_cfg.look_min_mm + s_cfg.look_gain_s * s_cfg.v_max_mm_s;
+    if (round_mm > s_cfg.look_max_mm)
+        round_mm = s_cfg.look_max_mm;
+
+    s_vprof[0] = s_cfg.v_max_mm_s;
+    for (uint32_t i = 1; i + 1U < s_n; i++)
+    {
+        float turn = FM_WrapRadPi(seg_heading(i) - seg_heading(i - 1U));
+        float span = 0.5f * (seg_len(i - 1U) + seg_len(i));
+        if (span > round_mm)
+            span = round_mm;
+
+        float kappa = ((turn >= 0.0f) ? turn : -turn) / span;
+        float v = s_cfg.v_max_mm_s;
+        if (kappa * v * v > s_cfg.a_lat_mm_s2)
+            v = sqrtf(s_cfg.a_lat_mm_s2 / kappa);
+        s_vprof[i] = v;
+    }
+    s_vprof[s_n - 1U] = 0.0f;
+
+    for (uint32_t i = s_n - 1U; i-- > 0U;)
+    {
+        float v = sqrtf(s_vprof[i + 1U] * s_vprof[i + 1U] + 2.0f * s_cfg.accel_mm_s2 * seg_len(i));
+        if (v < s_vprof[i])
+            s_vprof[i] = v;
+    }
+}
+
+// Допустимая скорость на длине дуги s участка seg
+static float profile_at(uint32_t seg, float s)
+{
+    float rest = s_s[seg + 1U] - s;
+    if (rest < 0.0f)
+        rest = 0.0f;
+
+    float vn = s_vprof[seg + 1U];
+    float v = sqrtf(vn * vn + 2.0f * s_cfg.accel_mm_s2 * rest);
+    return (v < s_vprof[seg]) ? v : s_vprof[seg];
+}
+
+// ---------------- Путь ----------------
+
+void Path_Clear(void)
+{
+    s_n = 0;
+    s_status = PATH_IDLE;
+}
+
+uint8_t Path_Add(float x_mm, float y_mm)
+{
+    float s = 0.0f;
+
+    if (s_n)
+    {
+        float dx = x_mm - s_pts[s_n - 1U].x_mm;
+        float dy = y_mm - s_pts[s_n - 1U].y_mm;
+        float d = sqrtf(dx * dx + dy * dy);
+        if (d < PATH_MIN_SEG_MM)
+            return 1; // повтор точки — участок нулевой длины не нужен
+        s = s_s[s_n - 1U] + d;
+    }
+    if (s_n >= PATH_MAX_POINTS)
+        return 0;
+
+    s_pts[s_n].x_mm = x_mm;
+    s_pts[s_n].y_mm = y_mm;
+    s_s[s_n] = s;
+    s_n++;
+    return 1;
+}
+
+uint8_t Path_AddSpline(const PathPoint_t *ctrl, uint32_t n, uint32_t steps)
+{
+    if (!ctrl || n == 0U)
+        return 1;
+    if (steps == 0U)
+        steps = 1U;
+
+    for (uint32_t i = 0; i + 1U < n; i++)
+    {
+        // крайние участки: недостающий сосед — сама крайняя точка
+        const PathPoint_t *p0 = &ctrl[(i > 0U) ? i - 1U : i];
+        const PathPoint_t *p1 = &ctrl[i];
+        const PathPoint_t *p2 = &ctrl[i + 1U];
+        const PathPoint_t *p3 = &ctrl[(i + 2U < n) ? i + 2U : i + 1U];
+
+        for (uint32_t k = 0; k < steps; k++)
+        {
+            float t = (float)k / (float)steps;
+            float t2 = t * t;
+            float t3 = t2 * t;
+
+            // p(t) = ½·(2p1 + (p2 − p0)t + (2p0 − 5p1 + 4p2 − p3)t² + (3p1 − p0 − 3p2 + p3)t³)
+            float x = 0.5f * (2.0f * p1->x_mm + (p2->x_mm - p0->x_mm) * t +
+                              (2.0f * p0->x_mm - 5.0f * p1->x_mm + 4.0f * p2->x_mm - p3->x_mm) * t2 +
+                              (3.0f * p1->x_mm - p0->x_mm - 3.0f * p2->x_mm + p3->x_mm) * t3);
+            float y = 0.5f * (2.0f * p1->y_mm + (p2->y_mm - p0->y_mm) * t +
+                              (2.0f * p0->y_mm - 5.0f * p1->y_mm + 4.0f * p2->y_mm - p3->y_mm) * t2 +
+                              (3.0f * p1->y_mm - p0->y_mm - 3.0f * p2->y_mm + p3->y_mm) * t3);
+            if (!Path_Add(x, y))
+                return 0;
+        }
+    }
+    return Path_Add(ctrl[n - 1U].x_mm, ctrl[n - 1U].y_mm);
+}
+
+uint32_t Path_Count(void)
+{
+    return s_n;
+}
+
+// ---------------- Следование ----------------
+
+void PathFollow_DefaultCfg(PathFollowCfg_t *cfg)
+{
+    cfg->mode = PATH_PURE_PURSUIT;
+    cfg->v_max_mm_s = 300.0f;
+    cfg->v_min_mm_s = 40.0f;
+    cfg->accel_mm_s2 = 600.0f;
+    cfg->a_lat_mm_s2 = 800.0f;
+    cfg->goal_tol_mm = 15.0f;
+
+    cfg->look_min_mm = 60.0f;
+    cfg->look_gain_s = 0.4f;
+    cfg->look_max_mm = 250.0f;
+
+    cfg->stanley_k = 2.0f;
+    cfg->stanley_kh = 4.0f;
+    cfg->stanley_v_soft = 50.0f;
+}
+
+uint8_t PathFollow_Start(const PathFollowCfg_t *cfg, const Pose_t *origin)
+{
+    if (s_n < 2U || !cfg)
+        return 0;
+
+    s_cfg = *cfg;
+    if (origin)
+    {
+        s_ox = origin->x_mm;
+        s_oy = origin->y_mm;
+        s_oth = origin->theta_rad;
+    }
+    else
+    {
+        s_ox = s_oy = s_oth = 0.0f;
+    }
+    s_oc = FM_Cos(s_oth);
+    s_os = FM_Sin(s_oth);
+
+    build_profile();
+
+    s_seg = 0;
+    s_v = 0.0f;
+    s_status = PATH_RUNNING;
+
+    PathFollowStats_t zero = {0};
+    s_st = zero;
+    s_st.length_mm = s_s[s_n - 1U];
+    s_errSum2 = 0.0f;
+    return 1;
+}
+
+PathStatus PathFollow_Step(const Pose_t *pose, float dt, float *v_mm_s, float *w_rad_s)
+{
+    *v_mm_s = 0.0f;
+    *w_rad_s = 0.0f;
+    if (s_status != PATH_RUNNING)
+        return s_status;
+
+    // поза в системе пути
+    float dx = pose->x_mm - s_ox;
+    float dy = pose->y_mm - s_oy;
+    float px = s_oc * dx + s_os * dy;
+    float py = -s_os * dx + s_oc * dy;
+    float th = FM_WrapRadPi(pose->theta_rad - s_oth);
+
+    // проекция: ближайший участок в окне вперёд от текущего
+    uint32_t last = s_seg + PATH_SEARCH_SEGS;
+    if (last > s_n - 2U)
+        last = s_n - 2U;
+
+    uint32_t best = s_seg;
+    float bestD2 = 0.0f, bestT = 0.0f, bestTu = 0.0f;
+    for (uint32_t i = s_seg; i <= last; i++)
+    {
+        const PathPoint_t *a = &s_pts[i];
+        float ex = s_pts[i + 1U].x_mm - a->x_mm;
+        float ey = s_pts[i + 1U].y_mm - a->y_mm;
+        float len = seg_len(i);
+        float tu = ((px - a->x_mm) * ex + (py - a->y_mm) * ey) / (len * len);
+        float t = (tu < 0.0f) ? 0.0f : (tu > 1.0f) ? 1.0f : tu;
+        float qx = px - (a->x_mm + ex * t);
+        float qy = py - (a->y_mm + ey * t);
+        float d2 = qx * qx + qy * qy;
+
+        if (i == s_seg || d2 < bestD2)
+        {
+            best = i;
+            bestD2 = d2;
+            bestT = t;
+            bestTu = tu;
+        }
+    }
+    s_seg = best;
+
+    const PathPoint_t *a = &s_pts[best];
+    float len = seg_len(best);
+    float ux = (s_pts[best + 1U].x_mm - a->x_mm) / len;
+    float uy = (s_pts[best + 1U].y_mm - a->y_mm) / len;
+    float e = ux * (py - a->y_mm) - uy * (px - a->x_mm); // + влево от пути
+    float s_proj = s_s[best] + bestT * len;
+
+    // учёт отклонения
+    float ae = (e >= 0.0f) ? e : -e;
+    if (ae > s_st.max_err_mm)
+        s_st.max_err_mm = ae;
+    s_errSum2 += e * e;
+    s_st.steps++;
+    s_st.time_s += dt;
+
+    // финиш: у последней точки или за её поперечной линией
+    const PathPoint_t *end = &s_pts[s_n - 1U];
+    float fx = px - end->x_mm;
+    float fy = py - end->y_mm;
+    float dEnd = sqrtf(fx * fx + fy * fy);
+    if (dEnd <= s_cfg.goal_tol_mm || (best == s_n - 2U && bestTu >= 1.0f))
+    {
+        s_st.end_err_mm = dEnd;
+        s_st.rms_err_mm = sqrtf(s_errSum2 / (float)s_st.steps);
+        s_status = PATH_DONE;
+        s_v = 0.0f;
+        return s_status;
+    }
+
+    // скорость: профиль, не ниже ползком, разгон ограничен
+    float vref = profile_at(best, s_proj);
+    if (vref < s_cfg.v_min_mm_s)
+        vref = s_cfg.v_min_mm_s;
+    float vup = s_v + s_cfg.accel_mm_s2 * dt;
+    s_v = (vref < vup) ? vref : vup;
+
+    float look = s_cfg.look_min_mm + s_cfg.look_gain_s * s_v;
+    if (look > s_cfg.look_max_mm)
+        look = s_cfg.look_max_mm;
+
+    float w;
+    if (s_cfg.mode == PATH_STANLEY)
+    {
+        float hx, hy, heading;
+        path_at(s_proj + s_cfg.look_gain_s * s_v, &hx, &hy, &heading);
+
+        float delta = FM_WrapRadPi(heading - th) +
+                      FM_Atan2(-s_cfg.stanley_k * e, s_v + s_cfg.stanley_v_soft);
+        w = s_cfg.stanley_kh * delta;
+    }
+    else
+    {
+        float tx, ty;
+        path_at(s_proj + look, &tx, &ty, NULL);
+
+        // цель в системе робота
+        float c = FM_Cos(th), s = FM_Sin(th);
+        float gx = tx - px, gy = ty - py;
+        float xl = c * gx + s * gy;
+        float yl = -s * gx + c * gy;
+        float l2 = xl * xl + yl * yl;
+
+        w = (l2 > 1.0f) ? s_v * 2.0f * yl / l2 : 0.0f;
+    }
+
+    *v_mm_s = s_v;
+    *w_rad_s = w;
+    return s_status;
+}
+
+void PathFollow_Stop(void)
+{
+    if (s_status == PATH_RUNNING && s_st.steps)
+        s_st.rms_err_mm = sqrtf(s_errSum2 / (float)s_st.steps);
+    s_status = PATH_IDLE;
+    s_v = 0.0f;
+}
+
+PathStatus PathFollow_Status(void)
+{
+    return s_status;
+}
+
+void PathFollow_GetStats(PathFollowStats_t *out)
+{
+    *out = s_st;
+    if (s_status == PATH_RUNNING && s_st.steps)
+        out->rms_err_mm = sqrtf(s_errSum2 / (float)s_st.steps);
+}
+
+void PathFollow_Report(void)
+{
+    PathFollowStats_t s;
+    PathFollow_GetStats(&s);
+
+    USART_Print("--- PATH (");
+    USART_Print((s_cfg.mode == PATH_STANLEY) ? "stanley" : "pure pursuit");
+    USART_Print(", ");
+    USART_PrintInt((int32_t)s_n);
+    USART_Println(" pts) ---");
+
+    USART_Print("length mm=");
+    USART_PrintFloat(s.length_mm, 0);
+    USART_Print(" time s=");
+    USART_PrintFloat(s.time_s, 2);
+    USART_Print(" steps=");
+    USART_PrintlnInt((int32_t)s.steps);
+
+    USART_Print("cross-track mm: max=");
+    USART_PrintFloat(s.max_err_mm, 1);
+    USART_Print(" rms=");
+    USART_PrintFloat(s.rms_err_mm, 1);
+    USART_Print("  end err mm=");
+    USART_PrintlnFloat(s.end_err_mm, 1);
+}
@@ -0,0 +1,67 @@
+// perf.c
+#include "perf.h"
+#include "usart.h"
+
+static PerfStat_t s_perf[PERF_SLOT_COUNT];
+
+static const char *const s_perfNames[PERF_SLOT_COUNT] = {
+    "EXTI9_5 (enc)",
+    "SpeedCtrl_Update",
+    "PID_Update L+R",
+    "MPU6050_ReadRaw",
+};
+
+void Perf_Init(void)
+{
+    SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk);
+    SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk);
+
+    for (uint32_t i = 0; i < PERF_SLOT_COUNT; i++)
+    {
+        s_perf[i].last = 0;
+        s_perf[i].min = 0xFFFFFFFFUL;
+        s_perf[i].max = 0;
+        s_perf[i].count = 0;
+        s_perf[i].sum = 0;
+    }
+}
+
+void Perf_Add(PerfSlot slot, uint32_t cycles)
+{
+    PerfStat_t *p = &s_perf[slot];
+
+    p->last = cycles;
+    if (cycles < p->min)
+        p->min = cycles;
+    if (cycles > p->max)
+        p->max = cycles;
+    p->count++;
+    p->sum += cycles;
+}
+
+void Perf_Report(void)
+{
+    // такты → нс при 168 МГц: ns = cycles * 1000 / 168
+    USART_Println("--- PERF (cycles: min/avg/max, avg ns) ---");
+
+    for (uint32_t i = 0; i < PERF_SLOT_COUNT; i++)
+    {
+        const PerfStat_t *p = &s_perf[i];
+        if (p->count == 0)
+            continue;
+
+        uint32_t avg = (uint32_t)(p->sum / p->count);
+
+        USART_Print(s_perfNames[i]);
+        USART_Print(": ");
+        USART_PrintInt((int32_t)p->min);
+        USART_Print("/");
+        USART_PrintInt((int32_t)avg);
+        USART_Print("/");
+        USART_PrintInt((int32_t)p->max);
+        USART_Print("  ");
+        USART_PrintInt((int32_t)((uint64_t)avg * 1000U / (SystemCoreClock / 1000000U)));
+        USART_Print(" ns  n=");
+        USART_PrintlnInt((int32_t)p->count);
+    }
+}
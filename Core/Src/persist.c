@@ -0,0 +1,110 @@
+// persist.c
+//
+// Слоты параметров в backup SRAM с проверкой по CRC-32.
+
+#include "persist.h"
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+static uint8_t *Persist_SlotAddr(PersistSlot slot)
+{
+    return (uint8_t *)(BKPSRAM_BASE + (uint32_t)slot * PERSIST_SLOT_SIZE);
+}
+
+// CRC-32 аппаратным блоком: по словам, хвост дополняется нулями
+static uint32_t Persist_Crc(const uint8_t *p, uint16_t len)
+{
+    SET_BIT(CRC->CR, CRC_CR_RESET);
+
+    while (len >= 4U)
+    {
+        uint32_t w;
+        memcpy(&w, p, 4U);
+        CRC->DR = w;
+        p += 4;
+        len -= 4U;
+    }
+
+    if (len)
+    {
+        uint32_t w = 0;
+        memcpy(&w, p, len);
+        CRC->DR = w;
+    }
+
+    return CRC->DR;
+}
+
+/* --------------------------------------------------------------------------
+ * Инициализация
+ * -------------------------------------------------------------------------- */
+void Persist_Init(void)
+{
+    // Доступ к backup-домену
+    SET_BIT(RCC->APB1ENR, RCC_APB1ENR_PWREN);
+    SET_BIT(PWR->CR, PWR_CR_DBP);
+
+    // Тактирование BKPSRAM и блока CRC
+    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_BKPSRAMEN | RCC_AHB1ENR_CRCEN);
+
+    // Backup-регулятор: без него содержимое пропадает при питании от VBAT
+    SET_BIT(PWR->CSR, PWR_CSR_BRE);
+    for (uint32_t t = 100000UL; t && !READ_BIT(PWR->CSR, PWR_CSR_BRR); t--)
+    {
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Чтение / запись
+ * -------------------------------------------------------------------------- */
+uint8_t Persist_Load(PersistSlot slot, uint16_t version, void *dst, uint16_t len)
+{
+    if (slot >= PERSIST_SLOT_COUNT || len > PERSIST_SLOT_DATA)
+        return 0;
+
+    const uint8_t *base = Persist_SlotAddr(slot);
+    PersistHdr_t hdr;
+    memcpy(&hdr, base, sizeof(hdr));
+
+    if (hdr.magic != PERSIST_MAGIC || hdr.version != version || hdr.len != len)
+        return 0;
+
+    const uint8_t *data = base + sizeof(PersistHdr_t);
+    if (Persist_Crc(data, len) != hdr.crc)
+        return 0;
+
+    memcpy(dst, data, len);
+    return 1;
+}
+
+uint8_t Persist_Save(PersistSlot slot, uint16_t version, const void *src, uint16_t len)
+{
+    if (slot >= PERSIST_SLOT_COUNT || len > PERSIST_SLOT_DATA)
+        return 0;
+
+    uint8_t *base = Persist_SlotAddr(slot);
+    PersistHdr_t hdr = {0, version, len, 0};
+
+    // Сначала гасим magic: прерванная запись не оставит «валидный» слот
+    memcpy(base, &hdr, sizeof(hdr));
+
+    memcpy(base + sizeof(PersistHdr_t), src, len);
+    hdr.crc = Persist_Crc(base + sizeof(PersistHdr_t), len);
+    hdr.magic = PERSIST_MAGIC;
+
+    __DSB();
+    memcpy(base, &hdr, sizeof(hdr));
+    return 1;
+}
+
+void Persist_Erase(PersistSlot slot)
+{
+    if (slot >= PERSIST_SLOT_COUNT)
+        return;
+
+    PersistHdr_t hdr = {0, 0, 0, 0};
+    memcpy(Persist_SlotAddr(slot), &hdr, sizeof(hdr));
+}
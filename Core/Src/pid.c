@@ -1,5 +1,6 @@
 // pid.c
 #include "pid.h"
+#include "mem_sections.h"
 
 void PID_Init(PID_t *pid, float kp, float ki, float kd, float outMin, float outMax)
 {
@@ -12,7 +13,13 @@ void PID_Init(PID_t *pid, float kp, float ki, float kd, float outMin, float outM
     pid->outMax = outMax;
 }
 
-float PID_Update(PID_t *pid, float setpoint, float measurement, float dt)
+void PID_Reset(PID_t *pid)
+{
+    pid->integrator = 0.0f;
+    pid->prevError = 0.0f;
+}
+
+RAMFUNC float PID_Update(PID_t *pid, float setpoint, float measurement, float dt)
 {
     float error = setpoint - measurement;
 
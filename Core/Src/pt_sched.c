@@ -0,0 +1,81 @@
+// pt_sched.c
+#include "pt_sched.h"
+#include "idle.h"
+
+volatile uint8_t g_ptPending;
+
+static PtSchedStats_t s_stats;
+
+/* Проход по задачам.
+ * progress — кто-то продвинулся: уступил, завершился или сменил строку.
+ * wake     — ближайший дедлайн среди ждущих времени.
+ */
+static uint32_t sched_pass(PtTask_t *tasks, uint32_t n, uint8_t *progress, uint32_t *wake)
+{
+    uint32_t alive = 0;
+
+    s_stats.passes++;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        PtTask_t *t = &tasks[i];
+        if (t->done)
+            continue;
+
+        uint16_t lc = t->pt.lc;
+        PtStatus r = t->fn(&t->pt, t->arg);
+        s_stats.switches++;
+
+        if (r >= PT_EXITED)
+        {
+            t->done = 1U;
+            *progress = 1U;
+            continue;
+        }
+
+        alive++;
+        if (r == PT_YIELDED || t->pt.lc != lc)
+            *progress = 1U;
+
+        if (t->pt.timed && (int32_t)(t->pt.wake_us - *wake) < 0)
+            *wake = t->pt.wake_us;
+    }
+
+    return alive;
+}
+
+uint32_t PtSched_Step(PtTask_t *tasks, uint32_t n)
+{
+    uint8_t progress = 0;
+    uint32_t wake = Time_DeadlineUs(IDLE_MAX_US);
+
+    return sched_pass(tasks, n, &progress, &wake);
+}
+
+void PtSched_Run(PtTask_t *tasks, uint32_t n)
+{
+    while (1)
+    {
+        uint8_t progress = 0;
+        uint32_t wake = Time_DeadlineUs(IDLE_MAX_US);
+
+        // сбрасываем ДО прохода: сигнал во время прохода не потеряется
+        g_ptPending = 0U;
+
+        if (sched_pass(tasks, n, &progress, &wake) == 0U)
+            return;
+
+        // g_ptPending проверяется ещё раз в Idle_SleepUntil под маской:
+        // PT_KICK() между этой проверкой и WFI не проспит до дедлайна
+        if (!progress && !g_ptPending)
+        {
+            s_stats.sleeps++;
+            Idle_SleepUntil(wake, &g_ptPending);
+        }
+    }
+}
+
+const PtSchedStats_t *PtSched_GetStats(void)
+{
+    return &s_stats;
+}
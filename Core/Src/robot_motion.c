@@ -2,16 +2,21 @@
 #include "motor.h"
 #include "encoder.h"
 #include "usart.h"
+#include "timebase.h"
+#include "idle.h"
+#include <stddef.h>
+#include "sensor_log.h"
+#include "stall_detect.h"
+#include "deadline.h"
+#include "odometry.h"
+#if MOTION_USE_IMU
+#include "MPU6050.h"
+#endif
 
 extern volatile uint32_t g_msTicks;
 
 /* === КОНФИГ === */
 
-/* Какой знак ШИМа означает "ФИЗИЧЕСКИ вперёд".
- * Если сейчас MoveForwardMM едет назад — просто поменяй +1 на -1.
- */
-#define MOTOR_FORWARD_SIGN (+1) // при необходимости поменяешь на (-1)
-
 /* минимальный рабочий PWM, чтобы колёса точно крутились */
 #define PWM_MIN_START 60
 #define PWM_MAX MOTOR_PWM_MAX
@@ -22,15 +27,42 @@ extern volatile uint32_t g_msTicks;
 #define WHEEL_BALANCE_A 1.00f // множитель для MOTOR_A
 #define WHEEL_BALANCE_B 1.00f // множитель для MOTOR_B
 
-/* === ВСПОМОГАТЕЛЬНОЕ === */
+/* === ПЛАНИРОВЩИК ОСТАНОВКИ === */
 
-static void Delay_ms(uint32_t ms)
-{
-    uint32_t start = g_msTicks;
-    while ((g_msTicks - start) < ms)
-    {
-    }
-}
+/* Замедление робота (мм/с²) при активном тормозе и при выбеге.
+ * Калибровка: разогнаться до v, остановиться, померить путь d → a = v²/(2d).
+ */
+#define STOP_BRAKE_DECEL_MM_S2 2500.0f
+#define STOP_COAST_DECEL_MM_S2 600.0f
+
+/* Задержка реакции: период опроса энкодеров + электрическая постоянная мотора */
+#define STOP_LATENCY_S 0.005f
+
+/* Окно оценки скорости по энкодерам (мс) */
+#define STOP_VEL_WINDOW_MS 20U
+
+/* Удержание тормоза: не меньше MIN, не больше MAX;
+ * колесо считаем остановившимся, если тиков нет STOP_STILL_MS.
+ */
+#define STOP_BRAKE_HOLD_MIN_MS 20U
+#define STOP_BRAKE_HOLD_MAX_MS 300U
+#define STOP_STILL_MS 40U
+
+/* Период проверки энкодеров при удержании тормоза (мкс) */
+#define STOP_POLL_US 2000U
+
+/* Бюджет одного прохода цикла движения (монитор дедлайнов).
+ * Обычный проход — десятки мкс; с MOTION_USE_IMU — чтение IMU (~1 мс).
+ */
+#define MOTION_DEADLINE_MS 50U
+
+/* Текущий режим остановки (по умолчанию — активный тормоз) */
+static MotorStopMode s_stopMode = MOTOR_STOP_BRAKE;
+
+/* MPU6050 ответил при старте (Motion_SetImu) */
+static uint8_t s_imuPresent = 0;
+
+/* === ВСПОМОГАТЕЛЬНОЕ === */
 
 static int16_t clamp_pwm_mag(int16_t v)
 {
@@ -43,12 +75,89 @@ static int16_t clamp_pwm_mag(int16_t v)
     return v;
 }
 
+/* Путь остановки (мм) со скорости v_mm_s в выбранном режиме:
+ *   d = v * t_latency + v² / (2a)
+ */
+static float stop_distance_mm(float v_mm_s, MotorStopMode mode)
+{
+    float decel = (mode == MOTOR_STOP_BRAKE) ? STOP_BRAKE_DECEL_MM_S2
+                                             : STOP_COAST_DECEL_MM_S2;
+    return v_mm_s * STOP_LATENCY_S + (v_mm_s * v_mm_s) / (2.0f * decel);
+}
+
+/* Выполнить остановку со скорости v_mm_s.
+ * BRAKE: тормоз держим, пока колёса не встанут (или до таймаута),
+ *        затем отпускаем в выбег, чтобы не греть мост.
+ * COAST: сразу выбег.
+ */
+static void execute_stop(float v_mm_s)
+{
+    if (s_stopMode != MOTOR_STOP_BRAKE)
+    {
+        Motor_Coast(MOTOR_A);
+        Motor_Coast(MOTOR_B);
+        return;
+    }
+
+    Motor_Brake(MOTOR_A);
+    Motor_Brake(MOTOR_B);
+
+    /* ожидаемое время торможения t = v / a, с запасом ×2 */
+    uint32_t hold_ms = (uint32_t)(2000.0f * v_mm_s / STOP_BRAKE_DECEL_MM_S2);
+    if (hold_ms < STOP_BRAKE_HOLD_MIN_MS)
+        hold_ms = STOP_BRAKE_HOLD_MIN_MS;
+    if (hold_ms > STOP_BRAKE_HOLD_MAX_MS)
+        hold_ms = STOP_BRAKE_HOLD_MAX_MS;
+
+    /* Между проверками спим: энкодерные EXTI будят ядро на каждом тике,
+     * иначе проверка раз в STOP_POLL_US
+     */
+    Timeout_t hold;
+    Timeout_Start(&hold, hold_ms * 1000U);
+    uint32_t minEnd = Time_DeadlineUs(STOP_BRAKE_HOLD_MIN_MS * 1000U);
+    uint32_t stillEnd = Time_DeadlineUs(STOP_STILL_MS * 1000U);
+    uint32_t lastL, lastR;
+    Encoder_GetTotals(&lastL, &lastR);
+
+    while (!Timeout_Expired(&hold))
+    {
+        uint32_t curL, curR;
+        Encoder_GetTotals(&curL, &curR);
+
+        if (curL != lastL || curR != lastR)
+        {
+            lastL = curL;
+            lastR = curR;
+            stillEnd = Time_DeadlineUs(STOP_STILL_MS * 1000U);
+        }
+        else if (Time_Reached(stillEnd) && Time_Reached(minEnd))
+        {
+            break; // колёса стоят
+        }
+
+        Idle_SleepUntil(Time_DeadlineUs(STOP_POLL_US), NULL);
+    }
+
+    Motor_Coast(MOTOR_A);
+    Motor_Coast(MOTOR_B);
+}
+
+void Motion_SetStopMode(MotorStopMode mode)
+{
+    s_stopMode = mode;
+}
+
+void Motion_SetImu(uint8_t present)
+{
+    s_imuPresent = present;
+}
+
 /* === ОСНОВНАЯ ФУНКЦИЯ === */
 
-void DriveDistanceMM(float distance_mm, int16_t speed)
+MotionResult DriveDistanceMM(float distance_mm, int16_t speed)
 {
     if (distance_mm <= 0.0f || speed == 0)
-        return;
+        return MOTION_OK;
 
     /* модуль PWM */
     int16_t pwm_mag = clamp_pwm_mag(speed);
@@ -69,8 +178,8 @@ void DriveDistanceMM(float distance_mm, int16_t speed)
     USART_Print(" dir_sign=");
     USART_PrintlnInt(dir_sign);
 
-    uint32_t startL = Encoder_GetTotalLeft();
-    uint32_t startR = Encoder_GetTotalRight();
+    uint32_t startL, startR;
+    Encoder_GetTotals(&startL, &startR);
 
     /* базовые PWM для обоих моторов (можно будет подкорректировать балансом) */
     int16_t pwmA = (int16_t)(pwm_mag * WHEEL_BALANCE_A);
@@ -80,20 +189,72 @@ void DriveDistanceMM(float distance_mm, int16_t speed)
     pwmA *= motor_dir;
     pwmB *= motor_dir;
 
+    Stall_Arm(1);
+    Deadline_Enable(DL_TASK_MOTION, MOTION_DEADLINE_MS);
+
     Motor_SetSpeed(MOTOR_A, pwmA);
     Motor_SetSpeed(MOTOR_B, pwmB);
 
     uint32_t lastPrint = g_msTicks;
 
+    /* оценка скорости для планировщика остановки и детектора заклинивания */
+    uint32_t velUs = Time_Us();
+    float velDist = 0.0f;
+    float v_mm_s = 0.0f;
+    uint32_t velL = startL, velR = startR;
+
     while (1)
     {
-        uint32_t curL = Encoder_GetTotalLeft();
-        uint32_t curR = Encoder_GetTotalRight();
+        Deadline_CheckIn(DL_TASK_MOTION);
 
-        float distL = Encoder_TicksToMM(curL - startL);
-        float distR = Encoder_TicksToMM(curR - startR);
+        uint32_t curL, curR;
+        Encoder_GetTotals(&curL, &curR);
+
+        /* тики без знака — путь считаем по модулю, масштаб колёс из одометрии */
+        float distL = Odom_LeftMM((int32_t)(curL - startL));
+        float distR = Odom_RightMM((int32_t)(curR - startR));
+        Odom_Update(dir_sign, dir_sign);
         float dist = 0.5f * (distL + distR);
 
+        uint32_t velDt = Time_ElapsedUs(velUs);
+        if (velDt >= STOP_VEL_WINDOW_MS * 1000U)
+        {
+            float dt = (float)velDt * 1e-6f;
+            float v = (dist - velDist) / dt;
+            v_mm_s = 0.5f * (v_mm_s + v); // простой ФНЧ против квантования тиков
+            velDist = dist;
+            velUs += velDt;
+
+            /* скорости колёс, об/с (энкодер без направления — знак из команды) */
+            float rpsL = (float)(curL - velL) / ((float)ENC_PULSES_PER_REV * dt);
+            float rpsR = (float)(curR - velR) / ((float)ENC_PULSES_PER_REV * dt);
+            velL = curL;
+            velR = curR;
+            Stall_UpdateWheels(pwmA, pwmB, (pwmA >= 0) ? rpsL : -rpsL,
+                               (pwmB >= 0) ? rpsR : -rpsR, dt);
+        }
+
+#if MOTION_USE_IMU
+        ImuSample_t imu;
+        if (s_imuPresent && MPU6050_ReadSample(&imu))
+            Stall_FeedAccel(&imu.raw[IMU_AX]);
+#endif
+
+        /* моторы уже отключены детектором — только сообщаем */
+        uint8_t ev = Stall_Event();
+        if (ev)
+        {
+            Deadline_Disable(DL_TASK_MOTION);
+            Stall_Arm(0);
+            Odom_Update(dir_sign, dir_sign);
+            USART_Print("ABORT: ");
+            USART_Print((ev & STALL_IMPACT) ? "impact" : "stall");
+            USART_Print(" at ");
+            USART_PrintFloat(dist, 1);
+            USART_Println(" mm");
+            return (ev & STALL_IMPACT) ? MOTION_ABORT_IMPACT : MOTION_ABORT_STALL;
+        }
+
         if (g_msTicks - lastPrint > 100)
         {
             lastPrint = g_msTicks;
@@ -106,31 +267,48 @@ void DriveDistanceMM(float distance_mm, int16_t speed)
             USART_Println(" mm");
         }
 
-        if (dist >= distance_mm)
+        SensorLog_Flush();
+
+        /* начинаем останов заранее — с учётом пути торможения */
+        if (dist + stop_distance_mm(v_mm_s, s_stopMode) >= distance_mm)
             break;
     }
 
-    Motor_SetSpeed(MOTOR_A, 0);
-    Motor_SetSpeed(MOTOR_B, 0);
+    Deadline_Disable(DL_TASK_MOTION);
+    Stall_Arm(0);
+    execute_stop(v_mm_s);
+
+    uint32_t endL, endR;
+    Encoder_GetTotals(&endL, &endR);
+    Odom_Update(dir_sign, dir_sign);
+    float finalDist = 0.5f * (Odom_LeftMM((int32_t)(endL - startL)) +
+                              Odom_RightMM((int32_t)(endR - startR)));
+
+    USART_Print("STOP! v=");
+    USART_PrintFloat(v_mm_s, 0);
+    USART_Print(" mm/s, final=");
+    USART_PrintFloat(finalDist, 1);
+    USART_Print(" mm, err=");
+    USART_PrintlnFloat(finalDist - distance_mm, 1);
 
-    USART_Println("STOP!");
+    return MOTION_OK;
 }
 
 /* === ОБЁРТКИ === */
 
-void MoveForwardMM(float distance_mm, int16_t pwm)
+MotionResult MoveForwardMM(float distance_mm, int16_t pwm)
 {
     if (pwm < 0)
         pwm = -pwm;
     /* Положительный speed → "вперёд" в логике функции,
        а реальное направление задаётся MOTOR_FORWARD_SIGN. */
-    DriveDistanceMM(distance_mm, +pwm);
+    return DriveDistanceMM(distance_mm, +pwm);
 }
 
-void MoveBackwardMM(float distance_mm, int16_t pwm)
+MotionResult MoveBackwardMM(float distance_mm, int16_t pwm)
 {
     if (pwm < 0)
         pwm = -pwm;
     /* Отрицательный speed → "назад" в логике функции. */
-    DriveDistanceMM(distance_mm, -pwm);
+    return DriveDistanceMM(distance_mm, -pwm);
 }
@@ -0,0 +1,190 @@
+// sensor_log.c
+#include "sensor_log.h"
+#include "timebase.h"
+#include "stm32f4xx.h"
+
+static uint8_t s_ring[SLOG_RING_SIZE];
+static volatile uint32_t s_head = 0; // пишет SensorLog_Write (main)
+static volatile uint32_t s_tail = 0; // двигает прерывание DMA
+static volatile uint32_t s_dmaLen = 0; // байт в текущей передаче DMA, 0 — простой
+static uint16_t s_seq = 0;
+static uint32_t s_dropped = 0;
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+static inline uint32_t SensorLog_Put(uint32_t h, uint8_t b)
+{
+    s_ring[h & (SLOG_RING_SIZE - 1U)] = b;
+    return h + 1U;
+}
+
+static uint32_t SensorLog_PutBytes(uint32_t h, const uint8_t *p, uint32_t n, uint8_t *sum)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        *sum = (uint8_t)(*sum + p[i]);
+        h = SensorLog_Put(h, p[i]);
+    }
+    return h;
+}
+
+#if SENSOR_LOG_ENABLE
+
+#define SLOG_DMA DMA2_Stream6 // USART6_TX: DMA2 Stream6, канал 5
+#define SLOG_DMA_CH 5U
+#define SLOG_DMA_FLAGS (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | \
+                        DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+
+static void SensorLog_HwInit(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_USART6EN;
+
+    // PC6 -> AF8 (USART6_TX), push-pull, high speed
+    GPIOC->MODER &= ~GPIO_MODER_MODER6_Msk;
+    GPIOC->MODER |= (2U << GPIO_MODER_MODER6_Pos);
+    GPIOC->AFR[0] &= ~(0xFU << (6U * 4U));
+    GPIOC->AFR[0] |= (8U << (6U * 4U));
+    GPIOC->OTYPER &= ~GPIO_OTYPER_OT6_Msk;
+    GPIOC->OSPEEDR |= GPIO_OSPEEDR_OSPEED6_Msk;
+
+    USART6->CR1 = 0;
+    USART6->BRR = (SLOG_PCLK2_HZ + SLOG_BAUD / 2U) / SLOG_BAUD;
+    USART6->CR2 = 0;
+    USART6->CR3 = USART_CR3_DMAT;
+    USART6->CR1 = USART_CR1_TE | USART_CR1_UE; // 8N1, только передача
+
+    // память → периферия, инкремент адреса памяти, прерывание по завершению
+    SLOG_DMA->CR = 0;
+    while (SLOG_DMA->CR & DMA_SxCR_EN)
+    {
+    }
+    SLOG_DMA->PAR = (uintptr_t)&USART6->DR;
+    SLOG_DMA->CR = (SLOG_DMA_CH << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC |
+                   (1U << DMA_SxCR_DIR_Pos) | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    SLOG_DMA->FCR = 0; // прямой режим
+
+    NVIC_SetPriority(DMA2_Stream6_IRQn, SLOG_DMA_IRQ_PRIO);
+    NVIC_EnableIRQ(DMA2_Stream6_IRQn);
+}
+
+/* Запустить DMA на непрерывный кусок кольца от s_tail.
+ * Вызывается из прерывания DMA или с запрещёнными прерываниями.
+ */
+static void SensorLog_Kick(void)
+{
+    if (s_dmaLen != 0U)
+        return;
+
+    uint32_t tail = s_tail;
+    uint32_t n = s_head - tail;
+    if (n == 0U)
+        return;
+
+    uint32_t off = tail & (SLOG_RING_SIZE - 1U);
+    if (n > SLOG_RING_SIZE - off)
+        n = SLOG_RING_SIZE - off; // до конца буфера, остаток — следующей передачей
+
+    DMA2->HIFCR = SLOG_DMA_FLAGS;
+    SLOG_DMA->M0AR = (uintptr_t)&s_ring[off];
+    SLOG_DMA->NDTR = n;
+    s_dmaLen = n;
+    SLOG_DMA->CR |= DMA_SxCR_EN;
+}
+
+void DMA2_Stream6_IRQHandler(void)
+{
+    uint32_t isr = DMA2->HISR;
+    DMA2->HIFCR = SLOG_DMA_FLAGS;
+
+    if (isr & (DMA_HISR_TCIF6 | DMA_HISR_TEIF6))
+    {
+        // ошибка передачи — кусок потерян, декодер увидит дыру по seq/sum8
+        s_tail += s_dmaLen;
+        s_dmaLen = 0;
+        SensorLog_Kick();
+    }
+}
+
+#endif // SENSOR_LOG_ENABLE
+
+/* --------------------------------------------------------------------------
+ * Публичные функции
+ * -------------------------------------------------------------------------- */
+
+void SensorLog_Init(void)
+{
+#if SENSOR_LOG_ENABLE
+    static uint8_t hw_ready = 0;
+    if (!hw_ready)
+    {
+        SensorLog_HwInit();
+        hw_ready = 1;
+    }
+    else
+    {
+        // остановить идущую передачу: кольцо сейчас обнулится
+        NVIC_DisableIRQ(DMA2_Stream6_IRQn);
+        SLOG_DMA->CR &= ~DMA_SxCR_EN;
+        while (SLOG_DMA->CR & DMA_SxCR_EN)
+        {
+        }
+        DMA2->HIFCR = SLOG_DMA_FLAGS;
+        NVIC_ClearPendingIRQ(DMA2_Stream6_IRQn);
+        NVIC_EnableIRQ(DMA2_Stream6_IRQn);
+    }
+#endif
+    s_dmaLen = 0;
+    s_head = 0;
+    s_tail = 0;
+    s_seq = 0;
+    s_dropped = 0;
+}
+
+void SensorLog_Write(uint8_t type, const void *payload, uint8_t len)
+{
+    uint32_t frame = 2U + sizeof(SensorLogHdr_t) + len + 1U;
+    uint32_t h = s_head;
+    uint32_t used = h - s_tail;
+
+    if (used + frame > SLOG_RING_SIZE)
+    {
+        s_dropped++;
+        s_seq++; // дыра в seq видна декодеру
+        return;
+    }
+
+    SensorLogHdr_t hdr;
+    hdr.t_us = Time_Us();
+    hdr.type = type;
+    hdr.len = len;
+    hdr.seq = s_seq++;
+
+    uint8_t sum = 0;
+    h = SensorLog_Put(h, SLOG_SYNC0);
+    h = SensorLog_Put(h, SLOG_SYNC1);
+    h = SensorLog_PutBytes(h, (const uint8_t *)&hdr, sizeof(hdr), &sum);
+    h = SensorLog_PutBytes(h, (const uint8_t *)payload, len, &sum);
+    h = SensorLog_Put(h, sum);
+
+    // кадр целиком в памяти раньше, чем DMA увидит новую голову
+    __DMB();
+    s_head = h;
+}
+
+void SensorLog_Flush(void)
+{
+#if SENSOR_LOG_ENABLE
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    SensorLog_Kick();
+    __set_PRIMASK(primask);
+#endif
+}
+
+uint32_t SensorLog_Dropped(void)
+{
+    return s_dropped;
+}
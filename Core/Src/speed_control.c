@@ -3,58 +3,137 @@
 #include "encoder.h"
 #include "motor.h"
 #include "pid.h" // твой модуль PID
+#include "trace.h"
+#include "mem_sections.h"
+#include "perf.h"
+#include "sensor_log.h"
+#include "wheel_estimator.h"
+#include "stall_detect.h"
+#include "deadline.h"
+#include "robot_motion.h" // MOTOR_FORWARD_SIGN
+#include "odometry.h"
 
 extern volatile uint32_t g_msTicks;
 
 // PID для левого и правого мотора
-static PID_t pid_left;
-static PID_t pid_right;
+static PID_t pid_left CCMRAM;
+static PID_t pid_right CCMRAM;
 
-// целевые скорости (об/сек) и направления
-static float target_left_rps = 0.0f;
-static float target_right_rps = 0.0f;
-static int8_t dir_left = +1;
-static int8_t dir_right = +1;
+// целевые скорости колёс, об/сек со знаком (+ вперёд)
+static float target_left_rps CCMRAM = 0.0f;
+static float target_right_rps CCMRAM = 0.0f;
 
-// перевод тиков за dt в обороты/сек (всегда >= 0)
-static float ticks_to_rps(uint32_t ticks, float dt_sec)
+static float abs_f(float x)
 {
-    float tps = (float)ticks / dt_sec;           // ticks per second
-    float rps = tps / (float)ENC_PULSES_PER_REV; // revolutions per second
-    return rps;
+    return (x >= 0.0f) ? x : -x;
 }
 
+/* Прямая связь по модели мотора: PWM, дающий скорость rps в установившемся
+ * режиме, — sign · (U0 + |rps| / K). ПИД докручивает только остаток
+ * (нагрузка, разброс моторов), интегратору не нужно переходить от +U к −U
+ * при реверсе.
+ */
+static float feedforward_pwm(float rps)
+{
+    if (rps == 0.0f)
+        return 0.0f;
+    float u = WHEEL_MODEL_U0 + abs_f(rps) * (1.0f / WHEEL_MODEL_K);
+    return (rps > 0.0f) ? u : -u;
+}
+
+// ПИД поверх прямой связи; пределы сдвинуты так, чтобы сумма осталась в ±PWM_MAX
+static float wheel_pid(PID_t *pid, float target, float meas, float dt)
+{
+    float ff = feedforward_pwm(target);
+    pid->outMax = (float)MOTOR_PWM_MAX - ff;
+    pid->outMin = -(float)MOTOR_PWM_MAX - ff;
+    return ff + PID_Update(pid, target, meas, dt);
+}
+
+// собственный курсор энкодеров (неразрушающие приращения)
+static EncoderCursor_t enc_cursor CCMRAM;
+
+// оценщики скорости колёс (Калман: тики + модель мотора)
+static WheelEst_t est_left CCMRAM;
+static WheelEst_t est_right CCMRAM;
+
+// PWM, поданный на прошлом шаге (вход модели на текущем интервале)
+static int16_t last_pwm_left CCMRAM = 0;
+static int16_t last_pwm_right CCMRAM = 0;
+
 void SpeedControl_Init(void)
 {
     /* Более мягкие коэффициенты ПИД:
      * начинаем с небольшого Kp, Ki, без D.
-     * Диапазон выхода [0 .. MOTOR_PWM_MAX].
+     * Диапазон выхода [-MOTOR_PWM_MAX .. MOTOR_PWM_MAX] — знаковый PWM.
      */
-    PID_Init(&pid_left, 8.0f, 1.0f, 0.0f, 0.0f, (float)MOTOR_PWM_MAX);
-    PID_Init(&pid_right, 8.0f, 1.0f, 0.0f, 0.0f, (float)MOTOR_PWM_MAX);
+    PID_Init(&pid_left, 8.0f, 1.0f, 0.0f, -(float)MOTOR_PWM_MAX, (float)MOTOR_PWM_MAX);
+    PID_Init(&pid_right, 8.0f, 1.0f, 0.0f, -(float)MOTOR_PWM_MAX, (float)MOTOR_PWM_MAX);
 
     target_left_rps = 0.0f;
     target_right_rps = 0.0f;
-    dir_left = +1;
-    dir_right = +1;
+
+    Encoder_CursorInit(&enc_cursor);
+
+    WheelEst_Init(&est_left, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+    WheelEst_Init(&est_right, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+    last_pwm_left = 0;
+    last_pwm_right = 0;
 
     Motor_SetSpeed(MOTOR_A, 0);
     Motor_SetSpeed(MOTOR_B, 0);
 }
 
+float SpeedControl_SetWheelRps(float left_rps, float right_rps)
+{
+    // насыщение одним множителем на оба колеса — кривизна сохраняется
+    float m = abs_f(left_rps);
+    if (abs_f(right_rps) > m)
+        m = abs_f(right_rps);
+
+    float k = 1.0f;
+    if (m > SPEED_WHEEL_MAX_RPS)
+        k = SPEED_WHEEL_MAX_RPS / m;
+
+    target_left_rps = left_rps * k;
+    target_right_rps = right_rps * k;
+
+    SLOG(SLOG_CMD, (&(SlogCmd_t){abs_f(target_left_rps), abs_f(target_right_rps),
+                                 (int8_t)((target_left_rps >= 0.0f) ? +1 : -1),
+                                 (int8_t)((target_right_rps >= 0.0f) ? +1 : -1)}));
+    return k;
+}
+
+float SpeedControl_SetTwist(float v_mm_s, float w_rad_s)
+{
+    const OdomCalib_t *c = Odom_GetCalib();
+    float half = 0.5f * c->track_mm;
+
+    // мм/с колеса → об/с: делим на мм за оборот (свой масштаб у каждого колеса)
+    float revL = c->mm_per_tick_left * (float)ENC_PULSES_PER_REV;
+    float revR = c->mm_per_tick_right * (float)ENC_PULSES_PER_REV;
+
+    // до Odom_Init() калибровки ещё нет — номинальный масштаб
+    if (revL <= 0.0f || revR <= 0.0f || half <= 0.0f)
+    {
+        revL = revR = ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT * (float)ENC_PULSES_PER_REV;
+        half = 0.5f * ODOM_TRACK_MM_DEFAULT;
+    }
+
+    return SpeedControl_SetWheelRps((v_mm_s - w_rad_s * half) / revL,
+                                    (v_mm_s + w_rad_s * half) / revR);
+}
+
 void SpeedControl_SetTarget(float left_rps, float right_rps,
                             int8_t dirL, int8_t dirR)
 {
-    if (left_rps < 0.0f)
-        left_rps = 0.0f;
-    if (right_rps < 0.0f)
-        right_rps = 0.0f;
-
-    target_left_rps = left_rps;
-    target_right_rps = right_rps;
+    left_rps = abs_f(left_rps);
+    right_rps = abs_f(right_rps);
 
-    dir_left = (dirL >= 0) ? +1 : -1;
-    dir_right = (dirR >= 0) ? +1 : -1;
+    (void)SpeedControl_SetWheelRps((dirL >= 0) ? left_rps : -left_rps,
+                                   (dirR >= 0) ? right_rps : -right_rps);
 }
 
 void SpeedControl_Stop(void)
@@ -62,43 +141,102 @@ void SpeedControl_Stop(void)
     target_left_rps = 0.0f;
     target_right_rps = 0.0f;
 
+    // накопленный интегратор не должен «выстрелить» при следующем старте
+    PID_Reset(&pid_left);
+    PID_Reset(&pid_right);
+
+    last_pwm_left = 0;
+    last_pwm_right = 0;
+
     Motor_SetSpeed(MOTOR_A, 0);
     Motor_SetSpeed(MOTOR_B, 0);
+
+    // направления 0 — метка Stop для воспроизведения (сброс ПИД)
+    SLOG(SLOG_CMD, (&(SlogCmd_t){0.0f, 0.0f, 0, 0}));
 }
 
-void SpeedControl_Update(float dt_sec)
+RAMFUNC void SpeedControl_Update(float dt_sec)
 {
-    uint32_t ticksL, ticksR;
-    Encoder_GetAndResetTicks(&ticksL, &ticksR);
+    PERF_BEGIN(PERF_SPEED_UPDATE);
 
-    // измеренная скорость
-    float measL = ticks_to_rps(ticksL, dt_sec);
-    float measR = ticks_to_rps(ticksR, dt_sec);
-
-    // ПИД-выход — желаемый |pwm| в [0 .. MOTOR_PWM_MAX]
-    float outL = PID_Update(&pid_left, target_left_rps, measL, dt_sec);
-    float outR = PID_Update(&pid_right, target_right_rps, measR, dt_sec);
+    uint32_t ticksL, ticksR;
 
-    if (outL < 0.0f)
-        outL = 0.0f;
-    if (outR < 0.0f)
-        outR = 0.0f;
+    TRACE(TRACE_EV_CTRL_TICK, 0, (uint32_t)(dt_sec * 1000000.0f));
+    Deadline_CheckIn(DL_TASK_CONTROL);
+
+    Encoder_GetDelta(&enc_cursor, &ticksL, &ticksR);
+
+    // вход регулятора — ровно то, что нужно для воспроизведения бит в бит
+    SLOG(SLOG_CTRL, (&(SlogCtrl_t){dt_sec, ticksL, ticksR}));
+
+    // оценка скорости: тики + PWM, действовавший на этом интервале
+    WheelEst_Update(&est_left, ticksL, last_pwm_left, dt_sec);
+    WheelEst_Update(&est_right, ticksR, last_pwm_right, dt_sec);
+
+    // заклинивание: детектор сам отключает моторы, регулятор больше не вмешивается
+    if (Stall_UpdateWheels(last_pwm_left, last_pwm_right,
+                           WheelEst_Speed(&est_left), WheelEst_Speed(&est_right), dt_sec))
+    {
+        PID_Reset(&pid_left);
+        PID_Reset(&pid_right);
+        last_pwm_left = 0;
+        last_pwm_right = 0;
+        PERF_END(PERF_SPEED_UPDATE);
+        return;
+    }
+
+    // скорость колеса со знаком «+ вперёд» (оценщик считает в знаке PWM)
+    float measL = WheelEst_Speed(&est_left) * (float)MOTOR_FORWARD_SIGN;
+    float measR = WheelEst_Speed(&est_right) * (float)MOTOR_FORWARD_SIGN;
+
+    // ПИД-выход — PWM со знаком в [-MOTOR_PWM_MAX .. MOTOR_PWM_MAX]:
+    // обратный знак при той же цели — активное торможение
+    PERF_BEGIN(PERF_PID_UPDATE);
+    float outL = wheel_pid(&pid_left, target_left_rps, measL, dt_sec);
+    float outR = wheel_pid(&pid_right, target_right_rps, measR, dt_sec);
+    PERF_END(PERF_PID_UPDATE);
 
     int16_t pwmL = (int16_t)outL;
     int16_t pwmR = (int16_t)outR;
 
-    /* --- Минимальный PWM для сдвига мотора --- */
+    /* --- Минимальный PWM для сдвига мотора ---
+     * Только в сторону цели: тормозящий (обратный) PWM не подтягиваем.
+     */
     const int16_t PWM_MIN_START = 60; // подбирал бы в районе 35–50
 
     if (target_left_rps > 0.0f && pwmL > 0 && pwmL < PWM_MIN_START)
         pwmL = PWM_MIN_START;
+    if (target_left_rps < 0.0f && pwmL < 0 && pwmL > -PWM_MIN_START)
+        pwmL = -PWM_MIN_START;
     if (target_right_rps > 0.0f && pwmR > 0 && pwmR < PWM_MIN_START)
         pwmR = PWM_MIN_START;
+    if (target_right_rps < 0.0f && pwmR < 0 && pwmR > -PWM_MIN_START)
+        pwmR = -PWM_MIN_START;
+
+    // «вперёд» робота → знак мотора
+    pwmL *= MOTOR_FORWARD_SIGN;
+    pwmR *= MOTOR_FORWARD_SIGN;
+
+    // оба борта одним пакетом (при 4WD задние моторы повторяют передние)
+    int16_t speeds[MOTOR_COUNT] = {pwmL, pwmR};
+#if MOTOR_4WD
+    speeds[MOTOR_C] = pwmL;
+    speeds[MOTOR_D] = pwmR;
+#endif
+    Motor_SetSpeeds(speeds);
+
+    last_pwm_left = pwmL;
+    last_pwm_right = pwmR;
 
-    // учитываем направление
-    pwmL *= dir_left;
-    pwmR *= dir_right;
+    SLOG(SLOG_PWM, (&(SlogPwm_t){pwmL, pwmR}));
 
-    Motor_SetSpeed(MOTOR_A, pwmL);
-    Motor_SetSpeed(MOTOR_B, pwmR);
+    PERF_END(PERF_SPEED_UPDATE);
+}
+
+void SpeedControl_GetMeasured(float *left_rps, float *right_rps)
+{
+    if (left_rps)
+        *left_rps = WheelEst_Speed(&est_left) * (float)MOTOR_FORWARD_SIGN;
+    if (right_rps)
+        *right_rps = WheelEst_Speed(&est_right) * (float)MOTOR_FORWARD_SIGN;
 }
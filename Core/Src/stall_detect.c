@@ -0,0 +1,155 @@
+// stall_detect.c
+#include "stall_detect.h"
+#include "speed_control.h"
+#include "MPU6050.h"
+#include "trace.h"
+#include "mem_sections.h"
+
+/* --------------------------------------------------------------------------
+ * Состояние
+ * -------------------------------------------------------------------------- */
+
+static volatile uint8_t s_event CCMRAM = STALL_NONE;
+static volatile uint8_t s_armed CCMRAM = 0;
+static MotorStopMode s_cutMode CCMRAM = MOTOR_STOP_COAST;
+
+// ожидаемая скорость (после звена τ) и время в состоянии «не крутится», по колёсам
+static float s_expect[2] CCMRAM;
+static float s_stallTime[2] CCMRAM;
+
+// удар: прошлый отсчёт и порог (квадрат, LSB²) для масштаба s_thrScale, g/LSB
+static int16_t s_prevAx CCMRAM, s_prevAy CCMRAM;
+static uint8_t s_havePrev CCMRAM = 0;
+static int64_t s_impactThr2 CCMRAM;
+static float s_thrScale CCMRAM;
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+static void stall_cut(uint8_t ev, uint32_t info)
+{
+    Motor_StopWithMode(MOTOR_A, s_cutMode);
+    Motor_StopWithMode(MOTOR_B, s_cutMode);
+
+    s_event |= ev;
+    TRACE(TRACE_EV_STALL, ev, info);
+}
+
+// Порог удара в LSB² для масштаба акселерометра ka (g/LSB)
+static void stall_set_threshold(float ka)
+{
+    float thr_lsb = STALL_IMPACT_G / ka;
+    s_impactThr2 = (int64_t)(thr_lsb * thr_lsb);
+    s_thrScale = ka;
+}
+
+// Одно колесо: 1 — заклинило
+static uint8_t stall_wheel(uint32_t i, int16_t pwm, float meas, float dt_sec)
+{
+    float u = (pwm >= 0) ? (float)pwm : -(float)pwm;
+    float u_eff = (u > WHEEL_MODEL_U0) ? (u - WHEEL_MODEL_U0) : 0.0f;
+    float target = WHEEL_MODEL_K * u_eff;
+
+    // ожидаемая скорость догоняет целевую с постоянной τ
+    float k = dt_sec / WHEEL_MODEL_TAU;
+    if (k > 1.0f)
+        k = 1.0f;
+    s_expect[i] += k * (target - s_expect[i]);
+
+    // скорость вдоль команды (колесо, которое тащит назад, тоже «стоит»)
+    float along = (pwm >= 0) ? meas : -meas;
+
+    if (s_expect[i] >= STALL_MIN_EXPECT_RPS && along < STALL_SPEED_RATIO * s_expect[i])
+        s_stallTime[i] += dt_sec;
+    else
+        s_stallTime[i] = 0.0f;
+
+    return s_stallTime[i] >= STALL_CONFIRM_S;
+}
+
+/* --------------------------------------------------------------------------
+ * Интерфейс
+ * -------------------------------------------------------------------------- */
+void Stall_Init(void)
+{
+    stall_set_threshold(MPU6050_GetAccelScale());
+
+    Stall_Arm(0);
+}
+
+void Stall_Arm(uint8_t on)
+{
+    s_armed = 0;
+
+    s_expect[0] = s_expect[1] = 0.0f;
+    s_stallTime[0] = s_stallTime[1] = 0.0f;
+    s_havePrev = 0;
+    s_event = STALL_NONE;
+
+    s_armed = on;
+}
+
+void Stall_SetCutMode(MotorStopMode mode)
+{
+    s_cutMode = mode;
+}
+
+RAMFUNC uint8_t Stall_UpdateWheels(int16_t pwmL, int16_t pwmR, float measL, float measR, float dt_sec)
+{
+    if (!s_armed || dt_sec <= 0.0f)
+        return s_event;
+
+    uint8_t ev = 0;
+    if (stall_wheel(0, pwmL, measL, dt_sec))
+        ev |= STALL_LEFT;
+    if (stall_wheel(1, pwmR, measR, dt_sec))
+        ev |= STALL_RIGHT;
+
+    if (ev && !(s_event & ev))
+        stall_cut(ev, 0);
+
+    return s_event;
+}
+
+RAMFUNC uint8_t Stall_FeedAccel(const int16_t accel[3])
+{
+    if (!s_armed)
+        return s_event;
+
+    // диапазон сменили после Stall_Init (MPU6050_Configure, ACCEL_CONFIG):
+    // порог — в новых LSB, прошлый отсчёт в старых сравнивать не с чем
+    float ka = MPU6050_GetAccelScale();
+    if (ka != s_thrScale)
+    {
+        stall_set_threshold(ka);
+        s_havePrev = 0;
+    }
+
+    if (s_havePrev)
+    {
+        int32_t dx = (int32_t)accel[0] - s_prevAx;
+        int32_t dy = (int32_t)accel[1] - s_prevAy;
+        int64_t d2 = (int64_t)dx * dx + (int64_t)dy * dy;
+
+        if (d2 > s_impactThr2 && !(s_event & STALL_IMPACT))
+            stall_cut(STALL_IMPACT, (d2 > 0xFFFFFFFFLL) ? 0xFFFFFFFFUL : (uint32_t)d2);
+    }
+
+    s_prevAx = accel[0];
+    s_prevAy = accel[1];
+    s_havePrev = 1;
+
+    return s_event;
+}
+
+uint8_t Stall_Event(void)
+{
+    return s_event;
+}
+
+void Stall_Clear(void)
+{
+    s_event = STALL_NONE;
+    s_stallTime[0] = s_stallTime[1] = 0.0f;
+}
@@ -0,0 +1,609 @@
+// teleop.c
+//
+// Телеуправление: кадры уставок с USART3 → скорости колёс → SpeedControl.
+// Формат кадров, статистика и поведение при обрыве — в teleop.h.
+
+#include "teleop.h"
+#include "usart.h"
+#include "timebase.h"
+#include "speed_control.h"
+#include "odometry.h"
+#include "deadline.h"
+#include "trace.h"
+#include "path_follow.h"
+#include "grid_plan.h"
+#include <stdio.h>
+
+/* Бюджет прохода цикла телеуправления: регулятор раз в 10 мс,
+ * плюс печать отчёта по запросу (~40 мс на 115200).
+ */
+#define TELEOP_DEADLINE_MS 100U
+
+/* --- Приём строки --- */
+static char s_line[TELEOP_LINE_MAX];
+static uint32_t s_lineLen;
+static uint8_t s_lineOverflow;
+
+/* --- Поток --- */
+static uint8_t s_haveSeq;
+static uint32_t s_lastSeq;
+static uint32_t s_lastRxUs;
+static uint32_t s_lastHostUs;
+static uint32_t s_lastFrameUs; // момент применения последней уставки
+
+typedef enum
+{
+    TELEOP_IDLE = 0, // стоим, ждём кадров
+    TELEOP_RUN,      // уставки идут
+    TELEOP_STOPPING, // поток оборвался — плавная остановка
+    TELEOP_PATH      // едем по загруженному пути (path_follow.h)
+} TeleopState;
+
+static TeleopState s_state;
+
+/* --- Текущая уставка корпуса: мм/с, рад/с --- */
+static float s_v, s_w;
+static uint32_t s_ctrlUs;
+
+/* --- Загруженные точки пути ($P) --- */
+static PathPoint_t s_path[TELEOP_PATH_MAX];
+static uint32_t s_pathLen;
+
+/* --- План по карте ($G) --- */
+static GridCell_t s_cells[GRID_CELLS];
+
+/* --- Статистика окна --- */
+static TeleopStats_t s_st;
+static uint8_t s_haveMinD;
+static int32_t s_minD; // min(rx − host) за окно
+static uint64_t s_queueSum;
+static uint64_t s_fwSum;
+static uint32_t s_rxDropBase;
+
+// ---------------- Вспомогательное ----------------
+
+static uint8_t nmea_xor(const char *p, uint32_t n)
+{
+    uint8_t x = 0;
+    while (n--)
+        x ^= (uint8_t)*p++;
+    return x;
+}
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// Целое со знаком до ',' или конца поля; *pp сдвигается за разделитель
+static uint8_t parse_int(const char **pp, const char *end, int32_t *out)
+{
+    const char *p = *pp;
+    uint8_t neg = 0;
+    uint32_t v = 0;
+    uint32_t digits = 0;
+
+    if (p < end && *p == '-')
+    {
+        neg = 1;
+        p++;
+    }
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        v = v * 10U + (uint32_t)(*p - '0');
+        p++;
+        digits++;
+    }
+    if (digits == 0U || digits > 10U || (neg && v > 2147483647UL))
+        return 0;
+    if (p < end)
+    {
+        if (*p != ',')
+            return 0;
+        p++;
+    }
+
+    *out = neg ? -(int32_t)v : (int32_t)v;
+    *pp = p;
+    return 1;
+}
+
+// n целых через запятую до конца тела кадра
+static uint8_t parse_fields(const char *p, const char *end, int32_t *f, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (!parse_int(&p, end, &f[i]))
+            return 0;
+    }
+    return (p == end) ? 1U : 0U;
+}
+
+static int32_t clamp_i32(int32_t v, int32_t lim)
+{
+    return (v > lim) ? lim : (v < -lim) ? -lim : v;
+}
+
+static void apply_twist(float v, float w)
+{
+    (void)SpeedControl_SetTwist(v, w);
+    s_v = v;
+    s_w = w;
+}
+
+// buf уже содержит "$<тело>" длиной n: дописать "*HH\r\n" и отправить
+static void send_frame(char *buf, uint32_t size, int n)
+{
+    if (n <= 0 || (uint32_t)n + 6U > size)
+        return;
+    snprintf(buf + n, size - (uint32_t)n, "*%02X\r\n",
+             nmea_xor(buf + 1, (uint32_t)n - 1U));
+    USART_Print(buf);
+}
+
+static void send_ack(uint32_t seq, uint32_t host_us, uint32_t dev_us)
+{
+    char buf[48];
+    int n = snprintf(buf, sizeof(buf), "$A,%lu,%lu,%lu", (unsigned long)seq,
+                     (unsigned long)host_us, (unsigned long)dev_us);
+    send_frame(buf, sizeof(buf), n);
+}
+
+// ---------------- Учёт времени кадра ----------------
+
+static void account_frame(uint32_t seq, uint32_t host_us, uint32_t rx_us)
+{
+    if (s_haveSeq)
+    {
+        if (seq - s_lastSeq > 1U)
+            s_st.lost += seq - s_lastSeq - 1U;
+
+        uint32_t gap = rx_us - s_lastRxUs;
+        if (gap > s_st.max_gap_us)
+            s_st.max_gap_us = gap;
+
+        // RFC 3550: разница интервалов прихода и отправки
+        int32_t D = (int32_t)(gap - (host_us - s_lastHostUs));
+        uint32_t absD = (uint32_t)((D < 0) ? -D : D);
+        s_st.jitter_us += ((float)absD - s_st.jitter_us) * (1.0f / 16.0f);
+        if (absD > s_st.max_jitter_us)
+            s_st.max_jitter_us = absD;
+    }
+
+    int32_t d = (int32_t)(rx_us - host_us);
+    if (!s_haveMinD || d < s_minD)
+    {
+        s_minD = d;
+        s_haveMinD = 1;
+    }
+    uint32_t q = (uint32_t)(d - s_minD);
+    s_queueSum += q;
+    if (q > s_st.queue_max_us)
+        s_st.queue_max_us = q;
+
+    s_haveSeq = 1;
+    s_lastSeq = seq;
+    s_lastRxUs = rx_us;
+    s_lastHostUs = host_us;
+}
+
+// ---------------- Разбор кадра ----------------
+
+static void handle_setpoint(const char *p, const char *end, uint32_t rx_us)
+{
+    int32_t f[4]; // seq, t_host, v, w
+    if (!parse_fields(p, end, f, 4U))
+    {
+        s_st.bad++;
+        return;
+    }
+
+    uint32_t seq = (uint32_t)f[0];
+    uint32_t host_us = (uint32_t)f[1];
+
+    // дубль или перестановка: старая уставка не должна перебить новую
+    if (s_haveSeq && (int32_t)(seq - s_lastSeq) <= 0)
+    {
+        s_st.stale++;
+        return;
+    }
+
+    account_frame(seq, host_us, rx_us);
+
+    // кинематика и насыщение с сохранением кривизны — в SpeedControl_SetTwist
+    apply_twist((float)clamp_i32(f[2], TELEOP_V_MAX_MM_S),
+                (float)clamp_i32(f[3], TELEOP_W_MAX_MRAD_S) * 1e-3f);
+
+    uint32_t now = Time_Us();
+    uint32_t fw = now - rx_us;
+    if (s_st.frames == 0U || fw < s_st.fw_min_us)
+        s_st.fw_min_us = fw;
+    if (fw > s_st.fw_max_us)
+        s_st.fw_max_us = fw;
+    s_fwSum += fw;
+    s_st.frames++;
+
+    if (s_state == TELEOP_PATH)
+        PathFollow_Stop(); // ручная уставка перебивает путь
+    else if (s_state != TELEOP_RUN && s_st.stalls)
+        TRACE(TRACE_EV_TELEOP, 1, seq);
+    s_state = TELEOP_RUN;
+    s_lastFrameUs = now;
+
+#if TELEOP_ACK_DIV
+    if (seq % TELEOP_ACK_DIV == 0U)
+        send_ack(seq, host_us, Time_Us() - rx_us);
+#endif
+}
+
+// ---------------- Загрузка пути ----------------
+
+static void handle_point(const char *p, const char *end)
+{
+    int32_t f[2]; // x, y
+    if (!parse_fields(p, end, f, 2U) || s_pathLen >= TELEOP_PATH_MAX)
+    {
+        s_st.bad++;
+        return;
+    }
+    s_path[s_pathLen].x_mm = (float)f[0];
+    s_path[s_pathLen].y_mm = (float)f[1];
+    s_pathLen++;
+}
+
+static void follow_cfg(int32_t mode, int32_t v_mm_s, PathFollowCfg_t *cfg)
+{
+    PathFollow_DefaultCfg(cfg);
+    cfg->mode = (mode == PATH_STANLEY) ? PATH_STANLEY : PATH_PURE_PURSUIT;
+    if (v_mm_s > 0)
+        cfg->v_max_mm_s = (float)clamp_i32(v_mm_s, TELEOP_V_MAX_MM_S);
+}
+
+static void handle_follow(const char *p, const char *end)
+{
+    int32_t f[3]; // mode, v_max, steps
+    if (!parse_fields(p, end, f, 3U))
+    {
+        s_st.bad++;
+        return;
+    }
+
+    PathFollowCfg_t cfg;
+    follow_cfg(f[0], f[1], &cfg);
+
+    // путь от текущей позы: первая точка — обычно (0, 0)
+    Path_Clear();
+    uint8_t ok;
+    if (f[2] > 1)
+        ok = Path_AddSpline(s_path, s_pathLen, (uint32_t)f[2]);
+    else
+    {
+        ok = 1;
+        for (uint32_t i = 0; i < s_pathLen && ok; i++)
+            ok = Path_Add(s_path[i].x_mm, s_path[i].y_mm);
+    }
+
+    Pose_t pose;
+    Odom_GetPose(&pose);
+    if (ok)
+        ok = PathFollow_Start(&cfg, &pose);
+
+    char buf[32];
+    send_frame(buf, sizeof(buf),
+               snprintf(buf, sizeof(buf), "$F,%lu", (unsigned long)(ok ? Path_Count() : 0U)));
+
+    if (ok)
+        s_state = TELEOP_PATH;
+}
+
+// $O,x0,y0,x1,y1,b — прямоугольник клеток карты занят / свободен
+static void handle_obstacle(const char *p, const char *end)
+{
+    int32_t f[5];
+    if (!parse_fields(p, end, f, 5U) || f[0] < 0 || f[1] < 0 || f[2] < 0 || f[3] < 0)
+    {
+        s_st.bad++;
+        return;
+    }
+    Grid_SetRect((uint32_t)f[0], (uint32_t)f[1], (uint32_t)f[2], (uint32_t)f[3], f[4] ? 1U : 0U);
+}
+
+// $G,gx,gy,mode,v — план от клетки под роботом до (gx, gy) и сразу в путь
+static void handle_goto(const char *p, const char *end)
+{
+    int32_t f[4];
+    if (!parse_fields(p, end, f, 4U) || f[0] < 0 || f[1] < 0 ||
+        f[0] >= (int32_t)GRID_W || f[1] >= (int32_t)GRID_H)
+    {
+        s_st.bad++;
+        return;
+    }
+
+    Pose_t pose;
+    GridCell_t start;
+    GridCell_t goal = {(uint8_t)f[0], (uint8_t)f[1]};
+    Odom_GetPose(&pose);
+
+    uint32_t t0 = Time_Us();
+    uint32_t cells = 0, points = 0;
+    if (Grid_CellAt(pose.x_mm, pose.y_mm, &start))
+        cells = Grid_Plan(GRID_ASTAR, start, goal, s_cells, GRID_CELLS);
+    if (cells)
+        points = Grid_EmitPath(s_cells, cells, 1U);
+    uint32_t plan_us = Time_ElapsedUs(t0);
+
+    PathFollowCfg_t cfg;
+    follow_cfg(f[2], f[3], &cfg);
+
+    // точки карты — в системе одометрии
+    if (points && PathFollow_Start(&cfg, NULL))
+        s_state = TELEOP_PATH;
+    else
+        points = 0;
+
+    char buf[48];
+    send_frame(buf, sizeof(buf),
+               snprintf(buf, sizeof(buf), "$G,%lu,%lu,%lu,%lu", (unsigned long)points,
+                        (unsigned long)cells, (unsigned long)Grid_LastStats()->expanded,
+                        (unsigned long)plan_us));
+}
+
+static void path_done(void)
+{
+    PathFollowStats_t ps;
+    PathFollow_GetStats(&ps);
+
+    char buf[48];
+    send_frame(buf, sizeof(buf),
+               snprintf(buf, sizeof(buf), "$D,%ld,%ld,%ld,%lu",
+                        (long)ps.max_err_mm, (long)ps.rms_err_mm, (long)ps.end_err_mm,
+                        (unsigned long)(ps.time_s * 1000.0f)));
+    PathFollow_Report();
+}
+
+static void handle_line(uint32_t rx_us)
+{
+    // "$<тело>*HH", \r в конце допускается
+    uint32_t n = s_lineLen;
+    if (n && s_line[n - 1U] == '\r')
+        n--;
+
+    if (n < 5U || s_line[0] != '$' || s_line[n - 3U] != '*')
+    {
+        s_st.bad++;
+        return;
+    }
+
+    int hi = hex_digit(s_line[n - 2U]);
+    int lo = hex_digit(s_line[n - 1U]);
+    const char *body = &s_line[1];
+    const char *end = &s_line[n - 3U];
+
+    if (hi < 0 || lo < 0 ||
+        nmea_xor(body, (uint32_t)(end - body)) != (uint8_t)((hi << 4) | lo))
+    {
+        s_st.bad++;
+        return;
+    }
+
+    if (body[0] == 'S' && end - body > 2 && body[1] == ',')
+        handle_setpoint(body + 2, end, rx_us);
+    else if (body[0] == 'R' && end - body == 1)
+        Teleop_Report();
+    else if (body[0] == 'P' && end - body > 2 && body[1] == ',')
+        handle_point(body + 2, end);
+    else if (body[0] == 'C' && end - body == 1)
+        s_pathLen = 0;
+    else if (body[0] == 'F' && end - body > 2 && body[1] == ',')
+        handle_follow(body + 2, end);
+    else if (body[0] == 'O' && end - body > 2 && body[1] == ',')
+        handle_obstacle(body + 2, end);
+    else if (body[0] == 'G' && end - body > 2 && body[1] == ',')
+        handle_goto(body + 2, end);
+    else
+        s_st.bad++;
+}
+
+static void rx_poll(void)
+{
+    while (USART_IsDataReceived())
+    {
+        char c = USART_ReadChar();
+
+        if (c != '\n')
+        {
+            if (s_lineLen < TELEOP_LINE_MAX)
+                s_line[s_lineLen++] = c;
+            else
+                s_lineOverflow = 1;
+            continue;
+        }
+
+        uint32_t rx_us;
+        if (!USART_PopEolStamp(&rx_us))
+            rx_us = Time_Us();
+
+        if (s_lineOverflow)
+            s_st.bad++;
+        else
+            handle_line(rx_us);
+
+        s_lineLen = 0;
+        s_lineOverflow = 0;
+    }
+}
+
+// ---------------- Регулятор и обрыв потока ----------------
+
+static void control_step(float dt)
+{
+    if (s_state == TELEOP_PATH)
+    {
+        // путь не требует потока: поза одометрии → (v, ω)
+        Pose_t pose;
+        float v, w;
+        Odom_GetPose(&pose);
+
+        if (PathFollow_Step(&pose, dt, &v, &w) == PATH_RUNNING)
+            apply_twist(v, w);
+        else
+        {
+            s_v = s_w = 0.0f;
+            SpeedControl_Stop();
+            s_state = TELEOP_IDLE;
+            path_done();
+        }
+    }
+    else if (s_state != TELEOP_IDLE && Time_ElapsedUs(s_lastFrameUs) >= TELEOP_STALL_MS * 1000U)
+    {
+        if (s_state == TELEOP_RUN)
+        {
+            s_st.stalls++;
+            s_state = TELEOP_STOPPING;
+            TRACE(TRACE_EV_TELEOP, 0, s_lastSeq);
+            USART_Println("TELEOP: stream stalled, stopping");
+        }
+
+        // сводим к нулю, масштабируя v и ω вместе — робот не сходит с дуги;
+        // темп задаёт самое быстрое колесо
+        float half = 0.5f * Odom_GetCalib()->track_mm;
+        float vmax = ((s_v >= 0.0f) ? s_v : -s_v) + ((s_w >= 0.0f) ? s_w : -s_w) * half;
+        float dv = TELEOP_STOP_DECEL_MM_S2 * dt;
+
+        if (vmax <= dv)
+        {
+            s_v = s_w = 0.0f;
+            SpeedControl_Stop();
+            s_state = TELEOP_IDLE;
+        }
+        else
+        {
+            float k = (vmax - dv) / vmax;
+            apply_twist(s_v * k, s_w * k);
+        }
+    }
+
+    SpeedControl_Update(dt);
+
+    // знак колёс для одометрии (энкодер одноканальный) — по измеренной скорости
+    float rpsL, rpsR;
+    SpeedControl_GetMeasured(&rpsL, &rpsR);
+    Odom_Update((rpsL >= 0.0f) ? +1 : -1, (rpsR >= 0.0f) ? +1 : -1);
+}
+
+// ---------------- API ----------------
+
+void Teleop_Init(void)
+{
+    SpeedControl_Init();
+
+    s_lineLen = 0;
+    s_lineOverflow = 0;
+    s_haveSeq = 0;
+    s_state = TELEOP_IDLE;
+    s_v = s_w = 0.0f;
+    s_ctrlUs = Time_Us();
+    s_pathLen = 0;
+
+    // карта: робот стартует в центре клетки (0, 0), курс вдоль +x
+    Grid_Init(GRID_CELL_MM_DEFAULT, -0.5f * GRID_CELL_MM_DEFAULT, -0.5f * GRID_CELL_MM_DEFAULT);
+
+    TeleopStats_t zero = {0};
+    s_st = zero;
+    s_haveMinD = 0;
+    s_queueSum = 0;
+    s_fwSum = 0;
+    s_rxDropBase = USART_RxDropped();
+}
+
+void Teleop_Poll(void)
+{
+    rx_poll();
+
+    uint32_t el = Time_ElapsedUs(s_ctrlUs);
+    if (el >= TELEOP_CTRL_PERIOD_US)
+    {
+        s_ctrlUs += el;
+        control_step((float)el * 1e-6f);
+    }
+}
+
+void Teleop_Run(void)
+{
+    USART_Println("TELEOP: waiting for $S frames on USART3");
+    Deadline_Enable(DL_TASK_CONTROL, TELEOP_DEADLINE_MS);
+
+    while (1)
+        Teleop_Poll();
+}
+
+uint8_t Teleop_IsActive(void)
+{
+    return (s_state == TELEOP_RUN || s_state == TELEOP_PATH) ? 1U : 0U;
+}
+
+void Teleop_GetStats(TeleopStats_t *out)
+{
+    *out = s_st;
+    out->rx_drops = USART_RxDropped() - s_rxDropBase;
+    if (s_st.frames)
+    {
+        out->queue_mean_us = (uint32_t)(s_queueSum / s_st.frames);
+        out->fw_mean_us = (uint32_t)(s_fwSum / s_st.frames);
+    }
+}
+
+void Teleop_Report(void)
+{
+    TeleopStats_t s;
+    Teleop_GetStats(&s);
+
+    USART_Println("--- TELEOP ---");
+    USART_Print("frames=");
+    USART_PrintInt((int32_t)s.frames);
+    USART_Print(" lost=");
+    USART_PrintInt((int32_t)s.lost);
+    USART_Print(" stale=");
+    USART_PrintInt((int32_t)s.stale);
+    USART_Print(" bad=");
+    USART_PrintInt((int32_t)s.bad);
+    USART_Print(" rx_drops=");
+    USART_PrintInt((int32_t)s.rx_drops);
+    USART_Print(" stalls=");
+    USART_PrintlnInt((int32_t)s.stalls);
+
+    USART_Print("jitter us: rfc3550=");
+    USART_PrintFloat(s.jitter_us, 1);
+    USART_Print(" max=");
+    USART_PrintInt((int32_t)s.max_jitter_us);
+    USART_Print("  max gap=");
+    USART_PrintlnInt((int32_t)s.max_gap_us);
+
+    USART_Print("queue delay us (over window min): mean=");
+    USART_PrintInt((int32_t)s.queue_mean_us);
+    USART_Print(" max=");
+    USART_PrintlnInt((int32_t)s.queue_max_us);
+
+    USART_Print("firmware rx->apply us: min/mean/max=");
+    USART_PrintInt((int32_t)s.fw_min_us);
+    USART_Print("/");
+    USART_PrintInt((int32_t)s.fw_mean_us);
+    USART_Print("/");
+    USART_PrintlnInt((int32_t)s.fw_max_us);
+
+    // новое окно: минимум задержки заново — дрейф часов хоста не копится
+    uint32_t stalls = s_st.stalls;
+    TeleopStats_t zero = {0};
+    s_st = zero;
+    s_st.stalls = stalls;
+    s_haveMinD = 0;
+    s_queueSum = 0;
+    s_fwSum = 0;
+    s_rxDropBase = USART_RxDropped();
+}
@@ -0,0 +1,49 @@
+// timebase.c
+#include "timebase.h"
+#include "idle.h"
+
+void Time_Init(void)
+{
+    SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM2EN);
+
+    CLEAR_BIT(TIMEBASE_TIM->CR1, TIM_CR1_CEN);
+
+    WRITE_REG(TIMEBASE_TIM->PSC, TIMEBASE_PSC);
+    WRITE_REG(TIMEBASE_TIM->ARR, 0xFFFFFFFFUL);
+    WRITE_REG(TIMEBASE_TIM->CNT, 0U);
+
+    // UG — загрузить PSC сразу, флаг обновления сбросить
+    SET_BIT(TIMEBASE_TIM->EGR, TIM_EGR_UG);
+    CLEAR_BIT(TIMEBASE_TIM->SR, TIM_SR_UIF);
+
+    SET_BIT(TIMEBASE_TIM->CR1, TIM_CR1_CEN);
+
+    // CC1 — будильник бестикового сна
+    Idle_Init();
+}
+
+void Time_DelayUs(uint32_t us)
+{
+    uint32_t start = Time_Us();
+    while (Time_ElapsedUs(start) < us)
+    {
+    }
+}
+
+void Time_DelayMs(uint32_t ms)
+{
+    // спим без SysTick до дедлайна, прерывания обслуживаются по пути
+    Idle_WaitUntil(Time_DeadlineUs(ms * 1000U));
+}
+
+/* Прерывание TIM2: CC1 — будильник сна (idle.c сам снимает флаг,
+ * обработчик страхует от «залипшего» запроса)
+ */
+void TIM2_IRQHandler(void)
+{
+    if (READ_BIT(TIMEBASE_TIM->SR, TIM_SR_CC1IF))
+    {
+        CLEAR_BIT(TIMEBASE_TIM->DIER, TIM_DIER_CC1IE);
+        CLEAR_BIT(TIMEBASE_TIM->SR, TIM_SR_CC1IF);
+    }
+}
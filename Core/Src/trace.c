@@ -0,0 +1,99 @@
+// trace.c
+//
+// Бортовой самописец: инициализация, очистка и выгрузка кольца событий.
+// Сама запись события — inline Trace_Record() в trace.h.
+
+#include "trace.h"
+#include "usart.h"
+#include "deadline.h"
+
+/* Размер буфера зашит в ASSERT линкер-скрипта (mem_sections.h) */
+_Static_assert(sizeof(TraceBuf_t) == TRACE_CAPACITY * sizeof(TraceRec_t) + 16U,
+               "TraceBuf_t changed: update the CCM ASSERT in the linker script");
+
+/* --------------------------------------------------------------------------
+ * Локальные функции
+ * -------------------------------------------------------------------------- */
+
+// Печать числа в hex фиксированной ширины (без sprintf — выгрузка длинная)
+static void Trace_PutHex(uint32_t v, uint8_t digits)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    for (int8_t i = (int8_t)digits - 1; i >= 0; i--)
+        USART_WriteChar(hex[(v >> (4U * (uint8_t)i)) & 0xFU]);
+}
+
+/* --------------------------------------------------------------------------
+ * Инициализация
+ * -------------------------------------------------------------------------- */
+void Trace_Init(void)
+{
+    // CCM RAM тактируется по умолчанию, но включим явно
+    SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_CCMDATARAMEN);
+
+    // Счётчик тактов DWT — источник меток времени
+    SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk);
+    SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk);
+
+    TraceBuf_t *tb = TRACE_BUF;
+
+    if (tb->magic != TRACE_MAGIC)
+    {
+        Trace_Clear();
+        return;
+    }
+
+    // Буфер пережил сброс — продолжаем писать в него
+    tb->boots++;
+    tb->cpu_hz = SystemCoreClock;
+    TRACE(TRACE_EV_BOOT, 0, RCC->CSR);
+}
+
+void Trace_Clear(void)
+{
+    TraceBuf_t *tb = TRACE_BUF;
+
+    tb->head = 0;
+    tb->boots = 0;
+    tb->cpu_hz = SystemCoreClock;
+    tb->magic = TRACE_MAGIC;
+}
+
+/* --------------------------------------------------------------------------
+ * Выгрузка
+ * -------------------------------------------------------------------------- */
+void Trace_Dump(void)
+{
+    TraceBuf_t *tb = TRACE_BUF;
+
+    // Фиксируем конец выгрузки: события, пришедшие во время печати, не берём
+    uint32_t head = tb->head;
+    uint32_t first = (head > TRACE_CAPACITY) ? (head - TRACE_CAPACITY) : 0U;
+
+    USART_Print("#TRACE v1 cpu_hz=");
+    USART_PrintInt((int32_t)tb->cpu_hz);
+    USART_Print(" boots=");
+    USART_PrintInt((int32_t)tb->boots);
+    USART_Print(" head=");
+    USART_PrintInt((int32_t)head);
+    USART_Print(" cap=");
+    USART_PrintlnInt((int32_t)TRACE_CAPACITY);
+
+    for (uint32_t i = first; i != head; i++)
+    {
+        const TraceRec_t *r = &tb->rec[i & (TRACE_CAPACITY - 1U)];
+        Deadline_Alive(); // выгрузка дольше таймаута IWDG
+
+        Trace_PutHex(r->ts, 8);
+        USART_WriteChar(' ');
+        Trace_PutHex(r->id, 4);
+        USART_WriteChar(' ');
+        Trace_PutHex(r->a, 4);
+        USART_WriteChar(' ');
+        Trace_PutHex(r->b, 8);
+        USART_WriteString("\r\n");
+    }
+
+    USART_Println("#END");
+}
@@ -1,12 +1,25 @@
 #include "usart.h"
+#include "timebase.h"
 #include <stdio.h> // для sprintf (если не нужен float/инты через sprintf — можно убрать)
 
-/* ===== Локальная функция: инициализация GPIO под USART2 =====
- * TX = PD5 (AF7)
- * RX = PA3 (AF7)
- */
 // usart.c — версия под USART3 PD8/PD9
 
+/* ===== Приём: кольцо по прерыванию RXNE =====
+ * Обработчик кладёт байт в s_rxBuf; на '\n' дополнительно запоминает
+ * Time_Us() в s_eolUs — момент прихода конца строки без задержки
+ * главного цикла (для учёта латентности, см. teleop.c).
+ * Оба кольца — один писатель (ISR), один читатель (main), без блокировок.
+ */
+static volatile uint8_t s_rxBuf[USART_RX_BUF_SIZE];
+static volatile uint32_t s_rxHead; // пишет ISR
+static volatile uint32_t s_rxTail; // читает main
+
+static volatile uint32_t s_eolUs[USART_RX_EOL_STAMPS];
+static volatile uint32_t s_eolHead;
+static volatile uint32_t s_eolTail;
+
+static volatile uint32_t s_rxDropped; // кольцо полно или аппаратный overrun
+
 static void USART3_GPIO_Init(void)
 {
     // Включаем порт D
@@ -40,13 +53,51 @@ void USART3_Init(uint32_t baudrate)
     uint32_t brr = (USART_PCLK1_HZ + baudrate / 2U) / baudrate;
     USART3->BRR = brr;
 
-    USART3->CR1 = USART_CR1_TE | USART_CR1_RE; // 8N1
+    USART3->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_RXNEIE; // 8N1
     USART3->CR2 = 0;
     USART3->CR3 = 0;
 
+    s_rxHead = s_rxTail = 0;
+    s_eolHead = s_eolTail = 0;
+    s_rxDropped = 0;
+
+    NVIC_SetPriority(USART3_IRQn, USART_RX_IRQ_PRIO);
+    NVIC_EnableIRQ(USART3_IRQn);
+
     USART3->CR1 |= USART_CR1_UE;
 }
 
+void USART3_IRQHandler(void)
+{
+    uint32_t sr = USART3->SR;
+
+    if (sr & (USART_SR_RXNE | USART_SR_ORE))
+    {
+        // чтение DR после SR сбрасывает и RXNE, и ORE
+        uint8_t c = (uint8_t)USART3->DR;
+
+        if (sr & USART_SR_ORE)
+            s_rxDropped++;
+
+        // '\n' без места под отметку тоже теряем — иначе строки и отметки разъедутся
+        uint32_t head = s_rxHead;
+        if (head - s_rxTail >= USART_RX_BUF_SIZE ||
+            (c == '\n' && s_eolHead - s_eolTail >= USART_RX_EOL_STAMPS))
+        {
+            s_rxDropped++;
+            return;
+        }
+
+        if (c == '\n')
+        {
+            s_eolUs[s_eolHead % USART_RX_EOL_STAMPS] = Time_Us();
+            s_eolHead++;
+        }
+        s_rxBuf[head % USART_RX_BUF_SIZE] = c;
+        s_rxHead = head + 1U;
+    }
+}
+
 void USART_WriteChar(char c)
 {
     while ((USART3->SR & USART_SR_TXE) == 0)
@@ -124,20 +175,35 @@ void USART_PrintlnFloat(float value, uint8_t digits)
     USART_WriteString("\r\n");
 }
 
-/* ===== RX (если захочешь читать из UART) ===== */
+/* ===== RX (кольцо USART3) ===== */
 
 uint8_t USART_IsDataReceived(void)
 {
-    return (USART2->SR & USART_SR_RXNE) ? 1U : 0U;
+    return (s_rxHead != s_rxTail) ? 1U : 0U;
 }
 
 char USART_ReadChar(void)
-
 {
-    while ((USART2->SR & USART_SR_RXNE) == 0)
+    while (s_rxHead == s_rxTail)
     {
     }
-    return (char)(USART2->DR & 0xFFU);
+    char c = (char)s_rxBuf[s_rxTail % USART_RX_BUF_SIZE];
+    s_rxTail++;
+    return c;
+}
+
+uint8_t USART_PopEolStamp(uint32_t *t_us)
+{
+    if (s_eolHead == s_eolTail)
+        return 0;
+    *t_us = s_eolUs[s_eolTail % USART_RX_EOL_STAMPS];
+    s_eolTail++;
+    return 1;
+}
+
+uint32_t USART_RxDropped(void)
+{
+    return s_rxDropped;
 }
 
 ///////  ДЛЯ FLOAT ЧИСЕЛ
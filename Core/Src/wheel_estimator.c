@@ -0,0 +1,100 @@
+// wheel_estimator.c
+#include "wheel_estimator.h"
+#include "mem_sections.h"
+#include <math.h>
+
+/* Шум процесса по умолчанию. Подобран на модели мотора с квантованием
+ * 40 имп/об, dt = 10 мс, ступеньками PWM и скачком нагрузки: RMS ошибка
+ * оценки ~0.09 об/с против ~1 об/с у «ticks / dt».
+ */
+#define WEST_Q_OMEGA 1.0f
+#define WEST_Q_DIST 10.0f
+
+/* Торможение противотоком: пока прогноз скорости выше порога, колесо
+ * ещё крутится в прежнюю сторону, хотя PWM уже обратный.
+ */
+#define WEST_REVERSAL_RPS 0.5f
+
+/* Начальная неопределённость */
+#define WEST_P0_OMEGA 1.0f
+#define WEST_P0_DIST 100.0f
+
+void WheelEst_Init(WheelEst_t *e, float K, float u0, float tau, float ppr)
+{
+    e->K = K;
+    e->u0 = u0;
+    e->tau = tau;
+    e->ppr = ppr;
+    e->q_omega = WEST_Q_OMEGA;
+    e->q_dist = WEST_Q_DIST;
+    e->a_dt = 0.0f; // множитель ещё не посчитан
+
+    WheelEst_Reset(e);
+}
+
+void WheelEst_Reset(WheelEst_t *e)
+{
+    e->omega = 0.0f;
+    e->dist = 0.0f;
+    e->accel = 0.0f;
+    e->P00 = WEST_P0_OMEGA;
+    e->P01 = 0.0f;
+    e->P11 = WEST_P0_DIST;
+}
+
+RAMFUNC void WheelEst_Update(WheelEst_t *e, uint32_t ticks, int16_t pwm, float dt)
+{
+    if (dt <= 0.0f)
+        return;
+
+    /* --- Вход модели: PWM без мёртвой зоны --- */
+    float u = (float)pwm;
+    float mag = (u >= 0.0f) ? u : -u;
+    mag = (mag > e->u0) ? (mag - e->u0) : 0.0f;
+    float u_eff = (u >= 0.0f) ? mag : -mag;
+
+    /* --- Прогноз: точное решение на шаге, F = [[a, τ·k], [0, 1]] --- */
+    if (dt != e->a_dt)
+    {
+        e->a = expf(-dt / e->tau);
+        e->a_dt = dt;
+    }
+    float a = e->a;
+    float k = 1.0f - a;
+    float b = e->tau * k; // вклад возмущения за шаг (→ dt при dt ≪ τ)
+
+    e->omega = a * e->omega + b * e->dist + k * e->K * u_eff;
+
+    float P00 = a * a * e->P00 + 2.0f * a * b * e->P01 + b * b * e->P11 + e->q_omega * dt;
+    float P01 = a * e->P01 + b * e->P11;
+    float P11 = e->P11 + e->q_dist * dt;
+
+    /* --- Измерение: тики → об/с, знак берём из команды --- */
+    float z = (float)ticks / (e->ppr * dt);
+    int8_t est = (e->omega >= 0.0f) ? +1 : -1;
+    int8_t sign = (pwm > 0) ? +1 : -1;
+    float w_abs = (e->omega >= 0.0f) ? e->omega : -e->omega;
+    if (pwm == 0)
+        sign = est; // выбег — сохраняем направление
+    else if (sign != est && w_abs > WEST_REVERSAL_RPS)
+        sign = est; // тормоз противотоком — колесо ещё не развернулось
+    z *= (float)sign;
+
+    float q = 1.0f / (e->ppr * dt); // шаг квантования
+    float R = q * q * (1.0f / 12.0f);
+
+    /* --- Коррекция (H = [1 0]) --- */
+    float S = P00 + R;
+    float K0 = P00 / S;
+    float K1 = P01 / S;
+    float y = z - e->omega;
+
+    e->omega += K0 * y;
+    e->dist += K1 * y;
+
+    e->P00 = (1.0f - K0) * P00;
+    e->P01 = (1.0f - K0) * P01;
+    e->P11 = P11 - K1 * P01;
+
+    e->accel = (e->K * u_eff - e->omega) / e->tau + e->dist;
+}
@@ -0,0 +1,25 @@
+// bench_host.c
+//
+// Набор бенчмарков bench.c на ПК: тот же Bench_RunAll(), что и на плате,
+// строка JSON печатается в stdout (make bench сравнивает её с эталоном
+// этой же машины bench_baseline.json через Tools/bench_compare.py).
+//
+// Цифры — ПК, а не Cortex-M4: годятся для поиска регрессий между
+// коммитами на одной машине, но не для бюджета тактов прошивки.
+
+#include "bench.h"
+#include "fake_board.h"
+#include "stm32f4xx.h"
+#include <stdio.h>
+
+int main(void)
+{
+    // «частота» 1 ГГц: такт = наносекунда ПК, у быстрых случаев
+    // остаются значащие цифры при печати с одним знаком после запятой
+    SystemCoreClock = 1000000000UL;
+
+    FakeUsart_Reset();
+    Bench_RunAll();
+    fputs(FakeUsart_Text(), stdout);
+    return 0;
+}
@@ -0,0 +1,63 @@
+// fake_board.h
+//
+// Подмены драйверов платы для тестов на ПК (Tests/): моторы, энкодеры,
+// USART3, backup SRAM, дедлайны, акселерометр. Каждая подмена — свой .c,
+// тест линкует только те, вместо которых не собирает настоящий модуль.
+// Здесь — ручки управления подменами из теста.
+
+#ifndef FAKE_BOARD_H
+#define FAKE_BOARD_H
+
+#include <stdint.h>
+#include "motor.h"
+
+/* ---------------- Время (host_mcu.c) ---------------- */
+
+extern volatile uint32_t g_msTicks;
+
+/* Сдвинуть TIM2->CNT (мкс) и g_msTicks (целые мс с начала) */
+void Host_AdvanceUs(uint32_t us);
+
+/* Монотонные наносекунды ПК — для отчётов ns/вызов */
+uint64_t Host_NowNs(void);
+
+/* ---------------- Моторы (fake_motor.c) ---------------- */
+
+extern int16_t g_fakeMotorPwm[MOTOR_COUNT]; // последний PWM со знаком
+extern uint8_t g_fakeMotorBrake[MOTOR_COUNT];
+extern uint32_t g_fakeMotorWrites;          // вызовов SetSpeed/SetSpeeds
+extern uint8_t g_fakeMotorEmergency;
+
+void FakeMotor_Reset(void);
+
+/* ---------------- Энкодеры (fake_encoder.c) ---------------- */
+
+/* Добавить тики к суммарным счётчикам (как будто пришли прерывания) */
+void FakeEnc_Add(uint32_t left, uint32_t right);
+void FakeEnc_Reset(void);
+
+/* Зовётся в начале каждого Encoder_GetTotals: тест, который крутит
+ * блокирующий цикл (DriveDistanceMM), двигает здесь время и модель
+ */
+extern void (*g_fakeEncPollHook)(void);
+
+/* ---------------- USART3 (fake_usart.c) ---------------- */
+
+/* Весь выведенный текст с прошлого сброса (обрезается по размеру буфера) */
+const char *FakeUsart_Text(void);
+void FakeUsart_Reset(void);
+
+/* Строки для USART_ReadChar / USART_IsDataReceived */
+void FakeUsart_Feed(const char *s);
+
+/* ---------------- Акселерометр (fake_imu.c) ---------------- */
+
+void FakeImu_SetAccelScale(float g_per_lsb);
+
+/* MPU6050_ReadSample отдаёт accel[3] (LSB) на момент чтения — массив
+ * тест может менять на ходу; NULL — датчика нет, чтения не удаются
+ */
+void FakeImu_SetAccel(const int16_t *accel);
+extern uint32_t g_fakeImuReads; // вызовов MPU6050_ReadSample
+
+#endif // FAKE_BOARD_H
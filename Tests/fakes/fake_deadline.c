@@ -0,0 +1,59 @@
+// fake_deadline.c — монитор дедлайнов только считает отметки
+#include "deadline.h"
+
+static DeadlineStats_t s_stats[DL_TASK_COUNT];
+static uint8_t s_tripped;
+
+void Deadline_Init(void)
+{
+    for (uint32_t i = 0; i < DL_TASK_COUNT; i++)
+        s_stats[i] = (DeadlineStats_t){0};
+    s_tripped = 0;
+}
+
+void Deadline_Enable(DeadlineTask task, uint32_t budget_ms)
+{
+    s_stats[task].budget_ms = budget_ms;
+}
+
+void Deadline_Disable(DeadlineTask task)
+{
+    s_stats[task].budget_ms = 0;
+}
+
+void Deadline_CheckIn(DeadlineTask task)
+{
+    s_stats[task].checkins++;
+}
+
+void Deadline_Tick(void)
+{
+}
+
+void Deadline_Alive(void)
+{
+}
+
+void Deadline_Failsafe(uint8_t reason)
+{
+    s_tripped = reason;
+}
+
+uint8_t Deadline_Tripped(void)
+{
+    return s_tripped;
+}
+
+uint8_t Deadline_WasWatchdogReset(void)
+{
+    return 0U;
+}
+
+const DeadlineStats_t *Deadline_GetStats(DeadlineTask task)
+{
+    return &s_stats[task];
+}
+
+void Deadline_Report(void)
+{
+}
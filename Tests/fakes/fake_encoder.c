@@ -0,0 +1,75 @@
+// fake_encoder.c — суммарные счётчики, которые двигает тест
+#include "encoder.h"
+#include "fake_board.h"
+
+static uint32_t s_totalL, s_totalR;
+static uint32_t s_lastL, s_lastR; // для Encoder_GetAndResetTicks
+
+void (*g_fakeEncPollHook)(void) = 0;
+
+void FakeEnc_Add(uint32_t left, uint32_t right)
+{
+    s_totalL += left;
+    s_totalR += right;
+}
+
+void FakeEnc_Reset(void)
+{
+    s_totalL = s_totalR = 0;
+    s_lastL = s_lastR = 0;
+}
+
+void Encoder_Init(void)
+{
+    FakeEnc_Reset();
+}
+
+void Encoder_GetAndResetTicks(uint32_t *leftTicks, uint32_t *rightTicks)
+{
+    *leftTicks = s_totalL - s_lastL;
+    *rightTicks = s_totalR - s_lastR;
+    s_lastL = s_totalL;
+    s_lastR = s_totalR;
+}
+
+uint32_t Encoder_GetTotalLeft(void)
+{
+    return s_totalL;
+}
+
+uint32_t Encoder_GetTotalRight(void)
+{
+    return s_totalR;
+}
+
+void Encoder_GetTotals(uint32_t *left, uint32_t *right)
+{
+    if (g_fakeEncPollHook)
+        g_fakeEncPollHook();
+    *left = s_totalL;
+    *right = s_totalR;
+}
+
+void Encoder_CursorInit(EncoderCursor_t *c)
+{
+    c->left = s_totalL;
+    c->right = s_totalR;
+}
+
+void Encoder_GetDelta(EncoderCursor_t *c, uint32_t *dLeft, uint32_t *dRight)
+{
+    *dLeft = s_totalL - c->left;
+    *dRight = s_totalR - c->right;
+    c->left = s_totalL;
+    c->right = s_totalR;
+}
+
+float Encoder_TicksToMM(uint32_t ticks)
+{
+    return (float)ticks * ENC_MM_PER_TICK;
+}
+
+float Encoder_TicksToMeters(uint32_t ticks)
+{
+    return (float)ticks * ENC_M_PER_TICK;
+}
@@ -0,0 +1,61 @@
+// fake_imu.c — масштабы и «пустой» датчик вместо MPU6050.c
+#include "MPU6050.h"
+#include "fake_board.h"
+
+static float s_accelScale = 1.0f / 4096.0f; // ±8g по умолчанию
+static float s_gyroScale = 1.0f / 16.4f;    // ±2000 °/с
+static const int16_t *s_accel;              // NULL — датчика нет
+uint32_t g_fakeImuReads;
+
+void FakeImu_SetAccelScale(float g_per_lsb)
+{
+    s_accelScale = g_per_lsb;
+}
+
+float MPU6050_GetAccelScale(void)
+{
+    return s_accelScale;
+}
+
+float MPU6050_GetGyroScale(void)
+{
+    return s_gyroScale;
+}
+
+void FakeImu_SetAccel(const int16_t *accel)
+{
+    s_accel = accel;
+}
+
+/* Без FakeImu_SetAccel датчика нет: чтения не удаются. Смещение
+ * гироскопа нулевое (нужно только для сборки odom_calib.c).
+ */
+uint8_t MPU6050_ReadSample(ImuSample_t *s)
+{
+    g_fakeImuReads++;
+    if (!s_accel)
+        return 0;
+    *s = (ImuSample_t){0};
+    for (uint32_t i = 0; i < 3U; i++)
+        s->raw[IMU_AX + i] = s_accel[i];
+    return 1;
+}
+
+void MPU6050_ToPhys(const ImuSample_t *in, ImuPhys_t *out, uint32_t n,
+                    const int16_t gyro_bias_lsb[3])
+{
+    (void)in;
+    (void)gyro_bias_lsb;
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = (ImuPhys_t){{0.0f, 0.0f, 0.0f}, 0.0f, {0.0f, 0.0f, 0.0f}, 0U};
+}
+
+void MPU6050_CalibrateGyro(float *bias_x, float *bias_y, float *bias_z)
+{
+    if (bias_x)
+        *bias_x = 0.0f;
+    if (bias_y)
+        *bias_y = 0.0f;
+    if (bias_z)
+        *bias_z = 0.0f;
+}
@@ -0,0 +1,82 @@
+// fake_motor.c — мотор запоминает последний PWM
+#include "motor.h"
+#include "fake_board.h"
+
+int16_t g_fakeMotorPwm[MOTOR_COUNT];
+uint8_t g_fakeMotorBrake[MOTOR_COUNT];
+uint32_t g_fakeMotorWrites;
+uint8_t g_fakeMotorEmergency;
+
+static int16_t clamp_pwm(int16_t s)
+{
+    if (s > (int16_t)MOTOR_PWM_MAX)
+        return (int16_t)MOTOR_PWM_MAX;
+    if (s < -(int16_t)MOTOR_PWM_MAX)
+        return -(int16_t)MOTOR_PWM_MAX;
+    return s;
+}
+
+void FakeMotor_Reset(void)
+{
+    for (uint32_t i = 0; i < MOTOR_COUNT; i++)
+    {
+        g_fakeMotorPwm[i] = 0;
+        g_fakeMotorBrake[i] = 0;
+    }
+    g_fakeMotorWrites = 0;
+    g_fakeMotorEmergency = 0;
+}
+
+void Motor_Init(void)
+{
+    FakeMotor_Reset();
+}
+
+void Motor_SetSpeed(MotorId id, int16_t speed)
+{
+    g_fakeMotorPwm[id] = clamp_pwm(speed);
+    g_fakeMotorBrake[id] = 0;
+    g_fakeMotorWrites++;
+}
+
+void Motor_SetSpeeds(const int16_t speeds[MOTOR_COUNT])
+{
+    for (uint32_t i = 0; i < MOTOR_COUNT; i++)
+    {
+        g_fakeMotorPwm[i] = clamp_pwm(speeds[i]);
+        g_fakeMotorBrake[i] = 0;
+    }
+    g_fakeMotorWrites++;
+}
+
+void Motor_Stop(MotorId id)
+{
+    Motor_SetSpeed(id, 0);
+}
+
+void Motor_Brake(MotorId id)
+{
+    g_fakeMotorPwm[id] = 0;
+    g_fakeMotorBrake[id] = 1;
+}
+
+void Motor_Coast(MotorId id)
+{
+    g_fakeMotorPwm[id] = 0;
+    g_fakeMotorBrake[id] = 0;
+}
+
+void Motor_StopWithMode(MotorId id, MotorStopMode mode)
+{
+    if (mode == MOTOR_STOP_BRAKE)
+        Motor_Brake(id);
+    else
+        Motor_Coast(id);
+}
+
+void Motor_EmergencyOff(void)
+{
+    for (uint32_t i = 0; i < MOTOR_COUNT; i++)
+        g_fakeMotorPwm[i] = 0;
+    g_fakeMotorEmergency = 1;
+}
@@ -0,0 +1,41 @@
+// fake_persist.c — backup SRAM в обычном массиве
+#include "persist.h"
+#include <string.h>
+
+static struct
+{
+    uint8_t valid;
+    uint16_t version;
+    uint16_t len;
+    uint8_t data[PERSIST_SLOT_DATA];
+} s_slot[PERSIST_SLOT_COUNT];
+
+void Persist_Init(void)
+{
+}
+
+uint8_t Persist_Load(PersistSlot slot, uint16_t version, void *dst, uint16_t len)
+{
+    if (slot >= PERSIST_SLOT_COUNT || !s_slot[slot].valid ||
+        s_slot[slot].version != version || s_slot[slot].len != len)
+        return 0U;
+    memcpy(dst, s_slot[slot].data, len);
+    return 1U;
+}
+
+uint8_t Persist_Save(PersistSlot slot, uint16_t version, const void *src, uint16_t len)
+{
+    if (slot >= PERSIST_SLOT_COUNT || len > PERSIST_SLOT_DATA)
+        return 0U;
+    memcpy(s_slot[slot].data, src, len);
+    s_slot[slot].version = version;
+    s_slot[slot].len = len;
+    s_slot[slot].valid = 1U;
+    return 1U;
+}
+
+void Persist_Erase(PersistSlot slot)
+{
+    if (slot < PERSIST_SLOT_COUNT)
+        s_slot[slot].valid = 0U;
+}
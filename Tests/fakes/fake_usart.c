@@ -0,0 +1,120 @@
+// fake_usart.c — вывод USART3 копится в буфере, ввод — из FakeUsart_Feed
+#include "usart.h"
+#include "fake_board.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FAKE_USART_TEXT 65536U
+
+static char s_text[FAKE_USART_TEXT];
+static uint32_t s_len;
+
+static const char *s_in;
+
+const char *FakeUsart_Text(void)
+{
+    return s_text;
+}
+
+void FakeUsart_Reset(void)
+{
+    s_len = 0;
+    s_text[0] = '\0';
+}
+
+void FakeUsart_Feed(const char *s)
+{
+    s_in = s;
+}
+
+void USART3_Init(uint32_t baudrate)
+{
+    (void)baudrate;
+    FakeUsart_Reset();
+}
+
+void USART_WriteChar(char c)
+{
+    if (s_len + 1U < FAKE_USART_TEXT)
+    {
+        s_text[s_len++] = c;
+        s_text[s_len] = '\0';
+    }
+}
+
+void USART_WriteString(const char *s)
+{
+    while (*s)
+        USART_WriteChar(*s++);
+}
+
+void USART_Print(const char *s)
+{
+    USART_WriteString(s);
+}
+
+void USART_Println(const char *s)
+{
+    USART_WriteString(s);
+    USART_WriteString("\r\n");
+}
+
+void USART_PrintInt(int32_t value)
+{
+    char b[16];
+    snprintf(b, sizeof(b), "%ld", (long)value);
+    USART_WriteString(b);
+}
+
+void USART_PrintlnInt(int32_t value)
+{
+    USART_PrintInt(value);
+    USART_WriteString("\r\n");
+}
+
+void USART_PrintHex(uint32_t value)
+{
+    char b[16];
+    snprintf(b, sizeof(b), "0x%08lX", (unsigned long)value);
+    USART_WriteString(b);
+}
+
+void USART_PrintlnHex(uint32_t value)
+{
+    USART_PrintHex(value);
+    USART_WriteString("\r\n");
+}
+
+void USART_PrintFloat(float value, uint8_t digits)
+{
+    char b[48];
+    snprintf(b, sizeof(b), "%.*f", (int)digits, (double)value);
+    USART_WriteString(b);
+}
+
+void USART_PrintlnFloat(float value, uint8_t digits)
+{
+    USART_PrintFloat(value, digits);
+    USART_WriteString("\r\n");
+}
+
+uint8_t USART_IsDataReceived(void)
+{
+    return (s_in && *s_in) ? 1U : 0U;
+}
+
+char USART_ReadChar(void)
+{
+    return (s_in && *s_in) ? *s_in++ : '\0';
+}
+
+uint8_t USART_PopEolStamp(uint32_t *t_us)
+{
+    (void)t_us;
+    return 0U;
+}
+
+uint32_t USART_RxDropped(void)
+{
+    return 0U;
+}
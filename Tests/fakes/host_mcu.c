@@ -0,0 +1,68 @@
+// host_mcu.c
+//
+// «Периферия» хостовой сборки: регистры в ОЗУ, CCM, маска прерываний,
+// миллисекундный счётчик SysTick и задержки timebase.h без ожидания.
+
+#include "stm32f4xx.h"
+#include "timebase.h"
+#include "fake_board.h"
+#include <stddef.h>
+#include <time.h>
+
+TIM_TypeDef HostTIM2;
+USART_TypeDef HostUSART3 = {.SR = USART_SR_TXE | USART_SR_TC};
+USART_TypeDef HostUSART6 = {.SR = USART_SR_TXE | USART_SR_TC};
+GPIO_TypeDef HostGPIOC;
+RCC_TypeDef HostRCC;
+DMA_TypeDef HostDMA2;
+DMA_Stream_TypeDef HostDMA2_Stream6;
+DWT_Type HostDWT;
+CoreDebug_Type HostCoreDebug;
+IWDG_TypeDef HostIWDG;
+DBGMCU_TypeDef HostDBGMCU;
+SCB_Type HostSCB;
+SysTick_Type HostSysTick;
+
+uint32_t SystemCoreClock = 168000000UL;
+
+uint8_t g_hostCcm[HOST_CCM_SIZE] __attribute__((aligned(8)));
+
+volatile uint32_t g_hostPrimask = 0;
+volatile uint32_t g_hostWfiCount = 0;
+volatile uint32_t g_hostWfiUnmasked = 0;
+void (*g_hostIrqHook)(void) = NULL;
+void (*g_hostWfiHook)(void) = NULL;
+
+volatile uint32_t g_msTicks = 0;
+
+static uint64_t s_hostUs = 0;
+
+void Host_AdvanceUs(uint32_t us)
+{
+    s_hostUs += us;
+    HostTIM2.CNT = (uint32_t)s_hostUs;
+    g_msTicks = (uint32_t)(s_hostUs / 1000U);
+    HostDWT.CYCCNT += us * (SystemCoreClock / 1000000UL);
+}
+
+uint64_t Host_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t Host_Cycles(void)
+{
+    return (uint32_t)(Host_NowNs() * (SystemCoreClock / 1000000UL) / 1000U);
+}
+
+void Time_DelayUs(uint32_t us)
+{
+    Host_AdvanceUs(us);
+}
+
+void Time_DelayMs(uint32_t ms)
+{
+    Host_AdvanceUs(ms * 1000U);
+}
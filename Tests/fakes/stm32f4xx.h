@@ -0,0 +1,281 @@
+// stm32f4xx.h (хостовая подмена)
+//
+// Заголовок устройства для сборки модулей Core/ на ПК (Tests/).
+// Периферия — обычные структуры в ОЗУ (host_mcu.c): тест сам двигает
+// TIM2->CNT, DWT->CYCCNT, читает USART3->DR. Определены только те
+// регистры, биты и intrinsics, которые нужны собираемым на хосте модулям.
+//
+// Маска прерываний — переменная g_hostPrimask: __disable_irq / __WFI
+// ничего не делают, кроме учёта и крючков теста (тест проверяет, что
+// WFI вызван с запрещёнными прерываниями, и «подбрасывает» прерывание
+// в окно перед маскированием).
+
+#ifndef HOST_STM32F4XX_H
+#define HOST_STM32F4XX_H
+
+#include <stdint.h>
+
+#define __IO volatile
+
+typedef struct
+{
+    __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR,
+        RCR, CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR;
+} TIM_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+} USART_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CTRL, CYCCNT, CPICNT, EXCCNT, SLEEPCNT, LSUCNT, FOLDCNT, PCSR;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+    __IO uint32_t KR, PR, RLR, SR;
+} IWDG_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CPUID, ICSR, VTOR, AIRCR, SCR, CCR;
+} SCB_Type;
+
+typedef struct
+{
+    __IO uint32_t CTRL, LOAD, VAL, CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    __IO uint32_t IDCODE, CR, APB1FZ, APB2FZ;
+} DBGMCU_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR, PLLCFGR, CFGR, CIR, AHB1ENR, AHB2ENR, APB1ENR, APB2ENR, BDCR, CSR;
+} RCC_TypeDef;
+
+/* Адреса памяти DMA — uintptr_t: на ПК указатель шире 32 бит */
+typedef struct
+{
+    __IO uint32_t CR, NDTR;
+    __IO uintptr_t PAR, M0AR, M1AR;
+    __IO uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t LISR, HISR, LIFCR, HIFCR;
+} DMA_TypeDef;
+
+typedef enum
+{
+    TIM2_IRQn = 28,
+    USART3_IRQn = 39,
+    DMA2_Stream6_IRQn = 69
+} IRQn_Type;
+
+extern TIM_TypeDef HostTIM2;
+extern USART_TypeDef HostUSART3;
+extern USART_TypeDef HostUSART6;
+extern GPIO_TypeDef HostGPIOC;
+extern RCC_TypeDef HostRCC;
+extern DMA_TypeDef HostDMA2;
+extern DMA_Stream_TypeDef HostDMA2_Stream6;
+extern DWT_Type HostDWT;
+extern CoreDebug_Type HostCoreDebug;
+extern IWDG_TypeDef HostIWDG;
+extern DBGMCU_TypeDef HostDBGMCU;
+extern SCB_Type HostSCB;
+extern SysTick_Type HostSysTick;
+
+#define TIM2 (&HostTIM2)
+#define USART3 (&HostUSART3)
+#define USART6 (&HostUSART6)
+#define GPIOC (&HostGPIOC)
+#define RCC (&HostRCC)
+#define DMA2 (&HostDMA2)
+#define DMA2_Stream6 (&HostDMA2_Stream6)
+#define DWT (&HostDWT)
+#define CoreDebug (&HostCoreDebug)
+#define IWDG (&HostIWDG)
+#define DBGMCU (&HostDBGMCU)
+#define SCB (&HostSCB)
+#define SysTick (&HostSysTick)
+
+#define USART_CR1_UE (1UL << 13)
+#define USART_CR1_TE (1UL << 3)
+#define USART_CR3_DMAT (1UL << 7)
+#define USART_SR_TXE (1UL << 7)
+#define USART_SR_TC (1UL << 6)
+#define USART_SR_RXNE (1UL << 5)
+#define RCC_CSR_RMVF (1UL << 24)
+#define RCC_CSR_IWDGRSTF (1UL << 29)
+#define IWDG_PR_PR_1 (1UL << 1)
+#define IWDG_SR_PVU (1UL << 0)
+#define IWDG_SR_RVU (1UL << 1)
+#define DBGMCU_APB1_FZ_DBG_IWDG_STOP (1UL << 12)
+#define RCC_AHB1ENR_GPIOCEN (1UL << 2)
+#define RCC_AHB1ENR_CCMDATARAMEN (1UL << 20)
+#define RCC_AHB1ENR_DMA2EN (1UL << 22)
+#define RCC_APB2ENR_USART6EN (1UL << 5)
+
+#define GPIO_MODER_MODER6_Pos 12U
+#define GPIO_MODER_MODER6_Msk (3UL << GPIO_MODER_MODER6_Pos)
+#define GPIO_OTYPER_OT6_Msk (1UL << 6)
+#define GPIO_OSPEEDR_OSPEED6_Msk (3UL << 12)
+
+#define DMA_SxCR_EN (1UL << 0)
+#define DMA_SxCR_TEIE (1UL << 2)
+#define DMA_SxCR_TCIE (1UL << 4)
+#define DMA_SxCR_DIR_Pos 6U
+#define DMA_SxCR_MINC (1UL << 10)
+#define DMA_SxCR_CHSEL_Pos 25U
+#define DMA_HISR_TEIF6 (1UL << 19)
+#define DMA_HISR_TCIF6 (1UL << 21)
+#define DMA_HIFCR_CFEIF6 (1UL << 16)
+#define DMA_HIFCR_CDMEIF6 (1UL << 18)
+#define DMA_HIFCR_CTEIF6 (1UL << 19)
+#define DMA_HIFCR_CHTIF6 (1UL << 20)
+#define DMA_HIFCR_CTCIF6 (1UL << 21)
+
+#define TIM_DIER_CC1IE (1UL << 1)
+#define TIM_SR_CC1IF (1UL << 1)
+#define SCB_SCR_SLEEPDEEP_Msk (1UL << 2)
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0)
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+#define SET_BIT(R, B) ((R) |= (B))
+#define CLEAR_BIT(R, B) ((R) &= ~(B))
+#define READ_BIT(R, B) ((R) & (B))
+#define WRITE_REG(R, V) ((R) = (V))
+#define READ_REG(R) ((R))
+
+extern uint32_t SystemCoreClock;
+
+/* Живой счётчик «тактов» для бенчмарков: время ПК в тактах SystemCoreClock
+ * (DWT->CYCCNT двигает только Host_AdvanceUs)
+ */
+uint32_t Host_Cycles(void);
+
+/* CCM RAM — массив на хосте (там лежит буфер трассировки) */
+#define HOST_CCM_SIZE 0x10000UL
+extern uint8_t g_hostCcm[HOST_CCM_SIZE];
+#define CCMDATARAM_BASE ((uintptr_t)&g_hostCcm[0])
+#define CCMDATARAM_END ((uintptr_t)&g_hostCcm[HOST_CCM_SIZE - 1UL])
+
+/* ---------------- NVIC: на ПК прерывания вызывает сам тест ---------------- */
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t prio)
+{
+    (void)irq;
+    (void)prio;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+/* ---------------- Intrinsics ---------------- */
+
+extern volatile uint32_t g_hostPrimask;
+extern volatile uint32_t g_hostWfiCount;
+extern volatile uint32_t g_hostWfiUnmasked; // WFI при разрешённых прерываниях
+
+/* Крючки теста (NULL — нет):
+ *   g_hostIrqHook — «прерывание», пришедшее в последний момент перед
+ *                   маскированием (__disable_irq при PRIMASK = 0);
+ *   g_hostWfiHook — само ожидание в WFI (тест двигает время).
+ */
+extern void (*g_hostIrqHook)(void);
+extern void (*g_hostWfiHook)(void);
+
+static inline void __disable_irq(void)
+{
+    if (!g_hostPrimask && g_hostIrqHook)
+        g_hostIrqHook();
+    g_hostPrimask = 1U;
+}
+
+static inline void __enable_irq(void)
+{
+    g_hostPrimask = 0U;
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return g_hostPrimask;
+}
+
+static inline void __set_PRIMASK(uint32_t m)
+{
+    g_hostPrimask = m;
+}
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __ISB(void)
+{
+}
+
+static inline void __NOP(void)
+{
+}
+
+static inline void __WFI(void)
+{
+    g_hostWfiCount++;
+    if (!g_hostPrimask)
+        g_hostWfiUnmasked++;
+    if (g_hostWfiHook)
+        g_hostWfiHook();
+}
+
+/* Эксклюзивный доступ: на хосте один поток пишет трассу — сбоев нет */
+static inline uint32_t __LDREXW(volatile uint32_t *p)
+{
+    return *p;
+}
+
+static inline uint32_t __STREXW(uint32_t v, volatile uint32_t *p)
+{
+    *p = v;
+    return 0U;
+}
+
+#endif // HOST_STM32F4XX_H
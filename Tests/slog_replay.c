@@ -0,0 +1,210 @@
+// slog_replay.c
+//
+// Воспроизведение лога sensor_log на ПК: кадры SLOG_CMD и SLOG_CTRL
+// подаются в неизменённые SpeedControl_SetTarget / SpeedControl_Stop /
+// SpeedControl_Update (speed_control.c собран как есть, драйверы —
+// подмены Tests/fakes), PWM после каждого шага сверяется с SLOG_PWM
+// из лога бит в бит.
+//
+// Кадры SLOG_IMU проверяются (контрольная сумма, seq) и считаются, но не
+// воспроизводятся: speed_control.c отсчёты IMU не читает, а курс
+// (robot_motion.c) в воспроизведение не входит.
+//
+// Файл отображается в память (mmap, только чтение) и декодируется
+// одним проходом — длина лога ОЗУ не ограничена, ядро подкачивает
+// страницы по мере чтения.
+//
+//   build/slog_replay capture.bin [-v]
+//
+// Код возврата 0 — все PWM совпали; 1 — расхождение, потерянные или
+// битые кадры, пропущенный PWM (заклинивание) или лог без шагов регулятора.
+
+#include "fake_board.h"
+#include "sensor_log.h"
+#include "speed_control.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t bad;     // контрольная сумма / обрезанный кадр
+    uint32_t lost;    // дыры в seq
+    uint32_t ctrl;
+    uint32_t cmd;
+    uint32_t pwm;
+    uint32_t imu;     // проверены, не воспроизводятся
+    uint32_t mismatch;
+    uint32_t missing; // SLOG_CTRL без SLOG_PWM
+    uint32_t orphan;  // SLOG_PWM без шага регулятора
+} ReplayStats_t;
+
+static uint8_t s_verbose;
+
+static void replay_frame(ReplayStats_t *st, const SensorLogHdr_t *h, const uint8_t *p,
+                         uint8_t *pending, SlogPwm_t *expect)
+{
+    switch (h->type)
+    {
+    case SLOG_CMD:
+    {
+        SlogCmd_t c;
+        if (h->len != sizeof(c))
+            break;
+        memcpy(&c, p, sizeof(c));
+        st->cmd++;
+        if (c.dirL == 0 && c.dirR == 0)
+            SpeedControl_Stop();
+        else
+            SpeedControl_SetTarget(c.left_rps, c.right_rps, c.dirL, c.dirR);
+        break;
+    }
+    case SLOG_CTRL:
+    {
+        SlogCtrl_t c;
+        if (h->len != sizeof(c))
+            break;
+        memcpy(&c, p, sizeof(c));
+        st->ctrl++;
+        if (*pending)
+            st->missing++;
+        FakeEnc_Add(c.ticksL, c.ticksR);
+        SpeedControl_Update(c.dt_sec);
+        expect->pwmL = g_fakeMotorPwm[MOTOR_A];
+        expect->pwmR = g_fakeMotorPwm[MOTOR_B];
+        *pending = 1;
+        break;
+    }
+    case SLOG_PWM:
+    {
+        SlogPwm_t w;
+        if (h->len != sizeof(w))
+            break;
+        memcpy(&w, p, sizeof(w));
+        st->pwm++;
+        if (!*pending)
+        {
+            st->orphan++;
+            break;
+        }
+        *pending = 0;
+        if (w.pwmL != expect->pwmL || w.pwmR != expect->pwmR)
+        {
+            if (st->mismatch++ < 10U || s_verbose)
+                printf("seq %u: log pwm %d/%d, replay %d/%d\n", (unsigned)h->seq, w.pwmL,
+                       w.pwmR, expect->pwmL, expect->pwmR);
+        }
+        else if (s_verbose)
+            printf("seq %u: pwm %d/%d ok\n", (unsigned)h->seq, w.pwmL, w.pwmR);
+        break;
+    }
+    case SLOG_IMU:
+        st->imu++;
+        break;
+    default:
+        break;
+    }
+}
+
+static void replay(const uint8_t *buf, size_t n, ReplayStats_t *st)
+{
+    uint8_t pending = 0;
+    SlogPwm_t expect = {0, 0};
+    uint8_t have_seq = 0;
+    uint16_t next_seq = 0;
+    size_t pos = 0;
+
+    SpeedControl_Init();
+
+    while (pos + 2U + sizeof(SensorLogHdr_t) + 1U <= n)
+    {
+        if (buf[pos] != SLOG_SYNC0 || buf[pos + 1U] != SLOG_SYNC1)
+        {
+            pos++;
+            continue;
+        }
+
+        SensorLogHdr_t h;
+        memcpy(&h, &buf[pos + 2U], sizeof(h));
+        size_t end = pos + 2U + sizeof(h) + h.len + 1U;
+        if (end > n)
+            break;
+
+        uint8_t sum = 0;
+        for (size_t i = pos + 2U; i < end - 1U; i++)
+            sum = (uint8_t)(sum + buf[i]);
+        if (sum != buf[end - 1U])
+        {
+            st->bad++;
+            pos++; // ищем следующее синхрослово
+            continue;
+        }
+
+        if (have_seq && h.seq != next_seq)
+            st->lost += (uint16_t)(h.seq - next_seq);
+        next_seq = (uint16_t)(h.seq + 1U);
+        have_seq = 1;
+
+        st->frames++;
+        replay_frame(st, &h, &buf[pos + 2U + sizeof(h)], &pending, &expect);
+        pos = end;
+    }
+
+    if (pos < n)
+        st->bad++; // хвост без конца кадра
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s capture.bin [-v]\n", argv[0]);
+        return 2;
+    }
+    s_verbose = (argc > 2 && strcmp(argv[2], "-v") == 0);
+
+    int fd = open(argv[1], O_RDONLY);
+    if (fd < 0)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0)
+    {
+        perror(argv[1]);
+        close(fd);
+        return 2;
+    }
+
+    ReplayStats_t st = {0};
+    if (sb.st_size > 0)
+    {
+        size_t len = (size_t)sb.st_size;
+        const uint8_t *buf = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buf == MAP_FAILED)
+        {
+            perror(argv[1]);
+            close(fd);
+            return 2;
+        }
+        (void)madvise((void *)buf, len, MADV_SEQUENTIAL);
+        replay(buf, len, &st);
+        munmap((void *)buf, len);
+    }
+    close(fd);
+
+    uint8_t ok = st.ctrl > 0U && st.mismatch == 0U && st.missing == 0U && st.orphan == 0U &&
+                 st.lost == 0U && st.bad == 0U;
+
+    printf("slog_replay: frames=%u ctrl=%u cmd=%u pwm=%u imu=%u mismatch=%u missing=%u "
+           "orphan=%u lost=%u bad=%u -> %s\n",
+           (unsigned)st.frames, (unsigned)st.ctrl, (unsigned)st.cmd, (unsigned)st.pwm,
+           (unsigned)st.imu, (unsigned)st.mismatch, (unsigned)st.missing, (unsigned)st.orphan,
+           (unsigned)st.lost, (unsigned)st.bad, ok ? "bit-exact" : "DIVERGED");
+    return ok ? 0 : 1;
+}
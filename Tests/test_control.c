@@ -0,0 +1,408 @@
+// test_control.c
+//
+// ПИД, регулятор курса, регулятор скорости колёс и порог удара
+// детектора заклинивания на ПК.
+//
+// SpeedControl_Update работает как на плате: тики — из fake_encoder.c,
+// PWM уходит в fake_motor.c. Между ними — модель колеса (wheel_plant.h)
+// с параметрами, нарочно отличающимися от WHEEL_MODEL_*: регулятор
+// должен дотягивать разброс моторов.
+//
+// Трассы сценариев сверяются с Tests/golden/*.csv; в конце — отчёт
+// ns/вызов для горячих функций (время ПК, не Cortex-M4: это сравнение
+// версий между собой, такты на плате — bench.c).
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "pid.h"
+#include "heading_control.h"
+#include "speed_control.h"
+#include "wheel_estimator.h"
+#include "encoder.h"
+#include "deadline.h"
+#include "odometry.h"
+#include "stall_detect.h"
+#include "wheel_plant.h"
+
+#define CTRL_DT 0.01f
+/* ---------------- ПИД ---------------- */
+
+static void test_pid_basic(void)
+{
+    PID_t p;
+
+    PID_Init(&p, 2.0f, 0.0f, 0.0f, -10.0f, 10.0f);
+    CHECK_NEAR(PID_Update(&p, 1.0f, 0.0f, 0.1f), 2.0f, 1e-6);
+
+    PID_Init(&p, 0.0f, 1.0f, 0.0f, -10.0f, 10.0f);
+    for (int i = 0; i < 5; i++)
+        (void)PID_Update(&p, 1.0f, 0.0f, 0.1f);
+    CHECK_NEAR(p.integrator, 0.5f, 1e-6);
+
+    PID_Init(&p, 0.0f, 0.0f, 1.0f, -10.0f, 10.0f);
+    (void)PID_Update(&p, 0.0f, 0.0f, 0.1f);
+    CHECK_NEAR(PID_Update(&p, 1.0f, 0.0f, 0.1f), 10.0f, 1e-5); // de/dt = 10
+
+    PID_Reset(&p);
+    CHECK(p.integrator == 0.0f && p.prevError == 0.0f);
+    CHECK(p.Kd == 1.0f && p.outMax == 10.0f);
+}
+
+static void test_pid_antiwindup(void)
+{
+    PID_t p;
+    PID_Init(&p, 1.0f, 10.0f, 0.0f, -1.0f, 1.0f);
+
+    // долгая ошибка при насыщении не копится в интеграторе
+    float out = 0.0f;
+    for (int i = 0; i < 200; i++)
+        out = PID_Update(&p, 5.0f, 0.0f, 0.01f);
+    CHECK(out == 1.0f);
+    CHECK(p.integrator < 0.11f);
+
+    // ошибка исчезла — выход сразу уходит с предела, без «отката» интегратора
+    out = PID_Update(&p, 0.0f, 0.0f, 0.01f);
+    CHECK(out < 1.0f);
+
+    // то же снизу
+    PID_Reset(&p);
+    for (int i = 0; i < 200; i++)
+        out = PID_Update(&p, -5.0f, 0.0f, 0.01f);
+    CHECK(out == -1.0f);
+    CHECK(p.integrator > -0.11f);
+}
+
+// Ступеньки уставки на модели первого порядка (y' = (u − y) / 0.1)
+static void test_pid_golden(void)
+{
+    PID_t p;
+    PID_Init(&p, 8.0f, 20.0f, 0.0f, -99.0f, 99.0f);
+
+    GoldenTable_t t;
+    Golden_Begin(&t, "pid_step", "t_ms,y,u,integrator", 4);
+
+    float y = 0.0f;
+    for (int i = 0; i < 200; i++)
+    {
+        float sp = (i < 100) ? 2.0f : 0.5f;
+        float u = PID_Update(&p, sp, y, CTRL_DT);
+        y += (u - y) * (CTRL_DT / 0.1f);
+        if (i == 99)
+            CHECK_NEAR(y, 2.0f, 0.05f);
+        Golden_Row(&t, (double[]){i * 10.0, y, u, p.integrator});
+    }
+    CHECK_NEAR(y, 0.5f, 0.02f);
+
+    Golden_Finish(&t, 1e-5);
+}
+
+/* ---------------- Курс ---------------- */
+
+static void test_heading(void)
+{
+    float l, r;
+
+    Heading_SetTarget(90.0f);
+    Heading_Compute(0.0f, 1.0f, &l, &r);
+    CHECK_NEAR(l, 1.0f - 0.05f * 90.0f, 1e-5); // цель слева — правое быстрее
+    CHECK_NEAR(r, 1.0f + 0.05f * 90.0f, 1e-5);
+
+    // ошибка через ±180: 170 → −170 — это 20° вправо, не 340° влево
+    Heading_SetTarget(170.0f);
+    Heading_Compute(-170.0f, 1.0f, &l, &r);
+    CHECK_NEAR(r - l, 2.0f * 0.05f * -20.0f, 1e-4);
+
+    Heading_SetTarget(270.0f); // = −90
+    Heading_Compute(-90.0f, 0.5f, &l, &r);
+    CHECK_NEAR(l, 0.5f, 1e-5);
+    CHECK_NEAR(r, 0.5f, 1e-5);
+
+    Heading_Compute(0.0f, 0.0f, NULL, NULL); // NULL допустим
+
+    GoldenTable_t t;
+    Golden_Begin(&t, "heading_sweep", "yaw_deg,outL,outR", 3);
+    Heading_SetTarget(45.0f);
+    for (int yaw = -180; yaw <= 180; yaw += 5)
+    {
+        Heading_Compute((float)yaw, 1.2f, &l, &r);
+        Golden_Row(&t, (double[]){yaw, l, r});
+    }
+    Golden_Finish(&t, 1e-5);
+}
+
+/* ---------------- Регулятор скорости ---------------- */
+
+static WheelPlant_t s_wl, s_wr;
+
+static void speed_reset(void)
+{
+    FakeMotor_Reset();
+    FakeEnc_Reset();
+    Deadline_Init();
+    s_wl = (WheelPlant_t){.K = 0.058, .u0 = 47.0, .tau = 0.09};
+    s_wr = (WheelPlant_t){.K = 0.064, .u0 = 53.0, .tau = 0.07};
+    SpeedControl_Init();
+}
+
+// Один период: модель едет под текущим PWM, тики в энкодер, шаг регулятора
+static void speed_tick(void)
+{
+    WheelPlant_Step(&s_wl, g_fakeMotorPwm[MOTOR_A], CTRL_DT);
+    WheelPlant_Step(&s_wr, g_fakeMotorPwm[MOTOR_B], CTRL_DT);
+    FakeEnc_Add(WheelPlant_Ticks(&s_wl), WheelPlant_Ticks(&s_wr));
+    Host_AdvanceUs(10000U);
+    SpeedControl_Update(CTRL_DT);
+}
+
+static void test_speed_saturation(void)
+{
+    speed_reset();
+    CHECK_NEAR(SpeedControl_SetWheelRps(1.0f, -2.0f), 1.0f, 0.0);
+    CHECK_NEAR(SpeedControl_SetWheelRps(2.0f * SPEED_WHEEL_MAX_RPS, SPEED_WHEEL_MAX_RPS),
+               0.5f, 1e-6);
+    CHECK_NEAR(SpeedControl_SetWheelRps(-4.0f * SPEED_WHEEL_MAX_RPS, 0.0f), 0.25f, 1e-6);
+
+    // twist без калибровки (Odom_Init не вызывался) — номинальный масштаб
+    float rev = ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT * (float)ENC_PULSES_PER_REV;
+    float k = SpeedControl_SetTwist(10.0f * rev * SPEED_WHEEL_MAX_RPS, 0.0f);
+    CHECK_NEAR(k, 0.1f, 1e-5);
+}
+
+/* ---------------- Оценщик скорости ---------------- */
+
+/* Модель = оценщик (WHEEL_MODEL_*), PWM-программа, RMS и максимум
+ * ошибки оценки против настоящей скорости после первых settle шагов
+ */
+static void est_run(float dt, uint32_t steps, uint32_t settle, const int16_t *pwm_at,
+                    uint32_t phases, double *rms, double *maxerr, uint8_t *sign_flip)
+{
+    WheelPlant_t w = {.K = WHEEL_MODEL_K, .u0 = WHEEL_MODEL_U0, .tau = WHEEL_MODEL_TAU};
+    WheelEst_t e;
+    WheelEst_Init(&e, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+
+    double sum = 0.0;
+    uint32_t n = 0;
+    *maxerr = 0.0;
+    *sign_flip = 0;
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        int16_t pwm = pwm_at[(i * phases) / steps];
+        WheelPlant_Step(&w, pwm, dt);
+        WheelEst_Update(&e, WheelPlant_Ticks(&w), pwm, dt);
+
+        // при постоянном PWM одного знака оценка знак не меняет
+        if (pwm > 0 && WheelEst_Speed(&e) < -0.05f)
+            *sign_flip = 1;
+
+        if ((i * phases) % steps >= settle * phases)
+        {
+            double err = (double)WheelEst_Speed(&e) - w.omega;
+            sum += err * err;
+            n++;
+            if (fabs(err) > *maxerr)
+                *maxerr = fabs(err);
+        }
+    }
+    *rms = (n > 0U) ? sqrt(sum / n) : 0.0;
+}
+
+static void test_wheel_estimator(void)
+{
+    double rms, mx;
+    uint8_t flip;
+
+    // штатный период: разгон, реверс знаковым PWM, выбег
+    const int16_t prog[4] = {80, 95, -80, 0};
+    est_run(CTRL_DT, 800, 30, prog, 4, &rms, &mx, &flip);
+    printf("west dt=10ms: rms %.3f max %.3f rps\n", rms, mx);
+    CHECK(rms < 0.15);
+
+    // dt больше τ (пропуски тактов, медленный опрос): Эйлер с a = 1 − dt/τ
+    // здесь раскачивается, точная дискретизация обязана сойтись
+    const float dts[3] = {WHEEL_MODEL_TAU, 2.5f * WHEEL_MODEL_TAU, 5.0f * WHEEL_MODEL_TAU};
+    const int16_t hold[1] = {90};
+    for (uint32_t k = 0; k < 3U; k++)
+    {
+        est_run(dts[k], 60, 10, hold, 1, &rms, &mx, &flip);
+        printf("west dt=%.0fms: rms %.3f max %.3f rps\n", dts[k] * 1000.0f, rms, mx);
+        CHECK(!flip);
+        CHECK(mx < 0.3);
+    }
+
+    // dt ≤ 0 — шаг пропускается, состояние не портится
+    WheelEst_t e;
+    WheelEst_Init(&e, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+    WheelEst_Update(&e, 5U, 80, 0.0f);
+    CHECK(WheelEst_Speed(&e) == 0.0f);
+}
+
+/* ---------------- Удар (stall_detect.c) ---------------- */
+
+/* Скачок по X на dg (g) от покоя в LSB масштаба ka; 1 — сработал удар */
+static uint8_t impact_after(float ka, float dg)
+{
+    int16_t rest[3] = {0, 0, (int16_t)(1.0f / ka)};
+    int16_t hit[3] = {(int16_t)(dg / ka), 0, rest[2]};
+
+    Stall_Arm(1);
+    Stall_FeedAccel(rest);
+    return (Stall_FeedAccel(hit) & STALL_IMPACT) != 0U;
+}
+
+static void test_stall_impact(void)
+{
+    const float k8g = 1.0f / 4096.0f, k2g = 1.0f / 16384.0f;
+
+    FakeImu_SetAccelScale(k8g);
+    Stall_Init();
+    CHECK(!impact_after(k8g, 0.5f));
+    CHECK(impact_after(k8g, 0.7f));
+
+    // диапазон сменили без Stall_Init: 0.5g при ±2g — 8192 LSB,
+    // по старому порогу (0.6g при ±8g ≈ 2458 LSB) это уже «удар»
+    FakeImu_SetAccelScale(k2g);
+    CHECK(!impact_after(k2g, 0.5f));
+    CHECK(impact_after(k2g, 0.7f));
+
+    // смена на ходу: те же 1.5g по X до и после — 6144 и 24576 LSB;
+    // отсчёт до смены с отсчётом после не сравнивается
+    FakeImu_SetAccelScale(k8g);
+    Stall_Arm(1);
+    int16_t a8[3] = {6144, 0, 4096};
+    Stall_FeedAccel(a8);
+    FakeImu_SetAccelScale(k2g);
+    int16_t a2[3] = {24576, 0, 16384};
+    CHECK((Stall_FeedAccel(a2) & STALL_IMPACT) == 0U);
+    CHECK((Stall_FeedAccel(a2) & STALL_IMPACT) == 0U);
+
+    Stall_Arm(0);
+    FakeImu_SetAccelScale(k8g);
+}
+
+static void test_speed_golden(void)
+{
+    speed_reset();
+
+    GoldenTable_t t;
+    Golden_Begin(&t, "speed_step", "t_ms,ticksL,ticksR,pwmL,pwmR,measL,measR", 7);
+
+    int16_t pwm_peak = 0;
+    uint32_t steps = 0;
+    float mL = 0.0f, mR = 0.0f;
+
+    for (uint32_t i = 0; i < 450; i++)
+    {
+        if (i == 0)
+            (void)SpeedControl_SetWheelRps(1.5f, 1.5f);
+        if (i == 150)
+        {
+            SpeedControl_GetMeasured(&mL, &mR);
+            CHECK_NEAR(mL, 1.5f, 0.15f);
+            CHECK_NEAR(mR, 1.5f, 0.15f);
+            CHECK_NEAR(s_wl.omega, 1.5, 0.15);
+            CHECK_NEAR(s_wr.omega, 1.5, 0.15);
+            (void)SpeedControl_SetTwist(200.0f, 1.0f);
+        }
+        if (i == 300)
+        {
+            // дуга: правое быстрее левого, отношение — как у уставки
+            CHECK(s_wr.omega > s_wl.omega);
+            (void)SpeedControl_SetWheelRps(-1.0f, -1.0f);
+        }
+        if (i == 400)
+        {
+            // реверс через ноль знаковым PWM
+            CHECK_NEAR(s_wl.omega, -1.0, 0.15);
+            CHECK_NEAR(s_wr.omega, -1.0, 0.15);
+            SpeedControl_Stop();
+            CHECK(g_fakeMotorPwm[MOTOR_A] == 0 && g_fakeMotorPwm[MOTOR_B] == 0);
+        }
+
+        uint32_t l0 = (uint32_t)s_wl.emitted, r0 = (uint32_t)s_wr.emitted;
+        speed_tick();
+        steps++;
+
+        SpeedControl_GetMeasured(&mL, &mR);
+        int16_t pl = g_fakeMotorPwm[MOTOR_A], pr = g_fakeMotorPwm[MOTOR_B];
+        if (pl > pwm_peak || -pl > pwm_peak)
+            pwm_peak = (pl >= 0) ? pl : (int16_t)-pl;
+        if (pr > pwm_peak || -pr > pwm_peak)
+            pwm_peak = (pr >= 0) ? pr : (int16_t)-pr;
+
+        Golden_Row(&t, (double[]){(i + 1U) * 10.0, (uint32_t)s_wl.emitted - l0,
+                                  (uint32_t)s_wr.emitted - r0, pl, pr, mL, mR});
+    }
+
+    CHECK(pwm_peak <= (int16_t)MOTOR_PWM_MAX);
+    CHECK(Deadline_GetStats(DL_TASK_CONTROL)->checkins == steps);
+
+    // после Stop цель ноль — колёса остановились
+    CHECK_NEAR(s_wl.omega, 0.0, 0.1);
+    CHECK_NEAR(s_wr.omega, 0.0, 0.1);
+
+    Golden_Finish(&t, 1e-4);
+}
+
+/* ---------------- Отчёт ns/вызов ---------------- */
+
+static volatile float s_sink;
+
+static void report_ns(void)
+{
+    const uint32_t N = 1000000U;
+    uint64_t t0;
+
+    printf("ns/update:\n");
+
+    PID_t p;
+    PID_Init(&p, 8.0f, 1.0f, 0.0f, -99.0f, 99.0f);
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < N; i++)
+        s_sink = PID_Update(&p, 1.5f, (float)(i & 63U) * 0.05f, CTRL_DT);
+    Test_ReportNs("PID_Update", Host_NowNs() - t0, N);
+
+    float l, r;
+    Heading_SetTarget(30.0f);
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < N; i++)
+    {
+        Heading_Compute((float)(i % 360U) - 180.0f, 1.0f, &l, &r);
+        s_sink = l + r;
+    }
+    Test_ReportNs("Heading_Compute", Host_NowNs() - t0, N);
+
+    WheelEst_t e;
+    WheelEst_Init(&e, WHEEL_MODEL_K, WHEEL_MODEL_U0, WHEEL_MODEL_TAU,
+                  (float)ENC_PULSES_PER_REV);
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < N; i++)
+        WheelEst_Update(&e, i & 1U, 80, CTRL_DT);
+    s_sink = WheelEst_Speed(&e);
+    Test_ReportNs("WheelEst_Update", Host_NowNs() - t0, N);
+
+    speed_reset();
+    (void)SpeedControl_SetWheelRps(1.5f, 1.2f);
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < N; i++)
+    {
+        FakeEnc_Add(i & 1U, (i >> 1) & 1U);
+        SpeedControl_Update(CTRL_DT);
+    }
+    Test_ReportNs("SpeedControl_Update", Host_NowNs() - t0, N);
+}
+
+int main(void)
+{
+    test_pid_basic();
+    test_pid_antiwindup();
+    test_pid_golden();
+    test_heading();
+    test_speed_saturation();
+    test_wheel_estimator();
+    test_stall_impact();
+    test_speed_golden();
+    report_ns();
+    return Test_Summary("test_control");
+}
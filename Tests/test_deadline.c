@@ -0,0 +1,104 @@
+// test_deadline.c
+//
+// Монитор дедлайнов (deadline.c) на ПК: когда SysTick вправе сбросить IWDG.
+// Сброс виден по записи ключа 0xAAAA в IWDG->KR; SysTick — прямой вызов
+// Deadline_Tick() после сдвига g_msTicks.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "deadline.h"
+#include "stm32f4xx.h"
+
+#define KEY_RELOAD 0xAAAAU
+
+// n миллисекунд SysTick; сколько раз за них сброшен IWDG
+static uint32_t run_ms(uint32_t n, uint8_t alive_each_ms)
+{
+    uint32_t reloads = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (alive_each_ms)
+            Deadline_Alive();
+        Host_AdvanceUs(1000U);
+        IWDG->KR = 0;
+        Deadline_Tick();
+        if (IWDG->KR == KEY_RELOAD)
+            reloads++;
+    }
+    return reloads;
+}
+
+// Без задач: только отметки main держат IWDG
+static void test_no_tasks(void)
+{
+    Deadline_Init();
+    CHECK(IWDG->KR == KEY_RELOAD);
+
+    // первый интервал засчитан самой инициализацией — один сброс, дальше тишина
+    CHECK(run_ms(1, 0) == 1U);
+    CHECK(run_ms(DEADLINE_IWDG_MS + 50U, 0) == 0U);
+
+    // main снова отмечается — IWDG сбрасывается
+    CHECK(run_ms(10, 1) == 10U);
+
+    // одна отметка — один сброс, не больше
+    Deadline_Alive();
+    CHECK(run_ms(5, 0) == 1U);
+}
+
+// Задача включена и здорова: отметки задачи достаточно
+static void test_task_keeps_iwdg(void)
+{
+    Deadline_Init();
+    (void)run_ms(1, 0);
+
+    Deadline_Enable(DL_TASK_CONTROL, 20U);
+    uint32_t reloads = 0;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        if (i % 10U == 0U)
+            Deadline_CheckIn(DL_TASK_CONTROL);
+        reloads += run_ms(1, 0);
+    }
+    CHECK(reloads == 100U);
+    CHECK(Deadline_Tripped() == 0U);
+
+    // задача выключена — снова нужен Deadline_Alive
+    Deadline_Disable(DL_TASK_CONTROL);
+    CHECK(run_ms(20, 0) == 0U);
+    CHECK(run_ms(3, 1) == 3U);
+}
+
+// Промах: моторы выключены, IWDG больше не сбрасывается даже с отметками main
+static void test_miss(void)
+{
+    FakeMotor_Reset();
+    Deadline_Init();
+    Deadline_Enable(DL_TASK_MOTION, 30U);
+    Deadline_CheckIn(DL_TASK_MOTION);
+
+    CHECK(run_ms(30, 1) == 30U);
+    CHECK(run_ms(1, 1) == 0U);
+    CHECK(Deadline_Tripped() == DL_TASK_MOTION + 1U);
+    CHECK(g_fakeMotorEmergency == 1U);
+    CHECK(Deadline_GetStats(DL_TASK_MOTION)->misses == 1U);
+    CHECK(run_ms(50, 1) == 0U);
+}
+
+// Failsafe (например, нет IMU) без задач: цикл с WFI не держит IWDG
+static void test_failsafe(void)
+{
+    Deadline_Init();
+    Deadline_Failsafe(DL_REASON_IMU_ABSENT);
+    CHECK(Deadline_Tripped() == DL_REASON_IMU_ABSENT);
+    CHECK(run_ms(DEADLINE_IWDG_MS, 1) == 0U);
+}
+
+int main(void)
+{
+    test_no_tasks();
+    test_task_keeps_iwdg();
+    test_miss();
+    test_failsafe();
+    return Test_Summary("test_deadline");
+}
@@ -0,0 +1,203 @@
+// test_fast_math.c
+//
+// fast_math.h на ПК: точность против libm (в double) и скорость против
+// sinf / cosf / atan2f той же сборки.
+//
+// Сетки равномерные, 10^6 точек на диапазон; печатается максимум
+// |ошибки| и точка, где он достигнут. Проверки — границы, заявленные
+// в шапке fast_math.h: если полином или приведение аргумента поменяют,
+// тест покажет, что цифры в комментарии пора обновить.
+//
+// Время — на хосте (x86/ARM64 с аппаратным libm), не на Cortex-M4:
+// отношение к libm здесь ориентир, абсолютные ns — нет.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "fast_math.h"
+#include <math.h>
+
+#define GRID 1000000U
+
+typedef struct
+{
+    double max_err;
+    double at;
+} ErrStat_t;
+
+static void err_acc(ErrStat_t *e, double err, double x)
+{
+    err = fabs(err);
+    if (err > e->max_err)
+    {
+        e->max_err = err;
+        e->at = x;
+    }
+}
+
+static void report(const char *what, const ErrStat_t *e, double bound)
+{
+    printf("  %-34s max |err| %.3g at %.6g (bound %.2g)\n", what, e->max_err, e->at, bound);
+}
+
+/* ---------------- Точность ---------------- */
+
+static ErrStat_t sin_err(double lo, double hi)
+{
+    ErrStat_t e = {0};
+    for (uint32_t i = 0; i <= GRID; i++)
+    {
+        double x = lo + (hi - lo) * i / GRID;
+        float xf = (float)x;
+        err_acc(&e, (double)FM_Sin(xf) - sin((double)xf), x);
+    }
+    return e;
+}
+
+static ErrStat_t cos_err(double lo, double hi)
+{
+    ErrStat_t e = {0};
+    for (uint32_t i = 0; i <= GRID; i++)
+    {
+        double x = lo + (hi - lo) * i / GRID;
+        float xf = (float)x;
+        err_acc(&e, (double)FM_Cos(xf) - cos((double)xf), x);
+    }
+    return e;
+}
+
+static void test_accuracy(void)
+{
+    ErrStat_t e;
+
+    e = sin_err(-M_PI_2, M_PI_2);
+    report("FM_Sin  |x| <= pi/2", &e, 7.2e-7);
+    CHECK(e.max_err <= 7.2e-7);
+
+    e = sin_err(-2.0 * M_PI, 2.0 * M_PI);
+    report("FM_Sin  |x| <= 2pi", &e, 1e-6);
+    CHECK(e.max_err <= 1e-6);
+
+    e = cos_err(-2.0 * M_PI, 2.0 * M_PI);
+    report("FM_Cos  |x| <= 2pi", &e, 1e-6);
+    CHECK(e.max_err <= 1e-6);
+
+    e = sin_err(-100.0, 100.0);
+    report("FM_Sin  |x| <= 100", &e, 1e-5);
+    CHECK(e.max_err <= 1e-5);
+
+    e = (ErrStat_t){0};
+    for (uint32_t i = 0; i <= GRID; i++)
+    {
+        double z = -1.0 + 2.0 * i / GRID;
+        float zf = (float)z;
+        err_acc(&e, (double)FM_AtanUnit(zf) - atan((double)zf), z);
+    }
+    report("FM_AtanUnit |z| <= 1", &e, 1.8e-6);
+    CHECK(e.max_err <= 1.8e-6);
+
+    // atan2 по окружности: все октанты и знаки
+    e = (ErrStat_t){0};
+    for (uint32_t i = 0; i <= GRID; i++)
+    {
+        double a = -M_PI + 2.0 * M_PI * i / GRID;
+        float y = (float)(3.0 * sin(a)), x = (float)(3.0 * cos(a));
+        double ref = atan2((double)y, (double)x);
+        double err = (double)FM_Atan2(y, x) - ref;
+        if (err > M_PI) // ±π на отрицательной полуоси — одно и то же
+            err -= 2.0 * M_PI;
+        if (err < -M_PI)
+            err += 2.0 * M_PI;
+        err_acc(&e, err, a);
+    }
+    report("FM_Atan2 (circle)", &e, 2e-6);
+    CHECK(e.max_err <= 2e-6);
+    CHECK(FM_Atan2(0.0f, 0.0f) == 0.0f);
+
+    // приведение углов: диапазон и ошибка против remainder() в double
+    e = (ErrStat_t){0};
+    uint32_t out = 0;
+    for (uint32_t i = 0; i <= GRID; i++)
+    {
+        double d = -1e5 + 2e5 * i / GRID;
+        float df = (float)d;
+        float w = FM_WrapDeg180(df);
+        if (w < -180.0f || w > 180.0f)
+            out++;
+        double ref = remainder((double)df, 360.0);
+        double err = (double)w - ref;
+        if (fabs(fabs(ref) - 180.0) < 1e-9) // ±180 — одно и то же
+            err = fabs((double)w) - 180.0;
+        err_acc(&e, err / (fabs((double)df) + 1.0), d);
+    }
+    report("FM_WrapDeg180 rel, |x| <= 1e5", &e, 1.2e-7);
+    CHECK(out == 0U);
+    CHECK(e.max_err <= 1.2e-7);
+}
+
+/* ---------------- Скорость ---------------- */
+
+static volatile float s_sink;
+
+#define PERF_N 4000000U
+
+static void test_perf(void)
+{
+    static float xs[1024], ys[1024];
+    for (uint32_t i = 0; i < 1024U; i++)
+    {
+        xs[i] = -6.0f + 12.0f * (float)i / 1024.0f;
+        ys[i] = 2.0f - 4.0f * (float)((i * 37U) % 1024U) / 1024.0f;
+    }
+
+    uint64_t t0;
+    float acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += FM_Sin(xs[i & 1023U]);
+    Test_ReportNs("FM_Sin", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += sinf(xs[i & 1023U]);
+    Test_ReportNs("sinf (libm)", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += FM_Cos(xs[i & 1023U]);
+    Test_ReportNs("FM_Cos", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += cosf(xs[i & 1023U]);
+    Test_ReportNs("cosf (libm)", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += FM_Atan2(ys[i & 1023U], xs[i & 1023U]);
+    Test_ReportNs("FM_Atan2", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+
+    acc = 0.0f;
+    t0 = Host_NowNs();
+    for (uint32_t i = 0; i < PERF_N; i++)
+        acc += atan2f(ys[i & 1023U], xs[i & 1023U]);
+    Test_ReportNs("atan2f (libm)", Host_NowNs() - t0, PERF_N);
+    s_sink = acc;
+}
+
+int main(void)
+{
+    test_accuracy();
+    test_perf();
+    return Test_Summary("test_fast_math");
+}
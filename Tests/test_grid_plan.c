@@ -0,0 +1,202 @@
+// test_grid_plan.c
+//
+// Планировщик по сетке (grid_plan.c) на случайных картах: правильность
+// против эталонного BFS и время планирования на ПК.
+//
+// Карты 32×32 с заполнением 0 / 15 / 25 / 40 %, по 200 карт и 10 пар
+// старт/цель на каждой (старт и цель освобождаются; часть пар без пути).
+// 25 % — та же плотность, что у случаев grid_astar_32 / grid_flood_32
+// в bench.c.
+//
+// Проверяется:
+//   - длина пути A* и волны равна кратчайшей по BFS, пути нет — 0;
+//   - путь связный (шаг в 4-соседа), от старта до цели, только по
+//     свободным клеткам;
+//   - Grid_EmitPath даёт точки и без сглаживания, и со сглаживанием,
+//     сглаженный путь не длиннее по числу точек;
+//   - занятые старт/цель и нехватка места в out — 0.
+//
+// Время — ns на одно планирование (хост); печатаются также среднее
+// число раскрытых клеток, пик открытого списка A* и переполнения кучи
+// (при них A* доделывает волной — длины проверяются и в этих случаях).
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "grid_plan.h"
+#include "path_follow.h"
+#include <stdlib.h>
+
+#define MAPS 200U
+#define PAIRS 10U
+
+static uint32_t s_rng = 0x2545F491UL;
+
+static uint32_t rnd(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng = x;
+    return x;
+}
+
+/* Эталон: BFS по 4-соседям, −1 — пути нет */
+static int32_t ref_bfs(GridCell_t s, GridCell_t g)
+{
+    static int32_t dist[GRID_CELLS];
+    static uint16_t q[GRID_CELLS];
+    static const int8_t dx[4] = {1, 0, -1, 0}, dy[4] = {0, 1, 0, -1};
+    uint32_t head = 0, tail = 0;
+
+    for (uint32_t i = 0; i < GRID_CELLS; i++)
+        dist[i] = -1;
+    dist[s.y * GRID_W + s.x] = 0;
+    q[tail++] = (uint16_t)(s.y * GRID_W + s.x);
+
+    while (head < tail)
+    {
+        uint32_t i = q[head++];
+        int32_t x = (int32_t)(i % GRID_W), y = (int32_t)(i / GRID_W);
+        for (uint32_t k = 0; k < 4U; k++)
+        {
+            int32_t nx = x + dx[k], ny = y + dy[k];
+            if (Grid_IsBlocked(nx, ny) || dist[ny * GRID_W + nx] >= 0)
+                continue;
+            dist[ny * GRID_W + nx] = dist[i] + 1;
+            q[tail++] = (uint16_t)(ny * GRID_W + nx);
+        }
+    }
+    return dist[g.y * GRID_W + g.x];
+}
+
+static uint8_t path_ok(const GridCell_t *p, uint32_t n, GridCell_t s, GridCell_t g)
+{
+    if (p[0].x != s.x || p[0].y != s.y || p[n - 1U].x != g.x || p[n - 1U].y != g.y)
+        return 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (Grid_IsBlocked(p[i].x, p[i].y))
+            return 0;
+        if (i && abs(p[i].x - p[i - 1U].x) + abs(p[i].y - p[i - 1U].y) != 1)
+            return 0;
+    }
+    return 1;
+}
+
+typedef struct
+{
+    uint64_t ns;
+    uint32_t plans;
+    uint32_t bad_len; // длина не совпала с BFS
+    uint32_t bad_path;
+    uint64_t expanded;
+    uint32_t open_peak;
+} AlgoStat_t;
+
+static void plan_one(AlgoStat_t *st, GridAlgo algo, GridCell_t s, GridCell_t g, int32_t ref,
+                     GridCell_t *out)
+{
+    uint64_t t0 = Host_NowNs();
+    uint32_t n = Grid_Plan(algo, s, g, out, GRID_CELLS);
+    st->ns += Host_NowNs() - t0;
+    st->plans++;
+
+    const GridPlanStats_t *ps = Grid_LastStats();
+    st->expanded += ps->expanded;
+    if (ps->open_peak > st->open_peak)
+        st->open_peak = ps->open_peak;
+
+    if (ref < 0)
+    {
+        if (n != 0U)
+            st->bad_len++;
+        return;
+    }
+    if (n != (uint32_t)ref + 1U)
+        st->bad_len++;
+    else if (!path_ok(out, n, s, g))
+        st->bad_path++;
+}
+
+static void test_random_maps(uint32_t fill_pct)
+{
+    static GridCell_t out[GRID_CELLS];
+    AlgoStat_t a = {0}, f = {0};
+    uint32_t no_path = 0, emit_bad = 0;
+    uint32_t ovf0 = Grid_LastStats()->overflows;
+
+    for (uint32_t m = 0; m < MAPS; m++)
+    {
+        Grid_Clear();
+        for (uint32_t y = 0; y < GRID_H; y++)
+            for (uint32_t x = 0; x < GRID_W; x++)
+                if (rnd() % 100U < fill_pct)
+                    Grid_SetBlocked(x, y, 1);
+
+        for (uint32_t k = 0; k < PAIRS; k++)
+        {
+            GridCell_t s = {(uint8_t)(rnd() % GRID_W), (uint8_t)(rnd() % GRID_H)};
+            GridCell_t g = {(uint8_t)(rnd() % GRID_W), (uint8_t)(rnd() % GRID_H)};
+            Grid_SetBlocked(s.x, s.y, 0);
+            Grid_SetBlocked(g.x, g.y, 0);
+
+            int32_t ref = ref_bfs(s, g);
+            if (ref < 0)
+                no_path++;
+
+            plan_one(&a, GRID_ASTAR, s, g, ref, out);
+            if (ref >= 0)
+            {
+                uint32_t n = (uint32_t)ref + 1U;
+                uint32_t corners = Grid_EmitPath(out, n, 0);
+                uint32_t smooth = Grid_EmitPath(out, n, 1);
+                if (corners == 0U || smooth == 0U || smooth > corners)
+                    emit_bad++;
+            }
+            plan_one(&f, GRID_FLOOD, s, g, ref, out);
+        }
+    }
+
+    printf("fill %2u%%: %u plans (%u without path), A* overflows %u\n", (unsigned)fill_pct,
+           (unsigned)a.plans, (unsigned)no_path,
+           (unsigned)(Grid_LastStats()->overflows - ovf0));
+    printf("  A*:    expanded %.0f, open peak %u\n", (double)a.expanded / a.plans,
+           (unsigned)a.open_peak);
+    Test_ReportNs("Grid_Plan(GRID_ASTAR)", a.ns, a.plans);
+    printf("  flood: expanded %.0f\n", (double)f.expanded / f.plans);
+    Test_ReportNs("Grid_Plan(GRID_FLOOD)", f.ns, f.plans);
+
+    CHECK(a.bad_len == 0U);
+    CHECK(a.bad_path == 0U);
+    CHECK(f.bad_len == 0U);
+    CHECK(f.bad_path == 0U);
+    CHECK(emit_bad == 0U);
+}
+
+static void test_reject(void)
+{
+    GridCell_t out[8];
+    GridCell_t s = {1, 1}, g = {20, 1};
+
+    Grid_Clear();
+    Grid_SetBlocked(g.x, g.y, 1);
+    CHECK(Grid_Plan(GRID_ASTAR, s, g, out, 8) == 0U);
+    CHECK(Grid_Plan(GRID_FLOOD, g, s, out, 8) == 0U);
+
+    Grid_SetBlocked(g.x, g.y, 0); // путь 20 клеток в 8 мест не влезает
+    CHECK(Grid_Plan(GRID_ASTAR, s, g, out, 8) == 0U);
+    CHECK(Grid_Plan(GRID_FLOOD, s, g, out, 8) == 0U);
+}
+
+int main(void)
+{
+    Grid_Init(GRID_CELL_MM_DEFAULT, 0.0f, 0.0f);
+
+    test_random_maps(0);
+    test_random_maps(15);
+    test_random_maps(25);
+    test_random_maps(40);
+    test_reject();
+    return Test_Summary("test_grid_plan");
+}
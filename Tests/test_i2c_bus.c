@@ -0,0 +1,409 @@
+// test_i2c_bus.c
+//
+// Менеджер шины i2c_bus.c и очередь отсчётов MPU6050 на ПК.
+//
+// Аппаратная часть — симулятор через I2CBusOps_t: у каждого адреса
+// 256 регистров, отсутствующее устройство не отвечает (ошибка шины),
+// время виртуальное — 100 кГц, 9 тактов SCL на байт ≈ 90 мкс.
+//
+// Проверяется:
+//   - порядок очереди: приоритет, при равном — ранний дедлайн (EDF);
+//   - ошибка отсутствующего устройства попадает в его статистику;
+//   - смешанная нагрузка (IMU 250 Гц, ToF кусками по 8 байт, магнитометр):
+//     IMU не опаздывает и не теряет отсчётов;
+//   - перегрузка (ToF одним чтением 64 байта): IMU теряет отсчёты
+//     (DROPPED), но ни одно чтение не начинается после дедлайна —
+//     устаревших отсчётов нет (late — начатые вовремя, но закончившиеся
+//     позже: данные защёлкнуты в начале, они годны);
+//   - MPU6050_SubmitSample на транзакции в очереди не трогает её;
+//   - MPU6050_Configure при сбое записи останавливается, а конфигурация
+//     и масштабы совпадают с тем, что реально записано в датчик;
+//   - MPU6050_SetDLPF через 260 Гц (F_int 1 ↔ 8 кГц) сохраняет частоту
+//     выдачи: SMPLRT_DIV пересчитан и записан, при сбое записи CONFIG
+//     делитель возвращается и повтор даёт ту же частоту.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "i2c_bus.h"
+#include "MPU6050.h"
+#include <string.h>
+
+#define SIM_US_PER_BYTE 90U
+
+static uint32_t s_now; // виртуальное время шины, мкс
+static uint8_t s_regs[128][256];
+static uint8_t s_present[128];
+static int s_failReg = -1;     // запись в этот регистр — ошибка шины
+static uint32_t s_writes[256]; // записей по номеру регистра
+
+static uint32_t sim_now(void)
+{
+    return s_now;
+}
+
+static uint8_t sim_read(uint8_t addr, uint8_t reg, uint8_t *dst, uint32_t n)
+{
+    s_now += (2U + 1U + n + 1U) * SIM_US_PER_BYTE; // адрес, регистр, адрес, данные
+    if (!s_present[addr & 0x7FU])
+        return 0;
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = s_regs[addr & 0x7FU][(uint8_t)(reg + i)];
+    return 1;
+}
+
+static uint8_t sim_write(uint8_t addr, uint8_t reg, const uint8_t *src, uint32_t n)
+{
+    s_now += (2U + n) * SIM_US_PER_BYTE;
+    if (!s_present[addr & 0x7FU] || (int)reg == s_failReg)
+        return 0;
+    s_writes[reg]++;
+    for (uint32_t i = 0; i < n; i++)
+        s_regs[addr & 0x7FU][(uint8_t)(reg + i)] = src[i];
+    return 1;
+}
+
+static const I2CBusOps_t s_simOps = {sim_read, sim_write, sim_now};
+
+static I2CDev_t s_imu = I2C_DEV_INIT("imu", 0x68);
+static I2CDev_t s_tof = I2C_DEV_INIT("tof", 0x29);
+static I2CDev_t s_mag = I2C_DEV_INIT("mag", 0x1E);
+static I2CDev_t s_ghost = I2C_DEV_INIT("ghost", 0x50);
+
+static void sim_reset(void)
+{
+    memset(s_regs, 0, sizeof(s_regs));
+    memset(s_present, 0, sizeof(s_present));
+    memset(s_writes, 0, sizeof(s_writes));
+    s_failReg = -1;
+    s_present[0x68] = s_present[0x29] = s_present[0x1E] = 1U;
+    s_now = 0;
+    I2CBus_Init(&s_simOps);
+}
+
+/* ---------------- Порядок очереди ---------------- */
+
+static int s_order[8];
+static uint32_t s_orderN;
+
+static void record_done(I2CXfer_t *x)
+{
+    s_order[s_orderN++] = (int)(intptr_t)x->ctx;
+}
+
+static void test_order(void)
+{
+    sim_reset();
+
+    I2CXfer_t x[4];
+    uint8_t b[4][2];
+    const uint8_t prio[4] = {I2C_PRIO_LOW, I2C_PRIO_NORMAL, I2C_PRIO_NORMAL, I2C_PRIO_HIGH};
+    const uint32_t dl[4] = {100, 500, 200, 900};
+
+    memset(x, 0, sizeof(x));
+    s_orderN = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        x[i].dev = &s_mag;
+        x[i].buf = b[i];
+        x[i].len = 2;
+        x[i].prio = prio[i];
+        x[i].deadline_us = dl[i];
+        x[i].done = record_done;
+        x[i].ctx = (void *)(intptr_t)i;
+        CHECK(I2CBus_Submit(&x[i]));
+    }
+    CHECK(!I2CBus_Submit(&x[0])); // уже в очереди
+    CHECK(I2CBus_Pending() == 4U);
+
+    while (I2CBus_Poll())
+    {
+    }
+    CHECK(s_orderN == 4U);
+    CHECK(s_order[0] == 3 && s_order[1] == 2 && s_order[2] == 1 && s_order[3] == 0);
+    for (int i = 0; i < 4; i++)
+        CHECK(x[i].status == I2C_XFER_DONE);
+
+    // отсутствующее устройство
+    uint8_t v;
+    CHECK(!I2CBus_Read(&s_ghost, 0, &v, 1));
+    CHECK(s_ghost.st.errors == 1U);
+}
+
+/* ---------------- Нагрузка на шину ---------------- */
+
+typedef struct
+{
+    uint32_t submitted;
+    uint32_t done;
+    uint32_t started_late; // начато на шине после дедлайна
+} ImuRun_t;
+
+static void imu_done(I2CXfer_t *x)
+{
+    ImuRun_t *r = (ImuRun_t *)x->ctx;
+    if (x->status == I2C_XFER_DONE && (int32_t)(x->start_us - x->deadline_us) > 0)
+        r->started_late++;
+}
+
+/* Один период шины: IMU каждые 4 мс с дедлайном = период,
+ * ToF кусками tof_len байт, магнитометр 100 Гц
+ */
+static void bus_run(uint32_t until_us, uint16_t tof_len, ImuRun_t *r)
+{
+    static I2CXfer_t xi, xt, xm;
+    static uint8_t bi[14], bt[64], bm[6];
+    uint32_t tImu = s_now, tTof = s_now, tMag = s_now;
+
+    memset(&xi, 0, sizeof(xi));
+    memset(&xt, 0, sizeof(xt));
+    memset(&xm, 0, sizeof(xm));
+
+    while ((int32_t)(s_now - until_us) < 0)
+    {
+        if ((int32_t)(s_now - tImu) >= 0 && xi.status != I2C_XFER_QUEUED)
+        {
+            if (xi.status == I2C_XFER_DONE)
+                r->done++;
+            xi = (I2CXfer_t){.dev = &s_imu, .buf = bi, .len = 14, .reg = 0x3B,
+                             .prio = I2C_PRIO_HIGH, .flags = I2C_XFER_DROP_LATE,
+                             .deadline_us = tImu + 4000U, .done = imu_done, .ctx = r};
+            if (I2CBus_Submit(&xi))
+                r->submitted++;
+            tImu += 4000U;
+        }
+        if ((int32_t)(s_now - tTof) >= 0 && xt.status != I2C_XFER_QUEUED)
+        {
+            xt = (I2CXfer_t){.dev = &s_tof, .buf = bt, .len = tof_len, .reg = 0x14,
+                             .prio = I2C_PRIO_LOW, .deadline_us = s_now + 33000U};
+            (void)I2CBus_Submit(&xt);
+            // короткие куски — три на кадр ToF 30 Гц; длинное чтение — без паузы
+            if (tof_len > 8U)
+                tTof = s_now;
+            else
+                tTof += 11111U;
+        }
+        if ((int32_t)(s_now - tMag) >= 0 && xm.status != I2C_XFER_QUEUED)
+        {
+            xm = (I2CXfer_t){.dev = &s_mag, .buf = bm, .len = 6, .reg = 0x03,
+                             .prio = I2C_PRIO_NORMAL, .deadline_us = tMag + 10000U};
+            (void)I2CBus_Submit(&xm);
+            tMag += 10000U;
+        }
+        if (!I2CBus_Poll())
+            s_now += 10U; // простой
+    }
+    while (I2CBus_Poll())
+    {
+    }
+}
+
+static void test_load(void)
+{
+    sim_reset();
+    s_regs[0x68][0x3B] = 0x12;
+
+    ImuRun_t r = {0};
+    bus_run(2000000U, 8U, &r);
+    printf("mixed: imu %u submitted, dropped %u, late %u, max wait %u us\n",
+           (unsigned)r.submitted, (unsigned)s_imu.st.dropped, (unsigned)s_imu.st.late,
+           (unsigned)s_imu.st.max_wait_us);
+    CHECK(r.submitted >= 499U);
+    CHECK(s_imu.st.dropped == 0U);
+    CHECK(s_imu.st.late == 0U);
+    CHECK(r.started_late == 0U);
+    CHECK(s_imu.st.max_wait_us < 4000U);
+
+    // перегрузка: 64 байта ToF ≈ 6 мс на шине — дольше периода IMU
+    I2CBus_ResetStats();
+    r = (ImuRun_t){0};
+    bus_run(s_now + 200000U, 64U, &r);
+    printf("overload: imu %u submitted, dropped %u, late %u\n", (unsigned)r.submitted,
+           (unsigned)s_imu.st.dropped, (unsigned)s_imu.st.late);
+    CHECK(s_imu.st.dropped > 0U);
+    CHECK(r.started_late == 0U);
+}
+
+/* ---------------- MPU6050 через очередь ---------------- */
+
+static void test_mpu_submit(void)
+{
+    sim_reset();
+
+    // ACCEL_X = 0x0102, ..., GYRO_Z = 0x0D0E (big endian в регистрах)
+    for (uint8_t i = 0; i < 14U; i++)
+        s_regs[MPU6050_ADDR][MPU6050_REG_ACCEL_XOUT_H + i] = (uint8_t)(i + 1U);
+
+    I2CXfer_t x;
+    ImuSample_t a, b;
+    memset(&x, 0, sizeof(x));
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0xA5, sizeof(b));
+
+    s_now = 1000U;
+    CHECK(MPU6050_SubmitSample(&x, &a, 5000U));
+    CHECK(x.status == I2C_XFER_QUEUED);
+    uint16_t seq = a.seq;
+
+    // повторная постановка той же x, пока она в очереди: отказ, x и b не тронуты
+    I2CXfer_t before = x;
+    ImuSample_t b0 = b;
+    CHECK(!MPU6050_SubmitSample(&x, &b, 9000U));
+    CHECK(memcmp(&x, &before, sizeof(x)) == 0);
+    CHECK(memcmp(&b, &b0, sizeof(b)) == 0);
+    CHECK(I2CBus_Pending() == 1U);
+
+    CHECK(I2CBus_Poll());
+    CHECK(x.status == I2C_XFER_DONE);
+    CHECK(a.raw[IMU_AX] == 0x0102 && a.raw[IMU_TEMP] == 0x0708 && a.raw[IMU_GZ] == 0x0D0E);
+    CHECK(a.t_us == x.start_us);
+
+    // после завершения — снова можно, номер следующий
+    CHECK(MPU6050_SubmitSample(&x, &a, 20000U));
+    CHECK(a.seq == (uint16_t)(seq + 1U));
+
+    // дедлайн прошёл до начала на шине — отсчёт отброшен, номер израсходован
+    s_now = 30000U;
+    CHECK(I2CBus_Poll());
+    CHECK(x.status == I2C_XFER_DROPPED);
+    CHECK(MPU6050_SubmitSample(&x, &a, 40000U));
+    CHECK(a.seq == (uint16_t)(seq + 2U));
+    CHECK(I2CBus_Poll());
+    CHECK(x.status == I2C_XFER_DONE);
+}
+
+/* ---------------- MPU6050_Configure со сбоем записи ---------------- */
+
+static uint8_t cfg_eq(const MPU6050_Config_t *a, const MPU6050_Config_t *b)
+{
+    return a->dlpf == b->dlpf && a->smplrt_div == b->smplrt_div &&
+           a->gyro_fs == b->gyro_fs && a->accel_fs == b->accel_fs;
+}
+
+/* Конфигурация драйвера против регистров симулятора */
+static uint8_t cfg_matches_device(void)
+{
+    const MPU6050_Config_t *c = MPU6050_GetConfig();
+    const uint8_t *r = s_regs[MPU6050_ADDR];
+    return r[MPU6050_REG_CONFIG] == (uint8_t)c->dlpf &&
+           r[MPU6050_REG_SMPLRT_DIV] == c->smplrt_div &&
+           r[MPU6050_REG_GYRO_CONFIG] == (uint8_t)(c->gyro_fs << 3) &&
+           r[MPU6050_REG_ACCEL_CONFIG] == (uint8_t)(c->accel_fs << 3);
+}
+
+static void test_mpu_configure(void)
+{
+    const MPU6050_Config_t def = MPU6050_CONFIG_DEFAULT;   // ±2000°/с, ±8g
+    const MPU6050_Config_t cal = MPU6050_CONFIG_CALIBRATION; // ±250°/с, ±2g
+
+    sim_reset();
+    CHECK(MPU6050_Configure(&def));
+    CHECK(cfg_eq(MPU6050_GetConfig(), &def));
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetGyroScale(), 1.0f / 16.4f, 1e-9);
+    CHECK_NEAR(MPU6050_GetAccelScale(), 1.0f / 4096.0f, 1e-12);
+
+    // сбой на GYRO_CONFIG: CONFIG и SMPLRT_DIV уже новые, диапазоны прежние,
+    // ACCEL_CONFIG после ошибки даже не пробуем
+    memset(s_writes, 0, sizeof(s_writes));
+    s_failReg = MPU6050_REG_GYRO_CONFIG;
+    CHECK(!MPU6050_Configure(&cal));
+    CHECK(s_writes[MPU6050_REG_ACCEL_CONFIG] == 0U);
+    const MPU6050_Config_t *c = MPU6050_GetConfig();
+    CHECK(c->dlpf == cal.dlpf && c->smplrt_div == cal.smplrt_div);
+    CHECK(c->gyro_fs == def.gyro_fs && c->accel_fs == def.accel_fs);
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetGyroScale(), 1.0f / 16.4f, 1e-9);
+    CHECK_NEAR(MPU6050_GetAccelScale(), 1.0f / 4096.0f, 1e-12);
+
+    // сбой на ACCEL_CONFIG: гироскоп уже в новом диапазоне — и его масштаб тоже
+    s_failReg = MPU6050_REG_ACCEL_CONFIG;
+    CHECK(!MPU6050_Configure(&cal));
+    CHECK(MPU6050_GetConfig()->gyro_fs == cal.gyro_fs);
+    CHECK(MPU6050_GetConfig()->accel_fs == def.accel_fs);
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetGyroScale(), 1.0f / 131.0f, 1e-9);
+    CHECK_NEAR(MPU6050_GetAccelScale(), 1.0f / 4096.0f, 1e-12);
+
+    // шина ожила — повтор доводит до конца
+    s_failReg = -1;
+    CHECK(MPU6050_Configure(&cal));
+    CHECK(cfg_eq(MPU6050_GetConfig(), &cal));
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetAccelScale(), 1.0f / 16384.0f, 1e-12);
+}
+
+/* ---------------- MPU6050_SetDLPF и частота выдачи ---------------- */
+
+static void test_mpu_dlpf(void)
+{
+    const MPU6050_Config_t def = MPU6050_CONFIG_DEFAULT; // 44 Гц, 125 Гц
+    const MPU6050_Config_t fast = MPU6050_CONFIG_LOW_LATENCY; // 184 Гц, 1 кГц
+    const uint8_t *r = s_regs[MPU6050_ADDR];
+
+    sim_reset();
+    CHECK(MPU6050_Configure(&def));
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 125.0f, 1e-3);
+
+    // внутри 1 кГц делитель не трогается
+    memset(s_writes, 0, sizeof(s_writes));
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_94HZ));
+    CHECK(s_writes[MPU6050_REG_SMPLRT_DIV] == 0U);
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 7U);
+
+    // 1 → 8 кГц: 125 Гц = 8000 / 64
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_260HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 63U);
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 125.0f, 1e-3);
+
+    // и обратно
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_21HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 7U);
+    CHECK(cfg_matches_device());
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 125.0f, 1e-3);
+
+    // 1 кГц без делителя ↔ 8 кГц / 8
+    CHECK(MPU6050_Configure(&fast));
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_260HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 7U);
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 1000.0f, 1e-3);
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_184HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 0U);
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 1000.0f, 1e-3);
+
+    // 8 кГц / 12 = 667 Гц в 1 кГц не делится: ближайшая — 500 Гц;
+    // 1 кГц / 50 = 20 Гц в 8 кГц — за пределом делителя, 31.25 Гц
+    MPU6050_Config_t odd = {MPU6050_DLPF_260HZ, 11U, MPU6050_GYRO_FS_2000, MPU6050_ACCEL_FS_8G};
+    CHECK(MPU6050_Configure(&odd));
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_44HZ));
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 500.0f, 1e-3);
+    odd = (MPU6050_Config_t){MPU6050_DLPF_44HZ, 49U, MPU6050_GYRO_FS_2000, MPU6050_ACCEL_FS_8G};
+    CHECK(MPU6050_Configure(&odd));
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_260HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 255U);
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 31.25f, 1e-3);
+
+    // сбой записи CONFIG по пути к 8 кГц: делитель уже был записан,
+    // его возвращают — конфигурация прежняя и совпадает с датчиком
+    CHECK(MPU6050_Configure(&def));
+    memset(s_writes, 0, sizeof(s_writes));
+    s_failReg = MPU6050_REG_CONFIG;
+    CHECK(!MPU6050_SetDLPF(MPU6050_DLPF_260HZ));
+    CHECK(s_writes[MPU6050_REG_SMPLRT_DIV] == 2U);
+    CHECK(cfg_eq(MPU6050_GetConfig(), &def));
+    CHECK(cfg_matches_device());
+    s_failReg = -1;
+    CHECK(MPU6050_SetDLPF(MPU6050_DLPF_260HZ));
+    CHECK(r[MPU6050_REG_SMPLRT_DIV] == 63U); // пересчёт от 1 кГц / 64, не повторно
+    CHECK_NEAR(MPU6050_GetOutputRateHz(), 125.0f, 1e-3);
+}
+
+int main(void)
+{
+    test_order();
+    test_load();
+    test_mpu_submit();
+    test_mpu_configure();
+    test_mpu_dlpf();
+    return Test_Summary("test_i2c_bus");
+}
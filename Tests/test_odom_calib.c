@@ -0,0 +1,311 @@
+// test_odom_calib.c
+//
+// Решатель калибровки одометрии (OdomCal_AddRun / OdomCal_Solve) на ПК.
+//
+// Робот-модель с заведомо разными колёсами: sL = 0.97·ном, sR = 1.02·ном,
+// колея 152 мм. Заезды строятся так же, как в OdomCal_RunGyro: два
+// разворота на 720° (в обе стороны) и прямые вперёд/назад, гироскоп
+// видит истинный поворот Δθ = (sR·nR − sL·nL) / b плюс шум.
+// Тики — целые, как у энкодера.
+//
+// Проверяется:
+//   - без шума масштабы и колея восстанавливаются до квантования тиков;
+//   - без эталонного заезда отношение sR/sL верное, а средний масштаб —
+//     переданный (гироскоп его не видит);
+//   - с шумом гироскопа (200 прогонов) — средняя ошибка масштаба и колеи;
+//   - вырожденные наборы (только развороты / только прямые), асимметрия
+//     сверх ODOM_CAL_MAX_ASYM и перевёрнутый гироскоп — отказ;
+//   - длинный маршрут (квадрат 2 × 2 м, 5 кругов = 40 м, развороты на
+//     месте в углах) через настоящий Odom_Integrate: номинальная
+//     калибровка (ODOM_SCALE_DEFAULT) против найденной решателем.
+//
+// Что показывает маршрут: курс на длинной дистанции решает остаточная
+// асимметрия колёс, а её точность — шум гироскопа за прямой заезд
+// (ошибка e ≈ σ·b / 2L). Без шума ошибка в конце 40 м — миллиметры
+// (квантование тиков); при σ = 0.001 рад — около 10 см; при 0.01 рад —
+// около метра (вдвое лучше номинала). Сантиметры на таком пути одна
+// одометрия даёт только с очень тихим гироскопом — иначе нужен курс
+// по гироскопу во время езды.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "odom_calib.h"
+#include "encoder.h"
+#include <math.h>
+
+#define NOM_MM_PER_TICK ((float)(M_PI * 65.0 / 40.0))
+#define TRACK_MM 152.0f
+
+typedef struct
+{
+    float sL, sR, b;
+    float gyro_sigma; // шум угла за заезд, рад
+    float gyro_sign;  // −1 — гироскоп перевёрнут
+} Robot_t;
+
+/* Детерминированный шум: LCG + сумма 12 равномерных ≈ N(0, 1) */
+static uint32_t s_rng = 12345U;
+
+static float rnd_u(void)
+{
+    s_rng = s_rng * 1664525U + 1013904223U;
+    return (float)(s_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static float rnd_n(void)
+{
+    float u = 0.0f;
+    for (int i = 0; i < 12; i++)
+        u += rnd_u();
+    return u - 6.0f;
+}
+
+static void add_run(OdomCal_t *c, const Robot_t *r, int32_t nL, int32_t nR)
+{
+    float dth = (r->sR * (float)nR - r->sL * (float)nL) / r->b;
+    OdomCal_AddRun(c, nL, nR, r->gyro_sign * (dth + r->gyro_sigma * rnd_n()));
+}
+
+/* Разворот на месте на turn рад: каждое колесо проходит дугу b·θ/2 */
+static void add_spin(OdomCal_t *c, const Robot_t *r, float turn)
+{
+    float arc = 0.5f * r->b * turn;
+    add_run(c, r, -(int32_t)lroundf(arc / r->sL), (int32_t)lroundf(arc / r->sR));
+}
+
+/* Прямой заезд одинаковым PWM: тики равны, разные колёса уводят вбок */
+static void add_straight(OdomCal_t *c, const Robot_t *r, float mm)
+{
+    int32_t n = (int32_t)lroundf(mm / NOM_MM_PER_TICK);
+    add_run(c, r, n, n);
+}
+
+static void plan(OdomCal_t *c, const Robot_t *r, uint8_t spins, uint8_t straights)
+{
+    OdomCal_Begin(c);
+    if (spins)
+    {
+        add_spin(c, r, 4.0f * (float)M_PI);
+        add_spin(c, r, -4.0f * (float)M_PI);
+    }
+    if (straights)
+    {
+        add_straight(c, r, ODOM_CAL_STRAIGHT_MM);
+        add_straight(c, r, -ODOM_CAL_STRAIGHT_MM);
+    }
+}
+
+/* Эталон: прямой заезд 1 м, измеренный рулеткой */
+static void set_ref(OdomCal_t *c, const Robot_t *r)
+{
+    OdomCal_SetReference(c, (int32_t)lroundf(1000.0f / r->sL),
+                         (int32_t)lroundf(1000.0f / r->sR), 1000.0f);
+}
+
+static void test_exact(void)
+{
+    Robot_t r = {0.97f * NOM_MM_PER_TICK, 1.02f * NOM_MM_PER_TICK, TRACK_MM, 0.0f, 1.0f};
+    OdomCal_t c;
+    OdomCalib_t o;
+
+    plan(&c, &r, 1, 1);
+    set_ref(&c, &r);
+    CHECK(c.runs == 4U);
+    CHECK(OdomCal_Solve(&c, NOM_MM_PER_TICK * 0.95f, &o));
+    printf("exact: L %.4f/%.4f R %.4f/%.4f track %.2f/%.2f\n", o.mm_per_tick_left, r.sL,
+           o.mm_per_tick_right, r.sR, o.track_mm, r.b);
+    CHECK_NEAR(o.mm_per_tick_left / r.sL, 1.0, 2e-3);
+    CHECK_NEAR(o.mm_per_tick_right / r.sR, 1.0, 2e-3);
+    CHECK_NEAR(o.track_mm, r.b, 0.5);
+
+    // без эталона: средний масштаб — переданный, асимметрия и колея в тиках — свои
+    OdomCal_SetReference(&c, 0, 0, 0.0f);
+    float mean = NOM_MM_PER_TICK; // номинал, а не истинные 0.995·ном
+    CHECK(OdomCal_Solve(&c, mean, &o));
+    CHECK_NEAR(0.5f * (o.mm_per_tick_left + o.mm_per_tick_right), mean, 1e-5);
+    CHECK_NEAR(o.mm_per_tick_right / o.mm_per_tick_left, r.sR / r.sL, 2e-3);
+    float s_true = 0.5f * (r.sL + r.sR);
+    CHECK_NEAR(o.track_mm, r.b * mean / s_true, 0.5);
+}
+
+static void test_noise(void)
+{
+    Robot_t r = {0.97f * NOM_MM_PER_TICK, 1.02f * NOM_MM_PER_TICK, TRACK_MM, 0.01f, 1.0f};
+    const uint32_t N = 200;
+    double errS = 0.0, errB = 0.0, worstS = 0.0;
+    uint32_t ok = 0;
+
+    for (uint32_t k = 0; k < N; k++)
+    {
+        OdomCal_t c;
+        OdomCalib_t o;
+        plan(&c, &r, 1, 1);
+        set_ref(&c, &r);
+        if (!OdomCal_Solve(&c, NOM_MM_PER_TICK * 0.95f, &o))
+            continue;
+        ok++;
+        double eL = fabs(o.mm_per_tick_left - r.sL) / r.sL;
+        double eR = fabs(o.mm_per_tick_right - r.sR) / r.sR;
+        errS += 0.5 * (eL + eR);
+        errB += fabs(o.track_mm - r.b);
+        if (eL > worstS)
+            worstS = eL;
+        if (eR > worstS)
+            worstS = eR;
+    }
+    printf("noise 0.01 rad: %u/%u solved, mean scale err %.3f%% (worst %.3f%%), "
+           "mean track err %.2f mm\n",
+           (unsigned)ok, (unsigned)N, 100.0 * errS / ok, 100.0 * worstS, errB / ok);
+    CHECK(ok == N);
+    CHECK(errS / ok < 0.002);
+    CHECK(worstS < 0.005);
+    CHECK(errB / ok < 0.5);
+}
+
+/* ---------------- Длинный маршрут ---------------- */
+
+#define ROUTE_STEP_MM 5.0 // путь колеса за шаг регулятора (0.5 м/с при 10 мс)
+#define ROUTE_DRAWS 20U   // калибровок с разным шумом на каждое σ
+
+typedef struct
+{
+    const Robot_t *r;
+    double accL, accR;    // истинный путь колёс, мм
+    int32_t tickL, tickR; // выданные целые тики
+    double x, y, th;      // истинная поза
+} Route_t;
+
+/* Шаг: колёса проходят dL, dR мм; энкодер отдаёт целые тики,
+ * одометрия интегрирует их, истинная поза — точную дугу
+ */
+static void route_step(Route_t *rt, double dL, double dR)
+{
+    rt->accL += dL;
+    rt->accR += dR;
+    int32_t tL = (int32_t)floor(rt->accL / rt->r->sL);
+    int32_t tR = (int32_t)floor(rt->accR / rt->r->sR);
+    Odom_Integrate(tL - rt->tickL, tR - rt->tickR);
+    rt->tickL = tL;
+    rt->tickR = tR;
+
+    double ds = 0.5 * (dL + dR), dth = (dR - dL) / rt->r->b;
+    rt->x += ds * cos(rt->th + 0.5 * dth);
+    rt->y += ds * sin(rt->th + 0.5 * dth);
+    rt->th += dth;
+}
+
+/* Квадрат 2 × 2 м пять раз против часовой; ошибка позы в конце, мм и ° */
+static double run_route(const Robot_t *r, const OdomCalib_t *cal, double *th_err_deg)
+{
+    const double side_mm = 2000.0;
+    const uint32_t laps = 5;
+    Route_t rt = {.r = r};
+    Pose_t p0 = {0.0f, 0.0f, 0.0f}, p;
+
+    Odom_SetCalib(cal);
+    Odom_SetPose(&p0);
+
+    uint32_t n_side = (uint32_t)(side_mm / ROUTE_STEP_MM);
+    uint32_t n_turn = (uint32_t)(0.25 * M_PI * r->b / ROUTE_STEP_MM);
+    double turn_step = 0.25 * M_PI * r->b / n_turn; // дуга колеса на 90°
+
+    for (uint32_t k = 0; k < 4U * laps; k++)
+    {
+        for (uint32_t i = 0; i < n_side; i++)
+            route_step(&rt, ROUTE_STEP_MM, ROUTE_STEP_MM);
+        for (uint32_t i = 0; i < n_turn; i++)
+            route_step(&rt, -turn_step, turn_step);
+    }
+
+    Odom_GetPose(&p);
+    *th_err_deg = fabs(remainder((double)p.theta_rad - rt.th, 2.0 * M_PI)) * 180.0 / M_PI;
+    return hypot((double)p.x_mm - rt.x, (double)p.y_mm - rt.y);
+}
+
+/* Худшая ошибка маршрута по ROUTE_DRAWS калибровкам с шумом sigma */
+static double route_worst(float sigma, double *th_worst)
+{
+    Robot_t r = {0.97f * NOM_MM_PER_TICK, 1.02f * NOM_MM_PER_TICK, TRACK_MM, sigma, 1.0f};
+    double worst = 0.0;
+    *th_worst = 0.0;
+
+    for (uint32_t k = 0; k < ROUTE_DRAWS; k++)
+    {
+        OdomCal_t c;
+        OdomCalib_t cal;
+        double th;
+
+        plan(&c, &r, 1, 1);
+        set_ref(&c, &r);
+        if (!OdomCal_Solve(&c, NOM_MM_PER_TICK, &cal))
+            return 1e9;
+
+        double e = run_route(&r, &cal, &th);
+        if (e > worst)
+            worst = e;
+        if (th > *th_worst)
+            *th_worst = th;
+    }
+    return worst;
+}
+
+static void test_long_route(void)
+{
+    Robot_t r = {0.97f * NOM_MM_PER_TICK, 1.02f * NOM_MM_PER_TICK, TRACK_MM, 0.0f, 1.0f};
+    const OdomCalib_t nominal = {ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT,
+                                 ENC_MM_PER_TICK * ODOM_SCALE_DEFAULT, ODOM_TRACK_MM_DEFAULT};
+    double th, e, e_nominal;
+
+    e_nominal = e = run_route(&r, &nominal, &th);
+    printf("route 40 m, nominal calib:          end error %7.1f mm, %6.2f deg\n", e, th);
+    CHECK(e > 1000.0);
+
+    e = route_worst(0.0f, &th);
+    printf("route 40 m, solved, gyro exact:     end error %7.1f mm, %6.2f deg\n", e, th);
+    CHECK(e < 10.0);
+    CHECK(th < 1.0);
+
+    e = route_worst(0.001f, &th);
+    printf("route 40 m, solved, gyro 0.001 rad: worst     %7.1f mm, %6.2f deg\n", e, th);
+    CHECK(e < 150.0);
+
+    e = route_worst(0.01f, &th);
+    printf("route 40 m, solved, gyro 0.01 rad:  worst     %7.1f mm, %6.2f deg\n", e, th);
+    CHECK(e < 0.5 * e_nominal);
+}
+
+static void test_reject(void)
+{
+    Robot_t r = {0.97f * NOM_MM_PER_TICK, 1.02f * NOM_MM_PER_TICK, TRACK_MM, 0.0f, 1.0f};
+    OdomCal_t c;
+    OdomCalib_t o = {0};
+    const OdomCalib_t o0 = o;
+
+    plan(&c, &r, 1, 0); // только развороты — асимметрию не видно
+    CHECK(!OdomCal_Solve(&c, NOM_MM_PER_TICK, &o));
+    plan(&c, &r, 0, 1); // только прямые — колею не видно
+    CHECK(!OdomCal_Solve(&c, NOM_MM_PER_TICK, &o));
+
+    Robot_t bad = r; // колёса разные на 30 %
+    bad.sL = 0.85f * NOM_MM_PER_TICK;
+    bad.sR = 1.15f * NOM_MM_PER_TICK;
+    plan(&c, &bad, 1, 1);
+    CHECK(!OdomCal_Solve(&c, NOM_MM_PER_TICK, &o));
+
+    Robot_t flipped = r; // ODOM_CAL_GYRO_SIGN не тот — колея выходит отрицательной
+    flipped.gyro_sign = -1.0f;
+    plan(&c, &flipped, 1, 1);
+    CHECK(!OdomCal_Solve(&c, NOM_MM_PER_TICK, &o));
+
+    // при отказе out не трогается
+    CHECK(o.mm_per_tick_left == o0.mm_per_tick_left && o.track_mm == o0.track_mm);
+}
+
+int main(void)
+{
+    test_exact();
+    test_noise();
+    test_long_route();
+    test_reject();
+    return Test_Summary("test_odom_calib");
+}
@@ -0,0 +1,213 @@
+// test_path_follow.c
+//
+// Следование по пути (path_follow.c) в замкнутом контуре: (v, ω)
+// регулятора интегрируются моделью unicycle, поза возвращается как
+// от одометрии. Период 10 мс — как TELEOP_CTRL_PERIOD_US.
+//
+// Пути: прямая 1.5 м (старт в 50 мм сбоку), угол 90° (1 м + 1 м),
+// S-сплайн Catmull-Rom по 5 контрольным точкам. Каждый — pure pursuit
+// и Stanley с настройками по умолчанию.
+//
+// Проверяется:
+//   - путь пройден (PATH_DONE) за разумное время, выход на финише нулевой;
+//   - max / RMS поперечного отклонения (статистика модуля) и ошибка
+//     конца — в пределах для каждого пути и режима; для прямой и угла
+//     наибольшее отклонение пересчитывается ещё и тестом по геометрии;
+//   - Path_AddSpline при переполнении буфера: 0, в буфере ровно
+//     PATH_MAX_POINTS точек, дальше Path_Add не добавляет, по влезшему
+//     началу кривой можно стартовать;
+//   - PathFollow_Start с 0 и 1 точкой (повтор точки не считается):
+//     0, статус PATH_IDLE, Step отдаёт нули.
+
+#include "test_util.h"
+#include "path_follow.h"
+#include <math.h>
+
+#define DT 0.01f
+#define MAX_STEPS 6000U // 60 с
+
+/* Пределы по режимам [PATH_PURE_PURSUIT, PATH_STANLEY]: ~1.3× от
+ * измеренного на этой модели. Ошибка конца — goal_tol_mm (15 мм)
+ * плюс шаг.
+ */
+typedef struct
+{
+    const char *name;
+    float max_err_mm[2];
+    float rms_err_mm[2];
+    float own_max_mm[2]; // своя оценка после первой секунды
+} Bounds_t;
+
+#define END_ERR_MM 16.0f
+
+/* Расстояние от точки до отрезка */
+static float seg_dist(float px, float py, float ax, float ay, float bx, float by)
+{
+    float ex = bx - ax, ey = by - ay;
+    float t = ((px - ax) * ex + (py - ay) * ey) / (ex * ex + ey * ey);
+    t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
+    float dx = px - (ax + ex * t), dy = py - (ay + ey * t);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+/* Прогон по уже загруженному пути. ref/nref — ломаная для своей оценки
+ * отклонения (NULL — только статистика модуля).
+ */
+static void run(PathMode mode, const Bounds_t *b, Pose_t pose, const PathPoint_t *ref,
+                uint32_t nref)
+{
+    PathFollowCfg_t cfg;
+    PathFollow_DefaultCfg(&cfg);
+    cfg.mode = (uint8_t)mode;
+
+    CHECK(PathFollow_Start(&cfg, NULL));
+
+    PathStatus st = PATH_RUNNING;
+    float v = 0.0f, w = 0.0f, own_max = 0.0f;
+    uint32_t k;
+    for (k = 0; k < MAX_STEPS && st == PATH_RUNNING; k++)
+    {
+        st = PathFollow_Step(&pose, DT, &v, &w);
+
+        // unicycle: поворот по средней точке шага
+        float mid = pose.theta_rad + 0.5f * w * DT;
+        pose.x_mm += v * DT * cosf(mid);
+        pose.y_mm += v * DT * sinf(mid);
+        pose.theta_rad += w * DT;
+
+        if (ref && k > 100U) // первая секунда — выход на путь со смещения
+        {
+            float d = 1e9f;
+            for (uint32_t i = 0; i + 1U < nref; i++)
+            {
+                float di = seg_dist(pose.x_mm, pose.y_mm, ref[i].x_mm, ref[i].y_mm,
+                                    ref[i + 1U].x_mm, ref[i + 1U].y_mm);
+                if (di < d)
+                    d = di;
+            }
+            if (d > own_max)
+                own_max = d;
+        }
+    }
+
+    PathFollowStats_t s;
+    PathFollow_GetStats(&s);
+    printf("%-7s %-12s %5.2f s: cross-track max %5.1f rms %5.1f mm, end %5.1f mm",
+           b->name, (mode == PATH_STANLEY) ? "stanley" : "pure pursuit", (double)s.time_s,
+           (double)s.max_err_mm, (double)s.rms_err_mm, (double)s.end_err_mm);
+    if (ref)
+        printf(", own max %.1f mm", (double)own_max);
+    printf("\n");
+
+    CHECK(st == PATH_DONE);
+    CHECK(PathFollow_Status() == PATH_DONE);
+    CHECK(v == 0.0f && w == 0.0f);
+    CHECK(s.time_s < 0.5f * MAX_STEPS * DT);
+    CHECK(s.max_err_mm <= b->max_err_mm[mode]);
+    CHECK(s.rms_err_mm <= b->rms_err_mm[mode]);
+    CHECK(s.end_err_mm <= END_ERR_MM);
+    if (ref)
+        CHECK(own_max <= b->own_max_mm[mode]);
+}
+
+static void test_straight(PathMode mode)
+{
+    static const PathPoint_t line[] = {{0.0f, 0.0f}, {1500.0f, 0.0f}};
+    static const Bounds_t b = {"line", {55.0f, 55.0f}, {22.0f, 18.0f}, {14.0f, 5.0f}};
+
+    Path_Clear();
+    Path_Add(line[0].x_mm, line[0].y_mm);
+    Path_Add(line[1].x_mm, line[1].y_mm);
+
+    // старт в 50 мм левее пути: max — само смещение, после первой
+    // секунды своя оценка — уже только остаток выхода на путь
+    Pose_t start = {0.0f, 50.0f, 0.0f};
+    run(mode, &b, start, line, 2);
+}
+
+static void test_corner(PathMode mode)
+{
+    static const PathPoint_t corner[] = {{0.0f, 0.0f}, {1000.0f, 0.0f}, {1000.0f, 1000.0f}};
+    static const Bounds_t b = {"corner", {50.0f, 65.0f}, {13.0f, 12.0f}, {50.0f, 65.0f}};
+
+    Path_Clear();
+    for (uint32_t i = 0; i < 3U; i++)
+        Path_Add(corner[i].x_mm, corner[i].y_mm);
+
+    Pose_t start = {0.0f, 0.0f, 0.0f};
+    run(mode, &b, start, corner, 3);
+}
+
+static void test_spline(PathMode mode)
+{
+    static const PathPoint_t ctrl[] = {
+        {0.0f, 0.0f}, {500.0f, 0.0f}, {1000.0f, 400.0f}, {1500.0f, 400.0f}, {2000.0f, 0.0f}};
+    static const Bounds_t b = {"spline", {12.0f, 27.0f}, {6.0f, 13.0f}, {0.0f, 0.0f}};
+
+    Path_Clear();
+    CHECK(Path_AddSpline(ctrl, 5, 8));
+    CHECK(Path_Count() == 4U * 8U + 1U);
+
+    Pose_t start = {0.0f, 0.0f, 0.0f};
+    run(mode, &b, start, NULL, 0);
+}
+
+static void test_spline_overflow(void)
+{
+    PathPoint_t ctrl[10];
+    for (uint32_t i = 0; i < 10U; i++)
+        ctrl[i] = (PathPoint_t){100.0f * (float)i, (i & 1U) ? 50.0f : 0.0f};
+
+    // 9 участков × 10 отсчётов + конец = 91 > PATH_MAX_POINTS
+    Path_Clear();
+    CHECK(Path_AddSpline(ctrl, 10, 10) == 0U);
+    CHECK(Path_Count() == PATH_MAX_POINTS);
+    CHECK(Path_Add(5000.0f, 0.0f) == 0U);
+    CHECK(Path_Count() == PATH_MAX_POINTS);
+
+    // уже влезшее — начало кривой: путь годный, по нему можно ехать
+    PathFollowCfg_t cfg;
+    PathFollow_DefaultCfg(&cfg);
+    CHECK(PathFollow_Start(&cfg, NULL));
+    PathFollow_Stop();
+    CHECK(PathFollow_Status() == PATH_IDLE);
+
+    // без переполнения — ровно столько точек, сколько отсчётов
+    Path_Clear();
+    CHECK(Path_AddSpline(ctrl, 7, 10));
+    CHECK(Path_Count() == PATH_MAX_POINTS - 3U);
+}
+
+static void test_start_too_short(void)
+{
+    PathFollowCfg_t cfg;
+    PathFollow_DefaultCfg(&cfg);
+    Pose_t pose = {0.0f, 0.0f, 0.0f};
+    float v = 1.0f, w = 1.0f;
+
+    Path_Clear();
+    CHECK(PathFollow_Start(&cfg, NULL) == 0U);
+    CHECK(PathFollow_Status() == PATH_IDLE);
+
+    Path_Add(100.0f, 0.0f);
+    Path_Add(100.5f, 0.0f); // ближе PATH_MIN_SEG_MM — та же точка
+    CHECK(Path_Count() == 1U);
+    CHECK(PathFollow_Start(&cfg, NULL) == 0U);
+    CHECK(PathFollow_Start(NULL, NULL) == 0U);
+    CHECK(PathFollow_Status() == PATH_IDLE);
+    CHECK(PathFollow_Step(&pose, DT, &v, &w) == PATH_IDLE);
+    CHECK(v == 0.0f && w == 0.0f);
+}
+
+int main(void)
+{
+    test_straight(PATH_PURE_PURSUIT);
+    test_straight(PATH_STANLEY);
+    test_corner(PATH_PURE_PURSUIT);
+    test_corner(PATH_STANLEY);
+    test_spline(PATH_PURE_PURSUIT);
+    test_spline(PATH_STANLEY);
+    test_spline_overflow();
+    test_start_too_short();
+    return Test_Summary("test_path_follow");
+}
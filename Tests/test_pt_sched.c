@@ -0,0 +1,162 @@
+// test_pt_sched.c
+//
+// Планировщик протопотоков (pt_sched.c) со сном idle.c на ПК.
+//
+// Главное — потерянное пробуждение: прерывание ставит флаг и PT_KICK()
+// в окне между проверкой g_ptPending и WFI. Крючок g_hostIrqHook
+// вызывается ровно там — в __disable_irq, пока маска ещё снята
+// (последний момент, когда обработчик может успеть). WFI с g_ptPending = 1
+// значит, что задача проспит до дедлайна; WFI-крючок в этом случае
+// продвигает время до будильника TIM2, как сделало бы настоящее ядро.
+//
+// Оба пути сна: короткий (SysTick выключен) и бестиковый.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "pt_sched.h"
+#include "idle.h"
+#include "stm32f4xx.h"
+
+#define EVENTS 20U
+
+static volatile uint8_t s_flag;
+static uint8_t s_armed;
+static uint32_t s_raisedUs;
+static uint32_t s_events;
+static uint32_t s_maxLatencyUs;
+static uint32_t s_wfiWithWork;
+
+/* «Прерывание» в последнем окне перед маскированием */
+static void irq_in_window(void)
+{
+    if (!s_armed)
+        return;
+    s_armed = 0;
+    s_flag = 1U;
+    s_raisedUs = Time_Us();
+    PT_KICK();
+}
+
+/* Сон ядра: до будильника TIM2 CC1 или до тика SysTick */
+static void wfi_sleep(void)
+{
+    if (g_ptPending)
+        s_wfiWithWork++;
+
+    if (TIM2->DIER & TIM_DIER_CC1IE)
+    {
+        int32_t d = (int32_t)(TIM2->CCR1 - Time_Us());
+        if (d > 0)
+            Host_AdvanceUs((uint32_t)d);
+    }
+    else
+    {
+        Host_AdvanceUs(1000U);
+    }
+}
+
+static PT_THREAD(waiter(Pt_t *pt, void *arg))
+{
+    PT_BEGIN(pt);
+    while (s_events < EVENTS)
+    {
+        s_armed = 1;
+        PT_AWAIT_FLAG(pt, s_flag);
+
+        uint32_t lat = Time_Us() - s_raisedUs;
+        if (lat > s_maxLatencyUs)
+            s_maxLatencyUs = lat;
+        s_events++;
+    }
+    PT_END(pt);
+}
+
+static uint32_t s_ticks;
+
+static PT_THREAD(sleeper(Pt_t *pt, void *arg))
+{
+    PT_BEGIN(pt);
+    while (s_ticks < 5U)
+    {
+        PT_SLEEP_MS(pt, 20);
+        s_ticks++;
+    }
+    PT_END(pt);
+}
+
+/* Время самого прохода: на ПК счётчик сам не идёт, а последнюю
+ * миллисекунду до дедлайна планировщик не спит, а крутится
+ */
+static PT_THREAD(pass_time(Pt_t *pt, void *arg))
+{
+    PT_BEGIN(pt);
+    Host_AdvanceUs(50U);
+    PT_WAIT_UNTIL(pt, (Host_AdvanceUs(50U), s_ticks >= 5U));
+    PT_END(pt);
+}
+
+static void reset(uint8_t tickless)
+{
+    s_flag = 0;
+    s_armed = 0;
+    s_events = 0;
+    s_maxLatencyUs = 0;
+    s_wfiWithWork = 0;
+    s_ticks = 0;
+    g_hostWfiCount = 0;
+    g_hostWfiUnmasked = 0;
+    g_hostPrimask = 0;
+    TIM2->DIER = 0;
+
+    SysTick->LOAD = 168000U - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = tickless ? SysTick_CTRL_ENABLE_Msk : 0U;
+}
+
+static void test_kick_in_window(uint8_t tickless)
+{
+    reset(tickless);
+    PtTask_t tasks[] = {PT_TASK(waiter, NULL, "waiter")};
+
+    g_hostIrqHook = irq_in_window;
+    g_hostWfiHook = wfi_sleep;
+    PtSched_Run(tasks, 1);
+    g_hostIrqHook = NULL;
+
+    printf("%s: %u events, max latency %u us, %u WFI\n",
+           tickless ? "tickless" : "short", (unsigned)s_events,
+           (unsigned)s_maxLatencyUs, (unsigned)g_hostWfiCount);
+    CHECK(s_events == EVENTS);
+    CHECK(s_wfiWithWork == 0U);
+    CHECK(s_maxLatencyUs == 0U); // задача продолжила без сна
+    CHECK(g_hostWfiUnmasked == 0U);
+    CHECK(g_hostPrimask == 0U); // маска восстановлена
+}
+
+/* Без прерываний сон обычный: WFI до дедлайна PT_SLEEP_MS */
+static void test_timed_sleep(uint8_t tickless)
+{
+    reset(tickless);
+    PtTask_t tasks[] = {PT_TASK(sleeper, NULL, "sleeper"), PT_TASK(pass_time, NULL, "time")};
+    uint32_t sleeps0 = PtSched_GetStats()->sleeps;
+    uint32_t t0 = Time_Us();
+
+    g_hostWfiHook = wfi_sleep;
+    PtSched_Run(tasks, 2);
+
+    uint32_t took = Time_Us() - t0;
+    CHECK(s_ticks == 5U);
+    CHECK(PtSched_GetStats()->sleeps > sleeps0);
+    CHECK(g_hostWfiCount > 0U);
+    CHECK(g_hostWfiUnmasked == 0U);
+    CHECK(took >= 100000U && took <= 106000U);
+}
+
+int main(void)
+{
+    test_kick_in_window(0);
+    test_kick_in_window(1);
+    test_timed_sleep(0);
+    test_timed_sleep(1);
+    return Test_Summary("test_pt_sched");
+}
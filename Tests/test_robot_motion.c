@@ -0,0 +1,256 @@
+// test_robot_motion.c
+//
+// Поездка на заданное расстояние (robot_motion.c) целиком: настоящие
+// stall_detect.c, odometry.c и idle.c, моторы и энкодеры — подмены.
+// DriveDistanceMM блокирующая, поэтому мир двигается из крючка опроса
+// энкодеров: каждое чтение Encoder_GetTotals — 1 мс модели.
+//
+// Колёса — wheel_plant.h с параметрами WHEEL_MODEL_* (детектор
+// заклинивания сравнивает с той же моделью). Под тормозом и на выбеге
+// колесо замедляется постоянно — с теми замедлениями, на которые
+// откалиброван планировщик остановки. Одометрия считается точной:
+// тик энкодера = Odom_LeftMM(1) пути.
+//
+// Проверяется:
+//   - штатный приезд с тормозом и выбегом: MOTION_OK, моторы
+//     выключены, ошибка конца — пара тиков плюс доля пути остановки
+//     (квантование оценки скорости); короткая цель — перелёт меньше
+//     пути торможения;
+//   - планировщик остановки: тормоз включается заранее, примерно за
+//     путь торможения с текущей скорости, а не на самой цели;
+//   - удержание тормоза спит в Idle_SleepUntil, а не крутится;
+//   - заклинивание колеса на ходу: детектор снимает PWM, поездка
+//     прерывается с MOTION_ABORT_STALL;
+//   - удар (скачок ускорения на ходу): с MOTION_USE_IMU (по умолчанию)
+//     поездка прерывается с MOTION_ABORT_IMPACT, без датчика
+//     (Motion_SetImu(0)) акселерометр не опрашивается. Сборка
+//     test_robot_motion_noimu — то же с MOTION_USE_IMU=0: опроса нет,
+//     поездка доезжает.
+
+#include "test_util.h"
+#include "fake_board.h"
+#include "wheel_plant.h"
+#include "robot_motion.h"
+#include "stall_detect.h"
+#include "odometry.h"
+#include "speed_control.h"
+#include "encoder.h"
+#include <string.h>
+
+#define STEP_US 1000U
+#define PLANT_BRAKE_DECEL_MM_S2 2500.0 // как STOP_BRAKE_DECEL_MM_S2
+#define PLANT_COAST_DECEL_MM_S2 600.0  // как STOP_COAST_DECEL_MM_S2
+
+typedef struct
+{
+    WheelPlant_t w;
+    uint8_t stuck; // колесо заклинило: не крутится при любом PWM
+} Wheel_t;
+
+static Wheel_t s_wl, s_wr;
+static double s_mmPerTick;
+static double s_brakeAtMM; // путь в момент включения тормоза, −1 — ещё нет
+static uint32_t s_stuckAfterMM; // заклинить левое колесо после этого пути (0 — нет)
+static uint32_t s_impactAfterMM; // удар по X после этого пути (0 — нет)
+static int16_t s_accel[3];       // отдаётся MPU6050_ReadSample (±8g, LSB)
+
+static double true_mm(void)
+{
+    return 0.5 * (s_wl.w.revs + s_wr.w.revs) * ENC_PULSES_PER_REV * s_mmPerTick;
+}
+
+static void wheel_step(Wheel_t *k, MotorId id)
+{
+    WheelPlant_t *w = &k->w;
+    double dt = STEP_US * 1e-6;
+
+    if (k->stuck)
+    {
+        w->omega = 0.0;
+        return;
+    }
+    if (g_fakeMotorPwm[id] != 0)
+    {
+        WheelPlant_Step(w, g_fakeMotorPwm[id], dt);
+        return;
+    }
+
+    double decel = g_fakeMotorBrake[id] ? PLANT_BRAKE_DECEL_MM_S2 : PLANT_COAST_DECEL_MM_S2;
+    double a = decel / (ENC_PULSES_PER_REV * s_mmPerTick) * dt; // об/с за шаг
+    double v0 = w->omega;
+    if (w->omega > a)
+        w->omega -= a;
+    else if (w->omega < -a)
+        w->omega += a;
+    else
+        w->omega = 0.0;
+    w->revs += 0.5 * fabs(v0 + w->omega) * dt;
+}
+
+static void world_step(void)
+{
+    Host_AdvanceUs(STEP_US);
+
+    if (s_brakeAtMM < 0.0 && g_fakeMotorBrake[MOTOR_A] && g_fakeMotorBrake[MOTOR_B])
+        s_brakeAtMM = true_mm();
+    if (s_stuckAfterMM && true_mm() >= (double)s_stuckAfterMM)
+        s_wl.stuck = 1;
+    if (s_impactAfterMM && true_mm() >= (double)s_impactAfterMM)
+        s_accel[0] = 4096; // +1g за отсчёт
+
+    wheel_step(&s_wl, MOTOR_A);
+    wheel_step(&s_wr, MOTOR_B);
+    FakeEnc_Add(WheelPlant_Ticks(&s_wl.w), WheelPlant_Ticks(&s_wr.w));
+}
+
+/* Доехать моделью до полной остановки (выбег после возврата) */
+static void settle(void)
+{
+    g_fakeEncPollHook = NULL;
+    for (uint32_t i = 0; i < 5000U && (s_wl.w.omega != 0.0 || s_wr.w.omega != 0.0); i++)
+        world_step();
+}
+
+static void reset(MotorStopMode mode)
+{
+    FakeMotor_Reset();
+    FakeEnc_Reset();
+    FakeUsart_Reset();
+    Odom_Init();
+    Stall_Init();
+    Motion_SetStopMode(mode);
+
+    s_mmPerTick = Odom_LeftMM(1);
+    s_wl = (Wheel_t){.w = {.K = WHEEL_MODEL_K, .u0 = WHEEL_MODEL_U0, .tau = WHEEL_MODEL_TAU}};
+    s_wr = s_wl;
+    s_brakeAtMM = -1.0;
+    s_stuckAfterMM = 0;
+    s_impactAfterMM = 0;
+    s_accel[0] = s_accel[1] = 0;
+    s_accel[2] = 4096;
+    FakeImu_SetAccel(NULL);
+    Motion_SetImu(0);
+    g_fakeImuReads = 0;
+    g_hostWfiCount = 0;
+    g_fakeEncPollHook = world_step;
+}
+
+/* Скорость установившегося режима, мм/с */
+static double cruise_mm_s(int16_t pwm)
+{
+    return WHEEL_MODEL_K * (pwm - WHEEL_MODEL_U0) * ENC_PULSES_PER_REV * s_mmPerTick;
+}
+
+static void test_arrive(MotorStopMode mode, float target_mm, int16_t pwm)
+{
+    reset(mode);
+    double v = cruise_mm_s(pwm);
+    double decel = (mode == MOTOR_STOP_BRAKE) ? PLANT_BRAKE_DECEL_MM_S2 : PLANT_COAST_DECEL_MM_S2;
+    double d_stop = v * v / (2.0 * decel);
+
+    MotionResult r = MoveForwardMM(target_mm, pwm);
+    CHECK(!g_fakeMotorBrake[MOTOR_A] && !g_fakeMotorBrake[MOTOR_B]); // тормоз отпущен
+    settle();
+
+    double end = true_mm();
+    printf("%s %4.0f mm @ pwm %d (%.0f mm/s, stop path %.0f mm): end %.1f mm, err %+.1f mm",
+           (mode == MOTOR_STOP_BRAKE) ? "brake" : "coast", (double)target_mm, pwm, v, d_stop,
+           end, end - target_mm);
+    if (mode == MOTOR_STOP_BRAKE)
+        printf(", brake at %.1f mm, %u WFI\n", s_brakeAtMM, (unsigned)g_hostWfiCount);
+    else
+        printf("\n");
+
+    CHECK(r == MOTION_OK);
+    CHECK(g_fakeMotorPwm[MOTOR_A] == 0 && g_fakeMotorPwm[MOTOR_B] == 0);
+    CHECK(strstr(FakeUsart_Text(), "STOP!") != NULL);
+    if (mode == MOTOR_STOP_BRAKE)
+        CHECK(g_hostWfiCount > 0U);
+
+    if (target_mm < 2.0f * d_stop)
+    {
+        // до крейсерской не разогнались: ФНЧ оценки скорости отстаёт
+        // на разгоне, перелёт есть, но меньше пути торможения
+        CHECK(end > target_mm - 2.5 * s_mmPerTick && end < target_mm + d_stop);
+        return;
+    }
+
+    // Скорость — по тикам за окно 20 мс (2–3 тика на крейсерской), её
+    // ошибка ~10 % даёт ~20 % пути остановки; с тормозом путь короткий
+    CHECK_NEAR(end, target_mm, 2.5 * s_mmPerTick + 0.2 * d_stop);
+    if (mode == MOTOR_STOP_BRAKE)
+    {
+        // тормоз — за путь торможения до цели, а не на ней
+        CHECK(s_brakeAtMM > 0.0);
+        CHECK_NEAR(target_mm - s_brakeAtMM, d_stop, 3.0 * s_mmPerTick);
+    }
+}
+
+static void test_stall_abort(void)
+{
+    reset(MOTOR_STOP_BRAKE);
+    s_stuckAfterMM = 300U;
+
+    MotionResult r = MoveForwardMM(1000.0f, 90);
+    settle();
+
+    double end = true_mm();
+    printf("stall after 300 mm: result %d, stopped at %.1f mm\n", (int)r, end);
+
+    CHECK(r == MOTION_ABORT_STALL);
+    CHECK((Stall_Event() & STALL_LEFT) == 0U); // DriveDistanceMM снял взвод и событие не держит
+    CHECK(g_fakeMotorPwm[MOTOR_A] == 0 && g_fakeMotorPwm[MOTOR_B] == 0);
+    CHECK(end >= 300.0 && end < 450.0);
+    CHECK(strstr(FakeUsart_Text(), "ABORT: stall") != NULL);
+    CHECK(strstr(FakeUsart_Text(), "STOP!") == NULL);
+}
+
+static void test_impact(uint8_t present)
+{
+    reset(MOTOR_STOP_BRAKE);
+    s_impactAfterMM = 300U;
+    if (present)
+        FakeImu_SetAccel(s_accel);
+    Motion_SetImu(present);
+
+    MotionResult r = MoveForwardMM(1000.0f, 90);
+    settle();
+
+    double end = true_mm();
+    printf("impact after 300 mm, imu %s: result %d, stopped at %.1f mm, %u IMU reads\n",
+           present ? "present" : "absent", (int)r, end, (unsigned)g_fakeImuReads);
+
+#if MOTION_USE_IMU
+    if (present)
+    {
+        CHECK(r == MOTION_ABORT_IMPACT);
+        CHECK(g_fakeImuReads > 0U);
+        CHECK(g_fakeMotorPwm[MOTOR_A] == 0 && g_fakeMotorPwm[MOTOR_B] == 0);
+        // детектор отключает моторы в выбег — робот докатывается
+        double v = cruise_mm_s(90);
+        CHECK(end >= 300.0 && end < 300.0 + 1.2 * v * v / (2.0 * PLANT_COAST_DECEL_MM_S2));
+        CHECK(strstr(FakeUsart_Text(), "ABORT: impact") != NULL);
+        return;
+    }
+#endif
+    // датчика нет или опрос выключен сборкой: удара не видно
+    CHECK(r == MOTION_OK);
+    CHECK(g_fakeImuReads == 0U);
+}
+
+int main(void)
+{
+    test_arrive(MOTOR_STOP_BRAKE, 1000.0f, 70);
+    test_arrive(MOTOR_STOP_BRAKE, 1000.0f, MOTOR_PWM_MAX);
+    test_arrive(MOTOR_STOP_BRAKE, 40.0f, MOTOR_PWM_MAX); // цель ближе пути разгона
+    test_arrive(MOTOR_STOP_COAST, 1000.0f, 70);
+    test_arrive(MOTOR_STOP_COAST, 1000.0f, MOTOR_PWM_MAX);
+    test_stall_abort();
+    test_impact(1);
+    test_impact(0);
+#if MOTION_USE_IMU
+    return Test_Summary("test_robot_motion");
+#else
+    return Test_Summary("test_robot_motion_noimu");
+#endif
+}
@@ -0,0 +1,140 @@
+// test_seqlock.c
+//
+// Стресс seqlock.h на ПК: один поток-писатель (в роли ISR энкодера)
+// непрерывно обновляет многословную запись, несколько потоков-читателей
+// снимают её через SeqLock_ReadCopy и через пару ReadBegin/ReadRetry.
+//
+// Запись согласована, если все её слова выведены из одного номера n:
+// разорванный снимок (половина слов от n, половина от n + 1) виден сразу.
+// Кроме того, номер в снимках каждого читателя не убывает.
+//
+// Барьер — SEQLOCK_BARRIER() в хостовом варианте (__atomic_thread_fence),
+// то есть ровно тот заголовок, что собирается в прошивку.
+
+#include "test_util.h"
+#include "seqlock.h"
+#include <pthread.h>
+
+#define WRITES 2000000U
+#define READERS 3U
+#define WORDS 8U
+
+typedef struct
+{
+    uint32_t n;
+    uint32_t w[WORDS];
+} Rec_t;
+
+static SeqLock_t s_lock = SEQLOCK_INIT;
+static volatile Rec_t s_rec;
+static volatile uint32_t s_done;
+
+static uint32_t word_of(uint32_t n, uint32_t i)
+{
+    return (n * 2654435761U) ^ (i * 0x9E3779B9U) ^ ~n;
+}
+
+static uint8_t rec_ok(const Rec_t *r)
+{
+    for (uint32_t i = 0; i < WORDS; i++)
+        if (r->w[i] != word_of(r->n, i))
+            return 0;
+    return 1;
+}
+
+static void *writer(void *arg)
+{
+    (void)arg;
+    for (uint32_t n = 1; n <= WRITES; n++)
+    {
+        SeqLock_WriteBegin(&s_lock);
+        s_rec.n = n;
+        for (uint32_t i = 0; i < WORDS; i++)
+            s_rec.w[i] = word_of(n, i);
+        SeqLock_WriteEnd(&s_lock);
+    }
+    __atomic_store_n(&s_done, 1U, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+typedef struct
+{
+    uint32_t snaps;
+    uint32_t torn;
+    uint32_t backwards;
+    uint32_t retries;
+    uint32_t last;
+} ReaderStats_t;
+
+static void *reader(void *arg)
+{
+    ReaderStats_t *st = (ReaderStats_t *)arg;
+
+    while (!__atomic_load_n(&s_done, __ATOMIC_ACQUIRE))
+    {
+        Rec_t r;
+
+        // половина снимков — готовой функцией, половина — вручную, как encoder.c
+        if (st->snaps & 1U)
+        {
+            SeqLock_ReadCopy(&s_lock, &r, &s_rec, sizeof(r));
+        }
+        else
+        {
+            uint32_t s;
+            do
+            {
+                s = SeqLock_ReadBegin(&s_lock);
+                r.n = s_rec.n;
+                for (uint32_t i = 0; i < WORDS; i++)
+                    r.w[i] = s_rec.w[i];
+                if (SeqLock_ReadRetry(&s_lock, s))
+                    st->retries++;
+                else
+                    break;
+            } while (1);
+        }
+
+        st->snaps++;
+        if (!rec_ok(&r))
+            st->torn++;
+        if (r.n < st->last)
+            st->backwards++;
+        st->last = r.n;
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    // начальная запись тоже согласована (n = 0)
+    for (uint32_t i = 0; i < WORDS; i++)
+        s_rec.w[i] = word_of(0U, i);
+
+    pthread_t wt, rt[READERS];
+    ReaderStats_t st[READERS] = {0};
+
+    for (uint32_t k = 0; k < READERS; k++)
+        CHECK(pthread_create(&rt[k], NULL, reader, &st[k]) == 0);
+    CHECK(pthread_create(&wt, NULL, writer, NULL) == 0);
+
+    pthread_join(wt, NULL);
+    for (uint32_t k = 0; k < READERS; k++)
+        pthread_join(rt[k], NULL);
+
+    uint32_t snaps = 0, retries = 0;
+    for (uint32_t k = 0; k < READERS; k++)
+    {
+        CHECK(st[k].torn == 0U);
+        CHECK(st[k].backwards == 0U);
+        CHECK(st[k].snaps > 0U);
+        snaps += st[k].snaps;
+        retries += st[k].retries;
+    }
+    CHECK(s_lock.seq == 2U * WRITES);
+    CHECK(s_rec.n == WRITES);
+
+    printf("seqlock: %u writes, %u snapshots by %u readers, %u manual retries\n",
+           (unsigned)WRITES, (unsigned)snaps, (unsigned)READERS, (unsigned)retries);
+    return Test_Summary("test_seqlock");
+}
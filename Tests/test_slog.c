@@ -0,0 +1,252 @@
+// test_slog.c
+//
+// Самописец sensor_log.c с SENSOR_LOG_ENABLE = 1 на ПК.
+//
+// DMA2 Stream6 эмулируется: пока поток включён, NDTR байт с адреса M0AR
+// уходят в «провод» USART6, затем — флаг TCIF6 и вызов обработчика
+// прерывания (он продолжает цепочку). Текст USART3 идёт в fake_usart.c,
+// то есть по другому каналу.
+//
+// Проверяется:
+//   - поток USART6 — только целые кадры, seq подряд, текст не вклинился;
+//   - куски DMA не пересекают конец кольца, передача продолжается
+//     из прерывания, пока кольцо не опустеет;
+//   - переполнение кольца — отброшенные кадры видны дырой в seq;
+//   - запись регулятора (ступенька, дуга, реверс, стоп) пишется
+//     в build/slog_run.bin для slog_replay, рядом — копия с одним
+//     испорченным PWM (build/slog_bad.bin): воспроизведение обязано
+//     совпасть с первой и разойтись со второй.
+
+#define _GNU_SOURCE // memmem
+#include "test_util.h"
+#include "fake_board.h"
+#include "sensor_log.h"
+#include "speed_control.h"
+#include "usart.h"
+#include "wheel_plant.h"
+#include "stm32f4xx.h"
+#include <string.h>
+
+void DMA2_Stream6_IRQHandler(void);
+
+#define WIRE_MAX (256U * 1024U)
+
+static uint8_t s_wire[WIRE_MAX];
+static uint32_t s_wireLen;
+static uint32_t s_dmaChunks;
+static uint32_t s_chunkWrap; // кусок вылез за конец кольца
+
+/* Эмуляция DMA: выполнить все передачи, которые успел поставить модуль */
+static void dma_drain(void)
+{
+    while (DMA2_Stream6->CR & DMA_SxCR_EN)
+    {
+        const uint8_t *src = (const uint8_t *)DMA2_Stream6->M0AR;
+        uint32_t n = DMA2_Stream6->NDTR;
+
+        if (n == 0U || n > SLOG_RING_SIZE)
+            s_chunkWrap++;
+        for (uint32_t i = 0; i < n && s_wireLen < WIRE_MAX; i++)
+            s_wire[s_wireLen++] = src[i];
+        s_dmaChunks++;
+
+        DMA2_Stream6->NDTR = 0;
+        DMA2_Stream6->CR &= ~DMA_SxCR_EN;
+        DMA2->HISR |= DMA_HISR_TCIF6;
+        DMA2_Stream6_IRQHandler();
+        DMA2->HISR = 0;
+    }
+}
+
+/* Разбор потока: число целых кадров, битых и дыр в seq */
+typedef struct
+{
+    uint32_t frames, bad, lost;
+    uint32_t per_type[5];
+    long first_pwm; // смещение первого SLOG_PWM
+} WireStats_t;
+
+static void wire_parse(const uint8_t *b, uint32_t n, WireStats_t *ws)
+{
+    memset(ws, 0, sizeof(*ws));
+    ws->first_pwm = -1;
+
+    uint32_t pos = 0;
+    uint16_t next = 0;
+    uint8_t have = 0;
+    while (pos + 11U <= n)
+    {
+        if (b[pos] != SLOG_SYNC0 || b[pos + 1U] != SLOG_SYNC1)
+        {
+            ws->bad++;
+            pos++;
+            continue;
+        }
+        SensorLogHdr_t h;
+        memcpy(&h, &b[pos + 2U], sizeof(h));
+        uint32_t end = pos + 2U + sizeof(h) + h.len + 1U;
+        if (end > n)
+            break;
+        uint8_t sum = 0;
+        for (uint32_t i = pos + 2U; i < end - 1U; i++)
+            sum = (uint8_t)(sum + b[i]);
+        if (sum != b[end - 1U])
+        {
+            ws->bad++;
+            pos++;
+            continue;
+        }
+        if (have && h.seq != next)
+            ws->lost += (uint16_t)(h.seq - next);
+        next = (uint16_t)(h.seq + 1U);
+        have = 1;
+        ws->frames++;
+        if (h.type < 5U)
+            ws->per_type[h.type]++;
+        if (h.type == SLOG_PWM && ws->first_pwm < 0)
+            ws->first_pwm = (long)pos;
+        pos = end;
+    }
+    if (pos != n)
+        ws->bad++;
+}
+
+static void save(const char *path, const uint8_t *b, uint32_t n)
+{
+    FILE *f = fopen(path, "wb");
+    CHECK(f != NULL);
+    if (!f)
+        return;
+    CHECK(fwrite(b, 1, n, f) == n);
+    fclose(f);
+}
+
+/* ---------------- Запись регулятора ---------------- */
+
+static void test_record(void)
+{
+    WheelPlant_t wl = {.K = 0.058, .u0 = 47.0, .tau = 0.09};
+    WheelPlant_t wr = {.K = 0.064, .u0 = 53.0, .tau = 0.07, .load = 0.2};
+
+    FakeMotor_Reset();
+    FakeEnc_Reset();
+    FakeUsart_Reset();
+    SensorLog_Init();
+    SpeedControl_Init();
+    s_wireLen = 0;
+    s_dmaChunks = 0;
+    s_chunkWrap = 0;
+
+    uint32_t steps = 0, cmds = 0;
+    for (uint32_t i = 0; i < 600; i++)
+    {
+        if (i == 0)
+            (void)SpeedControl_SetWheelRps(1.5f, 1.5f), cmds++;
+        if (i == 150)
+            (void)SpeedControl_SetTwist(250.0f, -1.5f), cmds++;
+        if (i == 300)
+            (void)SpeedControl_SetWheelRps(2.0f * SPEED_WHEEL_MAX_RPS, SPEED_WHEEL_MAX_RPS),
+                cmds++; // насыщение
+        if (i == 400)
+            (void)SpeedControl_SetWheelRps(-1.0f, -1.2f), cmds++;
+        if (i == 500)
+            SpeedControl_Stop(), cmds++;
+        if (i == 550)
+            (void)SpeedControl_SetWheelRps(0.8f, 0.8f), cmds++; // старт после Stop
+
+        WheelPlant_Step(&wl, g_fakeMotorPwm[MOTOR_A], 0.01);
+        WheelPlant_Step(&wr, g_fakeMotorPwm[MOTOR_B], 0.01);
+        FakeEnc_Add(WheelPlant_Ticks(&wl), WheelPlant_Ticks(&wr));
+        Host_AdvanceUs(10000U);
+        SpeedControl_Update(0.01f);
+        steps++;
+
+        // текстовая отладка в том же цикле, как в DriveDistanceMM
+        if (i % 10U == 0U)
+        {
+            USART_Print("Distance: ");
+            USART_PrintFloat((float)wl.revs, 1);
+            USART_Println(" mm");
+        }
+
+        // DMA «медленнее» цикла: кольцо копится по несколько кадров
+        SensorLog_Flush();
+        if (i % 7U == 6U)
+            dma_drain();
+    }
+    SensorLog_Flush();
+    dma_drain();
+
+    WireStats_t ws;
+    wire_parse(s_wire, s_wireLen, &ws);
+    CHECK(ws.bad == 0U);
+    CHECK(ws.lost == 0U);
+    CHECK(ws.per_type[SLOG_CTRL] == steps);
+    CHECK(ws.per_type[SLOG_PWM] == steps);
+    CHECK(ws.per_type[SLOG_CMD] == cmds);
+    CHECK(SensorLog_Dropped() == 0U);
+    CHECK(s_chunkWrap == 0U);
+    CHECK(s_wireLen > SLOG_RING_SIZE); // кольцо обернулось не раз
+    CHECK(memmem(s_wire, s_wireLen, "Distance", 8) == NULL); // текст — только в USART3
+    CHECK(strstr(FakeUsart_Text(), "Distance: ") != NULL);
+    printf("record: %u bytes in %u DMA chunks, %u frames\n", (unsigned)s_wireLen,
+           (unsigned)s_dmaChunks, (unsigned)ws.frames);
+
+    save("build/slog_run.bin", s_wire, s_wireLen);
+
+    // одна испорченная команда мотору (с верной суммой — кадр целый)
+    CHECK(ws.first_pwm >= 0);
+    if (ws.first_pwm >= 0)
+    {
+        uint32_t p = (uint32_t)ws.first_pwm + 2U + sizeof(SensorLogHdr_t);
+        s_wire[p] = (uint8_t)(s_wire[p] + 1U);
+        s_wire[p + sizeof(SlogPwm_t)] = (uint8_t)(s_wire[p + sizeof(SlogPwm_t)] + 1U);
+        save("build/slog_bad.bin", s_wire, s_wireLen);
+    }
+}
+
+/* ---------------- Переполнение кольца ---------------- */
+
+static void test_overflow(void)
+{
+    SensorLog_Init();
+    s_wireLen = 0;
+
+    // DMA стоит (Flush не зовётся): кольцо заполняется и начинает отбрасывать
+    SlogPwm_t w = {1, 2};
+    const uint32_t frame = 2U + sizeof(SensorLogHdr_t) + sizeof(w) + 1U;
+    const uint32_t fit = SLOG_RING_SIZE / frame;
+    for (uint32_t i = 0; i < fit + 10U; i++)
+        SensorLog_Write(SLOG_PWM, &w, sizeof(w));
+    CHECK(SensorLog_Dropped() == 10U);
+
+    SensorLog_Flush();
+    dma_drain();
+    SensorLog_Write(SLOG_PWM, &w, sizeof(w)); // после дыры
+    SensorLog_Flush();
+    dma_drain();
+
+    WireStats_t ws;
+    wire_parse(s_wire, s_wireLen, &ws);
+    CHECK(ws.bad == 0U);
+    CHECK(ws.frames == fit + 1U);
+    CHECK(ws.lost == 10U);
+
+    // Init посреди передачи: DMA остановлен, кольцо пустое
+    SensorLog_Write(SLOG_PWM, &w, sizeof(w));
+    SensorLog_Flush();
+    CHECK(DMA2_Stream6->CR & DMA_SxCR_EN);
+    SensorLog_Init();
+    CHECK(!(DMA2_Stream6->CR & DMA_SxCR_EN));
+    uint32_t before = s_wireLen;
+    SensorLog_Flush();
+    dma_drain();
+    CHECK(s_wireLen == before);
+}
+
+int main(void)
+{
+    test_record();
+    test_overflow();
+    return Test_Summary("test_slog");
+}
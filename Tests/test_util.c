@@ -0,0 +1,137 @@
+// test_util.c
+#include "test_util.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "golden"
+#endif
+
+uint32_t g_testChecks = 0;
+uint32_t g_testFails = 0;
+
+void Golden_Begin(GoldenTable_t *t, const char *name, const char *header, uint32_t cols)
+{
+    t->name = name;
+    t->header = header;
+    t->cols = cols;
+    t->rows = 0;
+    t->cap = 256;
+    t->v = malloc(sizeof(double) * t->cap * cols);
+}
+
+void Golden_Row(GoldenTable_t *t, const double *row)
+{
+    if (t->rows == t->cap)
+    {
+        t->cap *= 2U;
+        t->v = realloc(t->v, sizeof(double) * t->cap * t->cols);
+    }
+    memcpy(&t->v[t->rows * t->cols], row, sizeof(double) * t->cols);
+    t->rows++;
+}
+
+static void golden_path(const GoldenTable_t *t, char *path, size_t n)
+{
+    snprintf(path, n, "%s/%s.csv", GOLDEN_DIR, t->name);
+}
+
+static void golden_write(const GoldenTable_t *t)
+{
+    char path[256];
+    golden_path(t, path, sizeof(path));
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        g_testFails++;
+        printf("golden: cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "%s\n", t->header);
+    for (uint32_t r = 0; r < t->rows; r++)
+        for (uint32_t c = 0; c < t->cols; c++)
+            fprintf(f, "%.9g%c", t->v[r * t->cols + c], (c + 1U == t->cols) ? '\n' : ',');
+    fclose(f);
+    printf("golden: wrote %s (%u rows)\n", path, (unsigned)t->rows);
+}
+
+static void golden_compare(const GoldenTable_t *t, double tol)
+{
+    char path[256];
+    golden_path(t, path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    g_testChecks++;
+    if (!f)
+    {
+        g_testFails++;
+        printf("golden: %s missing (make golden)\n", path);
+        return;
+    }
+
+    char line[1024];
+    uint32_t row = 0, bad = 0;
+    double worst = 0.0;
+
+    if (!fgets(line, sizeof(line), f) || strncmp(line, t->header, strlen(t->header)) != 0)
+    {
+        g_testFails++;
+        printf("golden: %s header differs\n", path);
+        fclose(f);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), f) && row < t->rows)
+    {
+        char *p = line;
+        for (uint32_t c = 0; c < t->cols; c++)
+        {
+            double ref = strtod(p, &p);
+            if (*p == ',')
+                p++;
+            double got = t->v[row * t->cols + c];
+            double lim = tol * ((fabs(ref) > 1.0) ? fabs(ref) : 1.0);
+            double d = fabs(got - ref);
+            if (d > worst)
+                worst = d;
+            if (d > lim && bad++ < 5U)
+                printf("golden: %s row %u col %u: got %.9g, want %.9g\n",
+                       t->name, (unsigned)row, (unsigned)c, got, ref);
+        }
+        row++;
+    }
+    fclose(f);
+
+    if (row != t->rows)
+    {
+        bad++;
+        printf("golden: %s has %u rows, run produced %u\n", t->name, (unsigned)row,
+               (unsigned)t->rows);
+    }
+    if (bad)
+        g_testFails++;
+    printf("golden: %-16s %4u rows, max |diff| %.3g %s\n", t->name, (unsigned)t->rows,
+           worst, bad ? "FAIL" : "ok");
+}
+
+void Golden_Finish(GoldenTable_t *t, double tol)
+{
+    const char *upd = getenv("GOLDEN_UPDATE");
+    if (upd && upd[0] == '1')
+        golden_write(t);
+    else
+        golden_compare(t, tol);
+    free(t->v);
+    t->v = NULL;
+}
+
+int Test_Summary(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, (unsigned)g_testChecks, (unsigned)g_testFails);
+    return g_testFails ? 1 : 0;
+}
+
+void Test_ReportNs(const char *what, uint64_t ns_total, uint32_t calls)
+{
+    printf("  %-24s %8.1f ns/call (host)\n", what, (double)ns_total / (double)calls);
+}
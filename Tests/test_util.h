@@ -0,0 +1,67 @@
+// test_util.h
+//
+// Минимум для тестов на ПК: проверки, эталонные трассы, замер времени.
+//
+// Эталонная трасса (golden) — CSV в Tests/golden/: строка заголовка,
+// затем числа. Тест прогоняет сценарий, собирает ту же таблицу и
+// сравнивает по столбцам с допуском |a − b| ≤ tol · max(1, |b|).
+// GOLDEN_UPDATE=1 в окружении — перезаписать эталон вместо сравнения
+// (make golden); изменение эталона видно в diff коммита.
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern uint32_t g_testChecks;
+extern uint32_t g_testFails;
+
+#define CHECK(cond)                                                          \
+    do                                                                       \
+    {                                                                        \
+        g_testChecks++;                                                      \
+        if (!(cond))                                                         \
+        {                                                                    \
+            g_testFails++;                                                   \
+            printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, #cond);          \
+        }                                                                    \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                \
+    do                                                                       \
+    {                                                                        \
+        double ca_ = (double)(a), cb_ = (double)(b);                         \
+        g_testChecks++;                                                      \
+        if (!(ca_ - cb_ <= (tol) && cb_ - ca_ <= (tol)))                     \
+        {                                                                    \
+            g_testFails++;                                                   \
+            printf("%s:%d: FAIL: %s = %.9g, %s = %.9g (tol %.3g)\n",         \
+                   __FILE__, __LINE__, #a, ca_, #b, cb_, (double)(tol));     \
+        }                                                                    \
+    } while (0)
+
+/* Таблица для сравнения с эталоном: rows × cols, по строкам */
+typedef struct
+{
+    const char *name;   // файл golden/<name>.csv
+    const char *header; // "t_ms,pwmL,..."
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t cap;
+    double *v;
+} GoldenTable_t;
+
+void Golden_Begin(GoldenTable_t *t, const char *name, const char *header, uint32_t cols);
+void Golden_Row(GoldenTable_t *t, const double *row);
+
+/* Сравнить (или записать при GOLDEN_UPDATE=1) и освободить таблицу */
+void Golden_Finish(GoldenTable_t *t, double tol);
+
+/* Итог теста: печать и код возврата main */
+int Test_Summary(const char *name);
+
+/* Отчёт производительности: «name  N ns/call», счёт — на хосте */
+void Test_ReportNs(const char *what, uint64_t ns_total, uint32_t calls);
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,54 @@
+// wheel_plant.h
+//
+// Модель колеса для тестов на ПК: мотор первого порядка с мёртвой зоной
+// (те же K, u0, τ, что в WHEEL_MODEL_*, но свои у каждого колеса)
+// и одноканальный энкодер — тики без знака, целая часть пройденных
+// оборотов × PPR.
+
+#ifndef WHEEL_PLANT_H
+#define WHEEL_PLANT_H
+
+#include <math.h>
+#include <stdint.h>
+#include "encoder.h"
+
+#define PLANT_SUBSTEPS 10U
+
+typedef struct
+{
+    double K, u0, tau;
+    double load;    // об/с, снимается со скорости установившегося режима
+    double omega;   // об/с со знаком PWM
+    double revs;    // пройдено оборотов (модуль)
+    double emitted; // тиков уже отдано энкодеру
+} WheelPlant_t;
+
+static inline void WheelPlant_Step(WheelPlant_t *w, int16_t pwm, double dt)
+{
+    double u = (pwm >= 0) ? pwm : -pwm;
+    double ueff = (u > w->u0) ? (u - w->u0) : 0.0;
+    double target = w->K * ueff - w->load;
+    if (target < 0.0)
+        target = 0.0;
+    if (pwm < 0)
+        target = -target;
+
+    double h = dt / PLANT_SUBSTEPS;
+    double a = exp(-h / w->tau);
+    for (uint32_t i = 0; i < PLANT_SUBSTEPS; i++)
+    {
+        w->omega = target + (w->omega - target) * a;
+        w->revs += fabs(w->omega) * h;
+    }
+}
+
+/* Тики энкодера с прошлого вызова */
+static inline uint32_t WheelPlant_Ticks(WheelPlant_t *w)
+{
+    double total = floor(w->revs * ENC_PULSES_PER_REV);
+    uint32_t n = (uint32_t)(total - w->emitted);
+    w->emitted = total;
+    return n;
+}
+
+#endif // WHEEL_PLANT_H
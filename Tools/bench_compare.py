@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+bench_compare.py — сравнение прогона бенчмарков (BENCH_ENABLE=1) с эталоном.
+
+Прошивка печатает в USART3 одну строку JSON (см. Core/Inc/bench.h):
+    {"bench":"core","cpu_hz":...,"seed":...,"results":[{"name":..,"cycles":..,"ns":..,"heap":..}]}
+
+Тот же набор на ПК (Tests/: make bench) печатает "bench":"host"; его
+эталон — Tests/bench_baseline.json, свой у каждой машины (не в git:
+абсолютные ns разных ПК несравнимы). Прогоны платы и ПК между собой
+не сравниваются — при разном "bench" выдаётся предупреждение.
+
+Захват может содержать и обычный отладочный вывод — берётся последняя
+строка, начинающаяся с {"bench".
+
+Регрессия — рост тактов на операцию больше порога (по умолчанию 10%)
+или любой прирост кучи. Код возврата 1 при регрессии — годится для CI.
+
+Использование:
+    python3 bench_compare.py capture.txt --save bench_baseline.json   # записать эталон
+    python3 bench_compare.py capture.txt bench_baseline.json          # сравнить
+    python3 bench_compare.py capture.txt bench_baseline.json --threshold 5
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_run(path):
+    """Последний JSON-прогон из захвата (или из уже сохранённого JSON)."""
+    run = None
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('{"bench"'):
+                run = json.loads(line)
+    if run is None:
+        sys.exit("bench_compare: в %s нет строки {\"bench\"...}" % path)
+    return run
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("capture", help="захват USART3 с прогоном")
+    ap.add_argument("baseline", nargs="?", help="эталонный JSON")
+    ap.add_argument("--save", metavar="FILE", help="сохранить прогон как эталон")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="порог регрессии по тактам, %% (по умолчанию 10)")
+    args = ap.parse_args()
+
+    run = load_run(args.capture)
+
+    if args.save:
+        with open(args.save, "w") as f:
+            # одной строкой — тот же формат, что и в захвате
+            f.write(json.dumps(run, separators=(",", ":")) + "\n")
+        print("bench_compare: эталон записан в %s (%d случаев)"
+              % (args.save, len(run["results"])))
+        return 0
+
+    if not args.baseline:
+        ap.error("нужен эталон или --save")
+
+    base = load_run(args.baseline)
+    if base.get("bench") != run.get("bench"):
+        print("ВНИМАНИЕ: другая сборка (%s против %s)" % (run.get("bench"), base.get("bench")))
+    if base.get("seed") != run.get("seed"):
+        print("ВНИМАНИЕ: другое зерно входов (%s против %s)" % (run.get("seed"), base.get("seed")))
+    if base.get("cpu_hz") != run.get("cpu_hz"):
+        print("ВНИМАНИЕ: другая частота ядра (%s против %s)" % (run.get("cpu_hz"), base.get("cpu_hz")))
+
+    ref = {r["name"]: r for r in base["results"]}
+    regressions = 0
+
+    print("%-18s %10s %10s %8s %6s" % ("case", "base cyc", "cyc", "delta", "heap"))
+    for r in run["results"]:
+        b = ref.pop(r["name"], None)
+        if b is None:
+            print("%-18s %10s %10.1f %8s %6d  NEW" % (r["name"], "-", r["cycles"], "-", r["heap"]))
+            continue
+
+        delta = 100.0 * (r["cycles"] - b["cycles"]) / b["cycles"] if b["cycles"] else 0.0
+        flag = ""
+        if delta > args.threshold:
+            flag = "  REGRESSION"
+        if r["heap"] > max(b["heap"], 0):
+            flag += "  HEAP"
+        if flag:
+            regressions += 1
+
+        print("%-18s %10.1f %10.1f %+7.1f%% %6d%s"
+              % (r["name"], b["cycles"], r["cycles"], delta, r["heap"], flag))
+
+    for name in ref:
+        print("%-18s  пропал из прогона" % name)
+
+    print("bench_compare: %d регрессий (порог %.1f%%)" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
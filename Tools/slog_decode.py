@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+slog_decode.py — потоковый декодер бинарного лога sensor_log (SENSOR_LOG_ENABLE=1).
+
+Формат кадра (см. Core/Inc/sensor_log.h):
+    0xA5 0x5A | t_us:u32 type:u8 len:u8 seq:u16 | payload[len] | sum8
+
+Файл открывается через mmap и разбирается генератором, поэтому длина лога
+ограничена только диском. Битые кадры (контрольная сумма) пропускаются,
+дыры в seq считаются как потерянные кадры.
+
+Использование:
+    python3 slog_decode.py capture.bin              # CSV в stdout
+    python3 slog_decode.py capture.bin --stats      # только статистика
+"""
+
+import argparse
+import mmap
+import struct
+import sys
+
+SYNC = b"\xA5\x5A"
+HDR = struct.Struct("<IBBH")
+
+SLOG_CTRL, SLOG_PWM, SLOG_CMD, SLOG_IMU = 1, 2, 3, 4
+
+PAYLOAD = {
+    SLOG_CTRL: (struct.Struct("<fII"), ("dt_sec", "ticksL", "ticksR")),
+    SLOG_PWM: (struct.Struct("<hh"), ("pwmL", "pwmR")),
+    SLOG_CMD: (struct.Struct("<ffbb"), ("left_rps", "right_rps", "dirL", "dirR")),
+    SLOG_IMU: (struct.Struct("<7h"), ("ax", "ay", "az", "temp", "gx", "gy", "gz")),
+}
+NAMES = {SLOG_CTRL: "ctrl", SLOG_PWM: "pwm", SLOG_CMD: "cmd", SLOG_IMU: "imu"}
+
+
+def frames(buf, stats):
+    """Генератор (t_us, type, seq, fields) по буферу (mmap или bytes)."""
+    pos = 0
+    end = len(buf)
+    last_seq = None
+    while True:
+        pos = buf.find(SYNC, pos)
+        if pos < 0 or pos + 2 + HDR.size > end:
+            return
+        h0 = pos + 2
+        t_us, typ, ln, seq = HDR.unpack_from(buf, h0)
+        p0 = h0 + HDR.size
+        if p0 + ln + 1 > end:
+            return
+        body = buf[h0:p0 + ln]
+        if (sum(body) & 0xFF) != buf[p0 + ln]:
+            stats["bad"] += 1
+            pos += 1  # ложная синхронизация — ищем дальше
+            continue
+        if last_seq is not None:
+            gap = (seq - last_seq - 1) & 0xFFFF
+            stats["lost"] += gap
+        last_seq = seq
+        stats["frames"] += 1
+        spec = PAYLOAD.get(typ)
+        if spec is not None and spec[0].size == ln:
+            fields = dict(zip(spec[1], spec[0].unpack_from(buf, p0)))
+        else:
+            fields = {"raw": bytes(buf[p0:p0 + ln]).hex()}
+        yield t_us, typ, seq, fields
+        pos = p0 + ln + 1
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("input", help="бинарный захват USART6 (PC6, 921600 бод)")
+    ap.add_argument("--stats", action="store_true", help="вывести только статистику")
+    args = ap.parse_args()
+
+    stats = {"frames": 0, "bad": 0, "lost": 0}
+    out = sys.stdout
+    with open(args.input, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+        if not args.stats:
+            out.write("t_us,seq,type,fields\n")
+        for t_us, typ, seq, fields in frames(mm, stats):
+            if args.stats:
+                continue
+            kv = ";".join("%s=%s" % (k, v) for k, v in fields.items())
+            out.write("%d,%d,%s,%s\n" % (t_us, seq, NAMES.get(typ, typ), kv))
+
+    sys.stderr.write("slog_decode: frames=%d bad=%d lost=%d\n"
+                     % (stats["frames"], stats["bad"], stats["lost"]))
+
+
+if __name__ == "__main__":
+    main()
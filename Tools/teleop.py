@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""
+teleop.py — поток уставок (v, ω) в робота по USART3 и замер латентности.
+
+Прошивка собрана с TELEOP_ENABLE=1 (см. Core/Inc/teleop.h). Кадр:
+    $S,<seq>,<t_host_us>,<v_mm_s>,<w_mrad_s>*HH
+Ответ (каждый TELEOP_ACK_DIV-й кадр):
+    $A,<seq>,<t_host_us>,<dev_us>*HH
+
+По ответам считается полный круг RTT = t_приёма_ответа − t_host_us и время
+в канале RTT − dev_us (USB-UART туда и обратно, ОС хоста). Оценка
+задержки в одну сторону — половина времени в канале.
+
+В конце шлётся $R — прошивка печатает свою статистику (джиттер RFC 3550,
+задержка очереди, rx → применение), она выводится как есть.
+
+--stall-at T --stall-for D — пауза в потоке: проверка контролируемой
+остановки (TELEOP_STALL_MS) и возобновления.
+
+--path "x,y x,y ..." — вместо потока загрузить путь (мм, в системе робота:
+x вперёд, y влево) кадрами $C / $P и запустить $F; --follower pp|stanley,
+--spline N — точки как контрольные Catmull-Rom, N отсчётов на участок.
+Ждёт ответа $D и печатает ошибку следования и время.
+
+--goto gx,gy — путь планирует сама прошивка (A* по карте 32×32, клетки
+100 мм, робот в клетке 0,0); --map "x0,y0,x1,y1 ..." — занятые
+прямоугольники клеток, карта перед этим очищается.
+
+Использование:
+    python3 teleop.py /dev/ttyACM0 --rate 100 --v 150 --w 0 --duration 5
+    python3 teleop.py /dev/ttyACM0 --rate 50 --v 200 --w 800 --stall-at 2 --stall-for 0.5
+    python3 teleop.py /dev/ttyACM0 --path "0,0 500,0 500,500 0,500" --follower stanley
+    python3 teleop.py /dev/ttyACM0 --path "0,0 300,0 600,300 900,0" --spline 8 --v 250
+    python3 teleop.py /dev/ttyACM0 --map "3,0,3,5 6,3,6,9" --goto 9,2
+
+Нужен pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit("teleop: нужен pyserial (pip install pyserial)")
+
+
+def nmea(body):
+    x = 0
+    for ch in body.encode("ascii"):
+        x ^= ch
+    return "$%s*%02X\r\n" % (body, x)
+
+
+def parse_frame(line, tag):
+    """Поля кадра $<tag>,...*HH (список int) или None."""
+    if not line.startswith("$" + tag + ",") or line[-3:-2] != "*":
+        return None
+    body = line[1:-3]
+    x = 0
+    for ch in body.encode("ascii"):
+        x ^= ch
+    try:
+        if x != int(line[-2:], 16):
+            return None
+        return [int(f) for f in body.split(",")[1:]]
+    except ValueError:
+        return None
+
+
+def parse_ack(line):
+    """(seq, t_host, dev_us) или None."""
+    f = parse_frame(line, "A")
+    if f is None or len(f) != 3:
+        return None
+    return tuple(f)
+
+
+def parse_path(text):
+    pts = []
+    for tok in text.split():
+        x, y = tok.split(",")
+        pts.append((int(round(float(x))), int(round(float(y)))))
+    if len(pts) < 2:
+        raise ValueError("нужно не меньше двух точек")
+    return pts
+
+
+def send_slow(port, frames):
+    for fr in frames:
+        port.write(nmea(fr).encode("ascii"))
+        time.sleep(0.005)  # приёмный буфер USART3 — 256 байт
+
+
+def run_path(port, args):
+    """Загрузка пути (или цели на карте) и ожидание завершения ($D)."""
+    mode = 1 if args.follower == "stanley" else 0
+    if args.goto:
+        gx, gy = (int(v) for v in args.goto.split(","))
+        frames = ["O,0,0,31,31,0"]
+        for rect in (args.map or "").split():
+            frames.append("O,%s,1" % rect)
+        frames.append("G,%d,%d,%d,%d" % (gx, gy, mode, args.v or 0))
+    else:
+        frames = ["C"]
+        frames += ["P,%d,%d" % p for p in parse_path(args.path)]
+        frames.append("F,%d,%d,%d" % (mode, args.v or 0, args.spline))
+    send_slow(port, frames)
+
+    rx = b""
+    t0 = time.monotonic()
+    t_end = t0 + args.timeout
+    while time.monotonic() < t_end:
+        rx += port.read(4096)
+        while b"\n" in rx:
+            line, rx = rx.split(b"\n", 1)
+            text = line.decode("ascii", "replace").strip()
+            f = parse_frame(text, "F")
+            if f is not None:
+                if not f or f[0] == 0:
+                    print("path: прошивка не приняла путь")
+                    return 1
+                print("path: принято, %d точек после сглаживания" % f[0])
+                continue
+            g = parse_frame(text, "G")
+            if g is not None and len(g) == 4:
+                if g[0] == 0:
+                    print("path: пути нет (клеток %d, раскрыто %d)" % (g[1], g[2]))
+                    return 1
+                print("path: план %d клеток → %d точек, раскрыто %d, %d мкс"
+                      % (g[1], g[0], g[2], g[3]))
+                continue
+            d = parse_frame(text, "D")
+            if d is not None and len(d) == 4:
+                print("path: max e %d мм, rms %d мм, до конца %d мм, %.2f с"
+                      % (d[0], d[1], d[2], d[3] / 1000.0))
+                # хвост отчёта PathFollow_Report
+                t_tail = time.monotonic() + 0.3
+                while time.monotonic() < t_tail:
+                    rx += port.read(4096)
+                    time.sleep(0.01)
+                for tail in rx.decode("ascii", "replace").splitlines():
+                    if tail.strip():
+                        print("robot:", tail.strip())
+                return 0
+            if text:
+                print("robot:", text)
+        time.sleep(0.01)
+
+    # не дождались — остановить явной нулевой уставкой
+    port.write(nmea("S,%d,%d,0,0" % (1 << 30, now_us())).encode("ascii"))
+    print("path: нет ответа $D за %.1f с, робот остановлен" % args.timeout)
+    return 1
+
+
+def now_us():
+    return (time.monotonic_ns() // 1000) & 0xFFFFFFFF
+
+
+def pct(sorted_vals, p):
+    if not sorted_vals:
+        return 0
+    i = min(len(sorted_vals) - 1, int(round(p / 100.0 * (len(sorted_vals) - 1))))
+    return sorted_vals[i]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port", help="последовательный порт (USART3 через ST-LINK VCP)")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--rate", type=float, default=100.0, help="кадров в секунду (50–200)")
+    ap.add_argument("--duration", type=float, default=5.0, help="длительность потока, с")
+    ap.add_argument("--v", type=int, default=0, help="линейная скорость, мм/с")
+    ap.add_argument("--w", type=int, default=0, help="угловая скорость, мрад/с")
+    ap.add_argument("--stall-at", type=float, default=None, help="начало паузы, с")
+    ap.add_argument("--stall-for", type=float, default=0.5, help="длина паузы, с")
+    ap.add_argument("--path", default=None, help='точки пути "x,y x,y ...", мм')
+    ap.add_argument("--follower", choices=("pp", "stanley"), default="pp")
+    ap.add_argument("--spline", type=int, default=0,
+                    help="отсчётов Catmull-Rom на участок (0 — ломаная)")
+    ap.add_argument("--goto", default=None, help="клетка цели gx,gy — план на роботе")
+    ap.add_argument("--map", default=None, help='занятые клетки "x0,y0,x1,y1 ..."')
+    ap.add_argument("--timeout", type=float, default=30.0, help="ожидание конца пути, с")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=0)
+    if args.path or args.goto:
+        return run_path(port, args)
+    period = 1.0 / args.rate
+    rx = b""
+    rtt, wire, dev = [], [], []
+    sent = 0
+
+    def drain():
+        nonlocal rx
+        rx += port.read(4096)
+        while b"\n" in rx:
+            line, rx = rx.split(b"\n", 1)
+            text = line.decode("ascii", "replace").strip()
+            ack = parse_ack(text)
+            if ack is None:
+                if text:
+                    print("robot:", text)
+                continue
+            t_rx = now_us()
+            _, t_host, dev_us = ack
+            r = (t_rx - t_host) & 0xFFFFFFFF
+            rtt.append(r)
+            dev.append(dev_us)
+            wire.append(r - dev_us)
+
+    t0 = time.monotonic()
+    t_next = t0
+    seq = 0
+    try:
+        while True:
+            t = time.monotonic() - t0
+            if t >= args.duration:
+                break
+            stalled = (args.stall_at is not None and
+                       args.stall_at <= t < args.stall_at + args.stall_for)
+            if time.monotonic() >= t_next:
+                t_next += period
+                if not stalled:
+                    seq += 1
+                    port.write(nmea("S,%d,%d,%d,%d" % (seq, now_us(), args.v, args.w))
+                               .encode("ascii"))
+                    sent += 1
+            drain()
+            time.sleep(min(0.001, max(0.0, t_next - time.monotonic())))
+    finally:
+        # остановка явной нулевой уставкой, затем отчёт прошивки
+        seq += 1
+        port.write(nmea("S,%d,%d,0,0" % (seq, now_us())).encode("ascii"))
+        time.sleep(0.05)
+        port.write(nmea("R").encode("ascii"))
+        t_end = time.monotonic() + 0.5
+        while time.monotonic() < t_end:
+            drain()
+            time.sleep(0.01)
+
+    print("teleop: отправлено %d кадров, ответов %d" % (sent, len(rtt)))
+    for name, vals in (("RTT", rtt), ("канал (RTT - прошивка)", wire), ("прошивка", dev)):
+        s = sorted(vals)
+        if s:
+            print("  %-24s us: min %6d  p50 %6d  p99 %6d  max %6d"
+                  % (name, s[0], pct(s, 50), pct(s, 99), s[-1]))
+    if wire:
+        print("  оценка в одну сторону, us: p50 %d" % (pct(sorted(wire), 50) // 2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+trace2json.py — конвертер выгрузки бортового самописца (Trace_Dump)
+в формат Chrome trace / Perfetto (JSON Trace Event Format).
+
+Использование:
+    python3 trace2json.py uart_log.txt > trace.json
+    python3 trace2json.py uart_log.txt -o trace.json
+
+Открыть результат: https://ui.perfetto.dev или chrome://tracing.
+
+Во входном файле может быть любой посторонний текст UART — берутся только
+строки между "#TRACE v1 ..." и "#END" (последний блок в файле).
+"""
+
+import argparse
+import json
+import re
+import sys
+
+EV_BOOT = 1
+EV_CTRL_TICK = 2
+EV_PWM = 3
+EV_BRAKE = 4
+EV_ENC = 5
+EV_IMU_GYRO = 6
+EV_IMU_ACC = 7
+EV_I2C_ERR = 8
+EV_MARK = 9
+EV_STALL = 10
+EV_DEADLINE = 11
+EV_TELEOP = 12
+
+MOTOR_NAMES = {0: "A", 1: "B"}
+ENC_NAMES = {0: "L", 1: "R"}
+
+HEADER_RE = re.compile(r"#TRACE v1 cpu_hz=(\d+) boots=(\d+) head=(\d+) cap=(\d+)")
+REC_RE = re.compile(r"^([0-9A-F]{8}) ([0-9A-F]{4}) ([0-9A-F]{4}) ([0-9A-F]{8})$")
+
+
+def s16(v):
+    v &= 0xFFFF
+    return v - 0x10000 if v & 0x8000 else v
+
+
+def s32(v):
+    v &= 0xFFFFFFFF
+    return v - 0x100000000 if v & 0x80000000 else v
+
+
+def parse_dump(lines):
+    """Вернуть (header, records) последнего блока #TRACE ... #END."""
+    header = None
+    records = []
+    inside = False
+    for line in lines:
+        line = line.strip()
+        m = HEADER_RE.search(line)
+        if m:
+            header = {
+                "cpu_hz": int(m.group(1)),
+                "boots": int(m.group(2)),
+                "head": int(m.group(3)),
+                "cap": int(m.group(4)),
+            }
+            records = []
+            inside = True
+            continue
+        if not inside:
+            continue
+        if line.startswith("#END"):
+            inside = False
+            continue
+        m = REC_RE.match(line)
+        if m:
+            records.append(tuple(int(g, 16) for g in m.groups()))
+    if header is None:
+        raise SystemExit("trace2json: no '#TRACE v1' block found")
+    return header, records
+
+
+def unwrap_ts(records, cpu_hz):
+    """CYCCNT 32-битный и переполняется каждые ~25 с — разворачиваем.
+    После TRACE_EV_BOOT счётчик мог начаться заново — ось времени продолжаем."""
+    out = []
+    base = 0
+    prev = None
+    last_abs = 0
+    for ts, ev, a, b in records:
+        if ev == EV_BOOT and prev is not None:
+            base = last_abs + 1 - ts
+        elif prev is not None and ts < prev and (prev - ts) > 0x80000000:
+            base += 1 << 32
+        prev = ts
+        last_abs = base + ts
+        out.append((last_abs * 1e6 / cpu_hz, ev, a, b))
+    return out
+
+
+def to_chrome(records):
+    events = []
+    pid = 1
+    tid_ctrl, tid_motor, tid_enc, tid_imu, tid_sys = 1, 2, 3, 4, 5
+    for name, tid in (("control", tid_ctrl), ("motors", tid_motor),
+                      ("encoders", tid_enc), ("imu", tid_imu), ("system", tid_sys)):
+        events.append({"ph": "M", "pid": pid, "tid": tid,
+                       "name": "thread_name", "args": {"name": name}})
+
+    for ts, ev, a, b in records:
+        if ev == EV_CTRL_TICK:
+            events.append({"ph": "i", "pid": pid, "tid": tid_ctrl, "s": "t",
+                           "name": "ctrl_tick", "ts": ts, "args": {"dt_us": b}})
+        elif ev == EV_PWM:
+            events.append({"ph": "C", "pid": pid, "name": "pwm_" + MOTOR_NAMES.get(a, str(a)),
+                           "ts": ts, "args": {"pwm": s32(b)}})
+        elif ev == EV_BRAKE:
+            events.append({"ph": "i", "pid": pid, "tid": tid_motor, "s": "t",
+                           "name": "brake_" + MOTOR_NAMES.get(a, str(a)), "ts": ts})
+        elif ev == EV_ENC:
+            events.append({"ph": "C", "pid": pid, "name": "enc_" + ENC_NAMES.get(a, str(a)),
+                           "ts": ts, "args": {"ticks": b}})
+        elif ev == EV_IMU_GYRO:
+            events.append({"ph": "C", "pid": pid, "name": "gyro_raw", "ts": ts,
+                           "args": {"x": s16(b >> 16), "y": s16(b), "z": s16(a)}})
+        elif ev == EV_IMU_ACC:
+            events.append({"ph": "C", "pid": pid, "name": "accel_raw", "ts": ts,
+                           "args": {"x": s16(b >> 16), "y": s16(b), "z": s16(a)}})
+        elif ev == EV_I2C_ERR:
+            events.append({"ph": "i", "pid": pid, "tid": tid_imu, "s": "p", "name": "i2c_error",
+                           "ts": ts, "args": {"reg": hex(a), "sr1": hex(b >> 16),
+                                              "sr2": hex(b & 0xFFFF)}})
+        elif ev == EV_BOOT:
+            events.append({"ph": "i", "pid": pid, "tid": tid_sys, "s": "g", "name": "boot",
+                           "ts": ts, "args": {"rcc_csr": hex(b)}})
+        elif ev == EV_STALL:
+            kinds = [n for bit, n in ((1, "stall_L"), (2, "stall_R"), (4, "impact")) if a & bit]
+            events.append({"ph": "i", "pid": pid, "tid": tid_motor, "s": "g",
+                           "name": "+".join(kinds) or "stall", "ts": ts,
+                           "args": {"bits": a, "jerk_lsb2": b}})
+        elif ev == EV_DEADLINE:
+            if b == 0xFFFFFFFF:
+                events.append({"ph": "i", "pid": pid, "tid": tid_sys, "s": "g",
+                               "name": "failsafe", "ts": ts, "args": {"reason": a}})
+            else:
+                events.append({"ph": "i", "pid": pid, "tid": tid_sys, "s": "g",
+                               "name": "deadline_miss", "ts": ts,
+                               "args": {"task": a, "gap_ms": b}})
+        elif ev == EV_TELEOP:
+            events.append({"ph": "i", "pid": pid, "tid": tid_ctrl, "s": "p",
+                           "name": "teleop_resume" if a else "teleop_stall", "ts": ts,
+                           "args": {"seq": b}})
+        elif ev == EV_MARK:
+            events.append({"ph": "i", "pid": pid, "tid": tid_sys, "s": "t", "name": "mark",
+                           "ts": ts, "args": {"a": a, "b": b}})
+        else:
+            events.append({"ph": "i", "pid": pid, "tid": tid_sys, "s": "t",
+                           "name": "ev_%d" % ev, "ts": ts, "args": {"a": a, "b": b}})
+    return events
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("input", help="лог UART с выгрузкой Trace_Dump()")
+    ap.add_argument("-o", "--output", help="выходной JSON (по умолчанию stdout)")
+    args = ap.parse_args()
+
+    with open(args.input, "r", errors="replace") as f:
+        header, records = parse_dump(f)
+
+    recs = unwrap_ts(records, header["cpu_hz"])
+    doc = {
+        "traceEvents": to_chrome(recs),
+        "displayTimeUnit": "ms",
+        "otherData": {k: str(v) for k, v in header.items()},
+    }
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump(doc, out)
+    if args.output:
+        out.close()
+    sys.stderr.write("trace2json: %d records, boots=%d\n" % (len(records), header["boots"]))
+
+
+if __name__ == "__main__":
+    main()